@@ -16,6 +16,7 @@
  */
 
 #include "BoundingIntervalHierarchy.h"
+#include <cstring>
 
 #ifdef _MSC_VER
   #define isnan _isnan
@@ -245,13 +246,12 @@ void BIH::subdivide(int left, int right, std::vector<uint32> &tempTree, buildDat
 
 bool BIH::writeToFile(FILE* wf) const
 {
-    uint32 treeSize = tree.size();
     uint32 check=0, count;
     check += fwrite(&bounds.low(), sizeof(float), 3, wf);
     check += fwrite(&bounds.high(), sizeof(float), 3, wf);
     check += fwrite(&treeSize, sizeof(uint32), 1, wf);
     check += fwrite(&tree[0], sizeof(uint32), treeSize, wf);
-    count = objects.size();
+    count = objectCount;
     check += fwrite(&count, sizeof(uint32), 1, wf);
     check += fwrite(&objects[0], sizeof(uint32), count, wf);
     return check == (3 + 3 + 2 + treeSize + count);
@@ -266,14 +266,53 @@ bool BIH::readFromFile(FILE* rf)
     check += fread(&hi, sizeof(float), 3, rf);
     bounds = G3D::AABox(lo, hi);
     check += fread(&treeSize, sizeof(uint32), 1, rf);
-    tree.resize(treeSize);
-    check += fread(&tree[0], sizeof(uint32), treeSize, rf);
+    treeStorage.resize(treeSize);
+    check += fread(&treeStorage[0], sizeof(uint32), treeSize, rf);
     check += fread(&count, sizeof(uint32), 1, rf);
-    objects.resize(count); // = new uint32[nObjects];
-    check += fread(&objects[0], sizeof(uint32), count, rf);
+    objectStorage.resize(count); // = new uint32[nObjects];
+    check += fread(objectStorage.data(), sizeof(uint32), count, rf);
+    useStorage();
     return uint64(check) == uint64(3 + 3 + 1 + 1 + uint64(treeSize) + uint64(count));
 }
 
+bool BIH::readFromMemory(char const*& data, char const* end)
+{
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint32))
+        return false;
+
+    G3D::Vector3 lo, hi;
+    uint32 newTreeSize, count;
+    char const* pos = data;
+    if (end - pos < std::ptrdiff_t(sizeof(float) * 6 + sizeof(uint32)))
+        return false;
+
+    memcpy(&lo, pos, sizeof(float) * 3);
+    memcpy(&hi, pos + sizeof(float) * 3, sizeof(float) * 3);
+    memcpy(&newTreeSize, pos + sizeof(float) * 6, sizeof(uint32));
+    pos += sizeof(float) * 6 + sizeof(uint32);
+
+    // a tree always holds at least its root node
+    if (!newTreeSize || uint64(end - pos) < uint64(newTreeSize + 1) * sizeof(uint32))
+        return false;
+
+    uint32 const* newTree = reinterpret_cast<uint32 const*>(pos);
+    pos += newTreeSize * sizeof(uint32);
+    memcpy(&count, pos, sizeof(uint32));
+    pos += sizeof(uint32);
+    if (uint64(end - pos) < uint64(count) * sizeof(uint32))
+        return false;
+
+    treeStorage.clear();
+    objectStorage.clear();
+    bounds = G3D::AABox(lo, hi);
+    tree = newTree;
+    treeSize = newTreeSize;
+    objects = reinterpret_cast<uint32 const*>(pos);
+    objectCount = count;
+    data = pos + count * sizeof(uint32);
+    return true;
+}
+
 void BIH::BuildStats::updateLeaf(int depth, int n)
 {
     numLeaves++;
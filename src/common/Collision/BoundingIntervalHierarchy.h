@@ -23,6 +23,7 @@
 #include <G3D/AABox.h>
 
 #include "Define.h"
+#include "RayPacket.h"
 
 #include <stdexcept>
 #include <vector>
@@ -71,14 +72,43 @@ class TC_COMMON_API BIH
     private:
         void init_empty()
         {
-            tree.clear();
-            objects.clear();
+            treeStorage.clear();
+            objectStorage.clear();
             // create space for the first node
-            tree.push_back(3u << 30u); // dummy leaf
-            tree.insert(tree.end(), 2, 0);
+            treeStorage.push_back(3u << 30u); // dummy leaf
+            treeStorage.insert(treeStorage.end(), 2, 0);
+            useStorage();
+        }
+        void useStorage()
+        {
+            tree = treeStorage.data();
+            treeSize = uint32(treeStorage.size());
+            objects = objectStorage.data();
+            objectCount = uint32(objectStorage.size());
         }
     public:
         BIH() { init_empty(); }
+        BIH(BIH const& other) : treeStorage(other.treeStorage), objectStorage(other.objectStorage), tree(other.tree), objects(other.objects),
+            treeSize(other.treeSize), objectCount(other.objectCount), bounds(other.bounds)
+        {
+            if (!treeStorage.empty())
+                useStorage();
+        }
+        BIH& operator=(BIH const& other)
+        {
+            if (this == &other)
+                return *this;
+            treeStorage = other.treeStorage;
+            objectStorage = other.objectStorage;
+            tree = other.tree;
+            objects = other.objects;
+            treeSize = other.treeSize;
+            objectCount = other.objectCount;
+            bounds = other.bounds;
+            if (!treeStorage.empty())
+                useStorage();
+            return *this;
+        }
         template< class BoundsFunc, class PrimArray >
         void build(const PrimArray &primitives, BoundsFunc &getBounds, uint32 leafSize = 3, bool printStats=false)
         {
@@ -106,15 +136,16 @@ class TC_COMMON_API BIH
             if (printStats)
                 stats.printStats();
 
-            objects.resize(dat.numPrims);
+            objectStorage.resize(dat.numPrims);
             for (uint32 i=0; i<dat.numPrims; ++i)
-                objects[i] = dat.indices[i];
+                objectStorage[i] = dat.indices[i];
             //nObjects = dat.numPrims;
-            tree = tempTree;
+            treeStorage = tempTree;
+            useStorage();
             delete[] dat.primBound;
             delete[] dat.indices;
         }
-        uint32 primCount() const { return uint32(objects.size()); }
+        uint32 primCount() const { return objectCount; }
 
         template<typename RayCallback>
         void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst=false) const
@@ -255,6 +286,111 @@ class TC_COMMON_API BIH
             }
         }
 
+        /**
+        Traces all rays of mask through the tree at once, each node is visited once for the whole packet.
+        The callback is invoked as intersectCallback(packet, mask, entry) with the still active rays
+        that reached the leaf, it is responsible for updating packet.MaxDist and calling packet.AddHits
+        */
+        template<typename RayCallback>
+        void intersectRays(RayPacket& packet, RayCallback& intersectCallback, RayPacket::Mask mask) const
+        {
+            AABound box = { bounds.low(), bounds.high() };
+            mask = packet.IntersectBox(box.lo, box.hi, mask & packet.Active);
+            if (!mask)
+                return;
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, children are the parts of the node box left of the left clip plane and right of the right one
+                            AABound left = box;
+                            AABound right = box;
+                            left.hi[axis] = std::min(box.hi[axis], intBitsToFloat(tree[node + 1]));
+                            right.lo[axis] = std::max(box.lo[axis], intBitsToFloat(tree[node + 2]));
+                            RayPacket::Mask leftMask = left.lo[axis] <= left.hi[axis] ? packet.IntersectBox(left.lo, left.hi, mask) : 0;
+                            RayPacket::Mask rightMask = right.lo[axis] <= right.hi[axis] ? packet.IntersectBox(right.lo, right.hi, mask) : 0;
+                            if (!leftMask && !rightMask)
+                                break;
+
+                            if (leftMask && rightMask)
+                            {
+                                // push back right node
+                                stack[stackPos].node = offset + 3;
+                                stack[stackPos].mask = rightMask;
+                                stack[stackPos].box = right;
+                                stackPos++;
+                            }
+
+                            if (leftMask)
+                            {
+                                node = offset;
+                                mask = leftMask;
+                                box = left;
+                            }
+                            else
+                            {
+                                node = offset + 3;
+                                mask = rightMask;
+                                box = right;
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0 && mask) {
+                                intersectCallback(packet, mask, objects[offset]);
+                                mask &= packet.Active;
+                                --n;
+                                ++offset;
+                            }
+                            if (!packet.Active)
+                                return;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return; // should not happen
+                        box.lo[axis] = std::max(box.lo[axis], intBitsToFloat(tree[node + 1]));
+                        box.hi[axis] = std::min(box.hi[axis], intBitsToFloat(tree[node + 2]));
+                        node = offset;
+                        if (box.lo[axis] > box.hi[axis])
+                            break;
+                        mask = packet.IntersectBox(box.lo, box.hi, mask);
+                        if (!mask)
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return;
+                    // move back up the stack, rays may have found closer hits in the meantime
+                    stackPos--;
+                    box = stack[stackPos].box;
+                    mask = packet.IntersectBox(box.lo, box.hi, stack[stackPos].mask & packet.Active);
+                    node = stack[stackPos].node;
+                } while (!mask);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -335,10 +471,17 @@ class TC_COMMON_API BIH
 
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
+        // uses the tree written by writeToFile in place, data must stay valid and unchanged for the lifetime of this BIH and its copies
+        // data: [in/out] advanced past the tree, must be 4 byte aligned
+        bool readFromMemory(char const*& data, char const* end);
 
     protected:
-        std::vector<uint32> tree;
-        std::vector<uint32> objects;
+        std::vector<uint32> treeStorage;    // empty when the tree is used in place
+        std::vector<uint32> objectStorage;
+        uint32 const* tree;
+        uint32 const* objects;
+        uint32 treeSize;
+        uint32 objectCount;
         G3D::AABox bounds;
 
         struct buildData
@@ -354,6 +497,12 @@ class TC_COMMON_API BIH
             float tnear;
             float tfar;
         };
+        struct PacketStackNode
+        {
+            uint32 node;
+            RayPacket::Mask mask;
+            AABound box;
+        };
 
         class TC_COMMON_API BuildStats
         {
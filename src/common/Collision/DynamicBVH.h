@@ -0,0 +1,434 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DYNAMIC_BVH_H
+#define _DYNAMIC_BVH_H
+
+#include "Define.h"
+#include "Errors.h"
+#include <G3D/AABox.h>
+#include <G3D/BoundsTrait.h>
+#include <G3D/Ray.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Bounding volume hierarchy of moving objects that is updated in place.
+ *
+ * Leaves hold the bounds of an object enlarged by a margin, an object moving within them needs no change
+ * to the tree. Inserting picks the sibling increasing the surface of the tree the least, inserts and removes
+ * rebalance the nodes above the changed leaf with rotations, so no operation ever rebuilds the whole tree.
+ * Queries take a filter checked on every leaf reached before the callback, objects it rejects
+ * (disabled or in another phase) are skipped without any exact intersection test.
+ */
+template<class T, class BoundsFunc = BoundsTrait<T>>
+class DynamicBVH
+{
+    enum
+    {
+        NULL_NODE       = -1,
+        MAX_STACK_DEPTH = 256
+    };
+
+    struct Node
+    {
+        G3D::AABox Bounds;      // enlarged by _margin for leaves
+        T const* Object;        // nullptr for inner nodes
+        int32 Parent;           // next free node once released
+        int32 Child1;
+        int32 Child2;
+        int32 Height;           // 0 for leaves
+
+        bool IsLeaf() const { return Child1 == NULL_NODE; }
+    };
+
+public:
+    explicit DynamicBVH(float margin = 2.0f) : _margin(margin), _root(NULL_NODE), _freeList(NULL_NODE) { }
+    DynamicBVH(DynamicBVH const& right) = default;          // objects are shared, not copied
+
+    void insert(T const& obj)
+    {
+        if (_leaves.count(&obj))
+            return;
+
+        int32 leaf = allocateNode();
+        _nodes[leaf].Bounds = enlarge(getBounds(obj), _margin);
+        _nodes[leaf].Object = &obj;
+        _leaves[&obj] = leaf;
+        insertLeaf(leaf);
+    }
+
+    void remove(T const& obj)
+    {
+        auto itr = _leaves.find(&obj);
+        if (itr == _leaves.end())
+            return;
+
+        removeLeaf(itr->second);
+        freeNode(itr->second);
+        _leaves.erase(itr);
+    }
+
+    // Must be called after the bounds of obj changed, returns true if the tree had to be changed
+    bool update(T const& obj)
+    {
+        auto itr = _leaves.find(&obj);
+        if (itr == _leaves.end())
+            return false;
+
+        int32 leaf = itr->second;
+        G3D::AABox bounds = getBounds(obj);
+
+        // leaves much larger than their object (it shrunk or was teleported back) are refitted as well
+        if (_nodes[leaf].Bounds.contains(bounds) && enlarge(bounds, 4.0f * _margin).contains(_nodes[leaf].Bounds))
+            return false;
+
+        removeLeaf(leaf);
+        _nodes[leaf].Bounds = enlarge(bounds, _margin);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    bool contains(T const& obj) const { return _leaves.count(&obj) > 0; }
+    bool empty() const { return _root == NULL_NODE; }
+    uint32 size() const { return uint32(_leaves.size()); }
+    int32 height() const { return _root != NULL_NODE ? _nodes[_root].Height : 0; }
+
+    // callback(ray, obj, maxDist) returns true on hit, the search stops at the first hit
+    template<typename RayCallback, typename Filter>
+    void intersectRay(G3D::Ray const& ray, RayCallback& intersectCallback, float& maxDist, Filter const& filter) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        G3D::Vector3 const& origin = ray.origin();
+        G3D::Vector3 invDir;
+        for (int32 i = 0; i < 3; ++i)
+            invDir[i] = std::fabs(ray.direction()[i]) > 1e-8f ? 1.0f / ray.direction()[i] : std::copysign(1e30f, ray.direction()[i]);
+
+        int32 stack[MAX_STACK_DEPTH];
+        int32 stackSize = 0;
+        float enter;
+        if (!intersectBox(_nodes[_root].Bounds, origin, invDir, maxDist, enter))
+            return;
+
+        stack[stackSize++] = _root;
+        while (stackSize)
+        {
+            Node const& node = _nodes[stack[--stackSize]];
+            if (node.IsLeaf())
+            {
+                if (filter(*node.Object) && intersectCallback(ray, *node.Object, maxDist))
+                    return;
+
+                continue;
+            }
+
+            float enter1, enter2;
+            bool hit1 = intersectBox(_nodes[node.Child1].Bounds, origin, invDir, maxDist, enter1);
+            bool hit2 = intersectBox(_nodes[node.Child2].Bounds, origin, invDir, maxDist, enter2);
+            ASSERT(stackSize + 2 <= MAX_STACK_DEPTH);
+
+            // nearer child is visited first
+            if (hit1 && hit2)
+            {
+                bool firstIsNear = enter1 <= enter2;
+                stack[stackSize++] = firstIsNear ? node.Child2 : node.Child1;
+                stack[stackSize++] = firstIsNear ? node.Child1 : node.Child2;
+            }
+            else if (hit1)
+                stack[stackSize++] = node.Child1;
+            else if (hit2)
+                stack[stackSize++] = node.Child2;
+        }
+    }
+
+    // callback(point, obj) is called for every object passing filter with leaf bounds containing point
+    template<typename IsectCallback, typename Filter>
+    void intersectPoint(G3D::Vector3 const& point, IsectCallback& intersectCallback, Filter const& filter) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        int32 stack[MAX_STACK_DEPTH];
+        int32 stackSize = 0;
+        stack[stackSize++] = _root;
+        while (stackSize)
+        {
+            Node const& node = _nodes[stack[--stackSize]];
+            if (!node.Bounds.contains(point))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (filter(*node.Object))
+                    intersectCallback(point, *node.Object);
+
+                continue;
+            }
+
+            ASSERT(stackSize + 2 <= MAX_STACK_DEPTH);
+            stack[stackSize++] = node.Child1;
+            stack[stackSize++] = node.Child2;
+        }
+    }
+
+private:
+    static G3D::AABox getBounds(T const& obj)
+    {
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        return bounds;
+    }
+
+    static G3D::AABox enlarge(G3D::AABox const& bounds, float margin)
+    {
+        G3D::Vector3 extent(margin, margin, margin);
+        return G3D::AABox(bounds.low() - extent, bounds.high() + extent);
+    }
+
+    static G3D::AABox merge(G3D::AABox const& left, G3D::AABox const& right)
+    {
+        return G3D::AABox(left.low().min(right.low()), left.high().max(right.high()));
+    }
+
+    static bool intersectBox(G3D::AABox const& box, G3D::Vector3 const& origin, G3D::Vector3 const& invDir, float maxDist, float& enter)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDist;
+        for (int32 i = 0; i < 3; ++i)
+        {
+            float t1 = (box.low()[i] - origin[i]) * invDir[i];
+            float t2 = (box.high()[i] - origin[i]) * invDir[i];
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+
+        enter = tMin;
+        return tMin <= tMax;
+    }
+
+    int32 allocateNode()
+    {
+        int32 index;
+        if (_freeList != NULL_NODE)
+        {
+            index = _freeList;
+            _freeList = _nodes[index].Parent;
+        }
+        else
+        {
+            index = int32(_nodes.size());
+            _nodes.emplace_back();
+        }
+
+        Node& node = _nodes[index];
+        node.Object = nullptr;
+        node.Parent = NULL_NODE;
+        node.Child1 = NULL_NODE;
+        node.Child2 = NULL_NODE;
+        node.Height = 0;
+        return index;
+    }
+
+    void freeNode(int32 index)
+    {
+        _nodes[index].Object = nullptr;
+        _nodes[index].Parent = _freeList;
+        _nodes[index].Height = -1;
+        _freeList = index;
+    }
+
+    void insertLeaf(int32 leaf)
+    {
+        if (_root == NULL_NODE)
+        {
+            _root = leaf;
+            _nodes[leaf].Parent = NULL_NODE;
+            return;
+        }
+
+        // find the sibling whose enlargement costs the least surface, counting the enlargement of all its ancestors
+        G3D::AABox const leafBounds = _nodes[leaf].Bounds;
+        int32 index = _root;
+        while (!_nodes[index].IsLeaf())
+        {
+            Node const& node = _nodes[index];
+            float area = node.Bounds.area();
+            float combinedArea = merge(node.Bounds, leafBounds).area();
+
+            // cost of making a new parent for this node and the leaf
+            float cost = 2.0f * combinedArea;
+            // minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32 child)
+            {
+                Node const& childNode = _nodes[child];
+                float childArea = merge(childNode.Bounds, leafBounds).area();
+                return childNode.IsLeaf() ? childArea + inheritanceCost : childArea - childNode.Bounds.area() + inheritanceCost;
+            };
+
+            float cost1 = descendCost(node.Child1);
+            float cost2 = descendCost(node.Child2);
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        int32 sibling = index;
+        int32 oldParent = _nodes[sibling].Parent;
+        int32 newParent = allocateNode();
+        _nodes[newParent].Parent = oldParent;
+        _nodes[newParent].Bounds = merge(leafBounds, _nodes[sibling].Bounds);
+        _nodes[newParent].Height = _nodes[sibling].Height + 1;
+        _nodes[newParent].Child1 = sibling;
+        _nodes[newParent].Child2 = leaf;
+        _nodes[sibling].Parent = newParent;
+        _nodes[leaf].Parent = newParent;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (_nodes[oldParent].Child1 == sibling)
+                _nodes[oldParent].Child1 = newParent;
+            else
+                _nodes[oldParent].Child2 = newParent;
+        }
+        else
+            _root = newParent;
+
+        refitAncestors(newParent);
+    }
+
+    void removeLeaf(int32 leaf)
+    {
+        if (leaf == _root)
+        {
+            _root = NULL_NODE;
+            return;
+        }
+
+        int32 parent = _nodes[leaf].Parent;
+        int32 grandParent = _nodes[parent].Parent;
+        int32 sibling = _nodes[parent].Child1 == leaf ? _nodes[parent].Child2 : _nodes[parent].Child1;
+
+        freeNode(parent);
+        if (grandParent != NULL_NODE)
+        {
+            if (_nodes[grandParent].Child1 == parent)
+                _nodes[grandParent].Child1 = sibling;
+            else
+                _nodes[grandParent].Child2 = sibling;
+
+            _nodes[sibling].Parent = grandParent;
+            refitAncestors(grandParent);
+        }
+        else
+        {
+            _root = sibling;
+            _nodes[sibling].Parent = NULL_NODE;
+        }
+    }
+
+    void refitAncestors(int32 index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = rotate(index);
+
+            Node& node = _nodes[index];
+            node.Height = 1 + std::max(_nodes[node.Child1].Height, _nodes[node.Child2].Height);
+            node.Bounds = merge(_nodes[node.Child1].Bounds, _nodes[node.Child2].Bounds);
+            index = node.Parent;
+        }
+    }
+
+    // Rotates the taller child of iA up if the heights of its children differ by more than one, returns the new subtree root
+    int32 rotate(int32 iA)
+    {
+        Node& A = _nodes[iA];
+        if (A.IsLeaf() || A.Height < 2)
+            return iA;
+
+        int32 iB = A.Child1;
+        int32 iC = A.Child2;
+        Node& B = _nodes[iB];
+        Node& C = _nodes[iC];
+
+        int32 balance = C.Height - B.Height;
+        if (balance > 1)
+            return rotateUp(iA, iC, iB, true);
+
+        if (balance < -1)
+            return rotateUp(iA, iB, iC, false);
+
+        return iA;
+    }
+
+    // iUp (child of iA, isChild2 tells which one) takes the place of iA, iA keeps iOther and the shorter child of iUp
+    int32 rotateUp(int32 iA, int32 iUp, int32 iOther, bool isChild2)
+    {
+        Node& A = _nodes[iA];
+        Node& up = _nodes[iUp];
+        int32 iF = up.Child1;
+        int32 iG = up.Child2;
+        Node& F = _nodes[iF];
+        Node& G = _nodes[iG];
+
+        up.Child1 = iA;
+        up.Parent = A.Parent;
+        A.Parent = iUp;
+
+        if (up.Parent != NULL_NODE)
+        {
+            if (_nodes[up.Parent].Child1 == iA)
+                _nodes[up.Parent].Child1 = iUp;
+            else
+                _nodes[up.Parent].Child2 = iUp;
+        }
+        else
+            _root = iUp;
+
+        int32 iTaller = F.Height > G.Height ? iF : iG;
+        int32 iShorter = iTaller == iF ? iG : iF;
+        up.Child2 = iTaller;
+        if (isChild2)
+            A.Child2 = iShorter;
+        else
+            A.Child1 = iShorter;
+
+        _nodes[iShorter].Parent = iA;
+        A.Bounds = merge(_nodes[iOther].Bounds, _nodes[iShorter].Bounds);
+        A.Height = 1 + std::max(_nodes[iOther].Height, _nodes[iShorter].Height);
+        up.Bounds = merge(A.Bounds, _nodes[iTaller].Bounds);
+        up.Height = 1 + std::max(A.Height, _nodes[iTaller].Height);
+        return iUp;
+    }
+
+    float _margin;
+    int32 _root;
+    int32 _freeList;
+    std::vector<Node> _nodes;
+    std::unordered_map<T const*, int32> _leaves;
+
+    DynamicBVH& operator=(DynamicBVH const& right) = delete;
+};
+
+#endif // _DYNAMIC_BVH_H
@@ -16,14 +16,12 @@
  */
 
 #include "DynamicTree.h"
-#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBVH.h"
 #include "GameObjectModel.h"
 #include "Log.h"
 #include "MapTree.h"
 #include "ModelIgnoreFlags.h"
 #include "ModelInstance.h"
-#include "RegularGrid.h"
-#include "Timer.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
 #include "WorldModel.h"
@@ -33,82 +31,19 @@
 
 using VMAP::ModelInstance;
 
-namespace {
-
-int CHECK_TREE_PERIOD = 200;
-
-} // namespace
-
-template<> struct HashTrait< GameObjectModel>{
-    static size_t hashCode(const GameObjectModel& g) { return (size_t)(void*)&g; }
-};
-
-template<> struct PositionTrait< GameObjectModel> {
-    static void getPosition(const GameObjectModel& g, G3D::Vector3& p) { p = g.getPosition(); }
-};
-
 template<> struct BoundsTrait< GameObjectModel> {
     static void getBounds(const GameObjectModel& g, G3D::AABox& out) { out = g.getBounds();}
     static void getBounds2(const GameObjectModel* g, G3D::AABox& out) { out = g->getBounds();}
 };
 
-/*
-static bool operator == (const GameObjectModel& mdl, const GameObjectModel& mdl2){
-    return &mdl == &mdl2;
-}
-*/
-
-typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
-
-struct DynTreeImpl : public ParentTree/*, public Intersectable*/
+struct DynTreeImpl : public DynamicBVH<GameObjectModel>
 {
-    typedef GameObjectModel Model;
-    typedef ParentTree base;
-
-    DynTreeImpl() :
-        rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
-    {
-    }
-
-    void insert(const Model& mdl)
-    {
-        base::insert(mdl);
-        ++unbalanced_times;
-    }
-
-    void remove(const Model& mdl)
-    {
-        base::remove(mdl);
-        ++unbalanced_times;
-    }
-
-    void balance()
-    {
-        base::balance();
-        unbalanced_times = 0;
-    }
-
-    void update(uint32 difftime)
-    {
-        if (empty())
-            return;
-
-        rebalance_timer.Update(difftime);
-        if (rebalance_timer.Passed())
-        {
-            rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
-                balance();
-        }
-    }
-
-    TimeTrackerSmall rebalance_timer;
-    int unbalanced_times;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
 
+DynamicMapTree::DynamicMapTree(DynamicMapTree const& right) : impl(new DynTreeImpl(*right.impl)) { }
+
 DynamicMapTree::~DynamicMapTree()
 {
     delete impl;
@@ -124,28 +59,42 @@ void DynamicMapTree::remove(const GameObjectModel& mdl)
     impl->remove(mdl);
 }
 
+void DynamicMapTree::update(const GameObjectModel& mdl)
+{
+    impl->update(mdl);
+}
+
 bool DynamicMapTree::contains(const GameObjectModel& mdl) const
 {
     return impl->contains(mdl);
 }
 
-void DynamicMapTree::balance()
+uint32 DynamicMapTree::size() const
 {
-    impl->balance();
+    return impl->size();
 }
 
-void DynamicMapTree::update(uint32 t_diff)
+// rejects models before any of their bounds or triangles are tested
+struct DynamicTreePhaseFilter
 {
-    impl->update(t_diff);
-}
+    DynamicTreePhaseFilter(PhaseShift const& phaseShift) : _phaseShift(phaseShift) { }
+
+    bool operator()(GameObjectModel const& obj) const
+    {
+        return obj.isCollidable(_phaseShift);
+    }
+
+private:
+    PhaseShift const& _phaseShift;
+};
 
 struct DynamicTreeIntersectionCallback
 {
-    DynamicTreeIntersectionCallback(PhaseShift const& phaseShift) : _didHit(false), _phaseShift(phaseShift) { }
+    DynamicTreeIntersectionCallback() : _didHit(false) { }
 
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
-        _didHit = obj.intersectRay(r, distance, true, _phaseShift, VMAP::ModelIgnoreFlags::Nothing);
+        _didHit = obj.intersectRay(r, distance, true, VMAP::ModelIgnoreFlags::Nothing);
         return _didHit;
     }
 
@@ -153,32 +102,30 @@ struct DynamicTreeIntersectionCallback
 
 private:
     bool _didHit;
-    PhaseShift const& _phaseShift;
 };
 
 struct DynamicTreeAreaInfoCallback
 {
-    DynamicTreeAreaInfoCallback(PhaseShift const& phaseShift) : _phaseShift(phaseShift) {}
+    DynamicTreeAreaInfoCallback() { }
 
     void operator()(G3D::Vector3 const& p, GameObjectModel const& obj)
     {
-        obj.intersectPoint(p, _areaInfo, _phaseShift);
+        obj.intersectPoint(p, _areaInfo);
     }
 
     VMAP::AreaInfo const& GetAreaInfo() const { return _areaInfo; }
 
 private:
-    PhaseShift const& _phaseShift;
     VMAP::AreaInfo _areaInfo;
 };
 
 struct DynamicTreeLocationInfoCallback
 {
-    DynamicTreeLocationInfoCallback(PhaseShift const& phaseShift) : _phaseShift(phaseShift), _hitModel(nullptr) {}
+    DynamicTreeLocationInfoCallback() : _hitModel(nullptr) {}
 
     void operator()(G3D::Vector3 const& p, GameObjectModel const& obj)
     {
-        if (obj.GetLocationInfo(p, _locationInfo, _phaseShift))
+        if (obj.GetLocationInfo(p, _locationInfo))
             _hitModel = &obj;
     }
 
@@ -186,7 +133,6 @@ struct DynamicTreeLocationInfoCallback
     GameObjectModel const* GetHitModel() const { return _hitModel; }
 
 private:
-    PhaseShift const& _phaseShift;
     VMAP::LocationInfo _locationInfo;
     GameObjectModel const* _hitModel;
 };
@@ -194,8 +140,8 @@ private:
 bool DynamicMapTree::getIntersectionTime(G3D::Ray const& ray, G3D::Vector3 const& endPos, PhaseShift const& phaseShift, float& maxDist) const
 {
     float distance = maxDist;
-    DynamicTreeIntersectionCallback callback(phaseShift);
-    impl->intersectRay(ray, callback, distance, endPos);
+    DynamicTreeIntersectionCallback callback;
+    impl->intersectRay(ray, callback, distance, DynamicTreePhaseFilter(phaseShift));
     if (callback.didHit())
         maxDist = distance;
     return callback.didHit();
@@ -247,8 +193,8 @@ bool DynamicMapTree::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3
         return true;
 
     G3D::Ray r(startPos, (endPos - startPos) / maxDist);
-    DynamicTreeIntersectionCallback callback(phaseShift);
-    impl->intersectRay(r, callback, maxDist, endPos);
+    DynamicTreeIntersectionCallback callback;
+    impl->intersectRay(r, callback, maxDist, DynamicTreePhaseFilter(phaseShift));
 
     return !callback.didHit();
 }
@@ -257,8 +203,8 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
 {
     G3D::Vector3 v(x, y, z + 0.5f);
     G3D::Ray r(v, G3D::Vector3(0, 0, -1));
-    DynamicTreeIntersectionCallback callback(phaseShift);
-    impl->intersectZAllignedRay(r, callback, maxSearchDist);
+    DynamicTreeIntersectionCallback callback;
+    impl->intersectRay(r, callback, maxSearchDist, DynamicTreePhaseFilter(phaseShift));
 
     if (callback.didHit())
         return v.z - maxSearchDist;
@@ -269,8 +215,8 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
 bool DynamicMapTree::getAreaInfo(float x, float y, float& z, PhaseShift const& phaseShift, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
 {
     G3D::Vector3 v(x, y, z + 0.5f);
-    DynamicTreeAreaInfoCallback intersectionCallBack(phaseShift);
-    impl->intersectPoint(v, intersectionCallBack);
+    DynamicTreeAreaInfoCallback intersectionCallBack;
+    impl->intersectPoint(v, intersectionCallBack, DynamicTreePhaseFilter(phaseShift));
     if (intersectionCallBack.GetAreaInfo().result)
     {
         flags = intersectionCallBack.GetAreaInfo().flags;
@@ -286,8 +232,8 @@ bool DynamicMapTree::getAreaInfo(float x, float y, float& z, PhaseShift const& p
 void DynamicMapTree::getAreaAndLiquidData(float x, float y, float z, PhaseShift const& phaseShift, uint8 reqLiquidType, VMAP::AreaAndLiquidData& data) const
 {
     G3D::Vector3 v(x, y, z + 0.5f);
-    DynamicTreeLocationInfoCallback intersectionCallBack(phaseShift);
-    impl->intersectPoint(v, intersectionCallBack);
+    DynamicTreeLocationInfoCallback intersectionCallBack;
+    impl->intersectPoint(v, intersectionCallBack, DynamicTreePhaseFilter(phaseShift));
     if (intersectionCallBack.GetLocationInfo().hitModel)
     {
         data.floorZ = intersectionCallBack.GetLocationInfo().ground_Z;
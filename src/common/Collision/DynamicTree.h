@@ -43,8 +43,12 @@ class TC_COMMON_API DynamicMapTree
 public:
 
     DynamicMapTree();
+    // copies the tree structure, models are shared with the source and must outlive the copy
+    DynamicMapTree(DynamicMapTree const& right);
     ~DynamicMapTree();
 
+    DynamicMapTree& operator=(DynamicMapTree const&) = delete;
+
     bool isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, PhaseShift const& phaseShift) const;
     bool getIntersectionTime(G3D::Ray const& ray, G3D::Vector3 const& endPos, PhaseShift const& phaseShift, float& maxDist) const;
     bool getObjectHitPos(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos, G3D::Vector3& resultHitPos, float modifyDist, PhaseShift const& phaseShift) const;
@@ -55,10 +59,10 @@ public:
 
     void insert(const GameObjectModel&);
     void remove(const GameObjectModel&);
+    // must be called after the model moved, the tree is changed in place around its leaf
+    void update(const GameObjectModel&);
     bool contains(const GameObjectModel&) const;
-
-    void balance();
-    void update(uint32 diff);
+    uint32 size() const;
 };
 
 #endif // _DYNTREE_H
@@ -22,6 +22,12 @@
 #include "ModelIgnoreFlags.h"
 #include "Optional.h"
 #include <string>
+#include <vector>
+
+namespace G3D
+{
+    class Vector3;
+}
 
 //===========================================================
 
@@ -90,9 +96,22 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId, int x, int y) = 0;
             virtual void unloadMap(unsigned int pMapId) = 0;
 
+            /**
+            Load all models referenced by a map tile (and the same tile of child maps) without touching the map trees,
+            can be called from any thread. Returned models stay loaded until passed to releaseModels
+            */
+            virtual std::vector<uint32> preloadMapTileModels(char const* pBasePath, unsigned int pMapId, int x, int y) = 0;
+            virtual void releaseModels(std::vector<uint32> const& models) = 0;
+
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
+            Batched versions of isInLineOfSight and getHeight, positions are in world coordinates.
+            Rays are traced through the model trees together, which is considerably cheaper than one call per ray
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, G3D::Vector3 const* starts, G3D::Vector3 const* ends, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags) = 0;
+            virtual void getHeights(unsigned int pMapId, G3D::Vector3 const* positions, float* heights, uint32 count, float maxSearchDist) = 0;
+            /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
             return a position, that is pReduceDist closer to the origin
             */
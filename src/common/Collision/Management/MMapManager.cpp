@@ -19,11 +19,14 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MapDefines.h"
+#include <algorithm>
+#include <memory>
 
 namespace MMAP
 {
     static char const* const MAP_FILE_NAME_FORMAT = "%smmaps/%04i.mmap";
     static char const* const TILE_FILE_NAME_FORMAT = "%smmaps/%04i%02i%02i.mmtile";
+    static char const* const GRAPH_FILE_NAME_FORMAT = "%smmaps/%04i.mmgraph";
 
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
@@ -108,6 +111,14 @@ namespace MMAP
         // store inside our map list
         MMapData* mmap_data = new MMapData(mesh);
 
+        // optional, paths are limited to what a single navmesh query can find without it
+        std::unique_ptr<TileGraph> graph = std::make_unique<TileGraph>();
+        if (graph->Load(Trinity::StringFormat(GRAPH_FILE_NAME_FORMAT, basePath.c_str(), mapId)))
+        {
+            TC_LOG_DEBUG("maps", "MMAP:loadMapData: Loaded %04i.mmgraph with %u clusters", mapId, graph->GetNodeCount());
+            mmap_data->tileGraph = std::move(graph);
+        }
+
         itr->second = mmap_data;
         return true;
     }
@@ -117,22 +128,46 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
-    bool MMapManager::loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y)
+    bool MMapManager::loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y, MMapTileDataSet* preloadedTiles /*= nullptr*/)
     {
-        if (!loadMapImpl(basePath, mapId, x, y))
+        if (!loadMapImpl(basePath, mapId, x, y, preloadedTiles))
             return false;
 
         bool success = true;
         auto childMaps = childMapData.find(mapId);
         if (childMaps != childMapData.end())
             for (uint32 childMapId : childMaps->second)
-                if (!loadMapImpl(basePath, childMapId, x, y))
+                if (!loadMapImpl(basePath, childMapId, x, y, preloadedTiles))
                     success = false;
 
         return success;
     }
 
-    bool MMapManager::loadMapImpl(std::string const& basePath, uint32 mapId, int32 x, int32 y)
+    MMapTileDataSet MMapManager::readMapTiles(std::string const& basePath, uint32 mapId, int32 x, int32 y) const
+    {
+        MMapTileDataSet tiles;
+        MMapTileData tile;
+        if (readMapTile(basePath, mapId, x, y, tile))
+            tiles.push_back(tile);
+
+        auto childMaps = childMapData.find(mapId);
+        if (childMaps != childMapData.end())
+            for (uint32 childMapId : childMaps->second)
+                if (readMapTile(basePath, childMapId, x, y, tile))
+                    tiles.push_back(tile);
+
+        return tiles;
+    }
+
+    void MMapManager::freeMapTiles(MMapTileDataSet& tiles)
+    {
+        for (MMapTileData& tile : tiles)
+            dtFree(tile.Data);
+
+        tiles.clear();
+    }
+
+    bool MMapManager::loadMapImpl(std::string const& basePath, uint32 mapId, int32 x, int32 y, MMapTileDataSet* preloadedTiles)
     {
         // make sure the mmap is loaded and ready to load tiles
         if (!loadMapData(basePath, mapId))
@@ -147,6 +182,42 @@ namespace MMAP
         if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
             return false;
 
+        MMapTileData tile;
+        tile.Data = nullptr;
+        if (preloadedTiles)
+        {
+            auto itr = std::find_if(preloadedTiles->begin(), preloadedTiles->end(), [mapId](MMapTileData const& preloaded) { return preloaded.MapId == mapId; });
+            if (itr != preloadedTiles->end())
+            {
+                tile = *itr;
+                preloadedTiles->erase(itr);
+            }
+        }
+
+        if (!tile.Data && !readMapTile(basePath, mapId, x, y, tile))
+            return false;
+
+        dtMeshHeader* header = (dtMeshHeader*)tile.Data;
+        dtTileRef tileRef = 0;
+
+        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
+        if (dtStatusSucceed(mmap->navMesh->addTile(tile.Data, tile.Size, DT_TILE_FREE_DATA, 0, &tileRef)))
+        {
+            mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            ++loadedTiles;
+            TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile %04i[%02i, %02i] into %04i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
+            return true;
+        }
+        else
+        {
+            TC_LOG_ERROR("maps", "MMAP:loadMap: Could not load %04u%02i%02i.mmtile into navmesh", mapId, x, y);
+            dtFree(tile.Data);
+            return false;
+        }
+    }
+
+    bool MMapManager::readMapTile(std::string const& basePath, uint32 mapId, int32 x, int32 y, MMapTileData& tile) const
+    {
         // load this tile :: mmaps/MMMMXXYY.mmtile
         std::string fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, basePath.c_str(), mapId, x, y);
         FILE* file = fopen(fileName.c_str(), "rb");
@@ -198,32 +269,18 @@ namespace MMAP
         ASSERT(data);
 
         size_t result = fread(data, fileHeader.size, 1, file);
+        fclose(file);
         if (!result)
         {
             TC_LOG_ERROR("maps", "MMAP:loadMap: Bad header or data in mmap %04u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
-            return false;
-        }
-
-        fclose(file);
-
-        dtMeshHeader* header = (dtMeshHeader*)data;
-        dtTileRef tileRef = 0;
-
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
-        {
-            mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
-            ++loadedTiles;
-            TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile %04i[%02i, %02i] into %04i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
-            return true;
-        }
-        else
-        {
-            TC_LOG_ERROR("maps", "MMAP:loadMap: Could not load %04u%02i%02i.mmtile into navmesh", mapId, x, y);
             dtFree(data);
             return false;
         }
+
+        tile.MapId = mapId;
+        tile.Data = data;
+        tile.Size = fileHeader.size;
+        return true;
     }
 
     bool MMapManager::loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId)
@@ -396,6 +453,15 @@ namespace MMAP
         return itr->second->navMesh;
     }
 
+    TileGraph const* MMapManager::GetTileGraph(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        return itr->second->tileGraph.get();
+    }
+
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
         auto itr = GetMMapData(mapId);
@@ -408,4 +474,33 @@ namespace MMAP
 
         return queryItr->second;
     }
+
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(dtNavMesh const* navMesh)
+    {
+        struct QueryDeleter
+        {
+            void operator()(dtNavMeshQuery* query) const { dtFreeNavMeshQuery(query); }
+        };
+
+        thread_local std::unique_ptr<dtNavMeshQuery, QueryDeleter> query;
+        thread_local dtNavMesh const* queryNavMesh = nullptr;
+
+        if (!query)
+            query.reset(dtAllocNavMeshQuery());
+
+        // switching navmesh only resets the node pools, they are allocated once per thread
+        if (queryNavMesh != navMesh)
+        {
+            queryNavMesh = nullptr;
+            if (!query || dtStatusFailed(query->init(navMesh, 1024)))
+            {
+                TC_LOG_ERROR("maps", "MMAP:GetThreadNavMeshQuery: Failed to initialize dtNavMeshQuery");
+                return nullptr;
+            }
+
+            queryNavMesh = navMesh;
+        }
+
+        return query.get();
+    }
 }
@@ -21,6 +21,8 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include "TileGraph.h"
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -49,11 +51,22 @@ namespace MMAP
 
         dtNavMesh* navMesh;
         MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
+        std::unique_ptr<TileGraph> tileGraph;   // nullptr if mmaps_generator did not build one
     };
 
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
 
+    // tile read from disk but not added to navmesh yet, Data is owned by navmesh once the tile is loaded
+    struct MMapTileData
+    {
+        uint32 MapId;
+        unsigned char* Data;
+        uint32 Size;
+    };
+
+    typedef std::vector<MMapTileData> MMapTileDataSet;
+
     // singleton class
     // holds all all access to mmap loading unloading and meshes
     class TC_COMMON_API MMapManager
@@ -63,7 +76,10 @@ namespace MMAP
             ~MMapManager();
 
             void InitializeThreadUnsafe(std::unordered_map<uint32, std::vector<uint32>> const& mapData);
-            bool loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y);
+            bool loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y, MMapTileDataSet* preloadedTiles = nullptr);
+            // reads tiles of mapId and its child maps without adding them to navmesh, can be called from any thread
+            MMapTileDataSet readMapTiles(std::string const& basePath, uint32 mapId, int32 x, int32 y) const;
+            static void freeMapTiles(MMapTileDataSet& tiles);
             bool loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
@@ -72,16 +88,21 @@ namespace MMAP
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
+            // coarse graph for long paths, shares the lifetime of the navmesh
+            TileGraph const* GetTileGraph(uint32 mapId);
+            // query owned by the calling thread, for navmesh queries made outside of the map update of its instance
+            static dtNavMeshQuery const* GetThreadNavMeshQuery(dtNavMesh const* navMesh);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
         private:
             bool loadMapData(std::string const& basePath, uint32 mapId);
-            bool loadMapImpl(std::string const& basePath, uint32 mapId, int32 x, int32 y);
+            bool loadMapImpl(std::string const& basePath, uint32 mapId, int32 x, int32 y, MMapTileDataSet* preloadedTiles);
+            bool readMapTile(std::string const& basePath, uint32 mapId, int32 x, int32 y, MMapTileData& tile) const;
             bool loadMapInstanceImpl(std::string const& basePath, uint32 mapId, uint32 instanceId);
             bool unloadMapImpl(uint32 mapId, int32 x, int32 y);
             bool unloadMapImpl(uint32 mapId);
-            uint32 packTileID(int32 x, int32 y);
+            static uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
             MMapDataSet loadedMMaps;
@@ -0,0 +1,192 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TileGraph.h"
+#include "Log.h"
+#include "DetourCommon.h"
+#include "DetourNavMeshQuery.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <queue>
+
+namespace MMAP
+{
+    namespace
+    {
+        // routes needing more clusters are left to the regular search
+        uint32 const MAX_ROUTE_SEARCH_NODES = 8192;
+
+        template<class T>
+        bool ReadArray(FILE* file, std::vector<T>& data, uint32 count)
+        {
+            data.resize(count);
+            return !count || fread(data.data(), sizeof(T), count, file) == count;
+        }
+    }
+
+    bool TileGraph::Load(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+        {
+            TC_LOG_DEBUG("maps", "MMAP:TileGraph::Load: Could not open graph file '%s'", fileName.c_str());
+            return false;
+        }
+
+        MmapGraphHeader header;
+        if (fread(&header, sizeof(MmapGraphHeader), 1, file) != 1 || header.graphMagic != MMAP_GRAPH_MAGIC)
+        {
+            TC_LOG_ERROR("maps", "MMAP:TileGraph::Load: Bad header in '%s'", fileName.c_str());
+            fclose(file);
+            return false;
+        }
+
+        if (header.graphVersion != MMAP_GRAPH_VERSION || header.mmapVersion != MMAP_VERSION)
+        {
+            TC_LOG_ERROR("maps", "MMAP:TileGraph::Load: '%s' was built with generator v%u (graph v%u), expected v%u (graph v%u)",
+                fileName.c_str(), header.mmapVersion, header.graphVersion, MMAP_VERSION, MMAP_GRAPH_VERSION);
+            fclose(file);
+            return false;
+        }
+
+        bool success = ReadArray(file, _tiles, header.tileCount)
+            && ReadArray(file, _polyNodes, header.polyCount)
+            && ReadArray(file, _nodes, header.nodeCount)
+            && ReadArray(file, _edges, header.edgeCount);
+        fclose(file);
+
+        // everything is indexed by the file, a truncated or corrupted one must not be used
+        if (success)
+            success = std::all_of(_tiles.begin(), _tiles.end(), [&](MmapGraphTile const& tile) { return uint64(tile.firstPoly) + tile.polyCount <= _polyNodes.size(); })
+                && std::all_of(_polyNodes.begin(), _polyNodes.end(), [&](uint32 node) { return node == MMAP_GRAPH_INVALID_NODE || node < _nodes.size(); })
+                && std::all_of(_nodes.begin(), _nodes.end(), [&](MmapGraphNode const& node) { return uint64(node.firstEdge) + node.edgeCount <= _edges.size(); })
+                && std::all_of(_edges.begin(), _edges.end(), [&](MmapGraphEdge const& edge) { return edge.target < _nodes.size(); });
+
+        if (!success)
+        {
+            TC_LOG_ERROR("maps", "MMAP:TileGraph::Load: '%s' has corrupted data", fileName.c_str());
+            _tiles.clear();
+            _polyNodes.clear();
+            _nodes.clear();
+            _edges.clear();
+            return false;
+        }
+
+        for (uint32 i = 0; i < _tiles.size(); ++i)
+            _tileIndex[PackTileId(_tiles[i].x, _tiles[i].y)] = i;
+
+        return true;
+    }
+
+    uint32 TileGraph::GetNode(dtNavMesh const* navMesh, dtPolyRef ref) const
+    {
+        dtMeshTile const* tile = nullptr;
+        dtPoly const* poly = nullptr;
+        if (dtStatusFailed(navMesh->getTileAndPolyByRef(ref, &tile, &poly)))
+            return MMAP_GRAPH_INVALID_NODE;
+
+        auto itr = _tileIndex.find(PackTileId(tile->header->x, tile->header->y));
+        if (itr == _tileIndex.end())
+            return MMAP_GRAPH_INVALID_NODE;
+
+        MmapGraphTile const& graphTile = _tiles[itr->second];
+        if (graphTile.polyCount != uint32(tile->header->polyCount))
+            return MMAP_GRAPH_INVALID_NODE;
+
+        return _polyNodes[graphTile.firstPoly + uint32(poly - tile->polys)];
+    }
+
+    bool TileGraph::FindRoute(uint32 startNode, uint32 endNode, dtQueryFilter const& filter, std::vector<float>& portals) const
+    {
+        portals.clear();
+        if (startNode >= _nodes.size() || endNode >= _nodes.size())
+            return false;
+
+        if (startNode == endNode)
+            return true;
+
+        struct SearchNode
+        {
+            float Cost;
+            uint32 Parent;
+            uint32 ParentEdge;
+            bool Closed;
+        };
+
+        typedef std::pair<float, uint32> OpenEntry;     // estimated total cost, node
+
+        float const* goal = _nodes[endNode].center;
+        std::unordered_map<uint32, SearchNode> visited;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+
+        visited[startNode] = { 0.0f, MMAP_GRAPH_INVALID_NODE, 0, false };
+        open.emplace(dtVdist(_nodes[startNode].center, goal), startNode);
+
+        while (!open.empty())
+        {
+            uint32 current = open.top().second;
+            open.pop();
+
+            SearchNode& currentData = visited[current];
+            if (currentData.Closed)
+                continue;
+
+            currentData.Closed = true;
+            if (current == endNode)
+                break;
+
+            if (visited.size() > MAX_ROUTE_SEARCH_NODES)
+                return false;
+
+            MmapGraphNode const& node = _nodes[current];
+            float const currentCost = currentData.Cost;
+            for (uint32 i = node.firstEdge; i < node.firstEdge + node.edgeCount; ++i)
+            {
+                MmapGraphEdge const& edge = _edges[i];
+                MmapGraphNode const& target = _nodes[edge.target];
+
+                // same test as dtQueryFilter::passFilter, the end is reachable by definition
+                if (edge.target != endNode &&
+                    (!(target.flags & filter.getIncludeFlags()) || (target.flags & filter.getExcludeFlags())))
+                    continue;
+
+                float cost = currentCost + edge.cost;
+                auto itr = visited.find(edge.target);
+                if (itr != visited.end() && (itr->second.Closed || itr->second.Cost <= cost))
+                    continue;
+
+                visited[edge.target] = { cost, current, i, false };
+                open.emplace(cost + dtVdist(target.center, goal), edge.target);
+            }
+        }
+
+        auto endItr = visited.find(endNode);
+        if (endItr == visited.end() || !endItr->second.Closed)
+            return false;
+
+        std::vector<uint32> route;
+        for (uint32 node = endNode; node != startNode; node = visited[node].Parent)
+            route.push_back(visited[node].ParentEdge);
+
+        portals.reserve(route.size() * 3);
+        for (auto itr = route.rbegin(); itr != route.rend(); ++itr)
+            portals.insert(portals.end(), std::begin(_edges[*itr].portal), std::end(_edges[*itr].portal));
+
+        return true;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MMAP_TILE_GRAPH_H
+#define _MMAP_TILE_GRAPH_H
+
+#include "Define.h"
+#include "MapDefines.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class dtNavMesh;
+class dtQueryFilter;
+
+namespace MMAP
+{
+    /*
+     * Coarse graph of a map's navmesh, built by mmaps_generator into mmaps/MMMM.mmgraph.
+     *
+     * Every navmesh tile is split into clusters of polygons connected to each other within a small part of
+     * the tile, clusters are connected by the borders they share inside a tile and with the neighbour tiles.
+     * Searching the graph gives the clusters a long path crosses without loading the corridor in between,
+     * the path itself is then found by short detour queries between the portals of the route.
+     * The graph is read only once loaded and can be searched from any thread.
+     */
+    class TC_COMMON_API TileGraph
+    {
+        public:
+            TileGraph() { }
+
+            bool Load(std::string const& fileName);
+
+            // cluster of a polygon loaded in navMesh, MMAP_GRAPH_INVALID_NODE if its tile is not in the graph or was rebuilt since
+            uint32 GetNode(dtNavMesh const* navMesh, dtPolyRef ref) const;
+
+            // Finds the cheapest route from startNode to endNode crossing only clusters allowed by filter
+            // portals: [out] points where the route crosses from one cluster to the next, in detour coordinates
+            bool FindRoute(uint32 startNode, uint32 endNode, dtQueryFilter const& filter, std::vector<float>& portals) const;
+
+            uint32 GetNodeCount() const { return uint32(_nodes.size()); }
+
+        private:
+            static uint32 PackTileId(int32 x, int32 y) { return uint32(x) << 16 | uint32(y & 0xFFFF); }
+
+            std::vector<MmapGraphTile> _tiles;
+            std::unordered_map<uint32, uint32> _tileIndex;  // packed tile coords to index in _tiles
+            std::vector<uint32> _polyNodes;
+            std::vector<MmapGraphNode> _nodes;
+            std::vector<MmapGraphEdge> _edges;
+
+            TileGraph(TileGraph const& right) = delete;
+            TileGraph& operator=(TileGraph const& right) = delete;
+    };
+}
+
+#endif
@@ -15,6 +15,7 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -50,8 +51,8 @@ namespace VMAP
         for (auto i = iInstanceMapTrees.begin(); i != iInstanceMapTrees.end(); ++i)
             delete i->second;
 
-        for (auto i = iLoadedModelFiles.begin(); i != iLoadedModelFiles.end(); ++i)
-            delete i->second.getModel();
+        for (uint32 i = 0; i < iModelFileNames.size(); ++i)
+            delete iLoadedModels[i].Model.load();
     }
 
     InstanceTreeMap::const_iterator VMapManager2::GetMapTree(uint32 mapId) const
@@ -274,6 +275,50 @@ namespace VMAP
         return VMAP_INVALID_HEIGHT_VALUE;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, Vector3 const* starts, Vector3 const* ends, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags)
+    {
+        std::fill_n(results, count, true);
+        if (!isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            return;
+
+        auto instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<Vector3> pos1;
+        std::vector<Vector3> pos2;
+        pos1.reserve(count);
+        pos2.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            pos1.push_back(convertPositionToInternalRep(starts[i].x, starts[i].y, starts[i].z));
+            pos2.push_back(convertPositionToInternalRep(ends[i].x, ends[i].y, ends[i].z));
+        }
+
+        instanceTree->second->isInLineOfSight(pos1.data(), pos2.data(), results, count, ignoreFlags);
+    }
+
+    void VMapManager2::getHeights(unsigned int mapId, Vector3 const* positions, float* heights, uint32 count, float maxSearchDist)
+    {
+        std::fill_n(heights, count, VMAP_INVALID_HEIGHT_VALUE);
+        if (!isHeightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_HEIGHT))
+            return;
+
+        auto instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<Vector3> internalPositions;
+        internalPositions.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+            internalPositions.push_back(convertPositionToInternalRep(positions[i].x, positions[i].y, positions[i].z));
+
+        instanceTree->second->getHeights(internalPositions.data(), heights, count, maxSearchDist);
+        for (uint32 i = 0; i < count; ++i)
+            if (!(heights[i] < G3D::finf()))
+                heights[i] = VMAP_INVALID_HEIGHT_VALUE; // No height
+    }
+
     bool VMapManager2::getAreaInfo(unsigned int mapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
     {
         if (!IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_AREAFLAG))
@@ -350,15 +395,81 @@ namespace VMAP
         }
     }
 
-    WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags/* Only used when creating the model */)
+    void VMapManager2::loadModelList(std::string const& basePath)
+    {
+        std::call_once(iModelListLoaded, [this, &basePath]()
+        {
+            std::string fileName = basePath + WORLD_MODELS;
+            FILE* file = fopen(fileName.c_str(), "rb");
+            if (!file)
+            {
+                TC_LOG_ERROR("misc", "VMapManager2: could not open '%s', vmap models can not be loaded", fileName.c_str());
+                return;
+            }
+
+            char chunk[8];
+            uint32 count = 0;
+            bool result = readChunk(file, chunk, VMAP_MAGIC, 8) && fread(&count, sizeof(uint32), 1, file) == 1;
+            std::vector<std::string> fileNames;
+            for (uint32 i = 0; i < count && result; ++i)
+            {
+                uint32 nameLength;
+                char name[500];
+                result = fread(&nameLength, sizeof(uint32), 1, file) == 1 && nameLength < sizeof(name) && fread(name, sizeof(char), nameLength, file) == nameLength;
+                if (result)
+                    fileNames.emplace_back(name, nameLength);
+            }
+
+            fclose(file);
+            if (!result)
+            {
+                TC_LOG_ERROR("misc", "VMapManager2: '%s' is corrupted or was not written by this version of vmap4assembler", fileName.c_str());
+                return;
+            }
+
+            iModelFileNames = std::move(fileNames);
+            iModelIds.reserve(iModelFileNames.size());
+            for (uint32 i = 0; i < iModelFileNames.size(); ++i)
+                iModelIds[iModelFileNames[i]] = i;
+
+            iLoadedModels.reset(new ManagedModel[iModelFileNames.size()]);
+        });
+    }
+
+    uint32 VMapManager2::getModelId(std::string const& filename) const
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
-        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+        auto itr = iModelIds.find(filename);
+        if (itr == iModelIds.end())
+            return INVALID_MODEL_ID;
+
+        return itr->second;
+    }
 
-        auto model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
+    WorldModel* VMapManager2::acquireModelInstance(std::string const& basepath, uint32 modelId, uint32 flags/* Only used when creating the model */)
+    {
+        loadModelList(basepath);
+        if (modelId >= iModelFileNames.size())
         {
-            WorldModel* worldmodel = new WorldModel();
+            TC_LOG_ERROR("misc", "VMapManager2: trying to load unknown model id %u", modelId);
+            return nullptr;
+        }
+
+        ManagedModel& model = iLoadedModels[modelId];
+
+        // the model stays loaded as long as it is referenced, taking another reference needs no lock
+        int32 refCount = model.RefCount.load(std::memory_order_acquire);
+        while (refCount > 0)
+            if (model.RefCount.compare_exchange_weak(refCount, refCount + 1, std::memory_order_acq_rel))
+                return model.Model.load(std::memory_order_acquire);
+
+        std::lock_guard<std::mutex> lock(iModelLocks[modelId % iModelLocks.size()]);
+
+        // still set if its last reference was released but not deleted yet, it is simply reused
+        WorldModel* worldmodel = model.Model.load(std::memory_order_acquire);
+        if (!worldmodel)
+        {
+            std::string const& filename = iModelFileNames[modelId];
+            worldmodel = new WorldModel();
             if (!worldmodel->readFile(basepath + filename + ".vmo"))
             {
                 TC_LOG_ERROR("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
@@ -368,31 +479,95 @@ namespace VMAP
             TC_LOG_DEBUG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
 
             worldmodel->Flags = flags;
-
-            model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
-            model->second.setModel(worldmodel);
+            model.Model.store(worldmodel, std::memory_order_release);
         }
-        model->second.incRefCount();
-        return model->second.getModel();
+
+        model.RefCount.fetch_add(1, std::memory_order_acq_rel);
+        return worldmodel;
     }
 
-    void VMapManager2::releaseModelInstance(const std::string &filename)
+    void VMapManager2::releaseModelInstance(uint32 modelId)
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
-        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+        if (modelId >= iModelFileNames.size())
+        {
+            TC_LOG_ERROR("misc", "VMapManager2: trying to unload unknown model id %u", modelId);
+            return;
+        }
 
-        auto model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
+        ManagedModel& model = iLoadedModels[modelId];
+        int32 refCount = model.RefCount.fetch_sub(1, std::memory_order_acq_rel);
+        if (refCount > 1)
+            return;
+
+        if (refCount < 1)
         {
-            TC_LOG_ERROR("misc", "VMapManager2: trying to unload non-loaded file '%s'", filename.c_str());
+            model.RefCount.fetch_add(1, std::memory_order_acq_rel);
+            TC_LOG_ERROR("misc", "VMapManager2: trying to unload non-loaded file '%s'", iModelFileNames[modelId].c_str());
             return;
         }
-        if (model->second.decRefCount() == 0)
+
+        std::lock_guard<std::mutex> lock(iModelLocks[modelId % iModelLocks.size()]);
+
+        // acquired again before the lock was taken
+        if (model.RefCount.load(std::memory_order_acquire) > 0)
+            return;
+
+        if (WorldModel* worldmodel = model.Model.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            TC_LOG_DEBUG("maps", "VMapManager2: unloading file '%s'", iModelFileNames[modelId].c_str());
+            delete worldmodel;
+        }
+    }
+
+    WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags/* Only used when creating the model */)
+    {
+        loadModelList(basepath);
+        uint32 modelId = getModelId(filename);
+        if (modelId == INVALID_MODEL_ID)
+        {
+            TC_LOG_ERROR("misc", "VMapManager2: model '%s' is not listed in '%s%s'", filename.c_str(), basepath.c_str(), WORLD_MODELS);
+            return nullptr;
+        }
+
+        return acquireModelInstance(basepath, modelId, flags);
+    }
+
+    void VMapManager2::releaseModelInstance(const std::string &filename)
+    {
+        uint32 modelId = getModelId(filename);
+        if (modelId == INVALID_MODEL_ID)
         {
-            TC_LOG_DEBUG("maps", "VMapManager2: unloading file '%s'", filename.c_str());
-            delete model->second.getModel();
-            iLoadedModelFiles.erase(model);
+            TC_LOG_ERROR("misc", "VMapManager2: trying to unload non-loaded file '%s'", filename.c_str());
+            return;
         }
+
+        releaseModelInstance(modelId);
+    }
+
+    std::vector<uint32> VMapManager2::preloadMapTileModels(char const* basePath, unsigned int mapId, int x, int y)
+    {
+        std::vector<uint32> models;
+        if (!isMapLoadingEnabled())
+            return models;
+
+        std::string path = basePath;
+        if (!path.empty() && path.back() != '/' && path.back() != '\\')
+            path.push_back('/');
+
+        StaticMapTree::AcquireMapTileModels(path, mapId, x, y, this, models);
+
+        auto childMaps = iChildMapData.find(mapId);
+        if (childMaps != iChildMapData.end())
+            for (uint32 childMapId : childMaps->second)
+                StaticMapTree::AcquireMapTileModels(path, childMapId, x, y, this, models);
+
+        return models;
+    }
+
+    void VMapManager2::releaseModels(std::vector<uint32> const& models)
+    {
+        for (uint32 model : models)
+            releaseModelInstance(model);
     }
 
     LoadResult VMapManager2::existsMap(char const* basePath, unsigned int mapId, int x, int y)
@@ -18,6 +18,9 @@
 #ifndef _VMAPMANAGER2_H
 #define _VMAPMANAGER2_H
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -50,21 +53,18 @@ namespace VMAP
     class StaticMapTree;
     class WorldModel;
 
-    class TC_COMMON_API ManagedModel
+    uint32 const INVALID_MODEL_ID = 0xFFFFFFFF;
+
+    // reference counted model file, indexed by model id
+    struct ManagedModel
     {
-        public:
-            ManagedModel() : iModel(nullptr), iRefCount(0) { }
-            void setModel(WorldModel* model) { iModel = model; }
-            WorldModel* getModel() { return iModel; }
-            void incRefCount() { ++iRefCount; }
-            int decRefCount() { return --iRefCount; }
-        protected:
-            WorldModel* iModel;
-            int iRefCount;
+        ManagedModel() : Model(nullptr), RefCount(0) { }
+
+        std::atomic<WorldModel*> Model;
+        std::atomic<int32> RefCount;
     };
 
     typedef std::unordered_map<uint32, StaticMapTree*> InstanceTreeMap;
-    typedef std::unordered_map<std::string, ManagedModel> ModelFileMap;
 
     enum DisableTypes
     {
@@ -78,13 +78,20 @@ namespace VMAP
     {
         protected:
             // Tree to check collision
-            ModelFileMap iLoadedModelFiles;
             InstanceTreeMap iInstanceMapTrees;
             std::unordered_map<uint32, std::vector<uint32>> iChildMapData;
             std::unordered_map<uint32, uint32> iParentMapData;
             bool thread_safe_environment;
-            // Mutex for iLoadedModelFiles
-            std::mutex LoadedModelFilesLock;
+
+            // model ids are indexes in the model list written by vmap4assembler, the list never changes once read
+            std::once_flag iModelListLoaded;
+            std::vector<std::string> iModelFileNames;
+            std::unordered_map<std::string, uint32> iModelIds;
+            std::unique_ptr<ManagedModel[]> iLoadedModels;
+            // only taken to load or delete a model, acquiring a loaded model is lock free
+            std::array<std::mutex, 64> iModelLocks;
+
+            void loadModelList(std::string const& basePath);
 
             static uint32 GetLiquidFlagsDummy(uint32) { return 0; }
             static bool IsVMAPDisabledForDummy(uint32 /*entry*/, uint8 /*flags*/) { return false; }
@@ -110,12 +117,17 @@ namespace VMAP
             void unloadMap(unsigned int mapId) override;
             void unloadSingleMap(uint32 mapId);
 
+            std::vector<uint32> preloadMapTileModels(char const* basePath, unsigned int mapId, int x, int y) override;
+            void releaseModels(std::vector<uint32> const& models) override;
+
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) override ;
             /**
             fill the hit pos and return true, if an object was hit
             */
             bool getObjectHitPos(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist) override;
             float getHeight(unsigned int mapId, float x, float y, float z, float maxSearchDist) override;
+            void isInLineOfSight(unsigned int mapId, G3D::Vector3 const* starts, G3D::Vector3 const* ends, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags) override;
+            void getHeights(unsigned int mapId, G3D::Vector3 const* positions, float* heights, uint32 count, float maxSearchDist) override;
 
             bool processCommand(char* /*command*/) override { return false; } // for debug and extensions
 
@@ -123,8 +135,12 @@ namespace VMAP
             bool GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 reqLiquidType, float& level, float& floor, uint32& type) const override;
             void getAreaAndLiquidData(unsigned int mapId, float x, float y, float z, uint8 reqLiquidType, AreaAndLiquidData& data) const override;
 
+            WorldModel* acquireModelInstance(const std::string& basepath, uint32 modelId, uint32 flags = 0);
+            void releaseModelInstance(uint32 modelId);
+            // by file name, for models not placed by map tiles
             WorldModel* acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags = 0);
             void releaseModelInstance(const std::string& filename);
+            uint32 getModelId(std::string const& filename) const;
 
             // what's the use of this? o.O
             virtual std::string getDirFileName(unsigned int mapId, int /*x*/, int /*y*/) const override
@@ -29,6 +29,57 @@ static_assert(sizeof(MmapTileHeader) == (sizeof(MmapTileHeader::mmapMagic) +
                                          sizeof(MmapTileHeader::usesLiquids) +
                                          sizeof(MmapTileHeader::padding)), "MmapTileHeader has uninitialized padding fields");
 
+// mmaps/MMMM.mmgraph - coarse graph of the navmesh used to plan paths longer than a single detour query allows
+// layout: MmapGraphHeader, MmapGraphTile[tileCount], uint32 cluster of each polygon[polyCount], MmapGraphNode[nodeCount], MmapGraphEdge[edgeCount]
+const uint32 MMAP_GRAPH_MAGIC = 0x4d4d4752; // 'MMGR'
+#define MMAP_GRAPH_VERSION 1
+#define MMAP_GRAPH_INVALID_NODE 0xFFFFFFFF
+
+struct MmapGraphHeader
+{
+    uint32 graphMagic;
+    uint32 graphVersion;
+    uint32 mmapVersion;
+    uint32 tileCount;
+    uint32 polyCount;
+    uint32 nodeCount;
+    uint32 edgeCount;
+
+    MmapGraphHeader() : graphMagic(MMAP_GRAPH_MAGIC), graphVersion(MMAP_GRAPH_VERSION),
+        mmapVersion(MMAP_VERSION), tileCount(0), polyCount(0), nodeCount(0), edgeCount(0) { }
+};
+
+// polygons of a navmesh tile, indexed the same way as dtMeshTile::polys
+struct MmapGraphTile
+{
+    int32 x;                // dtMeshHeader::x
+    int32 y;                // dtMeshHeader::y
+    uint32 polyCount;       // dtMeshHeader::polyCount, tiles rebuilt after the graph don't match it
+    uint32 firstPoly;
+};
+
+// cluster - polygons of a tile connected to each other within a small part of it
+struct MmapGraphNode
+{
+    float center[3];        // detour coordinates, on one of the polygons of the cluster
+    uint16 flags;           // dtPoly::flags shared by all polygons of the cluster
+    uint16 padding;
+    uint32 firstEdge;
+    uint32 edgeCount;
+};
+
+struct MmapGraphEdge
+{
+    uint32 target;
+    float cost;             // distance from the center of the cluster to the center of target through portal
+    float portal[3];        // point on the border between both clusters
+};
+
+static_assert(sizeof(MmapGraphHeader) == 28, "MmapGraphHeader size is not correct");
+static_assert(sizeof(MmapGraphTile) == 16, "MmapGraphTile size is not correct");
+static_assert(sizeof(MmapGraphNode) == 24, "MmapGraphNode size is not correct, adjust the padding field size");
+static_assert(sizeof(MmapGraphEdge) == 20, "MmapGraphEdge size is not correct");
+
 enum NavArea
 {
     NAV_AREA_EMPTY          = 0,
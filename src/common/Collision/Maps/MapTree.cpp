@@ -32,6 +32,8 @@ using G3D::Vector3;
 
 namespace VMAP
 {
+    uint32 const INVALID_TREE_INDEX = 0xFFFFFFFF;
+
     class MapRayCallback
     {
         public:
@@ -50,6 +52,19 @@ namespace VMAP
             ModelIgnoreFlags flags;
     };
 
+    class MapPacketCallback
+    {
+        public:
+            MapPacketCallback(ModelInstance* val, ModelIgnoreFlags ignoreFlags) : prims(val), flags(ignoreFlags) { }
+            void operator()(RayPacket& packet, RayPacket::Mask mask, uint32 entry)
+            {
+                prims[entry].intersectRays(packet, mask, flags);
+            }
+        protected:
+            ModelInstance* prims;
+            ModelIgnoreFlags flags;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -152,6 +167,13 @@ namespace VMAP
     }
     //=========================================================
 
+    void StaticMapTree::getIntersectionTimes(RayPacket& packet, ModelIgnoreFlags ignoreFlags) const
+    {
+        MapPacketCallback intersectionCallBack(iTreeValues, ignoreFlags);
+        iTree.intersectRays(packet, intersectionCallBack, packet.All());
+    }
+    //=========================================================
+
     bool StaticMapTree::isInLineOfSight(Vector3 const& pos1, Vector3 const& pos2, ModelIgnoreFlags ignoreFlag) const
     {
         float maxDist = (pos2 - pos1).magnitude();
@@ -235,6 +257,64 @@ namespace VMAP
         return(height);
     }
 
+    void StaticMapTree::isInLineOfSight(Vector3 const* pos1, Vector3 const* pos2, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags) const
+    {
+        uint32 packetIndex[RAY_PACKET_SIZE];
+        RayPacket packet(true);
+        auto trace = [&]()
+        {
+            getIntersectionTimes(packet, ignoreFlags);
+            RayPacket::ForEach(packet.Hits, [&](uint32 i) { results[packetIndex[i]] = false; });
+            packet = RayPacket(true);
+        };
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            // same special cases as the single ray version
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            if (maxDist == std::numeric_limits<float>::max() || !std::isfinite(maxDist))
+            {
+                results[i] = false;
+                continue;
+            }
+
+            results[i] = true;
+            if (maxDist < 1e-10f)
+                continue;
+
+            packetIndex[packet.AddRay(pos1[i], (pos2[i] - pos1[i]) / maxDist, maxDist)] = i;
+            if (packet.IsFull())
+                trace();
+        }
+
+        if (packet.Count)
+            trace();
+    }
+
+    void StaticMapTree::getHeights(Vector3 const* positions, float* heights, uint32 count, float maxSearchDist) const
+    {
+        uint32 firstIndex = 0;
+        RayPacket packet(false);
+        auto trace = [&]()
+        {
+            getIntersectionTimes(packet, ModelIgnoreFlags::Nothing);
+            for (uint32 i = 0; i < packet.Count; ++i)
+                heights[firstIndex + i] = (packet.Hits & RayPacket::Bit(i)) ? positions[firstIndex + i].z - packet.MaxDist[i] : G3D::finf();
+            firstIndex += packet.Count;
+            packet = RayPacket(false);
+        };
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            packet.AddRay(positions[i], Vector3(0, 0, -1), maxSearchDist);
+            if (packet.IsFull())
+                trace();
+        }
+
+        if (packet.Count)
+            trace();
+    }
+
     StaticMapTree::TileFileOpenResult StaticMapTree::OpenMapTileFile(std::string const& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm)
     {
         TileFileOpenResult result;
@@ -351,12 +431,14 @@ namespace VMAP
 
     void StaticMapTree::UnloadMap(VMapManager2* vm)
     {
+        for (loadedTileMap::const_iterator tile = iLoadedTiles.begin(); tile != iLoadedTiles.end(); ++tile)
+            for (TileSpawnReference const& spawn : tile->second)
+                if (spawn.ModelId != INVALID_MODEL_ID)
+                    vm->releaseModelInstance(spawn.ModelId);
+
         for (loadedSpawnMap::iterator i = iLoadedSpawns.begin(); i != iLoadedSpawns.end(); ++i)
-        {
             iTreeValues[i->first].setUnloaded();
-            for (uint32 refCount = 0; refCount < i->second; ++refCount)
-                vm->releaseModelInstance(iTreeValues[i->first].name);
-        }
+
         iLoadedSpawns.clear();
         iLoadedTiles.clear();
     }
@@ -372,6 +454,7 @@ namespace VMAP
         }
         LoadResult result = LoadResult::FileNotFound;
 
+        std::vector<TileSpawnReference>& tileSpawns = iLoadedTiles[packTileID(tileX, tileY)];
         TileFileOpenResult fileResult = OpenMapTileFile(iBasePath, iMapID, tileX, tileY, vm);
         if (fileResult.File)
         {
@@ -387,38 +470,42 @@ namespace VMAP
             {
                 // read model spawns
                 ModelSpawn spawn;
-                if (ModelSpawn::readFromFile(fileResult.File, spawn))
+                uint32 modelId;
+                if (ModelSpawn::readFromFile(fileResult.File, spawn) && fread(&modelId, sizeof(uint32), 1, fileResult.File) == 1)
                 {
                     // acquire model instance
-                    WorldModel* model = vm->acquireModelInstance(iBasePath, spawn.name, spawn.flags);
+                    WorldModel* model = vm->acquireModelInstance(iBasePath, modelId, spawn.flags);
                     if (!model)
                         TC_LOG_ERROR("misc", "StaticMapTree::LoadMapTile() : could not acquire WorldModel pointer [%u, %u]", tileX, tileY);
 
+                    TileSpawnReference reference = { INVALID_TREE_INDEX, model ? modelId : INVALID_MODEL_ID };
+
                     // update tree
                     auto spawnIndex = iSpawnIndices.find(spawn.ID);
                     if (spawnIndex != iSpawnIndices.end())
                     {
                         uint32 referencedVal = spawnIndex->second;
-                        if (!iLoadedSpawns.count(referencedVal))
+                        if (referencedVal >= iNTreeValues)
+                            TC_LOG_ERROR("maps", "StaticMapTree::LoadMapTile() : invalid tree element (%u/%u) referenced in tile %s", referencedVal, iNTreeValues, fileResult.Name.c_str());
+                        else
                         {
-                            if (referencedVal >= iNTreeValues)
+                            if (!iLoadedSpawns.count(referencedVal))
                             {
-                                TC_LOG_ERROR("maps", "StaticMapTree::LoadMapTile() : invalid tree element (%u/%u) referenced in tile %s", referencedVal, iNTreeValues, fileResult.Name.c_str());
-                                continue;
+                                iTreeValues[referencedVal] = ModelInstance(spawn, model);
+                                iLoadedSpawns[referencedVal] = 1;
                             }
-
-                            iTreeValues[referencedVal] = ModelInstance(spawn, model);
-                            iLoadedSpawns[referencedVal] = 1;
-                        }
-                        else
-                        {
-                            ++iLoadedSpawns[referencedVal];
+                            else
+                            {
+                                ++iLoadedSpawns[referencedVal];
 #ifdef VMAP_DEBUG
-                            if (iTreeValues[referencedVal].ID != spawn.ID)
-                                TC_LOG_DEBUG("maps", "StaticMapTree::LoadMapTile() : trying to load wrong spawn in node");
-                            else if (iTreeValues[referencedVal].name != spawn.name)
-                                TC_LOG_DEBUG("maps", "StaticMapTree::LoadMapTile() : name collision on GUID=%u", spawn.ID);
+                                if (iTreeValues[referencedVal].ID != spawn.ID)
+                                    TC_LOG_DEBUG("maps", "StaticMapTree::LoadMapTile() : trying to load wrong spawn in node");
+                                else if (iTreeValues[referencedVal].name != spawn.name)
+                                    TC_LOG_DEBUG("maps", "StaticMapTree::LoadMapTile() : name collision on GUID=%u", spawn.ID);
 #endif
+                            }
+
+                            reference.TreeIndex = referencedVal;
                         }
                     }
                     else if (int32(iMapID) == fileResult.UsedMapId)
@@ -429,6 +516,8 @@ namespace VMAP
                         TC_LOG_ERROR("maps", "StaticMapTree::LoadMapTile() : invalid tree element (spawn %u) referenced in tile %s by map %u", spawn.ID, fileResult.Name.c_str(), iMapID);
                         result = LoadResult::ReadFromFileFailed;
                     }
+
+                    tileSpawns.push_back(reference);
                 }
                 else
                 {
@@ -436,11 +525,8 @@ namespace VMAP
                     result = LoadResult::ReadFromFileFailed;
                 }
             }
-            iLoadedTiles[packTileID(tileX, tileY)] = true;
             fclose(fileResult.File);
         }
-        else
-            iLoadedTiles[packTileID(tileX, tileY)] = false;
         TC_METRIC_EVENT("map_events", "LoadMapTile",
             "Map: " + std::to_string(iMapID) + " TileX: " + std::to_string(tileX) + " TileY: " + std::to_string(tileY));
         return result;
@@ -448,6 +534,33 @@ namespace VMAP
 
     //=========================================================
 
+    void StaticMapTree::AcquireMapTileModels(std::string const& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm, std::vector<uint32>& models)
+    {
+        TileFileOpenResult fileResult = OpenMapTileFile(basePath, mapID, tileX, tileY, vm);
+        if (!fileResult.File)
+            return;
+
+        char chunk[8];
+        uint32 numSpawns = 0;
+        if (readChunk(fileResult.File, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, fileResult.File) == 1)
+        {
+            for (uint32 i = 0; i < numSpawns; ++i)
+            {
+                ModelSpawn spawn;
+                uint32 modelId;
+                if (!ModelSpawn::readFromFile(fileResult.File, spawn) || fread(&modelId, sizeof(uint32), 1, fileResult.File) != 1)
+                    break;
+
+                if (vm->acquireModelInstance(basePath, modelId, spawn.flags))
+                    models.push_back(modelId);
+            }
+        }
+
+        fclose(fileResult.File);
+    }
+
+    //=========================================================
+
     void StaticMapTree::UnloadMapTile(uint32 tileX, uint32 tileY, VMapManager2* vm)
     {
         uint32 tileID = packTileID(tileX, tileY);
@@ -457,46 +570,23 @@ namespace VMAP
             TC_LOG_ERROR("misc", "StaticMapTree::UnloadMapTile() : trying to unload non-loaded tile - Map:%u X:%u Y:%u", iMapID, tileX, tileY);
             return;
         }
-        if (tile->second) // file associated with tile
+        for (TileSpawnReference const& spawn : tile->second)
         {
-            TileFileOpenResult fileResult = OpenMapTileFile(iBasePath, iMapID, tileX, tileY, vm);
-            if (fileResult.File)
+            // release model instance
+            if (spawn.ModelId != INVALID_MODEL_ID)
+                vm->releaseModelInstance(spawn.ModelId);
+
+            // update tree
+            if (spawn.TreeIndex == INVALID_TREE_INDEX)
+                continue;
+
+            loadedSpawnMap::iterator loadedSpawn = iLoadedSpawns.find(spawn.TreeIndex);
+            if (loadedSpawn == iLoadedSpawns.end())
+                TC_LOG_ERROR("misc", "StaticMapTree::UnloadMapTile() : trying to unload non-referenced model '%s' (ID:%u)", iTreeValues[spawn.TreeIndex].name.c_str(), iTreeValues[spawn.TreeIndex].ID);
+            else if (--loadedSpawn->second == 0)
             {
-                bool result = true;
-                char chunk[8];
-                if (!readChunk(fileResult.File, chunk, VMAP_MAGIC, 8))
-                    result = false;
-                uint32 numSpawns;
-                if (fread(&numSpawns, sizeof(uint32), 1, fileResult.File) != 1)
-                    result = false;
-                for (uint32 i = 0; i < numSpawns && result; ++i)
-                {
-                    // read model spawns
-                    ModelSpawn spawn;
-                    result = ModelSpawn::readFromFile(fileResult.File, spawn);
-                    if (result)
-                    {
-                        // release model instance
-                        vm->releaseModelInstance(spawn.name);
-
-                        // update tree
-                        auto spawnIndex = iSpawnIndices.find(spawn.ID);
-                        if (spawnIndex != iSpawnIndices.end())
-                        {
-                            uint32 referencedNode = spawnIndex->second;
-                            if (!iLoadedSpawns.count(referencedNode))
-                                TC_LOG_ERROR("misc", "StaticMapTree::UnloadMapTile() : trying to unload non-referenced model '%s' (ID:%u)", spawn.name.c_str(), spawn.ID);
-                            else if (--iLoadedSpawns[referencedNode] == 0)
-                            {
-                                iTreeValues[referencedNode].setUnloaded();
-                                iLoadedSpawns.erase(referencedNode);
-                            }
-                        }
-                        else if (int32(iMapID) == fileResult.UsedMapId) // logic documented in StaticMapTree::LoadMapTile
-                            result = false;
-                    }
-                }
-                fclose(fileResult.File);
+                iTreeValues[spawn.TreeIndex].setUnloaded();
+                iLoadedSpawns.erase(loadedSpawn);
             }
         }
         iLoadedTiles.erase(tile);
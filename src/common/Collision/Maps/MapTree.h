@@ -41,7 +41,14 @@ namespace VMAP
 
     class TC_COMMON_API StaticMapTree
     {
-        typedef std::unordered_map<uint32, bool> loadedTileMap;
+        // spawn of a loaded tile, kept to unload the tile without reading its file again
+        struct TileSpawnReference
+        {
+            uint32 TreeIndex;   // 0xFFFFFFFF if the spawn is not in this tree
+            uint32 ModelId;     // INVALID_MODEL_ID if the model could not be loaded
+        };
+
+        typedef std::unordered_map<uint32, std::vector<TileSpawnReference>> loadedTileMap;
         typedef std::unordered_map<uint32, uint32> loadedSpawnMap;
         private:
             uint32 iMapID;
@@ -52,7 +59,7 @@ namespace VMAP
 
             // Store all the map tile idents that are loaded for that map
             // some maps are not splitted into tiles and we have to make sure, not removing the map before all tiles are removed
-            // empty tiles have no tile file, hence map with bool instead of just a set (consistency check)
+            // empty tiles have no tile file and no spawns
             loadedTileMap iLoadedTiles;
             std::vector<std::pair<int32, int32>> iLoadedPrimaryTiles;
             // stores <tree_index, reference_count> to invalidate tree values, unload map, and to be able to report errors
@@ -69,12 +76,14 @@ namespace VMAP
         private:
             static TileFileOpenResult OpenMapTileFile(std::string const& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm);
             bool getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+            void getIntersectionTimes(RayPacket& packet, ModelIgnoreFlags ignoreFlags) const;
             //bool containsLoadedMapTile(unsigned int pTileIdent) const { return(iLoadedMapTiles.containsKey(pTileIdent)); }
         public:
             static std::string getTileFileName(uint32 mapID, uint32 tileX, uint32 tileY);
             static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX<<16 | tileY; }
             static void unpackTileID(uint32 ID, uint32 &tileX, uint32 &tileY) { tileX = ID >> 16; tileY = ID & 0xFF; }
             static LoadResult CanLoadMap(const std::string &basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm);
+            static void AcquireMapTileModels(std::string const& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapManager2* vm, std::vector<uint32>& models);
 
             StaticMapTree(uint32 mapID, const std::string &basePath);
             ~StaticMapTree();
@@ -82,6 +91,9 @@ namespace VMAP
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2, ModelIgnoreFlags ignoreFlags) const;
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
+            // batched versions, rays are traced through the tree in packets of RAY_PACKET_SIZE
+            void isInLineOfSight(G3D::Vector3 const* pos1, G3D::Vector3 const* pos2, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags) const;
+            void getHeights(G3D::Vector3 const* positions, float* heights, uint32 count, float maxSearchDist) const;
             bool getAreaInfo(G3D::Vector3 &pos, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const;
             bool GetLocationInfo(const G3D::Vector3 &pos, LocationInfo &info) const;
 
@@ -160,14 +160,13 @@ GameObjectModel* GameObjectModel::Create(std::unique_ptr<GameObjectModelOwnerBas
     return mdl;
 }
 
-bool GameObjectModel::intersectRay(G3D::Ray const& ray, float& maxDist, bool stopAtFirstHit, PhaseShift const& phaseShift, VMAP::ModelIgnoreFlags ignoreFlags) const
+bool GameObjectModel::isCollidable(PhaseShift const& phaseShift) const
 {
-    if (!isCollisionEnabled() || !owner->IsSpawned())
-        return false;
-
-    if (!owner->IsInPhase(phaseShift))
-        return false;
+    return isCollisionEnabled() && owner->IsSpawned() && owner->IsInPhase(phaseShift);
+}
 
+bool GameObjectModel::intersectRay(G3D::Ray const& ray, float& maxDist, bool stopAtFirstHit, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
     float time = ray.intersectionTime(iBound);
     if (time == G3D::finf())
         return false;
@@ -185,12 +184,9 @@ bool GameObjectModel::intersectRay(G3D::Ray const& ray, float& maxDist, bool sto
     return hit;
 }
 
-void GameObjectModel::intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo& info, PhaseShift const& phaseShift) const
+void GameObjectModel::intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo& info) const
 {
-    if (!isCollisionEnabled() || !owner->IsSpawned() || !isMapObject())
-        return;
-
-    if (!owner->IsInPhase(phaseShift))
+    if (!isMapObject())
         return;
 
     if (!iBound.contains(point))
@@ -212,12 +208,9 @@ void GameObjectModel::intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo&
     }
 }
 
-bool GameObjectModel::GetLocationInfo(G3D::Vector3 const& point, VMAP::LocationInfo& info, PhaseShift const& phaseShift) const
+bool GameObjectModel::GetLocationInfo(G3D::Vector3 const& point, VMAP::LocationInfo& info) const
 {
-    if (!isCollisionEnabled() || !owner->IsSpawned() || !isMapObject())
-        return false;
-
-    if (!owner->IsInPhase(phaseShift))
+    if (!isMapObject())
         return false;
 
     if (!iBound.contains(point))
@@ -71,9 +71,12 @@ public:
     bool isMapObject() const { return isWmo; }
     uint8 GetNameSetId() const { return owner->GetNameSetId(); }
 
-    bool intersectRay(G3D::Ray const& ray, float& maxDist, bool stopAtFirstHit, PhaseShift const& phaseShift, VMAP::ModelIgnoreFlags ignoreFlags) const;
-    void intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo& info, PhaseShift const& phaseShift) const;
-    bool GetLocationInfo(G3D::Vector3 const& point, VMAP::LocationInfo& info, PhaseShift const& phaseShift) const;
+    // checked by DynamicMapTree while searching, the intersection functions below don't repeat it
+    bool isCollidable(PhaseShift const& phaseShift) const;
+
+    bool intersectRay(G3D::Ray const& ray, float& maxDist, bool stopAtFirstHit, VMAP::ModelIgnoreFlags ignoreFlags) const;
+    void intersectPoint(G3D::Vector3 const& point, VMAP::AreaInfo& info) const;
+    bool GetLocationInfo(G3D::Vector3 const& point, VMAP::LocationInfo& info) const;
     bool GetLiquidLevel(G3D::Vector3 const& point, VMAP::LocationInfo& info, float& liqHeight) const;
 
     static GameObjectModel* Create(std::unique_ptr<GameObjectModelOwnerBase> modelOwner, std::string const& dataPath);
@@ -63,6 +63,35 @@ namespace VMAP
         return hit;
     }
 
+    RayPacket::Mask ModelInstance::intersectRays(RayPacket& packet, RayPacket::Mask mask, ModelIgnoreFlags ignoreFlags) const
+    {
+        if (!iModel)
+            return 0;
+
+        mask = packet.IntersectBox(iBound.low(), iBound.high(), mask);
+        if (!mask)
+            return 0;
+
+        // child bounds are defined in object space:
+        RayPacket modelPacket(packet.StopAtFirstHit);
+        uint32 packetIndex[RAY_PACKET_SIZE];
+        RayPacket::ForEach(mask, [&](uint32 i)
+        {
+            Vector3 p = iInvRot * (Vector3(packet.OrgX[i], packet.OrgY[i], packet.OrgZ[i]) - iPos) * iInvScale;
+            packetIndex[modelPacket.AddRay(p, iInvRot * Vector3(packet.DirX[i], packet.DirY[i], packet.DirZ[i]), packet.MaxDist[i] * iInvScale)] = i;
+        });
+
+        RayPacket::Mask hits = 0;
+        RayPacket::ForEach(iModel->IntersectRays(modelPacket, modelPacket.All(), ignoreFlags), [&](uint32 i)
+        {
+            packet.MaxDist[packetIndex[i]] = modelPacket.MaxDist[i] * iScale;
+            hits |= RayPacket::Bit(packetIndex[i]);
+        });
+
+        packet.AddHits(hits);
+        return hits;
+    }
+
     void ModelInstance::intersectPoint(const G3D::Vector3& p, AreaInfo &info) const
     {
         if (!iModel)
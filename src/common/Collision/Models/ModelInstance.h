@@ -24,6 +24,7 @@
 #include <G3D/Ray.h>
 
 #include "Define.h"
+#include "RayPacket.h"
 
 namespace VMAP
 {
@@ -67,6 +68,7 @@ namespace VMAP
             ModelInstance(const ModelSpawn &spawn, WorldModel* model);
             void setUnloaded() { iModel = nullptr; }
             bool intersectRay(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+            RayPacket::Mask intersectRays(RayPacket& packet, RayPacket::Mask mask, ModelIgnoreFlags ignoreFlags) const;
             void intersectPoint(const G3D::Vector3& p, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3& p, LocationInfo &info) const;
             bool GetLiquidLevel(const G3D::Vector3& p, LocationInfo &info, float &liqHeight) const;
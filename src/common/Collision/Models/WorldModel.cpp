@@ -20,6 +20,8 @@
 #include "MapTree.h"
 #include "ModelInstance.h"
 #include "ModelIgnoreFlags.h"
+#include "MappedFile.h"
+#include <cstring>
 
 using G3D::Vector3;
 using G3D::Ray;
@@ -31,7 +33,42 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    namespace
+    {
+        // readers for mapped model files, data is advanced past everything read
+        bool ReadMapped(char const*& data, char const* end, void* dest, std::size_t size)
+        {
+            if (std::size_t(end - data) < size)
+                return false;
+
+            memcpy(dest, data, size);
+            data += size;
+            return true;
+        }
+
+        bool ReadMappedChunk(char const*& data, char const* end, char const* compare, uint32 len)
+        {
+            if (std::size_t(end - data) < len || memcmp(data, compare, len) != 0)
+                return false;
+
+            data += len;
+            return true;
+        }
+
+        // arrays are used in place, the writer keeps them aligned
+        template<class T>
+        T const* ReadMappedArray(char const*& data, char const* end, uint32 count)
+        {
+            if (reinterpret_cast<uintptr_t>(data) % alignof(T) || uint64(end - data) < uint64(count) * sizeof(T))
+                return nullptr;
+
+            T const* array = reinterpret_cast<T const*>(data);
+            data += count * sizeof(T);
+            return array;
+        }
+    }
+
+    bool IntersectTriangle(const MeshTriangle &tri, Vector3 const* points, const G3D::Ray &ray, float &distance)
     {
         static const float EPS = 1e-5f;
 
@@ -242,31 +279,31 @@ namespace VMAP
         return result;
     }
 
-    bool WmoLiquid::readFromFile(FILE* rf, WmoLiquid* &out)
+    bool WmoLiquid::readFromMemory(char const*& data, char const* end, WmoLiquid* &out)
     {
         bool result = false;
         WmoLiquid* liquid = new WmoLiquid();
 
-        if (fread(&liquid->iTilesX, sizeof(uint32), 1, rf) == 1 &&
-            fread(&liquid->iTilesY, sizeof(uint32), 1, rf) == 1 &&
-            fread(&liquid->iCorner, sizeof(Vector3), 1, rf) == 1 &&
-            fread(&liquid->iType, sizeof(uint32), 1, rf) == 1)
+        if (ReadMapped(data, end, &liquid->iTilesX, sizeof(uint32)) &&
+            ReadMapped(data, end, &liquid->iTilesY, sizeof(uint32)) &&
+            ReadMapped(data, end, &liquid->iCorner, sizeof(Vector3)) &&
+            ReadMapped(data, end, &liquid->iType, sizeof(uint32)))
         {
             if (liquid->iTilesX && liquid->iTilesY)
             {
                 uint32 size = (liquid->iTilesX + 1) * (liquid->iTilesY + 1);
                 liquid->iHeight = new float[size];
-                if (fread(liquid->iHeight, sizeof(float), size, rf) == size)
+                if (ReadMapped(data, end, liquid->iHeight, size * sizeof(float)))
                 {
                     size = liquid->iTilesX * liquid->iTilesY;
                     liquid->iFlags = new uint8[size];
-                    result = fread(liquid->iFlags, sizeof(uint8), size, rf) == size;
+                    result = ReadMapped(data, end, liquid->iFlags, size * sizeof(uint8));
                 }
             }
             else
             {
                 liquid->iHeight = new float[1];
-                result = fread(liquid->iHeight, sizeof(float), 1, rf) == 1;
+                result = ReadMapped(data, end, liquid->iHeight, sizeof(float));
             }
         }
 
@@ -289,18 +326,51 @@ namespace VMAP
 
     GroupModel::GroupModel(const GroupModel &other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertexStorage(other.vertexStorage), triangleStorage(other.triangleStorage), vertices(other.vertices), vertexCount(other.vertexCount),
+        triangles(other.triangles), triangleCount(other.triangleCount), meshTree(other.meshTree), iLiquid(nullptr)
     {
+        if (!vertexStorage.empty())
+            useStorage();
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
     }
 
+    GroupModel& GroupModel::operator=(const GroupModel &other)
+    {
+        if (this == &other)
+            return *this;
+        iBound = other.iBound;
+        iMogpFlags = other.iMogpFlags;
+        iGroupWMOID = other.iGroupWMOID;
+        vertexStorage = other.vertexStorage;
+        triangleStorage = other.triangleStorage;
+        vertices = other.vertices;
+        vertexCount = other.vertexCount;
+        triangles = other.triangles;
+        triangleCount = other.triangleCount;
+        meshTree = other.meshTree;
+        if (!vertexStorage.empty())
+            useStorage();
+        delete iLiquid;
+        iLiquid = other.iLiquid ? new WmoLiquid(*other.iLiquid) : nullptr;
+        return *this;
+    }
+
+    void GroupModel::useStorage()
+    {
+        vertices = vertexStorage.data();
+        vertexCount = uint32(vertexStorage.size());
+        triangles = triangleStorage.data();
+        triangleCount = uint32(triangleStorage.size());
+    }
+
     void GroupModel::setMeshData(std::vector<Vector3> &vert, std::vector<MeshTriangle> &tri)
     {
-        vertices.swap(vert);
-        triangles.swap(tri);
-        TriBoundFunc bFunc(vertices);
-        meshTree.build(triangles, bFunc);
+        vertexStorage.swap(vert);
+        triangleStorage.swap(tri);
+        useStorage();
+        TriBoundFunc bFunc(vertexStorage);
+        meshTree.build(triangleStorage, bFunc);
     }
 
     bool GroupModel::writeToFile(FILE* wf)
@@ -314,7 +384,7 @@ namespace VMAP
 
         // write vertices
         if (result && fwrite("VERT", 1, 4, wf) != 4) result = false;
-        count = vertices.size();
+        count = vertexCount;
         chunkSize = sizeof(uint32)+ sizeof(Vector3)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
@@ -324,7 +394,7 @@ namespace VMAP
 
         // write triangle mesh
         if (result && fwrite("TRIM", 1, 4, wf) != 4) result = false;
-        count = triangles.size();
+        count = triangleCount;
         chunkSize = sizeof(uint32)+ sizeof(MeshTriangle)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
@@ -342,74 +412,92 @@ namespace VMAP
             if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
             return result;
         }
-        chunkSize = iLiquid->GetFileSize();
+        // padded to keep the arrays of the next group aligned when the file is used in place
+        uint32 liquidSize = iLiquid->GetFileSize();
+        chunkSize = (liquidSize + 3) & ~3u;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result) result = iLiquid->writeToFile(wf);
+        uint32 const padding = 0;
+        if (result && chunkSize != liquidSize && fwrite(&padding, 1, chunkSize - liquidSize, wf) != chunkSize - liquidSize) result = false;
 
         return result;
     }
 
-    bool GroupModel::readFromFile(FILE* rf)
+    bool GroupModel::readFromMemory(char const*& data, char const* end)
     {
-        char chunk[8];
-        bool result = true;
         uint32 chunkSize = 0;
         uint32 count = 0;
-        triangles.clear();
-        vertices.clear();
+        vertexStorage.clear();
+        triangleStorage.clear();
+        useStorage();
         delete iLiquid;
         iLiquid = nullptr;
 
-        if (result && fread(&iBound, sizeof(G3D::AABox), 1, rf) != 1) result = false;
-        if (result && fread(&iMogpFlags, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&iGroupWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+        if (!ReadMapped(data, end, &iBound, sizeof(G3D::AABox)) ||
+            !ReadMapped(data, end, &iMogpFlags, sizeof(uint32)) ||
+            !ReadMapped(data, end, &iGroupWMOID, sizeof(uint32)))
+            return false;
 
         // read vertices
-        if (result && !readChunk(rf, chunk, "VERT", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
+        if (!ReadMappedChunk(data, end, "VERT", 4) ||
+            !ReadMapped(data, end, &chunkSize, sizeof(uint32)) ||
+            !ReadMapped(data, end, &count, sizeof(uint32)))
+            return false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
-            return result;
-        if (result) vertices.resize(count);
-        if (result && fread(&vertices[0], sizeof(Vector3), count, rf) != count) result = false;
+            return true;
+        vertices = ReadMappedArray<Vector3>(data, end, count);
+        if (!vertices)
+            return false;
+        vertexCount = count;
 
         // read triangle mesh
-        if (result && !readChunk(rf, chunk, "TRIM", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result) triangles.resize(count);
-        if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+        if (!ReadMappedChunk(data, end, "TRIM", 4) ||
+            !ReadMapped(data, end, &chunkSize, sizeof(uint32)) ||
+            !ReadMapped(data, end, &count, sizeof(uint32)))
+            return false;
+        triangles = ReadMappedArray<MeshTriangle>(data, end, count);
+        if (!triangles)
+            return false;
+        triangleCount = count;
 
         // read mesh BIH
-        if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
-        if (result) result = meshTree.readFromFile(rf);
+        if (!ReadMappedChunk(data, end, "MBIH", 4) || !meshTree.readFromMemory(data, end))
+            return false;
 
-        // write liquid data
-        if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && chunkSize > 0)
-            result = WmoLiquid::readFromFile(rf, iLiquid);
-        return result;
+        // read liquid data, the chunk includes the padding up to the next group
+        if (!ReadMappedChunk(data, end, "LIQU", 4) || !ReadMapped(data, end, &chunkSize, sizeof(uint32)))
+            return false;
+        if (!chunkSize)
+            return true;
+        if (std::size_t(end - data) < chunkSize)
+            return false;
+
+        char const* liquidEnd = data + chunkSize;
+        if (!WmoLiquid::readFromMemory(data, liquidEnd, iLiquid))
+            return false;
+
+        data = liquidEnd;
+        return true;
     }
 
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) { }
+        GModelRayCallback(MeshTriangle const* tris, Vector3 const* vert):
+            vertices(vert), triangles(tris), hit(false) { }
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/)
         {
             bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
             if (result)  hit=true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        Vector3 const* vertices;
+        MeshTriangle const* triangles;
         bool hit;
     };
 
     bool GroupModel::IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const
     {
-        if (triangles.empty())
+        if (!triangleCount)
             return false;
 
         GModelRayCallback callback(triangles, vertices);
@@ -417,9 +505,33 @@ namespace VMAP
         return callback.hit;
     }
 
+    struct GModelPacketCallback
+    {
+        GModelPacketCallback(MeshTriangle const* tris, Vector3 const* vert):
+            vertices(vert), triangles(tris), hits(0) { }
+        void operator()(RayPacket& packet, RayPacket::Mask mask, uint32 entry)
+        {
+            MeshTriangle const& tri = triangles[entry];
+            hits |= packet.IntersectTriangle(vertices[tri.idx0], vertices[tri.idx1], vertices[tri.idx2], mask);
+        }
+        Vector3 const* vertices;
+        MeshTriangle const* triangles;
+        RayPacket::Mask hits;
+    };
+
+    RayPacket::Mask GroupModel::IntersectRays(RayPacket& packet, RayPacket::Mask mask) const
+    {
+        if (!triangleCount)
+            return 0;
+
+        GModelPacketCallback callback(triangles, vertices);
+        meshTree.intersectRays(packet, callback, mask);
+        return callback.hits;
+    }
+
     bool GroupModel::IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const
     {
-        if (triangles.empty() || !iBound.contains(pos))
+        if (!triangleCount || !iBound.contains(pos))
             return false;
         GModelRayCallback callback(triangles, vertices);
         Vector3 rPos = pos - 0.1f * down;
@@ -447,13 +559,17 @@ namespace VMAP
 
     void GroupModel::getMeshData(std::vector<G3D::Vector3>& outVertices, std::vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid)
     {
-        outVertices = vertices;
-        outTriangles = triangles;
+        outVertices.assign(vertices, vertices + vertexCount);
+        outTriangles.assign(triangles, triangles + triangleCount);
         liquid = iLiquid;
     }
 
     // ===================== WorldModel ==================================
 
+    WorldModel::WorldModel() : Flags(0), RootWMOID(0) { }
+
+    WorldModel::~WorldModel() { }
+
     void WorldModel::setGroupModels(std::vector<GroupModel> &models)
     {
         groupModels.swap(models);
@@ -493,6 +609,31 @@ namespace VMAP
         return isc.hit;
     }
 
+    struct WModelPacketCallback
+    {
+        WModelPacketCallback(const std::vector<GroupModel> &mod): models(mod.begin()), hits(0) { }
+        void operator()(RayPacket& packet, RayPacket::Mask mask, uint32 entry)
+        {
+            hits |= models[entry].IntersectRays(packet, mask);
+        }
+        std::vector<GroupModel>::const_iterator models;
+        RayPacket::Mask hits;
+    };
+
+    RayPacket::Mask WorldModel::IntersectRays(RayPacket& packet, RayPacket::Mask mask, ModelIgnoreFlags ignoreFlags) const
+    {
+        // M2 models are not taken into account for LoS calculation if caller requested their ignoring.
+        if ((ignoreFlags & ModelIgnoreFlags::M2) != ModelIgnoreFlags::Nothing && (Flags & MOD_M2))
+            return 0;
+
+        if (groupModels.size() == 1)
+            return groupModels[0].IntersectRays(packet, mask);
+
+        WModelPacketCallback isc(groupModels);
+        groupTree.intersectRays(packet, isc, mask);
+        return isc.hits;
+    }
+
     class WModelAreaCallback {
         public:
             WModelAreaCallback(const std::vector<GroupModel> &vals, const Vector3 &down):
@@ -601,38 +742,41 @@ namespace VMAP
 
     bool WorldModel::readFile(const std::string &filename)
     {
-        FILE* rf = fopen(filename.c_str(), "rb");
-        if (!rf)
+        std::unique_ptr<MappedFile> mapping = MappedFile::Open(filename, MappedFile::Access::ReadOnly);
+        if (!mapping)
             return false;
 
-        bool result = true;
+        char const* data = mapping->GetData();
+        char const* end = data + mapping->GetSize();
         uint32 chunkSize = 0;
         uint32 count = 0;
-        char chunk[8];                          // Ignore the added magic header
-        if (!readChunk(rf, chunk, VMAP_MAGIC, 8)) result = false;
 
-        if (result && !readChunk(rf, chunk, "WMOD", 4)) result = false;
-        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result && fread(&RootWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+        bool result = ReadMappedChunk(data, end, VMAP_MAGIC, 8)
+            && ReadMappedChunk(data, end, "WMOD", 4)
+            && ReadMapped(data, end, &chunkSize, sizeof(uint32))
+            && ReadMapped(data, end, &RootWMOID, sizeof(uint32));
 
         // read group models
-        if (result && readChunk(rf, chunk, "GMOD", 4))
+        if (result && ReadMappedChunk(data, end, "GMOD", 4))
         {
-            //if (fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
-
-            if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
-            if (result) groupModels.resize(count);
-            //if (result && fread(&groupModels[0], sizeof(GroupModel), count, rf) != count) result = false;
-            for (uint32 i=0; i<count && result; ++i)
-                result = groupModels[i].readFromFile(rf);
+            result = ReadMapped(data, end, &count, sizeof(uint32)) && uint64(count) * sizeof(G3D::AABox) <= uint64(end - data);
+            if (result)
+                groupModels.resize(count);
+            for (uint32 i = 0; i < count && result; ++i)
+                result = groupModels[i].readFromMemory(data, end);
 
             // read group BIH
-            if (result && !readChunk(rf, chunk, "GBIH", 4)) result = false;
-            if (result) result = groupTree.readFromFile(rf);
+            result = result && ReadMappedChunk(data, end, "GBIH", 4) && groupTree.readFromMemory(data, end);
         }
 
-        fclose(rf);
-        return result;
+        if (!result)
+        {
+            groupModels.clear();
+            return false;
+        }
+
+        fileMapping = std::move(mapping);
+        return true;
     }
 
     void WorldModel::getGroupModels(std::vector<GroupModel>& outGroupModels)
@@ -25,6 +25,9 @@
 #include "BoundingIntervalHierarchy.h"
 
 #include "Define.h"
+#include <memory>
+
+class MappedFile;
 
 namespace VMAP
 {
@@ -57,7 +60,7 @@ namespace VMAP
             uint8 *GetFlagsStorage() { return iFlags; }
             uint32 GetFileSize();
             bool writeToFile(FILE* wf);
-            static bool readFromFile(FILE* rf, WmoLiquid* &liquid);
+            static bool readFromMemory(char const*& data, char const* end, WmoLiquid*& liquid);
             void getPosInfo(uint32 &tilesX, uint32 &tilesY, G3D::Vector3 &corner) const;
         private:
             WmoLiquid() : iTilesX(0), iTilesY(0), iCorner(), iType(0), iHeight(nullptr), iFlags(nullptr) { }
@@ -73,31 +76,40 @@ namespace VMAP
     class TC_COMMON_API GroupModel
     {
         public:
-            GroupModel() : iBound(), iMogpFlags(0), iGroupWMOID(0), iLiquid(nullptr) { }
+            GroupModel() : iBound(), iMogpFlags(0), iGroupWMOID(0), vertices(nullptr), vertexCount(0), triangles(nullptr), triangleCount(0), iLiquid(nullptr) { }
             GroupModel(const GroupModel &other);
             GroupModel(uint32 mogpFlags, uint32 groupWMOID, const G3D::AABox &bound):
-                        iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iLiquid(nullptr) { }
+                        iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), vertices(nullptr), vertexCount(0), triangles(nullptr), triangleCount(0), iLiquid(nullptr) { }
             ~GroupModel() { delete iLiquid; }
+            GroupModel& operator=(const GroupModel &other);
 
             //! pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry!
             void setMeshData(std::vector<G3D::Vector3> &vert, std::vector<MeshTriangle> &tri);
             void setLiquidData(WmoLiquid*& liquid) { iLiquid = liquid; liquid = nullptr; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
+            RayPacket::Mask IntersectRays(RayPacket& packet, RayPacket::Mask mask) const;
             bool IsInsideObject(const G3D::Vector3 &pos, const G3D::Vector3 &down, float &z_dist) const;
             bool GetLiquidLevel(const G3D::Vector3 &pos, float &liqHeight) const;
             uint32 GetLiquidType() const;
             bool writeToFile(FILE* wf);
-            bool readFromFile(FILE* rf);
+            //! mesh and tree are used in place, see WorldModel::readFile
+            bool readFromMemory(char const*& data, char const* end);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
             void getMeshData(std::vector<G3D::Vector3>& outVertices, std::vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid);
         protected:
+            void useStorage();
+
             G3D::AABox iBound;
             uint32 iMogpFlags;// 0x8 outdor; 0x2000 indoor
             uint32 iGroupWMOID;
-            std::vector<G3D::Vector3> vertices;
-            std::vector<MeshTriangle> triangles;
+            std::vector<G3D::Vector3> vertexStorage;    // only filled by setMeshData, loaded models point into their file
+            std::vector<MeshTriangle> triangleStorage;
+            G3D::Vector3 const* vertices;
+            uint32 vertexCount;
+            MeshTriangle const* triangles;
+            uint32 triangleCount;
             BIH meshTree;
             WmoLiquid* iLiquid;
     };
@@ -106,22 +118,30 @@ namespace VMAP
     class TC_COMMON_API WorldModel
     {
         public:
-            WorldModel(): Flags(0), RootWMOID(0) { }
+            WorldModel();
+            ~WorldModel();
 
             //! pass group models to WorldModel and create BIH. Passed vector is swapped with old geometry!
             void setGroupModels(std::vector<GroupModel> &models);
             void setRootWmoID(uint32 id) { RootWMOID = id; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+            RayPacket::Mask IntersectRays(RayPacket& packet, RayPacket::Mask mask, ModelIgnoreFlags ignoreFlags) const;
             bool IntersectPoint(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, LocationInfo &info) const;
             bool writeFile(const std::string &filename);
+            //! maps the file read only, vertices, triangles and trees of the groups are used in place
             bool readFile(const std::string &filename);
+            //! returned groups point into this model's file, they must not outlive it
             void getGroupModels(std::vector<GroupModel>& outGroupModels);
             uint32 Flags;
         protected:
             uint32 RootWMOID;
+            std::unique_ptr<MappedFile> fileMapping;
             std::vector<GroupModel> groupModels;
             BIH groupTree;
+
+            WorldModel(WorldModel const& right) = delete;
+            WorldModel& operator=(WorldModel const& right) = delete;
     };
 } // namespace VMAP
 
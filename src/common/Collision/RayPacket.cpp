@@ -0,0 +1,232 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RayPacket.h"
+#include "Errors.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAY_PACKET_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // same threshold as VMAP::IntersectTriangle
+    float const TRIANGLE_EPS = 1e-5f;
+}
+
+uint32 RayPacket::AddRay(G3D::Vector3 const& origin, G3D::Vector3 const& direction, float maxDist)
+{
+    ASSERT(Count < RAY_PACKET_SIZE);
+
+    // axis parallel rays get a huge but finite inverse, (plane - origin) * invDir must not become 0 * inf
+    auto inverse = [](float d) { return std::fabs(d) > 1e-8f ? 1.0f / d : std::copysign(1e30f, d); };
+
+    uint32 i = Count++;
+    OrgX[i] = origin.x;
+    OrgY[i] = origin.y;
+    OrgZ[i] = origin.z;
+    DirX[i] = direction.x;
+    DirY[i] = direction.y;
+    DirZ[i] = direction.z;
+    InvDirX[i] = inverse(direction.x);
+    InvDirY[i] = inverse(direction.y);
+    InvDirZ[i] = inverse(direction.z);
+    MaxDist[i] = maxDist;
+    Active |= Bit(i);
+    return i;
+}
+
+void RayPacket::AddHits(Mask hits)
+{
+    Hits |= hits;
+    if (StopAtFirstHit)
+        Active &= ~hits;
+}
+
+#ifdef RAY_PACKET_SSE2
+
+RayPacket::Mask RayPacket::IntersectBox(G3D::Vector3 const& low, G3D::Vector3 const& high, Mask mask) const
+{
+    Mask result = 0;
+    for (uint32 g = 0; g < Count; g += 4)
+    {
+        uint32 lanes = uint32(mask >> g) & 0xF;
+        if (!lanes)
+            continue;
+
+        __m128 tMin = _mm_setzero_ps();
+        __m128 tMax = _mm_load_ps(&MaxDist[g]);
+
+        auto slab = [&](float lo, float hi, float const* org, float const* invDir)
+        {
+            __m128 o = _mm_load_ps(org + g);
+            __m128 inv = _mm_load_ps(invDir + g);
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(lo), o), inv);
+            __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(hi), o), inv);
+            tMin = _mm_max_ps(tMin, _mm_min_ps(t1, t2));
+            tMax = _mm_min_ps(tMax, _mm_max_ps(t1, t2));
+        };
+
+        slab(low.x, high.x, OrgX, InvDirX);
+        slab(low.y, high.y, OrgY, InvDirY);
+        slab(low.z, high.z, OrgZ, InvDirZ);
+
+        result |= Mask(uint32(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax))) & lanes) << g;
+    }
+
+    return result;
+}
+
+RayPacket::Mask RayPacket::IntersectTriangle(G3D::Vector3 const& v0, G3D::Vector3 const& v1, G3D::Vector3 const& v2, Mask mask)
+{
+    // See RTR2 ch. 13.7 for the algorithm, vectorized over 4 rays
+    G3D::Vector3 const e1 = v1 - v0;
+    G3D::Vector3 const e2 = v2 - v0;
+
+    __m128 const e1x = _mm_set1_ps(e1.x), e1y = _mm_set1_ps(e1.y), e1z = _mm_set1_ps(e1.z);
+    __m128 const e2x = _mm_set1_ps(e2.x), e2y = _mm_set1_ps(e2.y), e2z = _mm_set1_ps(e2.z);
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const one = _mm_set1_ps(1.0f);
+    __m128 const absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    Mask result = 0;
+    for (uint32 g = 0; g < Count; g += 4)
+    {
+        uint32 lanes = uint32(mask >> g) & 0xF;
+        if (!lanes)
+            continue;
+
+        __m128 dx = _mm_load_ps(&DirX[g]), dy = _mm_load_ps(&DirY[g]), dz = _mm_load_ps(&DirZ[g]);
+
+        // p = dir x e2
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+        // determinant is ill-conditioned
+        __m128 valid = _mm_cmpge_ps(_mm_and_ps(a, absMask), _mm_set1_ps(TRIANGLE_EPS));
+        if (!(_mm_movemask_ps(valid) & lanes))
+            continue;
+
+        __m128 f = _mm_div_ps(one, a);
+        __m128 sx = _mm_sub_ps(_mm_load_ps(&OrgX[g]), _mm_set1_ps(v0.x));
+        __m128 sy = _mm_sub_ps(_mm_load_ps(&OrgY[g]), _mm_set1_ps(v0.y));
+        __m128 sz = _mm_sub_ps(_mm_load_ps(&OrgZ[g]), _mm_set1_ps(v0.z));
+
+        __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+        // q = s x e1
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+        __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+        __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_load_ps(&MaxDist[g]))));
+
+        uint32 hits = uint32(_mm_movemask_ps(valid)) & lanes;
+        if (!hits)
+            continue;
+
+        alignas(16) float distances[4];
+        _mm_store_ps(distances, t);
+        for (uint32 i = 0; i < 4; ++i)
+            if (hits & (1 << i))
+                MaxDist[g + i] = distances[i];
+
+        result |= Mask(hits) << g;
+    }
+
+    AddHits(result);
+    return result;
+}
+
+#else
+
+RayPacket::Mask RayPacket::IntersectBox(G3D::Vector3 const& low, G3D::Vector3 const& high, Mask mask) const
+{
+    Mask result = 0;
+    ForEach(mask, [&](uint32 i)
+    {
+        float tMin = 0.0f;
+        float tMax = MaxDist[i];
+
+        auto slab = [&](float lo, float hi, float org, float invDir)
+        {
+            float t1 = (lo - org) * invDir;
+            float t2 = (hi - org) * invDir;
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        };
+
+        slab(low.x, high.x, OrgX[i], InvDirX[i]);
+        slab(low.y, high.y, OrgY[i], InvDirY[i]);
+        slab(low.z, high.z, OrgZ[i], InvDirZ[i]);
+
+        if (tMin <= tMax)
+            result |= Bit(i);
+    });
+
+    return result;
+}
+
+RayPacket::Mask RayPacket::IntersectTriangle(G3D::Vector3 const& v0, G3D::Vector3 const& v1, G3D::Vector3 const& v2, Mask mask)
+{
+    // See RTR2 ch. 13.7 for the algorithm
+    G3D::Vector3 const e1 = v1 - v0;
+    G3D::Vector3 const e2 = v2 - v0;
+
+    Mask result = 0;
+    ForEach(mask, [&](uint32 i)
+    {
+        G3D::Vector3 const dir(DirX[i], DirY[i], DirZ[i]);
+        G3D::Vector3 const p(dir.cross(e2));
+        float const a = e1.dot(p);
+        if (std::fabs(a) < TRIANGLE_EPS)
+            return;
+
+        float const f = 1.0f / a;
+        G3D::Vector3 const s(G3D::Vector3(OrgX[i], OrgY[i], OrgZ[i]) - v0);
+        float const u = f * s.dot(p);
+        if (u < 0.0f || u > 1.0f)
+            return;
+
+        G3D::Vector3 const q(s.cross(e1));
+        float const v = f * dir.dot(q);
+        if (v < 0.0f || u + v > 1.0f)
+            return;
+
+        float const t = f * e2.dot(q);
+        if (t > 0.0f && t < MaxDist[i])
+        {
+            MaxDist[i] = t;
+            result |= Bit(i);
+        }
+    });
+
+    AddHits(result);
+    return result;
+}
+
+#endif
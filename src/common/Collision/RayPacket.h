@@ -0,0 +1,85 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RAYPACKET_H
+#define _RAYPACKET_H
+
+#include "Define.h"
+#include <G3D/Ray.h>
+#include <G3D/Vector3.h>
+
+#define RAY_PACKET_SIZE 64
+
+/**
+    @class RayPacket
+
+    @brief Rays traced together through the collision trees, stored as structure of arrays so the
+    ray-box and ray-triangle tests can process several rays per instruction.
+
+    MaxDist of every ray shrinks to the closest hit found so far. Rays are removed from Active once
+    they are finished (first hit when StopAtFirstHit is set), tests skip all rays not in the mask
+    passed to them.
+*/
+struct TC_COMMON_API RayPacket
+{
+    typedef uint64 Mask;
+
+    explicit RayPacket(bool stopAtFirstHit) : Count(0), Active(0), Hits(0), StopAtFirstHit(stopAtFirstHit) { }
+
+    //! Adds a ray (direction with length of 1), returns its index
+    uint32 AddRay(G3D::Vector3 const& origin, G3D::Vector3 const& direction, float maxDist);
+    G3D::Ray GetRay(uint32 i) const { return G3D::Ray::fromOriginAndDirection({ OrgX[i], OrgY[i], OrgZ[i] }, { DirX[i], DirY[i], DirZ[i] }); }
+    bool IsFull() const { return Count == RAY_PACKET_SIZE; }
+
+    //! Returns the rays of mask entering the box within their MaxDist
+    Mask IntersectBox(G3D::Vector3 const& low, G3D::Vector3 const& high, Mask mask) const;
+    //! Tests rays of mask against a triangle, returns the rays hitting it closer than their MaxDist (MaxDist is updated)
+    Mask IntersectTriangle(G3D::Vector3 const& v0, G3D::Vector3 const& v1, G3D::Vector3 const& v2, Mask mask);
+    //! Marks rays as hit, finishing them if only the first hit is needed
+    void AddHits(Mask hits);
+
+    static Mask Bit(uint32 i) { return Mask(1) << i; }
+    Mask All() const { return Count == RAY_PACKET_SIZE ? ~Mask(0) : Bit(Count) - 1; }
+
+    //! Calls f(index) for every ray of mask
+    template<typename F>
+    static void ForEach(Mask mask, F&& f)
+    {
+        for (uint32 i = 0; mask; ++i, mask >>= 1)
+            if (mask & 1)
+                f(i);
+    }
+
+    uint32 Count;
+    Mask Active;
+    Mask Hits;
+    bool StopAtFirstHit;
+
+    // unused lanes are zero so vector code can always process full groups of 4 rays
+    alignas(16) float OrgX[RAY_PACKET_SIZE] = { };
+    alignas(16) float OrgY[RAY_PACKET_SIZE] = { };
+    alignas(16) float OrgZ[RAY_PACKET_SIZE] = { };
+    alignas(16) float DirX[RAY_PACKET_SIZE] = { };
+    alignas(16) float DirY[RAY_PACKET_SIZE] = { };
+    alignas(16) float DirZ[RAY_PACKET_SIZE] = { };
+    alignas(16) float InvDirX[RAY_PACKET_SIZE] = { };
+    alignas(16) float InvDirY[RAY_PACKET_SIZE] = { };
+    alignas(16) float InvDirZ[RAY_PACKET_SIZE] = { };
+    alignas(16) float MaxDist[RAY_PACKET_SIZE] = { };
+};
+
+#endif // _RAYPACKET_H
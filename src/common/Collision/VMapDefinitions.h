@@ -24,9 +24,10 @@
 
 namespace VMAP
 {
-    const char VMAP_MAGIC[] = "VMAP_4.9";
+    const char VMAP_MAGIC[] = "VMAP_4.A";
     const char RAW_VMAP_MAGIC[] = "VMAP049";                // used in extracted vmap files with raw data
     const char GAMEOBJECT_MODELS[] = "GameObjectModels.dtree";
+    const char WORLD_MODELS[] = "WorldModels.vmlist";       // model file names, tiles reference models by their index in this list
 
     // defined in VMapManager2.cpp currently...
     bool readChunk(FILE* rf, char *dest, const char *compare, uint32 len);
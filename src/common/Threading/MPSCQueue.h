@@ -19,24 +19,31 @@
 #define MPSCQueue_h__
 
 #include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+namespace Trinity
+{
+namespace Impl
+{
 // C++ implementation of Dmitry Vyukov's lock free MPSC queue
 // http://www.1024cores.net/home/lock-free-algorithms/queues/non-intrusive-mpsc-node-based-queue
 template<typename T>
-class MPSCQueue
+class MPSCQueueNonIntrusive
 {
 public:
-    MPSCQueue() : _head(new Node()), _tail(_head.load(std::memory_order_relaxed))
+    MPSCQueueNonIntrusive() : _head(new Node()), _tail(_head.load(std::memory_order_relaxed))
     {
         Node* front = _head.load(std::memory_order_relaxed);
         front->Next.store(nullptr, std::memory_order_relaxed);
     }
 
-    ~MPSCQueue()
+    ~MPSCQueueNonIntrusive()
     {
         T* output;
-        while (this->Dequeue(output))
+        while (Dequeue(output))
             ;
 
         Node* front = _head.load(std::memory_order_relaxed);
@@ -76,8 +83,91 @@ private:
     std::atomic<Node*> _head;
     std::atomic<Node*> _tail;
 
-    MPSCQueue(MPSCQueue const&) = delete;
-    MPSCQueue& operator=(MPSCQueue const&) = delete;
+    MPSCQueueNonIntrusive(MPSCQueueNonIntrusive const&) = delete;
+    MPSCQueueNonIntrusive& operator=(MPSCQueueNonIntrusive const&) = delete;
+};
+
+// C++ implementation of Dmitry Vyukov's lock free MPSC queue
+// http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+// Elements are linked through IntrusiveLink member, enqueueing does not allocate.
+// Remaining elements are deleted when the queue is destroyed.
+template<typename T, std::atomic<T*> T::* IntrusiveLink>
+class MPSCQueueIntrusive
+{
+public:
+    MPSCQueueIntrusive() : _dummyPtr(reinterpret_cast<T*>(std::addressof(_dummy))), _head(_dummyPtr), _tail(_dummyPtr)
+    {
+        // _dummy is intentionally left uninitialized (T might not be default constructible), only its link is constructed
+        std::atomic<T*>* dummyNext = new (&(_dummyPtr->*IntrusiveLink)) std::atomic<T*>();
+        dummyNext->store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~MPSCQueueIntrusive()
+    {
+        T* output;
+        while (Dequeue(output))
+            delete output;
+    }
+
+    void Enqueue(T* input)
+    {
+        (input->*IntrusiveLink).store(nullptr, std::memory_order_release);
+        T* prevHead = _head.exchange(input, std::memory_order_acq_rel);
+        (prevHead->*IntrusiveLink).store(input, std::memory_order_release);
+    }
+
+    bool Dequeue(T*& result)
+    {
+        T* tail = _tail.load(std::memory_order_relaxed);
+        T* next = (tail->*IntrusiveLink).load(std::memory_order_acquire);
+        if (tail == _dummyPtr)
+        {
+            if (!next)
+                return false;
+
+            _tail.store(next, std::memory_order_release);
+            tail = next;
+            next = (next->*IntrusiveLink).load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            _tail.store(next, std::memory_order_release);
+            result = tail;
+            return true;
+        }
+
+        T* head = _head.load(std::memory_order_acquire);
+        if (tail != head)
+            return false;
+
+        // last element is never handed out while it is the head, put dummy behind it first
+        Enqueue(_dummyPtr);
+        next = (tail->*IntrusiveLink).load(std::memory_order_acquire);
+        if (next)
+        {
+            _tail.store(next, std::memory_order_release);
+            result = tail;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _dummy;
+    T* _dummyPtr;
+    std::atomic<T*> _head;
+    std::atomic<T*> _tail;
+
+    MPSCQueueIntrusive(MPSCQueueIntrusive const&) = delete;
+    MPSCQueueIntrusive& operator=(MPSCQueueIntrusive const&) = delete;
 };
+}
+}
+
+template<typename T, std::atomic<T*> T::* IntrusiveLink = nullptr>
+using MPSCQueue = std::conditional_t<IntrusiveLink != nullptr,
+    Trinity::Impl::MPSCQueueIntrusive<T, IntrusiveLink>,
+    Trinity::Impl::MPSCQueueNonIntrusive<T>>;
 
 #endif // MPSCQueue_h__
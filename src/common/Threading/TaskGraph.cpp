@@ -0,0 +1,140 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TaskGraph.h"
+#include "Errors.h"
+#include "Log.h"
+#include "Timer.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+TaskGraph::TaskId TaskGraph::AddTask(std::string name, std::function<void()> task, std::initializer_list<TaskId> dependencies /*= { }*/)
+{
+    TaskId id = TaskId(_tasks.size());
+    _tasks.emplace_back();
+    Task& newTask = _tasks.back();
+    newTask.Name = std::move(name);
+    newTask.Function = std::move(task);
+
+    for (TaskId dependency : dependencies)
+    {
+        ASSERT(dependency < id, "Task %s can only depend on tasks added before it", newTask.Name.c_str());
+        if (_tasks[dependency].Done)
+            continue;
+
+        _tasks[dependency].Dependents.push_back(id);
+        ++newTask.PendingDependencies;
+    }
+
+    return id;
+}
+
+void TaskGraph::Run(uint32 threadCount)
+{
+    TaskId const end = TaskId(_tasks.size());
+    if (_firstPendingTask == end)
+        return;
+
+    uint32 runStartTime = getMSTime();
+    uint32 const taskCount = end - _firstPendingTask;
+
+    // insertion order is a valid topological order
+    if (threadCount <= 1 || taskCount == 1)
+    {
+        for (TaskId id = _firstPendingTask; id < end; ++id)
+            Execute(id, runStartTime);
+
+        _firstPendingTask = end;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _remainingTasks = taskCount;
+        for (TaskId id = _firstPendingTask; id < end; ++id)
+            if (!_tasks[id].PendingDependencies)
+                _readyTasks.push_back(id);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(std::min(threadCount, taskCount) - 1);
+    for (uint32 i = 1; i < std::min(threadCount, taskCount); ++i)
+        threads.emplace_back(&TaskGraph::WorkerThread, this, runStartTime);
+
+    WorkerThread(runStartTime);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    _firstPendingTask = end;
+}
+
+void TaskGraph::WorkerThread(uint32 runStartTime)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (;;)
+    {
+        _condition.wait(lock, [this] { return !_readyTasks.empty() || !_remainingTasks; });
+        if (!_remainingTasks)
+            return;
+
+        TaskId id = _readyTasks.front();
+        _readyTasks.pop_front();
+
+        lock.unlock();
+        Execute(id, runStartTime);
+        lock.lock();
+
+        --_remainingTasks;
+        for (TaskId dependent : _tasks[id].Dependents)
+            if (!--_tasks[dependent].PendingDependencies)
+                _readyTasks.push_back(dependent);
+
+        _condition.notify_all();
+    }
+}
+
+void TaskGraph::Execute(TaskId id, uint32 runStartTime)
+{
+    Task& task = _tasks[id];
+    uint32 startTime = getMSTime();
+    task.StartTime = getMSTimeDiff(runStartTime, startTime);
+
+    task.Function();
+
+    task.Duration = GetMSTimeDiffToNow(startTime);
+    task.Done = true;
+}
+
+void TaskGraph::LogTimings(char const* logger) const
+{
+    std::vector<TaskId> order(_firstPendingTask);
+    std::iota(order.begin(), order.end(), TaskId(0));
+    std::stable_sort(order.begin(), order.end(), [this](TaskId left, TaskId right)
+    {
+        return _tasks[left].Duration > _tasks[right].Duration;
+    });
+
+    uint32 total = 0;
+    for (TaskId id : order)
+        total += _tasks[id].Duration;
+
+    TC_LOG_INFO(logger, "Task timings (%u tasks, %u ms in total):", uint32(order.size()), total);
+    for (TaskId id : order)
+        TC_LOG_INFO(logger, "  %7u ms  (started +%u ms)  %s", _tasks[id].Duration, _tasks[id].StartTime, _tasks[id].Name.c_str());
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TaskGraph_h__
+#define TaskGraph_h__
+
+#include "Define.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+    @class TaskGraph
+
+    @brief Runs a set of tasks with dependencies between them on a pool of threads.
+
+    Tasks may only depend on tasks added before them, which keeps the graph acyclic and makes
+    insertion order a valid sequential execution order (used when running with a single thread).
+    Run() executes every task added since the previous Run() and blocks until all of them finished,
+    dependencies on tasks completed by an earlier Run() are already satisfied.
+    Execution times of all tasks are kept for LogTimings().
+*/
+class TC_COMMON_API TaskGraph
+{
+    public:
+        typedef uint32 TaskId;
+
+        TaskGraph() : _firstPendingTask(0), _remainingTasks(0) { }
+
+        //! Adds a task, name is used for log output and the timing report
+        TaskId AddTask(std::string name, std::function<void()> task, std::initializer_list<TaskId> dependencies = { });
+
+        //! Executes all pending tasks using up to threadCount threads (including the calling thread)
+        void Run(uint32 threadCount);
+
+        //! Logs execution time of every task, longest first
+        void LogTimings(char const* logger) const;
+
+    private:
+        struct Task
+        {
+            std::string Name;
+            std::function<void()> Function;
+            std::vector<TaskId> Dependents;
+            uint32 PendingDependencies = 0;
+            uint32 StartTime = 0;       // relative to start of the Run() that executed the task
+            uint32 Duration = 0;
+            bool Done = false;
+        };
+
+        void Execute(TaskId id, uint32 runStartTime);
+        void WorkerThread(uint32 runStartTime);
+
+        std::vector<Task> _tasks;
+        TaskId _firstPendingTask;
+
+        std::mutex _lock;
+        std::condition_variable _condition;
+        std::deque<TaskId> _readyTasks;
+        uint32 _remainingTasks;
+
+        TaskGraph(TaskGraph const& right) = delete;
+        TaskGraph& operator=(TaskGraph const& right) = delete;
+};
+
+#endif // TaskGraph_h__
@@ -17,6 +17,7 @@
 
 #include "EventProcessor.h"
 #include "Errors.h"
+#include <algorithm>
 
 void BasicEvent::ScheduleAbort()
 {
@@ -32,6 +33,21 @@ void BasicEvent::SetAborted()
     m_abortState = AbortState::STATE_ABORTED;
 }
 
+namespace
+{
+    // std heap functions build a max-heap, so the earliest event compares greatest
+    struct QueuedEventLater
+    {
+        bool operator()(EventProcessor::QueuedEvent const& left, EventProcessor::QueuedEvent const& right) const
+        {
+            if (left.Time != right.Time)
+                return left.Time > right.Time;
+
+            return left.Sequence > right.Sequence;
+        }
+    };
+}
+
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
@@ -43,12 +59,12 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    std::multimap<uint64, BasicEvent*>::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front().Time <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* event = i->second;
-        m_events.erase(i);
+        std::pop_heap(m_events.begin(), m_events.end(), QueuedEventLater());
+        BasicEvent* event = m_events.back().Event;
+        m_events.pop_back();
 
         if (event->IsRunning())
         {
@@ -81,33 +97,40 @@ void EventProcessor::Update(uint32 p_time)
 
 void EventProcessor::KillAllEvents(bool force)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end();)
+    // Abort may add events, they are kept out of the batch being killed and handled by the next pass
+    std::vector<QueuedEvent> kept;
+    while (!m_events.empty())
     {
-        // Abort events which weren't aborted already
-        if (!itr->second->IsAborted())
+        std::vector<QueuedEvent> events;
+        events.swap(m_events);
+        std::sort(events.begin(), events.end(), [](QueuedEvent const& left, QueuedEvent const& right)
         {
-            itr->second->SetAborted();
-            itr->second->Abort(m_time);
-        }
+            return QueuedEventLater()(right, left);
+        });
 
-        // Skip non-deletable events when we are
-        // not forcing the event cancellation.
-        if (!force && !itr->second->IsDeletable())
+        for (QueuedEvent const& queued : events)
         {
-            ++itr;
-            continue;
-        }
+            // Abort events which weren't aborted already
+            if (!queued.Event->IsAborted())
+            {
+                queued.Event->SetAborted();
+                queued.Event->Abort(m_time);
+            }
 
-        delete itr->second;
+            // Skip non-deletable events when we are
+            // not forcing the event cancellation.
+            if (!force && !queued.Event->IsDeletable())
+            {
+                kept.push_back(queued);
+                continue;
+            }
 
-        if (force)
-            ++itr; // Clear the whole container when forcing
-        else
-            itr = m_events.erase(itr);
+            delete queued.Event;
+        }
     }
 
-    if (force)
-        m_events.clear();
+    m_events.swap(kept);
+    std::make_heap(m_events.begin(), m_events.end(), QueuedEventLater());
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -115,19 +138,22 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     if (set_addtime)
         Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    m_events.push_back({ e_time, m_sequence++, Event });
+    std::push_heap(m_events.begin(), m_events.end(), QueuedEventLater());
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 newTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
+    for (QueuedEvent& queued : m_events)
     {
-        if (itr->second != Event)
+        if (queued.Event != Event)
             continue;
 
+        // same as removing and adding the event again
         Event->m_execTime = newTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(newTime, Event));
+        queued.Time = newTime;
+        queued.Sequence = m_sequence++;
+        std::make_heap(m_events.begin(), m_events.end(), QueuedEventLater());
         break;
     }
 }
@@ -19,7 +19,7 @@
 #define __EVENTPROCESSOR_H
 
 #include "Define.h"
-#include <map>
+#include <vector>
 
 class EventProcessor;
 
@@ -70,7 +70,14 @@ class TC_COMMON_API BasicEvent
 class TC_COMMON_API EventProcessor
 {
     public:
-        EventProcessor() : m_time(0) { }
+        struct QueuedEvent
+        {
+            uint64 Time;
+            uint64 Sequence;                                // events with the same time execute in the order they were added
+            BasicEvent* Event;
+        };
+
+        EventProcessor() : m_time(0), m_sequence(0) { }
         ~EventProcessor();
 
         void Update(uint32 p_time);
@@ -78,11 +85,13 @@ class TC_COMMON_API EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void ModifyEventTime(BasicEvent* Event, uint64 newTime);
         uint64 CalculateTime(uint64 t_offset) const;
-        std::multimap<uint64, BasicEvent*> const& GetEvents() const { return m_events; }
+        // heap ordered, only the first element is the next event to execute
+        std::vector<QueuedEvent> const& GetEvents() const { return m_events; }
 
     protected:
         uint64 m_time;
-        std::multimap<uint64, BasicEvent*> m_events;
+        uint64 m_sequence;
+        std::vector<QueuedEvent> m_events;                  // binary min-heap on (Time, Sequence)
 };
 
 #endif
@@ -0,0 +1,56 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+struct MappedFile::Region
+{
+    boost::interprocess::mapped_region Mapped;
+};
+
+MappedFile::MappedFile(std::unique_ptr<Region> region) : _region(std::move(region))
+{
+    _data = static_cast<char*>(_region->Mapped.get_address());
+    _size = _region->Mapped.get_size();
+}
+
+MappedFile::~MappedFile() = default;
+
+std::unique_ptr<MappedFile> MappedFile::Open(std::string const& fileName, Access access, Error* error /*= nullptr*/)
+{
+    std::unique_ptr<Region> region;
+    try
+    {
+        // the region stays valid after the file mapping and its descriptor are closed at the end of this block
+        boost::interprocess::file_mapping file(fileName.c_str(), boost::interprocess::read_only);
+        region.reset(new Region{ boost::interprocess::mapped_region(file, access == Access::CopyOnWrite ? boost::interprocess::copy_on_write : boost::interprocess::read_only) });
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        if (error)
+            *error = e.get_error_code() == boost::interprocess::not_found_error ? Error::NotFound : Error::Failed;
+
+        return nullptr;
+    }
+
+    if (error)
+        *error = Error::None;
+
+    return std::unique_ptr<MappedFile>(new MappedFile(std::move(region)));
+}
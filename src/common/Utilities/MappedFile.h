@@ -0,0 +1,70 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MappedFile_h__
+#define MappedFile_h__
+
+#include "Define.h"
+#include <memory>
+#include <string>
+
+/**
+ * @class MappedFile
+ *
+ * @brief Whole file mapped into memory.
+ *
+ * Only the mapped region is kept, the file descriptor is closed before Open returns.
+ * Data stays valid until the MappedFile is destroyed.
+ */
+class TC_COMMON_API MappedFile
+{
+public:
+    enum class Access
+    {
+        ReadOnly,
+        CopyOnWrite                                         // writes go to private pages, the file is never modified
+    };
+
+    enum class Error
+    {
+        None,
+        NotFound,
+        Failed
+    };
+
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    // returns nullptr when the file can not be mapped, error tells why
+    static std::unique_ptr<MappedFile> Open(std::string const& fileName, Access access, Error* error = nullptr);
+
+    char* GetData() const { return _data; }
+    std::size_t GetSize() const { return _size; }
+
+private:
+    struct Region;
+
+    explicit MappedFile(std::unique_ptr<Region> region);
+
+    std::unique_ptr<Region> _region;
+    char* _data;
+    std::size_t _size;
+};
+
+#endif // MappedFile_h__
@@ -51,6 +51,9 @@ using PreparedQueryResult = std::shared_ptr<PreparedResultSet>;
 using PreparedQueryResultFuture = std::future<PreparedQueryResult>;
 using PreparedQueryResultPromise = std::promise<PreparedQueryResult>;
 
+class StreamedResultSet;
+using StreamQueryResult = std::unique_ptr<StreamedResultSet>;
+
 class QueryCallback;
 
 template<typename T>
@@ -53,7 +53,9 @@ DatabaseLoader& DatabaseLoader::AddDatabase(DatabaseWorkerPool<T>& pool, std::st
 
         uint8 const synchThreads = uint8(sConfigMgr->GetIntDefault(name + "Database.SynchThreads", 1));
 
-        pool.SetConnectionInfo(dbString, asyncThreads, synchThreads);
+        uint32 const writeBatchSize = uint32(std::max(sConfigMgr->GetIntDefault(name + "Database.WriteBatchSize", 32), 1));
+
+        pool.SetConnectionInfo(dbString, asyncThreads, synchThreads, writeBatchSize);
         if (uint32 error = pool.Open())
         {
             // Database does not exist
@@ -16,14 +16,21 @@
  */
 
 #include "DatabaseWorker.h"
+#include "Log.h"
+#include "Metric.h"
+#include "MySQLConnection.h"
+#include "MySQLPreparedStatement.h"
+#include "PreparedStatement.h"
 #include "SQLOperation.h"
 #include "ProducerConsumerQueue.h"
+#include <algorithm>
 
 DatabaseWorker::DatabaseWorker(ProducerConsumerQueue<SQLOperation*>* newQueue, MySQLConnection* connection)
 {
     _connection = connection;
     _queue = newQueue;
     _cancelationToken = false;
+    _writeBatch.reserve(_connection->m_connectionInfo.writeBatchSize);
     _workerThread = std::thread(&DatabaseWorker::WorkerThread, this);
 }
 
@@ -41,18 +48,173 @@ void DatabaseWorker::WorkerThread()
     if (!_queue)
         return;
 
+    SQLOperation* operation = nullptr;
+
     for (;;)
     {
-        SQLOperation* operation = nullptr;
-
-        _queue->WaitAndPop(operation);
+        if (!operation)
+            _queue->WaitAndPop(operation);
 
         if (_cancelationToken || !operation)
             return;
 
-        operation->SetConnection(_connection);
-        operation->call();
+        if (operation->IsOneWay() && _connection->m_connectionInfo.writeBatchSize > 1)
+        {
+            operation = ExecuteWriteBatch(operation);
+            continue;
+        }
+
+        ExecuteSingle(operation);
+        operation = nullptr;
+    }
+}
+
+void DatabaseWorker::ExecuteSingle(SQLOperation* operation)
+{
+    operation->SetConnection(_connection);
+    operation->call();
+
+    delete operation;
+}
+
+SQLOperation* DatabaseWorker::ExecuteWriteBatch(SQLOperation* first)
+{
+    // Only operations that are already waiting are batched, a lone write is never delayed
+    SQLOperation* next = nullptr;
+    _writeBatch.push_back(first);
+    while (_writeBatch.size() < _connection->m_connectionInfo.writeBatchSize && _queue->Pop(next))
+    {
+        if (!next)
+            break;
+
+        if (!next->IsOneWay())
+            break;
+
+        _writeBatch.push_back(next);
+        next = nullptr;
+    }
+
+    if (_writeBatch.size() == 1)
+    {
+        ExecuteSingle(first);
+        _writeBatch.clear();
+        return next;
+    }
+
+    uint32 coalesced = CoalesceWriteBatch();
+
+    std::size_t const batchSize = _writeBatch.size();
+    uint32 const reconnects = _connection->m_reconnects;
+    std::size_t failedOperation = batchSize;            // operation that failed without a reconnect, it is not run again
+    bool failed = false;
+
+    // Reconnecting discards the open transaction on server side and leaves the session in autocommit.
+    // Statements are not retried by the connection while the batch is open, so a reconnect fails the
+    // batch before any of its operations ran outside of the transaction, and the whole batch is replayed in order.
+    _connection->m_retryAfterReconnect = false;
+    _connection->BeginTransaction();
+    if (_connection->m_reconnects != reconnects)
+        failed = true;
+
+    for (std::size_t i = 0; i < batchSize && !failed; ++i)
+    {
+        _writeBatch[i]->SetConnection(_connection);
+        bool const result = _writeBatch[i]->Execute();
+        if (_connection->m_reconnects != reconnects)
+            failed = true;
+        else if (!result)
+        {
+            // already logged, it fails the same way after the operations before it are replayed
+            failedOperation = i;
+            failed = true;
+        }
+    }
+
+    if (!failed && (!_connection->Execute("COMMIT") || _connection->m_reconnects != reconnects))
+        failed = true;
 
+    _connection->m_retryAfterReconnect = true;
+
+    if (failed)
+    {
+        if (_connection->m_reconnects == reconnects)
+            _connection->RollbackTransaction();
+
+        TC_LOG_WARN("sql.sql", "DatabaseWorker: Write batch of %u operations on database `%s` failed, executing them separately.",
+            uint32(batchSize), _connection->m_connectionInfo.database.c_str());
+
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            if (i == failedOperation)
+                continue;
+
+            _writeBatch[i]->SetConnection(_connection);
+            _writeBatch[i]->Execute();
+        }
+    }
+
+    for (SQLOperation* operation : _writeBatch)
         delete operation;
+
+    _writeBatch.clear();
+
+    TC_METRIC_VALUE("db_write_batch", uint64(batchSize), TC_METRIC_TAG("db", _connection->m_connectionInfo.database));
+    if (coalesced)
+        TC_METRIC_VALUE("db_write_coalesced", uint64(coalesced), TC_METRIC_TAG("db", _connection->m_connectionInfo.database));
+
+    return next;
+}
+
+uint32 DatabaseWorker::CoalesceWriteBatch()
+{
+    uint32 coalesced = 0;
+    for (std::size_t i = 0; i < _writeBatch.size(); ++i)
+    {
+        PreparedStatementBase const* stmt = _writeBatch[i]->GetPreparedStatement();
+        if (!stmt)
+            continue;
+
+        MySQLPreparedStatement const* info = _connection->GetPreparedStatement(stmt->GetIndex());
+        if (!info || !info->IsCoalescableUpdate())
+            continue;
+
+        for (std::size_t j = i + 1; j < _writeBatch.size(); ++j)
+        {
+            PreparedStatementBase const* laterStmt = _writeBatch[j]->GetPreparedStatement();
+            if (!laterStmt)
+                break;
+
+            if (IsOverwrittenBy(_writeBatch[i], _writeBatch[j]))
+            {
+                delete _writeBatch[i];
+                _writeBatch[i] = nullptr;
+                ++coalesced;
+                break;
+            }
+
+            // Operations in between may only touch other rows of the same statement or other tables
+            if (laterStmt->GetIndex() == stmt->GetIndex())
+                continue;
+
+            MySQLPreparedStatement const* laterInfo = _connection->GetPreparedStatement(laterStmt->GetIndex());
+            if (!laterInfo || !laterInfo->IsCoalescableUpdate() || laterInfo->GetUpdatedTable() == info->GetUpdatedTable())
+                break;
+        }
     }
+
+    if (coalesced)
+        _writeBatch.erase(std::remove(_writeBatch.begin(), _writeBatch.end(), nullptr), _writeBatch.end());
+
+    return coalesced;
+}
+
+bool DatabaseWorker::IsOverwrittenBy(SQLOperation const* earlier, SQLOperation const* later) const
+{
+    PreparedStatementBase const* earlierStmt = earlier->GetPreparedStatement();
+    PreparedStatementBase const* laterStmt = later->GetPreparedStatement();
+    if (earlierStmt->GetIndex() != laterStmt->GetIndex())
+        return false;
+
+    MySQLPreparedStatement const* info = _connection->GetPreparedStatement(earlierStmt->GetIndex());
+    return earlierStmt->HasSameParameters(*laterStmt, info->GetKeyParameterIndex());
 }
@@ -21,6 +21,7 @@
 #include "Define.h"
 #include <atomic>
 #include <thread>
+#include <vector>
 
 template <typename T>
 class ProducerConsumerQueue;
@@ -41,6 +42,17 @@ class TC_DATABASE_API DatabaseWorker
         void WorkerThread();
         std::thread _workerThread;
 
+        //! Pops further fire-and-forget operations already waiting in the queue and executes them
+        //! together with the first one inside a single transaction.
+        //! Returns the first operation that could not be batched, if any was popped.
+        SQLOperation* ExecuteWriteBatch(SQLOperation* first);
+        //! Drops writes that are fully overwritten by a later update of the same row within the batch
+        uint32 CoalesceWriteBatch();
+        bool IsOverwrittenBy(SQLOperation const* earlier, SQLOperation const* later) const;
+        void ExecuteSingle(SQLOperation* operation);
+
+        std::vector<SQLOperation*> _writeBatch;
+
         std::atomic<bool> _cancelationToken;
 
         DatabaseWorker(DatabaseWorker const& right) = delete;
@@ -67,9 +67,10 @@ DatabaseWorkerPool<T>::~DatabaseWorkerPool()
 
 template <class T>
 void DatabaseWorkerPool<T>::SetConnectionInfo(std::string const& infoString,
-    uint8 const asyncThreads, uint8 const synchThreads)
+    uint8 const asyncThreads, uint8 const synchThreads, uint32 const writeBatchSize /*= 1*/)
 {
     _connectionInfo = std::make_unique<MySQLConnectionInfo>(infoString);
+    _connectionInfo->writeBatchSize = std::max(writeBatchSize, 1u);
 
     _async_threads = asyncThreads;
     _synch_threads = synchThreads;
@@ -202,6 +203,52 @@ PreparedQueryResult DatabaseWorkerPool<T>::Query(PreparedStatement<T>* stmt)
     return PreparedQueryResult(ret);
 }
 
+template <class T>
+StreamQueryResult DatabaseWorkerPool<T>::StreamQuery(const char* sql)
+{
+    T* connection = GetFreeConnection();
+    StreamedResultSet* result = connection->StreamQuery(sql);
+    if (!result)
+    {
+        connection->Unlock();
+        return StreamQueryResult(nullptr);
+    }
+
+    //! Connection is released by the result set
+    if (!result->NextRow())
+    {
+        delete result;
+        return StreamQueryResult(nullptr);
+    }
+
+    return StreamQueryResult(result);
+}
+
+template <class T>
+StreamQueryResult DatabaseWorkerPool<T>::StreamQuery(PreparedStatement<T>* stmt)
+{
+    T* connection = GetFreeConnection();
+    StreamedResultSet* result = connection->StreamQuery(stmt);
+
+    //! Delete proxy-class. Not needed anymore
+    delete stmt;
+
+    if (!result)
+    {
+        connection->Unlock();
+        return StreamQueryResult(nullptr);
+    }
+
+    //! Connection is released by the result set
+    if (!result->NextRow())
+    {
+        delete result;
+        return StreamQueryResult(nullptr);
+    }
+
+    return StreamQueryResult(result);
+}
+
 template <class T>
 QueryCallback DatabaseWorkerPool<T>::AsyncQuery(const char* sql)
 {
@@ -355,6 +402,12 @@ void DatabaseWorkerPool<T>::KeepAlive()
         Enqueue(new PingOperation);
 }
 
+template <class T>
+std::size_t DatabaseWorkerPool<T>::GetQueueSize() const
+{
+    return _queue->Size();
+}
+
 template <class T>
 uint32 DatabaseWorkerPool<T>::OpenConnections(InternalIndex type, uint8 numConnections)
 {
@@ -394,6 +447,35 @@ uint32 DatabaseWorkerPool<T>::OpenConnections(InternalIndex type, uint8 numConne
     return 0;
 }
 
+template <class T>
+uint32 DatabaseWorkerPool<T>::OpenExtraSynchConnections(uint8 numConnections)
+{
+    for (uint8 i = 0; i < numConnections; ++i)
+    {
+        auto connection = std::make_unique<T>(*_connectionInfo);
+        if (uint32 error = connection->Open())
+            return error;
+
+        connection->LockIfReady();
+        bool const prepared = connection->PrepareStatements();
+        connection->Unlock();
+        if (!prepared)
+            return 1;
+
+        _connections[IDX_SYNCH].push_back(std::move(connection));
+    }
+
+    return 0;
+}
+
+template <class T>
+void DatabaseWorkerPool<T>::CloseExtraSynchConnections()
+{
+    auto& connections = _connections[IDX_SYNCH];
+    if (connections.size() > _synch_threads)
+        connections.erase(connections.begin() + _synch_threads, connections.end());
+}
+
 template <class T>
 unsigned long DatabaseWorkerPool<T>::EscapeString(char *to, const char *from, unsigned long length)
 {
@@ -48,7 +48,7 @@ class DatabaseWorkerPool
 
         ~DatabaseWorkerPool();
 
-        void SetConnectionInfo(std::string const& infoString, uint8 const asyncThreads, uint8 const synchThreads);
+        void SetConnectionInfo(std::string const& infoString, uint8 const asyncThreads, uint8 const synchThreads, uint32 const writeBatchSize = 1);
 
         uint32 Open();
 
@@ -143,6 +143,21 @@ class DatabaseWorkerPool
         //! Statement must be prepared with CONNECTION_SYNCH flag.
         PreparedQueryResult Query(PreparedStatement<T>* stmt);
 
+        /**
+            Streaming query (with unbuffered resultset) methods.
+        */
+
+        //! Directly executes an SQL query in string format that will block the calling thread until the first row is received.
+        //! Remaining rows are read from the server while iterating, intended for bulk loads of big tables.
+        //! The synchronous connection stays reserved until the result is destroyed or fully iterated,
+        //! do not run other synchronous queries on this database from the calling thread meanwhile.
+        StreamQueryResult StreamQuery(const char* sql);
+
+        //! Directly executes an SQL query in prepared format that will block the calling thread until the first row is received.
+        //! Same restrictions as for StreamQuery(const char*) apply.
+        //! Statement must be prepared with CONNECTION_SYNCH flag.
+        StreamQueryResult StreamQuery(PreparedStatement<T>* stmt);
+
         /**
             Asynchronous query (with resultset) methods.
         */
@@ -206,6 +221,20 @@ class DatabaseWorkerPool
         //! Keeps all our MySQL connections alive, prevent the server from disconnecting us.
         void KeepAlive();
 
+        //! Amount of operations waiting for an async worker thread.
+        std::size_t GetQueueSize() const;
+
+        //! Amount of connections available for synchronous queries.
+        std::size_t GetSynchConnectionCount() const { return _connections[IDX_SYNCH].size(); }
+
+        //! Opens additional synchronous connections on top of the configured ones, e.g. for concurrent startup loaders.
+        //! Must not be called while other threads may use the synchronous connections.
+        uint32 OpenExtraSynchConnections(uint8 numConnections);
+
+        //! Closes the connections opened by OpenExtraSynchConnections, keeping the configured ones.
+        //! Must not be called while other threads may use the synchronous connections.
+        void CloseExtraSynchConnections();
+
     private:
         uint32 OpenConnections(InternalIndex type, uint8 numConnections);
 
@@ -82,6 +82,7 @@ class TC_DATABASE_API Field
 {
     friend class ResultSet;
     friend class PreparedResultSet;
+    friend class StreamedResultSet;
 
     public:
         Field();
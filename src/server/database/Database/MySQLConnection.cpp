@@ -30,7 +30,7 @@
 #include "MySQLWorkaround.h"
 #include <mysqld_error.h>
 
-MySQLConnectionInfo::MySQLConnectionInfo(std::string const& infoString)
+MySQLConnectionInfo::MySQLConnectionInfo(std::string const& infoString) : writeBatchSize(1)
 {
     Tokenizer tokens(infoString, ';');
 
@@ -49,6 +49,8 @@ MySQLConnectionInfo::MySQLConnectionInfo(std::string const& infoString)
 MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
+m_reconnects(0),
+m_retryAfterReconnect(true),
 m_queue(nullptr),
 m_Mysql(nullptr),
 m_connectionInfo(connInfo),
@@ -57,6 +59,8 @@ m_connectionFlags(CONNECTION_SYNCH) { }
 MySQLConnection::MySQLConnection(ProducerConsumerQueue<SQLOperation*>* queue, MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
+m_reconnects(0),
+m_retryAfterReconnect(true),
 m_queue(queue),
 m_Mysql(nullptr),
 m_connectionInfo(connInfo),
@@ -180,7 +184,7 @@ bool MySQLConnection::Execute(const char* sql)
             TC_LOG_INFO("sql.sql", "SQL: %s", sql);
             TC_LOG_ERROR("sql.sql", "[%u] %s", lErrno, mysql_error(m_Mysql));
 
-            if (_HandleMySQLErrno(lErrno))  // If it returns true, an error was handled successfully (i.e. reconnection)
+            if (_HandleMySQLErrno(lErrno) && m_retryAfterReconnect)  // If it returns true, an error was handled successfully (i.e. reconnection)
                 return Execute(sql);       // Try again
 
             return false;
@@ -215,7 +219,7 @@ bool MySQLConnection::Execute(PreparedStatementBase* stmt)
         uint32 lErrno = mysql_errno(m_Mysql);
         TC_LOG_ERROR("sql.sql", "SQL(p): %s\n [ERROR]: [%u] %s", m_mStmt->getQueryString().c_str(), lErrno, mysql_stmt_error(msql_STMT));
 
-        if (_HandleMySQLErrno(lErrno))  // If it returns true, an error was handled successfully (i.e. reconnection)
+        if (_HandleMySQLErrno(lErrno) && m_retryAfterReconnect)  // If it returns true, an error was handled successfully (i.e. reconnection)
             return Execute(stmt);       // Try again
 
         m_mStmt->ClearParameters();
@@ -227,7 +231,7 @@ bool MySQLConnection::Execute(PreparedStatementBase* stmt)
         uint32 lErrno = mysql_errno(m_Mysql);
         TC_LOG_ERROR("sql.sql", "SQL(p): %s\n [ERROR]: [%u] %s", m_mStmt->getQueryString().c_str(), lErrno, mysql_stmt_error(msql_STMT));
 
-        if (_HandleMySQLErrno(lErrno))  // If it returns true, an error was handled successfully (i.e. reconnection)
+        if (_HandleMySQLErrno(lErrno) && m_retryAfterReconnect)  // If it returns true, an error was handled successfully (i.e. reconnection)
             return Execute(stmt);       // Try again
 
         m_mStmt->ClearParameters();
@@ -506,6 +510,53 @@ PreparedResultSet* MySQLConnection::Query(PreparedStatementBase* stmt)
     return new PreparedResultSet(stmt->m_stmt->GetSTMT(), result, rowCount, fieldCount);
 }
 
+StreamedResultSet* MySQLConnection::StreamQuery(const char* sql)
+{
+    if (!sql || !m_Mysql)
+        return nullptr;
+
+    uint32 _s = getMSTime();
+
+    if (mysql_query(m_Mysql, sql))
+    {
+        uint32 lErrno = mysql_errno(m_Mysql);
+        TC_LOG_INFO("sql.sql", "SQL: %s", sql);
+        TC_LOG_ERROR("sql.sql", "[%u] %s", lErrno, mysql_error(m_Mysql));
+
+        if (_HandleMySQLErrno(lErrno))      // If it returns true, an error was handled successfully (i.e. reconnection)
+            return StreamQuery(sql);        // We try again
+
+        return nullptr;
+    }
+
+    TC_LOG_DEBUG("sql.sql", "[%u ms] SQL(stream): %s", getMSTimeDiff(_s, getMSTime()), sql);
+
+    // Rows are left on server side and read one by one by the result set
+    MySQLResult* result = reinterpret_cast<MySQLResult*>(mysql_use_result(m_Mysql));
+    if (!result)
+        return nullptr;
+
+    uint32 fieldCount = mysql_field_count(m_Mysql);
+    MySQLField* fields = reinterpret_cast<MySQLField*>(mysql_fetch_fields(result));
+
+    return new StreamedResultSet(this, result, fields, fieldCount);
+}
+
+StreamedResultSet* MySQLConnection::StreamQuery(PreparedStatementBase* stmt)
+{
+    MySQLResult* result = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(stmt, &result, &rowCount, &fieldCount))
+        return nullptr;
+
+    if (!result)
+        return nullptr;
+
+    return new StreamedResultSet(this, stmt->m_stmt->GetSTMT(), result, fieldCount);
+}
+
 bool MySQLConnection::_HandleMySQLErrno(uint32 errNo, uint8 attempts /*= 5*/)
 {
     switch (errNo)
@@ -543,6 +594,7 @@ bool MySQLConnection::_HandleMySQLErrno(uint32 errNo, uint8 attempts /*= 5*/)
                         (m_connectionFlags & CONNECTION_ASYNC) ? "asynchronous" : "synchronous");
 
                 m_reconnecting = false;
+                ++m_reconnects;
                 return true;
             }
 
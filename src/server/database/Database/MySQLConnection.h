@@ -49,12 +49,17 @@ struct TC_DATABASE_API MySQLConnectionInfo
     std::string database;
     std::string host;
     std::string port_or_socket;
+
+    //! Maximum amount of consecutive one-way async statements executed in a single transaction
+    uint32 writeBatchSize;
 };
 
 class TC_DATABASE_API MySQLConnection
 {
     template <class T> friend class DatabaseWorkerPool;
+    friend class DatabaseWorker;
     friend class PingOperation;
+    friend class StreamedResultSet;
 
     public:
         MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
@@ -70,6 +75,8 @@ class TC_DATABASE_API MySQLConnection
         bool Execute(PreparedStatementBase* stmt);
         ResultSet* Query(const char* sql);
         PreparedResultSet* Query(PreparedStatementBase* stmt);
+        StreamedResultSet* StreamQuery(const char* sql);
+        StreamedResultSet* StreamQuery(PreparedStatementBase* stmt);
         bool _Query(const char* sql, MySQLResult** pResult, MySQLField** pFields, uint64* pRowCount, uint32* pFieldCount);
         bool _Query(PreparedStatementBase* stmt, MySQLResult** pResult, uint64* pRowCount, uint32* pFieldCount);
 
@@ -101,6 +108,8 @@ class TC_DATABASE_API MySQLConnection
         PreparedStatementContainer           m_stmts;         //! PreparedStatements storage
         bool                                 m_reconnecting;  //! Are we reconnecting?
         bool                                 m_prepareError;  //! Was there any error while preparing statements?
+        uint32                               m_reconnects;    //! Successful reconnects, a reconnect discards open transaction
+        bool                                 m_retryAfterReconnect; //! Retry one-way statements after reconnecting, off while a write batch is open
 
     private:
         bool _HandleMySQLErrno(uint32 errNo, uint8 attempts = 5);
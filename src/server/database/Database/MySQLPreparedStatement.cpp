@@ -20,10 +20,13 @@
 #include "Log.h"
 #include "MySQLHacks.h"
 #include "PreparedStatement.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <sstream>
 
 MySQLPreparedStatement::MySQLPreparedStatement(MySQLStmt* stmt, std::string queryString) :
-    m_stmt(nullptr), m_Mstmt(stmt), m_bind(nullptr), m_queryString(std::move(queryString))
+    m_stmt(nullptr), m_Mstmt(stmt), m_bind(nullptr), m_queryString(std::move(queryString)), m_keyParamIndex(0)
 {
     /// Initialize variable parameters
     m_paramCount = mysql_stmt_param_count(stmt);
@@ -34,6 +37,8 @@ MySQLPreparedStatement::MySQLPreparedStatement(MySQLStmt* stmt, std::string quer
     /// "If set to 1, causes mysql_stmt_store_result() to update the metadata MYSQL_FIELD->max_length value."
     MySQLBool bool_tmp = MySQLBool(1);
     mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &bool_tmp);
+
+    ParseCoalescableUpdate();
 }
 
 MySQLPreparedStatement::~MySQLPreparedStatement()
@@ -60,6 +65,112 @@ void MySQLPreparedStatement::ClearParameters()
     }
 }
 
+namespace
+{
+    // splits query into identifiers (without quoting backticks) and single character symbols
+    std::vector<std::string> TokenizeQuery(std::string const& query)
+    {
+        std::vector<std::string> tokens;
+        std::size_t i = 0;
+        while (i < query.length())
+        {
+            char c = query[i];
+            if (isspace(static_cast<unsigned char>(c)))
+                ++i;
+            else if (c == '`')
+            {
+                std::size_t end = query.find('`', i + 1);
+                if (end == std::string::npos)
+                    return {};
+
+                tokens.push_back(query.substr(i + 1, end - i - 1));
+                i = end + 1;
+            }
+            else if (isalnum(static_cast<unsigned char>(c)) || c == '_')
+            {
+                std::size_t start = i;
+                while (i < query.length() && (isalnum(static_cast<unsigned char>(query[i])) || query[i] == '_' || query[i] == '.'))
+                    ++i;
+
+                tokens.push_back(query.substr(start, i - start));
+            }
+            else
+            {
+                tokens.emplace_back(1, c);
+                ++i;
+            }
+        }
+
+        return tokens;
+    }
+
+    bool IsKeyword(std::string const& token, char const* keyword)
+    {
+        return token.length() == strlen(keyword) && std::equal(token.begin(), token.end(), keyword, [](char a, char b)
+        {
+            return toupper(static_cast<unsigned char>(a)) == b;
+        });
+    }
+
+    bool IsColumnName(std::string const& token)
+    {
+        return !token.empty() && token != "?" && (isalpha(static_cast<unsigned char>(token[0])) || token[0] == '_');
+    }
+
+    // parses "column = ?" pairs separated by separator keyword (or ',' when null) until stop keyword
+    bool ParseAssignments(std::vector<std::string> const& tokens, std::size_t& pos, char const* separator, char const* stop, std::vector<std::string>& columns)
+    {
+        for (;;)
+        {
+            if (pos + 3 > tokens.size() || !IsColumnName(tokens[pos]) || tokens[pos + 1] != "=" || tokens[pos + 2] != "?")
+                return false;
+
+            columns.push_back(tokens[pos]);
+            std::transform(columns.back().begin(), columns.back().end(), columns.back().begin(), ::tolower);
+            pos += 3;
+
+            if (pos == tokens.size() || (tokens[pos] == ";" && pos + 1 == tokens.size()))
+                return !stop;
+
+            if (stop && IsKeyword(tokens[pos], stop))
+            {
+                ++pos;
+                return true;
+            }
+
+            if (separator ? !IsKeyword(tokens[pos], separator) : tokens[pos] != ",")
+                return false;
+
+            ++pos;
+        }
+    }
+}
+
+void MySQLPreparedStatement::ParseCoalescableUpdate()
+{
+    std::vector<std::string> tokens = TokenizeQuery(m_queryString);
+    if (tokens.size() < 4 || !IsKeyword(tokens[0], "UPDATE") || !IsColumnName(tokens[1]) || !IsKeyword(tokens[2], "SET"))
+        return;
+
+    std::size_t pos = 3;
+    std::vector<std::string> setColumns;
+    std::vector<std::string> keyColumns;
+    if (!ParseAssignments(tokens, pos, nullptr, "WHERE", setColumns) || !ParseAssignments(tokens, pos, "AND", nullptr, keyColumns))
+        return;
+
+    if (setColumns.size() + keyColumns.size() != m_paramCount)
+        return;
+
+    // statements changing their own key are not idempotent
+    for (std::string const& column : setColumns)
+        if (std::find(keyColumns.begin(), keyColumns.end(), column) != keyColumns.end())
+            return;
+
+    m_updatedTable = tokens[1];
+    std::transform(m_updatedTable.begin(), m_updatedTable.end(), m_updatedTable.begin(), ::tolower);
+    m_keyParamIndex = uint32(setColumns.size());
+}
+
 static bool ParamenterIndexAssertFail(uint32 stmtIndex, uint8 index, uint32 paramCount)
 {
     TC_LOG_ERROR("sql.driver", "Attempted to bind parameter %u%s on a PreparedStatement %u (statement has only %u parameters)", uint32(index) + 1, (index == 1 ? "st" : (index == 2 ? "nd" : (index == 3 ? "rd" : "nd"))), stmtIndex, paramCount);
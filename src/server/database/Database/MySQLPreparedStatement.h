@@ -55,6 +55,12 @@ class TC_DATABASE_API MySQLPreparedStatement
 
         uint32 GetParameterCount() const { return m_paramCount; }
 
+        //! True for "UPDATE table SET a = ?, ... WHERE key = ? AND ..." statements where every value is a parameter.
+        //! Executing it again with the same key parameters overwrites everything the previous execution wrote.
+        bool IsCoalescableUpdate() const { return m_keyParamIndex != 0; }
+        std::string const& GetUpdatedTable() const { return m_updatedTable; }
+        uint32 GetKeyParameterIndex() const { return m_keyParamIndex; }
+
     protected:
         MySQLStmt* GetSTMT() { return m_Mstmt; }
         MySQLBind* GetBind() { return m_bind; }
@@ -62,6 +68,7 @@ class TC_DATABASE_API MySQLPreparedStatement
         void ClearParameters();
         void AssertValidIndex(uint8 index);
         std::string getQueryString() const;
+        void ParseCoalescableUpdate();
 
     private:
         MySQLStmt* m_Mstmt;
@@ -69,6 +76,8 @@ class TC_DATABASE_API MySQLPreparedStatement
         std::vector<bool> m_paramsSet;
         MySQLBind* m_bind;
         std::string const m_queryString;
+        std::string m_updatedTable;
+        uint32 m_keyParamIndex;
 
         MySQLPreparedStatement(MySQLPreparedStatement const& right) = delete;
         MySQLPreparedStatement& operator=(MySQLPreparedStatement const& right) = delete;
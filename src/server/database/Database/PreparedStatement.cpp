@@ -88,6 +88,69 @@ void PreparedStatementBase::BindParameters(MySQLPreparedStatement* stmt)
     #endif
 }
 
+bool PreparedStatementBase::HasSameParameters(PreparedStatementBase const& right, uint32 first) const
+{
+    if (statement_data.size() != right.statement_data.size())
+        return false;
+
+    for (std::size_t i = first; i < statement_data.size(); ++i)
+    {
+        PreparedStatementData const& left = statement_data[i];
+        PreparedStatementData const& other = right.statement_data[i];
+        if (left.type != other.type)
+            return false;
+
+        bool same = true;
+        switch (left.type)
+        {
+            case TYPE_BOOL:
+                same = left.data.boolean == other.data.boolean;
+                break;
+            case TYPE_UI8:
+                same = left.data.ui8 == other.data.ui8;
+                break;
+            case TYPE_UI16:
+                same = left.data.ui16 == other.data.ui16;
+                break;
+            case TYPE_UI32:
+                same = left.data.ui32 == other.data.ui32;
+                break;
+            case TYPE_UI64:
+                same = left.data.ui64 == other.data.ui64;
+                break;
+            case TYPE_I8:
+                same = left.data.i8 == other.data.i8;
+                break;
+            case TYPE_I16:
+                same = left.data.i16 == other.data.i16;
+                break;
+            case TYPE_I32:
+                same = left.data.i32 == other.data.i32;
+                break;
+            case TYPE_I64:
+                same = left.data.i64 == other.data.i64;
+                break;
+            case TYPE_FLOAT:
+                same = left.data.f == other.data.f;
+                break;
+            case TYPE_DOUBLE:
+                same = left.data.d == other.data.d;
+                break;
+            case TYPE_STRING:
+            case TYPE_BINARY:
+                same = left.binary == other.binary;
+                break;
+            case TYPE_NULL:
+                break;
+        }
+
+        if (!same)
+            return false;
+    }
+
+    return true;
+}
+
 //- Bind to buffer
 void PreparedStatementBase::setBool(const uint8 index, const bool value)
 {
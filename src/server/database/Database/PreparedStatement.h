@@ -106,6 +106,9 @@ class TC_DATABASE_API PreparedStatementBase
 
         uint32 GetIndex() const { return m_index; }
 
+        //! Compares parameters starting at index first, used to detect statements updating the same row
+        bool HasSameParameters(PreparedStatementBase const& right, uint32 first) const;
+
     protected:
         void BindParameters(MySQLPreparedStatement* stmt);
 
@@ -141,6 +144,8 @@ class TC_DATABASE_API PreparedStatementTask : public SQLOperation
         ~PreparedStatementTask();
 
         bool Execute() override;
+        bool IsOneWay() const override { return !m_has_result; }
+        PreparedStatementBase const* GetPreparedStatement() const override { return m_stmt; }
         PreparedQueryResultFuture GetFuture() { return m_result->get_future(); }
 
     protected:
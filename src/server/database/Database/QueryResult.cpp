@@ -19,6 +19,7 @@
 #include "Errors.h"
 #include "Field.h"
 #include "Log.h"
+#include "MySQLConnection.h"
 #include "MySQLHacks.h"
 #include "MySQLWorkaround.h"
 
@@ -152,6 +153,36 @@ static char const* FieldTypeToString(enum_field_types type)
     }
 }
 
+bool IsVariableLengthType(enum_field_types type)
+{
+    switch (type)
+    {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+// max_length is only known for results stored on client side, streamed strings start with
+// a buffer fitting the column definition (but no more than 1 KiB) and grow on truncation
+uint32 StreamedSizeForType(MYSQL_FIELD* field)
+{
+    if (IsVariableLengthType(field->type))
+        return uint32(std::min<unsigned long>(field->length, 1024)) + 1;
+
+    return SizeForType(field);
+}
+
+uint32 const NullValueLength = 0xFFFFFFFF;
+
 void InitializeDatabaseFieldMetadata(QueryResultFieldMetadata* meta, MySQLField const* field, uint32 fieldIndex)
 {
     meta->TableName = field->org_table;
@@ -182,6 +213,7 @@ _fields(fields)
 PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount) :
 m_rowCount(rowCount),
 m_rowPosition(0),
+m_rowSize(0),
 m_fieldCount(fieldCount),
 m_rBind(nullptr),
 m_stmt(stmt),
@@ -213,8 +245,10 @@ m_metadataResult(result)
     {
         TC_LOG_WARN("sql.sql", "%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
         delete[] m_rBind;
+        m_rBind = nullptr;
         delete[] m_isNull;
         delete[] m_length;
+        m_rowCount = 0;
         return;
     }
 
@@ -223,6 +257,7 @@ m_metadataResult(result)
     //- This is where we prepare the buffer based on metadata
     MySQLField* field = reinterpret_cast<MySQLField*>(mysql_fetch_fields(m_metadataResult));
     m_fieldMetadata.resize(m_fieldCount);
+    m_currentRow.resize(m_fieldCount);
     std::size_t rowSize = 0;
     for (uint32 i = 0; i < m_fieldCount; ++i)
     {
@@ -230,6 +265,7 @@ m_metadataResult(result)
         rowSize += size;
 
         InitializeDatabaseFieldMetadata(&m_fieldMetadata[i], &field[i], i);
+        m_currentRow[i].SetMetadata(&m_fieldMetadata[i]);
 
         m_rBind[i].buffer_type = field[i].type;
         m_rBind[i].buffer_length = size;
@@ -254,16 +290,19 @@ m_metadataResult(result)
         CleanUp();
         delete[] m_isNull;
         delete[] m_length;
+        m_rowCount = 0;
         return;
     }
 
-    m_rows.resize(uint32(m_rowCount) * m_fieldCount);
+    m_rowSize = rowSize;
+
+    // Fetched values stay in the row buffer, only their lengths are recorded per row and
+    // the Field objects of a single row are pointed at the current row when iterating
+    m_lengths.resize(std::size_t(m_rowCount) * m_fieldCount);
     while (_NextRow())
     {
         for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
         {
-            m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetMetadata(&m_fieldMetadata[fIndex]);
-
             unsigned long buffer_length = m_rBind[fIndex].buffer_length;
             unsigned long fetched_length = *m_rBind[fIndex].length;
             if (!*m_rBind[fIndex].is_null)
@@ -289,24 +328,21 @@ m_metadataResult(result)
                         break;
                 }
 
-                m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetByteValue(
-                    (char const*)buffer,
-                    fetched_length);
+                m_lengths[std::size_t(m_rowPosition) * m_fieldCount + fIndex] = uint32(fetched_length);
 
                 // move buffer pointer to next part
                 m_stmt->bind[fIndex].buffer = (char*)buffer + rowSize;
             }
             else
-            {
-                m_rows[uint32(m_rowPosition) * m_fieldCount + fIndex].SetByteValue(
-                    nullptr,
-                    *m_rBind[fIndex].length);
-            }
+                m_lengths[std::size_t(m_rowPosition) * m_fieldCount + fIndex] = NullValueLength;
         }
         m_rowPosition++;
     }
     m_rowPosition = 0;
 
+    if (m_rowCount)
+        SetCurrentRow();
+
     /// All data is buffered, let go of mysql c api structures
     mysql_stmt_free_result(m_stmt);
 }
@@ -356,9 +392,23 @@ bool PreparedResultSet::NextRow()
     if (++m_rowPosition >= m_rowCount)
         return false;
 
+    SetCurrentRow();
     return true;
 }
 
+void PreparedResultSet::SetCurrentRow()
+{
+    std::size_t const rowOffset = std::size_t(m_rowPosition) * m_rowSize;
+    uint32 const* lengths = &m_lengths[std::size_t(m_rowPosition) * m_fieldCount];
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        if (lengths[i] != NullValueLength)
+            m_currentRow[i].SetByteValue(static_cast<char const*>(m_rBind[i].buffer) + rowOffset, lengths[i]);
+        else
+            m_currentRow[i].SetByteValue(nullptr, 0);
+    }
+}
+
 bool PreparedResultSet::_NextRow()
 {
     /// Only called in low-level code, namely the constructor
@@ -407,12 +457,208 @@ Field const& ResultSet::operator[](std::size_t index) const
 Field* PreparedResultSet::Fetch() const
 {
     ASSERT(m_rowPosition < m_rowCount);
-    return const_cast<Field*>(&m_rows[uint32(m_rowPosition) * m_fieldCount]);
+    return const_cast<Field*>(m_currentRow.data());
 }
 
 Field const& PreparedResultSet::operator[](std::size_t index) const
 {
     ASSERT(m_rowPosition < m_rowCount);
     ASSERT(index < m_fieldCount);
-    return m_rows[uint32(m_rowPosition) * m_fieldCount + index];
+    return m_currentRow[index];
+}
+
+StreamedResultSet::StreamedResultSet(MySQLConnection* connection, MySQLResult* result, MySQLField* fields, uint32 fieldCount) :
+_fetchedRowCount(0),
+_fieldCount(fieldCount),
+_connection(connection),
+_result(result),
+_stmt(nullptr),
+_bind(nullptr)
+{
+    _fieldMetadata.resize(_fieldCount);
+    _currentRow.resize(_fieldCount);
+    for (uint32 i = 0; i < _fieldCount; ++i)
+    {
+        InitializeDatabaseFieldMetadata(&_fieldMetadata[i], &fields[i], i);
+        _currentRow[i].SetMetadata(&_fieldMetadata[i]);
+    }
+}
+
+StreamedResultSet::StreamedResultSet(MySQLConnection* connection, MySQLStmt* stmt, MySQLResult* metadataResult, uint32 fieldCount) :
+_fetchedRowCount(0),
+_fieldCount(fieldCount),
+_connection(connection),
+_result(metadataResult),
+_stmt(stmt),
+_bind(nullptr)
+{
+    // Same ownership rules as in PreparedResultSet - length and is_null arrays are freed by the next result bound to this statement
+    if (_stmt->bind_result_done)
+    {
+        delete[] _stmt->bind->length;
+        delete[] _stmt->bind->is_null;
+    }
+
+    _bind = new MySQLBind[_fieldCount];
+    MySQLBool* isNull = new MySQLBool[_fieldCount];
+    unsigned long* length = new unsigned long[_fieldCount];
+
+    memset(_bind, 0, sizeof(MySQLBind) * _fieldCount);
+    memset(isNull, 0, sizeof(MySQLBool) * _fieldCount);
+    memset(length, 0, sizeof(unsigned long) * _fieldCount);
+
+    MySQLField* field = reinterpret_cast<MySQLField*>(mysql_fetch_fields(_result));
+    _fieldMetadata.resize(_fieldCount);
+    _currentRow.resize(_fieldCount);
+    _buffers.resize(_fieldCount);
+    for (uint32 i = 0; i < _fieldCount; ++i)
+    {
+        InitializeDatabaseFieldMetadata(&_fieldMetadata[i], &field[i], i);
+        _currentRow[i].SetMetadata(&_fieldMetadata[i]);
+
+        _buffers[i].resize(std::max<uint32>(StreamedSizeForType(&field[i]), 1));
+
+        _bind[i].buffer_type = field[i].type;
+        _bind[i].buffer = _buffers[i].data();
+        _bind[i].buffer_length = _buffers[i].size();
+        _bind[i].length = &length[i];
+        _bind[i].is_null = &isNull[i];
+        _bind[i].error = nullptr;
+        _bind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
+    }
+
+    if (mysql_stmt_bind_result(_stmt, _bind))
+    {
+        TC_LOG_WARN("sql.sql", "%s:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(_stmt));
+        delete[] isNull;
+        delete[] length;
+        CleanUp();
+    }
+}
+
+StreamedResultSet::~StreamedResultSet()
+{
+    CleanUp();
+}
+
+bool StreamedResultSet::NextRow()
+{
+    if (!_connection)
+        return false;
+
+    if (!(_stmt ? FetchBinaryRow() : FetchTextRow()))
+    {
+        // Release the connection as soon as the last row was read
+        CleanUp();
+        return false;
+    }
+
+    ++_fetchedRowCount;
+    return true;
+}
+
+bool StreamedResultSet::FetchTextRow()
+{
+    MYSQL_ROW row = mysql_fetch_row(_result);
+    if (!row)
+    {
+        if (uint32 lErrno = mysql_errno(_result->handle))
+            TC_LOG_ERROR("sql.sql", "%s:mysql_fetch_row, result streaming aborted after " UI64FMTD " rows. Error: [%u] %s", __FUNCTION__, _fetchedRowCount, lErrno, mysql_error(_result->handle));
+
+        return false;
+    }
+
+    unsigned long* lengths = mysql_fetch_lengths(_result);
+    if (!lengths)
+    {
+        TC_LOG_WARN("sql.sql", "%s:mysql_fetch_lengths, cannot retrieve value lengths. Error %s.", __FUNCTION__, mysql_error(_result->handle));
+        return false;
+    }
+
+    for (uint32 i = 0; i < _fieldCount; ++i)
+        _currentRow[i].SetStructuredValue(row[i], lengths[i]);
+
+    return true;
+}
+
+bool StreamedResultSet::FetchBinaryRow()
+{
+    int retval = mysql_stmt_fetch(_stmt);
+    if (retval == MYSQL_NO_DATA)
+        return false;
+
+    if (retval != 0 && retval != MYSQL_DATA_TRUNCATED)
+    {
+        TC_LOG_ERROR("sql.sql", "%s:mysql_stmt_fetch, result streaming aborted after " UI64FMTD " rows. Error: %s", __FUNCTION__, _fetchedRowCount, mysql_stmt_error(_stmt));
+        return false;
+    }
+
+    bool rebind = false;
+    for (uint32 i = 0; i < _fieldCount; ++i)
+    {
+        if (*_bind[i].is_null)
+        {
+            _currentRow[i].SetByteValue(nullptr, 0);
+            continue;
+        }
+
+        unsigned long const fetchedLength = *_bind[i].length;
+        if (IsVariableLengthType(_bind[i].buffer_type))
+        {
+            // Value did not fit (including null terminator) - grow the buffer, fetch this column again and keep the bigger buffer for next rows
+            if (fetchedLength >= _bind[i].buffer_length)
+            {
+                _buffers[i].resize(fetchedLength + 1);
+                _bind[i].buffer = _buffers[i].data();
+                _bind[i].buffer_length = _buffers[i].size();
+                if (mysql_stmt_fetch_column(_stmt, &_bind[i], i, 0))
+                {
+                    TC_LOG_ERROR("sql.sql", "%s:mysql_stmt_fetch_column, cannot refetch truncated column %u. Error: %s", __FUNCTION__, i, mysql_stmt_error(_stmt));
+                    return false;
+                }
+
+                rebind = true;
+            }
+
+            _buffers[i][fetchedLength] = '\0';
+        }
+
+        _currentRow[i].SetByteValue(_buffers[i].data(), fetchedLength);
+    }
+
+    if (rebind && mysql_stmt_bind_result(_stmt, _bind))
+    {
+        TC_LOG_ERROR("sql.sql", "%s:mysql_stmt_bind_result, cannot rebind grown buffers. Error: %s", __FUNCTION__, mysql_stmt_error(_stmt));
+        return false;
+    }
+
+    return true;
+}
+
+void StreamedResultSet::CleanUp()
+{
+    if (!_connection)
+        return;
+
+    // Freeing an unbuffered result discards all rows that were not read yet
+    if (_stmt)
+        mysql_stmt_free_result(_stmt);
+
+    if (_result)
+    {
+        mysql_free_result(_result);
+        _result = nullptr;
+    }
+
+    delete[] _bind;
+    _bind = nullptr;
+
+    _connection->Unlock();
+    _connection = nullptr;
+}
+
+Field const& StreamedResultSet::operator[](std::size_t index) const
+{
+    ASSERT(index < _fieldCount);
+    return _currentRow[index];
 }
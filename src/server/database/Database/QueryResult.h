@@ -22,6 +22,8 @@
 #include "DatabaseEnvFwd.h"
 #include <vector>
 
+class MySQLConnection;
+
 class TC_DATABASE_API ResultSet
 {
     public:
@@ -65,9 +67,11 @@ class TC_DATABASE_API PreparedResultSet
 
     protected:
         std::vector<QueryResultFieldMetadata> m_fieldMetadata;
-        std::vector<Field> m_rows;
+        std::vector<uint32> m_lengths;    ///< Length of every fetched value, row by row (NullValueLength for NULL)
+        std::vector<Field> m_currentRow;  ///< Fields of the row at m_rowPosition, pointing into the row buffer
         uint64 m_rowCount;
         uint64 m_rowPosition;
+        std::size_t m_rowSize;
         uint32 m_fieldCount;
 
     private:
@@ -77,9 +81,53 @@ class TC_DATABASE_API PreparedResultSet
 
         void CleanUp();
         bool _NextRow();
+        void SetCurrentRow();
 
         PreparedResultSet(PreparedResultSet const& right) = delete;
         PreparedResultSet& operator=(PreparedResultSet const& right) = delete;
 };
 
+/**
+    @class StreamedResultSet
+
+    @brief Unbuffered query result, rows are transferred from the MySQL server one at a time while iterating
+    instead of being stored on the client before the first row is returned.
+
+    Only a single row of Field objects exists at any time. The connection used to run the query stays
+    reserved until the result is destroyed or iterated to the end - the owning thread must not run
+    other synchronous queries on the same database in the meantime.
+*/
+class TC_DATABASE_API StreamedResultSet
+{
+    public:
+        StreamedResultSet(MySQLConnection* connection, MySQLResult* result, MySQLField* fields, uint32 fieldCount);
+        StreamedResultSet(MySQLConnection* connection, MySQLStmt* stmt, MySQLResult* metadataResult, uint32 fieldCount);
+        ~StreamedResultSet();
+
+        bool NextRow();
+        uint64 GetFetchedRowCount() const { return _fetchedRowCount; }
+        uint32 GetFieldCount() const { return _fieldCount; }
+
+        Field* Fetch() const { return const_cast<Field*>(_currentRow.data()); }
+        Field const& operator[](std::size_t index) const;
+
+    private:
+        bool FetchTextRow();
+        bool FetchBinaryRow();
+        void CleanUp();
+
+        std::vector<QueryResultFieldMetadata> _fieldMetadata;
+        std::vector<Field> _currentRow;
+        std::vector<std::vector<char>> _buffers;    ///< Per column value buffers for prepared statements
+        uint64 _fetchedRowCount;
+        uint32 _fieldCount;
+        MySQLConnection* _connection;
+        MySQLResult* _result;                       ///< Rows for ad hoc queries, field metadata for prepared statements
+        MySQLStmt* _stmt;
+        MySQLBind* _bind;
+
+        StreamedResultSet(StreamedResultSet const& right) = delete;
+        StreamedResultSet& operator=(StreamedResultSet const& right) = delete;
+};
+
 #endif
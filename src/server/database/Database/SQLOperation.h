@@ -65,6 +65,10 @@ class TC_DATABASE_API SQLOperation
         virtual bool Execute() = 0;
         virtual void SetConnection(MySQLConnection* con) { m_conn = con; }
 
+        //! One-way statements without result can be grouped into write batches by DatabaseWorker
+        virtual bool IsOneWay() const { return false; }
+        virtual PreparedStatementBase const* GetPreparedStatement() const { return nullptr; }
+
         MySQLConnection* m_conn;
 
     private:
@@ -263,6 +263,49 @@ void ThreatContainer::clearReferences()
     }
 
     iThreatList.clear();
+    iReferences.clear();
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* hostileRef)
+{
+    auto itr = iReferences.find(hostileRef->getUnitGuid());
+    if (itr == iReferences.end() || *itr->second != hostileRef)
+        return;
+
+    // the remaining references stay ordered
+    iThreatList.erase(itr->second);
+    iReferences.erase(itr);
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* hostileRef)
+{
+    iThreatList.push_back(hostileRef);
+    iReferences.emplace(hostileRef->getUnitGuid(), std::prev(iThreatList.end()));
+    checkOrder(hostileRef);
+}
+
+//============================================================
+// The list is sorted as long as every reference is ordered against its neighbours,
+// so a threat change only has to compare the changed reference with them
+
+void ThreatContainer::checkOrder(HostileReference* hostileRef)
+{
+    if (iDirty)
+        return;
+
+    auto itr = iReferences.find(hostileRef->getUnitGuid());
+    if (itr == iReferences.end() || *itr->second != hostileRef)
+        return;
+
+    Trinity::ThreatOrderPred pred;
+    StorageType::iterator position = itr->second;
+    StorageType::iterator next = std::next(position);
+    if ((position != iThreatList.begin() && pred(*position, *std::prev(position))) || (next != iThreatList.end() && pred(*next, *position)))
+        iDirty = true;
 }
 
 //============================================================
@@ -272,15 +315,11 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit const* victim) cons
     if (!victim)
         return nullptr;
 
-    ObjectGuid guid = victim->GetGUID();
-    for (ThreatContainer::StorageType::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        HostileReference* ref = (*i);
-        if (ref && ref->getUnitGuid() == guid)
-            return ref;
-    }
+    auto itr = iReferences.find(victim->GetGUID());
+    if (itr == iReferences.end())
+        return nullptr;
 
-    return nullptr;
+    return *itr->second;
 }
 
 //============================================================
@@ -308,7 +347,36 @@ void ThreatContainer::ModifyThreatByPercent(Unit* victim, int32 percent)
 void ThreatContainer::update()
 {
     if (iDirty && iThreatList.size() > 1)
-        iThreatList.sort(Trinity::ThreatOrderPred());
+    {
+        // the list was sorted at the last update and usually only a few references changed their threat since,
+        // move each of them back to its place and fall back to a full sort if they moved too far
+        Trinity::ThreatOrderPred pred;
+        std::size_t steps = 0;
+        std::size_t const maxSteps = iThreatList.size() * 8;
+
+        for (StorageType::iterator itr = std::next(iThreatList.begin()); itr != iThreatList.end() && steps <= maxSteps;)
+        {
+            StorageType::iterator next = std::next(itr);
+            StorageType::iterator position = std::prev(itr);
+            if (pred(*itr, *position))
+            {
+                while (position != iThreatList.begin() && pred(*itr, *std::prev(position)))
+                {
+                    --position;
+                    ++steps;
+                }
+
+                // splice keeps the iterators of iReferences valid
+                iThreatList.splice(position, iThreatList, itr);
+            }
+
+            itr = next;
+        }
+
+        // both keep the order of references with the same threat
+        if (steps > maxSteps)
+            iThreatList.sort(Trinity::ThreatOrderPred());
+    }
 
     iDirty = false;
 }
@@ -580,9 +648,8 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostilRef && threatRefStatusChangeEvent->getFValue()<0.0f) ||
-                (getCurrentVictim() != hostilRef && threatRefStatusChangeEvent->getFValue()>0.0f))
-                setDirty(true);                             // the order in the threat list might have changed
+            if (hostilRef->isOnline())
+                iThreatContainer.checkOrder(hostilRef);     // the order in the threat list might have changed
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
             if (!hostilRef->isOnline())
@@ -598,8 +665,6 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
             }
             else
             {
-                if (getCurrentVictim() && hostilRef->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                    setDirty(true);
                 iThreatContainer.addReference(hostilRef);
                 iThreatOfflineContainer.remove(hostilRef);
             }
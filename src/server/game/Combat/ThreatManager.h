@@ -26,6 +26,8 @@
 #include "IteratorPair.h"
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 //==============================================================
 
@@ -193,15 +195,12 @@ class TC_GAME_API ThreatContainer
         StorageType const & getThreatList() const { return iThreatList; }
 
     private:
-        void remove(HostileReference* hostileRef)
-        {
-            iThreatList.remove(hostileRef);
-        }
+        void remove(HostileReference* hostileRef);
 
-        void addReference(HostileReference* hostileRef)
-        {
-            iThreatList.push_back(hostileRef);
-        }
+        void addReference(HostileReference* hostileRef);
+
+        // Mark the list dirty if the reference is no longer ordered against its neighbours
+        void checkOrder(HostileReference* hostileRef);
 
         void clearReferences();
 
@@ -209,7 +208,8 @@ class TC_GAME_API ThreatContainer
         void update();
 
         StorageType iThreatList;
-        bool iDirty;
+        std::unordered_map<ObjectGuid, StorageType::iterator> iReferences;  // position of each reference in iThreatList
+        bool iDirty;                                        // iThreatList is sorted when not set
 };
 
 //=================================================
@@ -221,7 +221,7 @@ class TC_GAME_API ThreatManager
         // -- compatibility layer for combat rewrite (PR #19930)
         Trinity::IteratorPair<std::list<ThreatReference*>::const_iterator> GetSortedThreatList() const { auto& list = iThreatContainer.getThreatList(); return { list.cbegin(), list.cend() }; }
         Trinity::IteratorPair<std::list<ThreatReference*>::const_iterator> GetUnsortedThreatList() const { return GetSortedThreatList(); }
-        std::list<ThreatReference*> GetModifiableThreatList() const { return iThreatContainer.getThreatList(); }
+        std::vector<ThreatReference*> GetModifiableThreatList() const { auto& list = iThreatContainer.getThreatList(); return { list.cbegin(), list.cend() }; }
         Unit* SelectVictim() { return getHostilTarget(); }
         Unit* GetCurrentVictim() const { if (ThreatReference* ref = getCurrentVictim()) return ref->GetVictim(); else return nullptr; }
         bool IsThreatListEmpty(bool includeOffline = false) const { return includeOffline ? areThreatListsEmpty() : isThreatListEmpty(); }
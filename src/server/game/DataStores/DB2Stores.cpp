@@ -478,7 +478,7 @@ template<typename T>
 constexpr std::size_t GetCppRecordSize(DB2Storage<T> const&) { return sizeof(T); }
 
 void LoadDB2(std::bitset<TOTAL_LOCALES>& availableDb2Locales, std::vector<std::string>& errlist, StorageMap& stores, DB2StorageBase* storage, std::string const& db2Path,
-    LocaleConstant defaultLocale, std::size_t cppRecordSize)
+    std::string const& db2CachePath, LocaleConstant defaultLocale, std::size_t cppRecordSize)
 {
     // validate structure
     DB2LoadInfo const* loadInfo = storage->GetLoadInfo();
@@ -511,50 +511,71 @@ void LoadDB2(std::bitset<TOTAL_LOCALES>& availableDb2Locales, std::vector<std::s
             storage->GetFileName().c_str(), loadInfo->Meta->GetRecordSize(), cppRecordSize);
     }
 
-    try
+    std::string cacheFile;
+    uint64 cacheKey = 0;
+    if (!db2CachePath.empty())
     {
-        storage->Load(db2Path + localeNames[defaultLocale] + '/', defaultLocale);
-    }
-    catch (std::system_error const& e)
-    {
-        if (e.code() == std::errc::no_such_file_or_directory)
-        {
-            errlist.push_back(Trinity::StringFormat("File %s does not exist", db2Path + localeNames[defaultLocale] + '/' + storage->GetFileName()));
-        }
-        else
-            throw;
-    }
-    catch (std::exception const& e)
-    {
-        errlist.emplace_back(e.what());
-        return;
-    }
+        std::vector<std::string> sourceFiles;
+        for (LocaleConstant i = LOCALE_enUS; i < TOTAL_LOCALES; i = LocaleConstant(i + 1))
+            if (i == defaultLocale || availableDb2Locales[i])
+                sourceFiles.push_back(db2Path + localeNames[i] + '/' + storage->GetFileName());
 
-    // load additional data and enUS strings from db
-    storage->LoadFromDB();
+        cacheFile = db2CachePath + storage->GetFileName() + ".cache";
+        cacheKey = storage->GetCacheKey(sourceFiles);
+    }
 
-    for (LocaleConstant i = LOCALE_enUS; i < TOTAL_LOCALES; i = LocaleConstant(i + 1))
+    if (cacheFile.empty() || !storage->LoadFromCache(cacheFile, cacheKey))
     {
-        if (defaultLocale == i || !availableDb2Locales[i])
-            continue;
-
+        std::size_t errorCount = errlist.size();
         try
         {
-            storage->LoadStringsFrom((db2Path + localeNames[i] + '/'), i);
+            storage->Load(db2Path + localeNames[defaultLocale] + '/', defaultLocale);
         }
         catch (std::system_error const& e)
         {
-            if (e.code() != std::errc::no_such_file_or_directory)
+            if (e.code() == std::errc::no_such_file_or_directory)
+            {
+                errlist.push_back(Trinity::StringFormat("File %s does not exist", db2Path + localeNames[defaultLocale] + '/' + storage->GetFileName()));
+            }
+            else
                 throw;
-
-            // locale db2 files are optional, do not error if nothing is found
         }
         catch (std::exception const& e)
         {
             errlist.emplace_back(e.what());
+            return;
+        }
+
+        // strings of all locales are loaded from files before applying hotfixes, cache only holds client data
+        for (LocaleConstant i = LOCALE_enUS; i < TOTAL_LOCALES; i = LocaleConstant(i + 1))
+        {
+            if (defaultLocale == i || !availableDb2Locales[i])
+                continue;
+
+            try
+            {
+                storage->LoadStringsFrom((db2Path + localeNames[i] + '/'), i);
+            }
+            catch (std::system_error const& e)
+            {
+                if (e.code() != std::errc::no_such_file_or_directory)
+                    throw;
+
+                // locale db2 files are optional, do not error if nothing is found
+            }
+            catch (std::exception const& e)
+            {
+                errlist.emplace_back(e.what());
+            }
         }
+
+        if (!cacheFile.empty() && errlist.size() == errorCount && !storage->SaveToCache(cacheFile, cacheKey))
+            TC_LOG_ERROR("server.loading", "Could not write DB2 cache file %s", cacheFile.c_str());
     }
 
+    // load additional data and enUS strings from db
+    storage->LoadFromDB();
+
     for (LocaleConstant i = LOCALE_koKR; i < TOTAL_LOCALES; i = LocaleConstant(i + 1))
         if (availableDb2Locales[i])
             storage->LoadStringsFromDB(i);
@@ -568,7 +589,7 @@ DB2Manager& DB2Manager::Instance()
     return instance;
 }
 
-uint32 DB2Manager::LoadStores(std::string const& dataPath, LocaleConstant defaultLocale)
+uint32 DB2Manager::LoadStores(std::string const& dataPath, std::string const& cachePath, LocaleConstant defaultLocale)
 {
     uint32 oldMSTime = getMSTime();
 
@@ -593,7 +614,23 @@ uint32 DB2Manager::LoadStores(std::string const& dataPath, LocaleConstant defaul
     if (!availableDb2Locales[defaultLocale])
         return 0;
 
-#define LOAD_DB2(store) LoadDB2(availableDb2Locales, loadErrors, _stores, &store, db2Path, defaultLocale, GetCppRecordSize(store))
+    std::string db2CachePath;
+    if (!cachePath.empty())
+    {
+        db2CachePath = cachePath;
+        if (db2CachePath.back() != '/' && db2CachePath.back() != '\\')
+            db2CachePath.push_back('/');
+
+        boost::system::error_code error;
+        boost::filesystem::create_directories(db2CachePath, error);
+        if (error)
+        {
+            TC_LOG_ERROR("server.loading", "Could not create DB2 cache directory %s (%s), DB2 cache is disabled", db2CachePath.c_str(), error.message().c_str());
+            db2CachePath.clear();
+        }
+    }
+
+#define LOAD_DB2(store) LoadDB2(availableDb2Locales, loadErrors, _stores, &store, db2Path, db2CachePath, defaultLocale, GetCppRecordSize(store))
 
     LOAD_DB2(sAchievementStore);
     LOAD_DB2(sAdventureJournalStore);
@@ -302,7 +302,7 @@ public:
 
     static DB2Manager& Instance();
 
-    uint32 LoadStores(std::string const& dataPath, LocaleConstant defaultLocale);
+    uint32 LoadStores(std::string const& dataPath, std::string const& cachePath, LocaleConstant defaultLocale);
     DB2StorageBase const* GetStorage(uint32 type) const;
 
     void LoadHotfixData();
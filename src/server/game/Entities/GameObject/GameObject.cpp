@@ -2602,6 +2602,19 @@ GameObject* GameObject::GetLinkedTrap()
     return ObjectAccessor::GetGameObject(*this, m_linkedTrap);
 }
 
+bool GameObject::GetValuesUpdateShareKey(Player const* target, uint32& key) const
+{
+    // Flags, Level, State
+    if (m_values.HasChanged(TYPEID_GAMEOBJECT))
+    {
+        UF::GameObjectData::Mask const& changesMask = m_gameObjectData->GetChangesMask();
+        if (changesMask[11] || changesMask[14] || changesMask[15])
+            return false;
+    }
+
+    return WorldObject::GetValuesUpdateShareKey(target, key);
+}
+
 void GameObject::BuildValuesCreate(ByteBuffer* data, Player const* target) const
 {
     UF::UpdateFieldFlag flags = GetUpdateFieldFlagsFor(target);
@@ -2707,9 +2720,8 @@ void GameObject::UpdateModelPosition()
 
     if (GetMap()->ContainsGameObjectModel(*m_model))
     {
-        GetMap()->RemoveGameObjectModel(*m_model);
         m_model->UpdatePosition();
-        GetMap()->InsertGameObjectModel(*m_model);
+        GetMap()->UpdateGameObjectModel(*m_model);
     }
 }
 
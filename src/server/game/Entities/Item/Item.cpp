@@ -1611,7 +1611,6 @@ void Item::BuildUpdate(UpdateDataMapType& data_map)
 {
     if (Player* owner = GetOwner())
         BuildFieldsUpdate(owner, data_map);
-    ClearUpdateMask(false);
 }
 
 UF::UpdateFieldFlag Item::GetUpdateFieldFlagsFor(Player const* target) const
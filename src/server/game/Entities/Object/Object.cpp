@@ -72,6 +72,7 @@ Object::Object() : m_values(this)
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_updateListIndex   = 0;
 }
 
 WorldObject::~WorldObject()
@@ -242,11 +243,35 @@ void Object::SendUpdateToPlayer(Player* player)
 
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player const* target) const
 {
-    ByteBuffer buf = PrepareValuesUpdateBuffer();
+    // written in place, values updates are sent every tick and a temporary buffer per block adds up
+    ByteBuffer& buf = data->GetBlockBuffer();
+    buf << uint8(UPDATETYPE_VALUES);
+    buf << GetGUID();
 
     BuildValuesUpdate(&buf, target);
 
-    data->AddUpdateBlock(buf);
+    data->AddUpdateBlock();
+}
+
+void Object::BuildSharedValuesUpdateBlockForPlayer(UpdateData* data, Player const* target, SharedUpdateBlockCache& cache) const
+{
+    uint32 shareKey = 0;
+    if (!GetValuesUpdateShareKey(target, shareKey))
+    {
+        BuildValuesUpdateBlockForPlayer(data, target);
+        return;
+    }
+
+    if (SharedUpdateBlockCache::Block const* block = cache.Find(this, shareKey))
+    {
+        data->AddUpdateBlock(block->Buffer->contents() + block->Pos, block->Size);
+        return;
+    }
+
+    ByteBuffer const& buffer = data->GetBlockBuffer();
+    std::size_t pos = buffer.wpos();
+    BuildValuesUpdateBlockForPlayer(data, target);
+    cache.Add(this, shareKey, &buffer, pos, buffer.wpos() - pos);
 }
 
 void Object::BuildValuesUpdateBlockForPlayerWithFlag(UpdateData* data, UF::UpdateFieldFlag flags, Player const* target) const
@@ -768,6 +793,17 @@ UF::UpdateFieldFlag Object::GetUpdateFieldFlagsFor(Player const* /*target*/) con
     return UF::UpdateFieldFlag::None;
 }
 
+bool Object::GetValuesUpdateShareKey(Player const* target, uint32& key) const
+{
+    // EntryID, DynamicFlags
+    if (m_values.HasChanged(TYPEID_OBJECT))
+        if (m_objectData->GetChangesMask()[1] || m_objectData->GetChangesMask()[2])
+            return false;
+
+    key = uint32(GetUpdateFieldFlagsFor(target));
+    return true;
+}
+
 void Object::BuildValuesUpdateWithFlag(ByteBuffer* data, UF::UpdateFieldFlag /*flags*/, Player const* /*target*/) const
 {
     std::size_t sizePos = data->wpos();
@@ -800,16 +836,14 @@ void Object::ClearUpdateMask(bool remove)
 
 void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
 {
-    UpdateDataMapType::iterator iter = data_map.find(player);
+    UpdateDataMap::Entry& entry = data_map.GetEntry(player, player->GetMapId());
 
-    if (iter == data_map.end())
-    {
-        std::pair<UpdateDataMapType::iterator, bool> p = data_map.emplace(player, UpdateData(player->GetMapId()));
-        ASSERT(p.second);
-        iter = p.first;
-    }
+    // Only send update once to a player
+    if (entry.LastObject == this)
+        return;
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    entry.LastObject = this;
+    BuildSharedValuesUpdateBlockForPlayer(&entry.Data, player, data_map.GetBlockCache());
 }
 
 void MovementInfo::OutDebug()
@@ -1130,18 +1164,29 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz, LineOfSightChecks ch
 {
     if (IsInWorld())
     {
-        float x, y, z;
-        if (GetTypeId() == TYPEID_PLAYER)
-            GetPosition(x, y, z);
-        else
-            GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
-
-        return GetMap()->isInLineOfSight(GetPhaseShift(), x, y, z + 2.0f, ox, oy, oz + 2.0f, checks, ignoreFlags);
+        LineOfSightQuery query;
+        BuildLineOfSightQuery(ox, oy, oz, query);
+        return GetMap()->isInLineOfSight(GetPhaseShift(), query.X1, query.Y1, query.Z1, query.X2, query.Y2, query.Z2, checks, ignoreFlags);
     }
 
     return true;
 }
 
+void WorldObject::BuildLineOfSightQuery(float x, float y, float z, LineOfSightQuery& query) const
+{
+    if (GetTypeId() == TYPEID_PLAYER)
+        GetPosition(query.X1, query.Y1, query.Z1);
+    else
+        GetHitSpherePointFor({ x, y, z }, query.X1, query.Y1, query.Z1);
+
+    query.Phases = &GetPhaseShift();
+    query.Z1 += 2.0f;
+    query.X2 = x;
+    query.Y2 = y;
+    query.Z2 = z + 2.0f;
+    query.InLineOfSight = true;
+}
+
 bool WorldObject::IsWithinLOSInMap(const WorldObject* obj, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
     if (!IsInMap(obj))
@@ -2628,7 +2673,6 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
-    GuidSet plr_list;
     WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) { }
     void Visit(PlayerMapType &m)
     {
@@ -2683,12 +2727,9 @@ struct WorldObjectChangeAccumulator
 
     void BuildPacket(Player* player)
     {
-        // Only send update once to a player
-        if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
-        {
+        // BuildFieldsUpdate skips players that already got this object
+        if (player->HaveAtClient(&i_object))
             i_object.BuildFieldsUpdate(player, i_updateDatas);
-            plr_list.insert(player->GetGUID());
-        }
     }
 
     template<class SKIP> void Visit(GridRefManager<SKIP> &) { }
@@ -2699,8 +2740,6 @@ void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
     WorldObjectChangeAccumulator notifier(*this, data_map);
     //we must build packets for all visible players
     Cell::VisitWorldObjects(this, notifier, GetVisibilityRange());
-
-    ClearUpdateMask(false);
 }
 
 void WorldObject::AddToObjectUpdate()
@@ -52,14 +52,17 @@ class SceneObject;
 class TempSummon;
 class Transport;
 class Unit;
+class SharedUpdateBlockCache;
 class UpdateData;
 class WorldObject;
 class WorldPacket;
 class ZoneScript;
+struct LineOfSightQuery;
 struct PositionFullTerrainStatus;
 struct QuaternionData;
 
-typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+class UpdateDataMap;
+typedef UpdateDataMap UpdateDataMapType;
 
 struct CreateObjectBits
 {
@@ -158,6 +161,7 @@ class TC_GAME_API Object
         void SendUpdateToPlayer(Player* player);
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player const* target) const;
+        void BuildSharedValuesUpdateBlockForPlayer(UpdateData* data, Player const* target, SharedUpdateBlockCache& cache) const;
         void BuildValuesUpdateBlockForPlayerWithFlag(UpdateData* data, UF::UpdateFieldFlag flags, Player const* target) const;
         void BuildDestroyUpdateBlock(UpdateData* data) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
@@ -171,6 +175,7 @@ class TC_GAME_API Object
 
         virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
+        // registers pending values updates for all viewers, the update mask is cleared by Map::SendObjectUpdates afterwards
         virtual void BuildUpdate(UpdateDataMapType&) { }
         void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
 
@@ -328,6 +333,9 @@ class TC_GAME_API Object
 
         void BuildMovementUpdate(ByteBuffer* data, CreateObjectBits flags) const;
         virtual UF::UpdateFieldFlag GetUpdateFieldFlagsFor(Player const* target) const;
+        // Returns false when pending changes contain fields patched per receiver (ViewerDependentValues.h),
+        // otherwise all targets with equal key receive identical values update blocks
+        virtual bool GetValuesUpdateShareKey(Player const* target, uint32& key) const;
         virtual void BuildValuesCreate(ByteBuffer* data, Player const* target) const = 0;
         virtual void BuildValuesUpdate(ByteBuffer* data, Player const* target) const = 0;
 
@@ -347,8 +355,11 @@ class TC_GAME_API Object
         bool m_objectUpdated;
 
     private:
+        friend class Map;
+
         ObjectGuid m_guid;
         bool m_inWorld;
+        uint32 m_updateListIndex;                           // position in Map::_updateObjects while m_objectUpdated is set
 
         Object(Object const& right) = delete;
         Object& operator=(Object const& right) = delete;
@@ -476,6 +487,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         bool IsWithinDistInMap(WorldObject const* obj, float dist2compare, bool is3D = true, bool incOwnRadius = true, bool incTargetRadius = true) const;
         bool IsWithinLOS(float x, float y, float z, LineOfSightChecks checks = LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags ignoreFlags = VMAP::ModelIgnoreFlags::Nothing) const;
         bool IsWithinLOSInMap(WorldObject const* obj, LineOfSightChecks checks = LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags ignoreFlags = VMAP::ModelIgnoreFlags::Nothing) const;
+        // fills query with the same ray IsWithinLOS(x, y, z) checks, for resolving many of them at once with Map::isInLineOfSight
+        void BuildLineOfSightQuery(float x, float y, float z, LineOfSightQuery& query) const;
         Position GetHitSpherePointFor(Position const& dest) const;
         void GetHitSpherePointFor(Position const& dest, float& x, float& y, float& z) const;
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true) const;
@@ -511,6 +524,7 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         float GetVisibilityRange() const;
         float GetSightRange(WorldObject const* target = nullptr) const;
         bool CanSeeOrDetect(WorldObject const* obj, bool ignoreStealth = false, bool distanceCheck = false, bool checkAlert = false) const;
+        bool CanSeeFromAnyDistance(WorldObject const* obj) const { return obj->IsAlwaysVisibleFor(this) || CanAlwaysSee(obj); }
 
         void SetExplicitSeerGuid(ObjectGuid guid) { m_explicitSeerGuid = guid; }
 
@@ -35,6 +35,8 @@
 #define DEFAULT_VISIBILITY_DISTANCE     VISIBILITY_DISTANCE_NORMAL // default visible distance, 100 yards on continents
 #define DEFAULT_VISIBILITY_INSTANCE     170.0f                  // default visible distance in instances, 170 yards
 #define DEFAULT_VISIBILITY_BGARENAS     533.0f                  // default visible distance in BG/Arenas, roughly 533 yards
+#define VISIBILITY_HYSTERESIS           10.0f                   // objects at client are kept this far beyond the sight range
+#define VISIBILITY_NOTIFY_DISTANCE      5.0f                    // units moving less since their last relocation notify are not notified again
 
 #define DEFAULT_PLAYER_BOUNDING_RADIUS      0.388999998569489f     // player size, also currently used (correctly?) for any non Unit world objects
 #define DEFAULT_PLAYER_COMBAT_REACH         1.5f
@@ -77,6 +79,7 @@ enum NotifyFlags
     NOTIFY_NONE                     = 0x00,
     NOTIFY_AI_RELOCATION            = 0x01,
     NOTIFY_VISIBILITY_CHANGED       = 0x02,
+    NOTIFY_VISIBILITY_STATE         = 0x04,                     // changed more than position, observers can not skip it on distance alone
     NOTIFY_ALL                      = 0xFF
 };
 
@@ -19,6 +19,8 @@
 #include "Errors.h"
 #include "WorldPacket.h"
 #include "Opcodes.h"
+#include "Object.h"
+#include <algorithm>
 
 UpdateData::UpdateData(uint32 map) : m_map(map), m_blockCount(0) { }
 
@@ -43,6 +45,12 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++m_blockCount;
 }
 
+void UpdateData::AddUpdateBlock(uint8 const* block, std::size_t size)
+{
+    m_data.append(block, size);
+    ++m_blockCount;
+}
+
 bool UpdateData::BuildPacket(WorldPacket* packet)
 {
     ASSERT(packet->empty());                                // shouldn't happen
@@ -76,3 +84,77 @@ void UpdateData::Clear()
     m_blockCount = 0;
     m_map = 0;
 }
+
+UpdateDataMap::Entry& UpdateDataMap::GetEntry(Player* viewer, uint32 mapId)
+{
+    if ((_used.size() + 1) * 2 > _slots.size())
+        Grow();
+
+    std::size_t slot = FindSlot(viewer);
+    if (_slots[slot])
+        return *_slots[slot];
+
+    if (_used.size() == _pool.size())
+        _pool.push_back(std::make_unique<Entry>());
+
+    Entry* entry = _pool[_used.size()].get();
+    entry->Viewer = viewer;
+    entry->LastObject = nullptr;
+    entry->Data.SetMapId(mapId);
+
+    _slots[slot] = entry;
+    _used.push_back(entry);
+    return *entry;
+}
+
+void UpdateDataMap::Clear()
+{
+    for (Entry* entry : _used)
+    {
+        entry->Data.Clear();
+        entry->Viewer = nullptr;
+        entry->LastObject = nullptr;
+    }
+
+    _used.clear();
+    std::fill(_slots.begin(), _slots.end(), nullptr);
+
+    _blockCache.Clear();
+}
+
+void UpdateDataMap::Grow()
+{
+    _slots.assign(std::max<std::size_t>(_slots.size() * 2, 64), nullptr);
+    _mask = _slots.size() - 1;
+
+    for (Entry* entry : _used)
+        _slots[FindSlot(entry->Viewer)] = entry;
+}
+
+std::size_t UpdateDataMap::FindSlot(Player const* viewer) const
+{
+    // objects are heap allocated so low bits carry no information
+    std::uintptr_t key = reinterpret_cast<std::uintptr_t>(viewer);
+    std::size_t slot = std::size_t((key >> 4) ^ (key >> 12)) & _mask;
+    while (_slots[slot] && _slots[slot]->Viewer != viewer)
+        slot = (slot + 1) & _mask;
+
+    return slot;
+}
+
+SharedUpdateBlockCache::Block const* SharedUpdateBlockCache::Find(Object const* owner, uint32 key) const
+{
+    for (Block const& block : _blocks)
+        if (block.Owner == owner && block.Key == key)
+            return &block;
+
+    return nullptr;
+}
+
+void SharedUpdateBlockCache::Add(Object const* owner, uint32 key, ByteBuffer const* buffer, std::size_t pos, std::size_t size)
+{
+    if (!_blocks.empty() && _blocks.back().Owner != owner)
+        _blocks.clear();
+
+    _blocks.push_back({ owner, key, buffer, pos, size });
+}
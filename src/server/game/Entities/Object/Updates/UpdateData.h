@@ -21,8 +21,12 @@
 #include "Define.h"
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
+#include <memory>
 #include <set>
+#include <vector>
 
+class Object;
+class Player;
 class WorldPacket;
 
 enum OBJECT_UPDATE_TYPE
@@ -47,9 +51,15 @@ class UpdateData
         void AddOutOfRangeGUID(GuidSet& guids);
         void AddOutOfRangeGUID(ObjectGuid guid);
         void AddUpdateBlock(const ByteBuffer &block);
+        void AddUpdateBlock(uint8 const* block, std::size_t size);
         bool BuildPacket(WorldPacket* packet);
         bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
         void Clear();
+        void SetMapId(uint32 map) { m_map = map; }
+
+        // Direct access for writing a block in place, must be followed by AddUpdateBlock()
+        ByteBuffer& GetBlockBuffer() { return m_data; }
+        void AddUpdateBlock() { m_data.ResetBitPos(); ++m_blockCount; }
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
@@ -63,4 +73,67 @@ class UpdateData
         UpdateData(UpdateData const& right) = delete;
         UpdateData& operator=(UpdateData const& right) = delete;
 };
+
+// Remembers where the values update block of the current object was first written
+// so viewers that would receive identical bytes get a copy instead of serializing again
+class SharedUpdateBlockCache
+{
+    public:
+        struct Block
+        {
+            Object const* Owner;
+            uint32 Key;
+            ByteBuffer const* Buffer;
+            std::size_t Pos;
+            std::size_t Size;
+        };
+
+        Block const* Find(Object const* owner, uint32 key) const;
+        void Add(Object const* owner, uint32 key, ByteBuffer const* buffer, std::size_t pos, std::size_t size);
+        void Clear() { _blocks.clear(); }
+
+    private:
+        std::vector<Block> _blocks;                         // blocks of a single object, reset when the next one is added
+};
+
+// Per viewer UpdateData collected during one Map::SendObjectUpdates pass.
+// Buffers and lookup table are kept between passes so steady state use does not allocate.
+class UpdateDataMap
+{
+    public:
+        struct Entry
+        {
+            Entry() : Viewer(nullptr), LastObject(nullptr), Data(0) { }
+
+            Player* Viewer;
+            Object const* LastObject;                       // last object that wrote a block for this viewer
+            UpdateData Data;
+        };
+
+        typedef std::vector<Entry*>::iterator iterator;
+
+        UpdateDataMap() : _mask(0) { }
+
+        Entry& GetEntry(Player* viewer, uint32 mapId);
+
+        iterator begin() { return _used.begin(); }
+        iterator end() { return _used.end(); }
+        bool empty() const { return _used.empty(); }
+
+        // releases all entries for reuse, keeps allocated storage
+        void Clear();
+
+        SharedUpdateBlockCache& GetBlockCache() { return _blockCache; }
+
+    private:
+        void Grow();
+        std::size_t FindSlot(Player const* viewer) const;
+
+        std::vector<std::unique_ptr<Entry>> _pool;
+        std::vector<Entry*> _used;
+        std::vector<Entry*> _slots;                         // open addressing table indexed by viewer pointer hash
+        std::size_t _mask;
+
+        SharedUpdateBlockCache _blockCache;
+};
 #endif
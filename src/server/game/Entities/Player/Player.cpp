@@ -3763,6 +3763,15 @@ UF::UpdateFieldFlag Player::GetUpdateFieldFlagsFor(Player const* target) const
     return flags;
 }
 
+bool Player::GetValuesUpdateShareKey(Player const* target, uint32& key) const
+{
+    // ActivePlayerData is only sent to ourselves
+    if (target == this)
+        return false;
+
+    return Unit::GetValuesUpdateShareKey(target, key);
+}
+
 void Player::BuildValuesCreate(ByteBuffer* data, Player const* target) const
 {
     UF::UpdateFieldFlag flags = GetUpdateFieldFlagsFor(target);
@@ -24414,6 +24423,82 @@ bool Player::HaveAtClient(Object const* u) const
     return u == this || m_clientGUIDs.find(u->GetGUID()) != m_clientGUIDs.end();
 }
 
+bool Player::IsVisibilityKeptOnRelocation(WorldObject const* target) const
+{
+    if (isNeedNotify(NOTIFY_VISIBILITY_STATE) || m_seer->isNeedNotify(NOTIFY_VISIBILITY_STATE) || target->isNeedNotify(NOTIFY_VISIBILITY_STATE))
+        return false;
+
+    // ghosts see around their corpse, stealth detection and vehicle accessories depend on more than the distance
+    if (isDead() || target->m_stealth.GetFlags() || target->m_invisibility.GetFlags())
+        return false;
+
+    if (Unit const* unit = target->ToUnit())
+        if (unit->GetVehicleBase())
+            return false;
+
+    // same bounds as the distance check of CanSeeOrDetect, without the combat reach when it can only widen them
+    float sightRange = GetSightRange(target);
+    float distSq = m_seer->GetExactDist2dSq(target);
+    if (HaveAtClient(target))
+        return distSq <= (sightRange + VISIBILITY_HYSTERESIS) * (sightRange + VISIBILITY_HYSTERESIS);
+
+    float maxDist = sightRange + m_seer->GetCombatReach() + target->GetCombatReach();
+    return distSq > maxDist * maxDist && !CanSeeFromAnyDistance(target);
+}
+
+bool Player::IsVisibilityWatched(WorldObject const* target) const
+{
+    // stealth detection, visibility distances of their own and vehicle accessories depend on more than the range of the target's cell
+    if (target->m_stealth.GetFlags() || target->m_invisibility.GetFlags())
+        return true;
+
+    if (target->IsVisibilityOverridden() || (target->isActiveObject() && !target->ToPlayer()))
+        return true;
+
+    // the cell ranges of the relocation scan only leave room for this much combat reach
+    if (target->GetCombatReach() > VISIBILITY_HYSTERESIS)
+        return true;
+
+    if (Unit const* unit = target->ToUnit())
+        if (unit->GetVehicleBase())
+            return true;
+
+    return false;
+}
+
+void Player::UpdateVisibilityWatch(WorldObject const* target)
+{
+    if (target == this)
+        return;
+
+    if (IsVisibilityWatched(target))
+        m_visibilityWatchGUIDs.insert(target->GetGUID());
+    else if (!m_visibilityWatchGUIDs.empty())
+        m_visibilityWatchGUIDs.erase(target->GetGUID());
+}
+
+bool Player::IsKeptAtClient(WorldObject const* target) const
+{
+    // ghosts see around their corpse
+    if (isDead())
+        return false;
+
+    WorldObject const* viewpoint = GetViewpoint();
+    if (!viewpoint)
+        viewpoint = this;
+
+    if (!viewpoint->IsWithinDist(target, GetSightRange(target) + VISIBILITY_HYSTERESIS, false))
+        return false;
+
+    if (Unit const* unit = target->ToUnit())
+        if (Unit const* vehicle = unit->GetVehicleBase())
+            if (!HaveAtClient(vehicle))
+                return false;
+
+    // only the distance may be out of bounds
+    return CanSeeOrDetect(target, false, false);
+}
+
 bool Player::IsNeverVisibleFor(WorldObject const* seer) const
 {
     if (Unit::IsNeverVisibleFor(seer))
@@ -24515,9 +24600,11 @@ inline void BeforeVisibilityDestroy<Creature>(Creature* t, Player* p)
 
 void Player::UpdateVisibilityOf(WorldObject* target)
 {
+    UpdateVisibilityWatch(target);
+
     if (HaveAtClient(target))
     {
-        if (!CanSeeOrDetect(target, false, true))
+        if (!CanSeeOrDetect(target, false, true) && !IsKeptAtClient(target))
         {
             if (target->GetTypeId() == TYPEID_UNIT)
                 BeforeVisibilityDestroy<Creature>(target->ToCreature(), this);
@@ -24603,9 +24690,11 @@ void Player::SendInitialVisiblePackets(Unit* target) const
 template<class T>
 void Player::UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow)
 {
+    UpdateVisibilityWatch(target);
+
     if (HaveAtClient(target))
     {
-        if (!CanSeeOrDetect(target, false, true))
+        if (!CanSeeOrDetect(target, false, true) && !IsKeptAtClient(target))
         {
             BeforeVisibilityDestroy<T>(target, this);
 
@@ -24647,7 +24736,7 @@ void Player::UpdateObjectVisibility(bool forced)
         return;
 
     if (!forced)
-        AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+        AddToNotify(NOTIFY_VISIBILITY_CHANGED | NOTIFY_VISIBILITY_STATE);
     else
     {
         Unit::UpdateObjectVisibility(true);
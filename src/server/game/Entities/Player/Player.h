@@ -26,6 +26,7 @@
 #include "DatabaseEnvFwd.h"
 #include "DBCEnums.h"
 #include "EquipementSet.h"
+#include "GridDefines.h"
 #include "GroupReference.h"
 #include "ItemDefines.h"
 #include "ItemEnchantmentMgr.h"
@@ -1961,6 +1962,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
     protected:
         UF::UpdateFieldFlag GetUpdateFieldFlagsFor(Player const* target) const override;
+        bool GetValuesUpdateShareKey(Player const* target, uint32& key) const override;
         void BuildValuesCreate(ByteBuffer* data, Player const* target) const override;
         void BuildValuesUpdate(ByteBuffer* data, Player const* target) const override;
         void ClearUpdateMask(bool remove) override;
@@ -2339,7 +2341,28 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         GuidUnorderedSet m_clientGUIDs;
         GuidUnorderedSet m_visibleTransports;
 
+        // viewpoint and cell area of the last relocation scan, the next one only visits the cells the move can change, see Trinity::PlayerRelocationNotifier
+        struct VisibilityScan
+        {
+            ObjectGuid Seer;
+            uint32 MapId = 0;
+            uint32 InstanceId = 0;
+            float X = 0.0f;
+            float Y = 0.0f;
+            float SightRange = 0.0f;                    // 0 until the first full scan
+            CellCoord LowCell;
+            CellCoord HighCell;
+        } m_visibilityScan;
+
+        // objects whose visibility can change without their cell changing its range (stealth, own visibility distance, vehicle passengers)
+        GuidUnorderedSet m_visibilityWatchGUIDs;
+
         bool HaveAtClient(Object const* u) const;
+        // true if target only moved relative to the viewpoint and not enough to be shown or hidden, UpdateVisibilityOf would do nothing
+        bool IsVisibilityKeptOnRelocation(WorldObject const* target) const;
+        bool IsVisibilityWatched(WorldObject const* target) const;
+        // visibility depending on player state changed without a notify (quest status, spawn conditions), the next relocation scan checks everything around
+        void RequestVisibilityRescan() { AddToNotify(NOTIFY_VISIBILITY_CHANGED | NOTIFY_VISIBILITY_STATE); }
 
         bool IsNeverVisibleFor(WorldObject const* seer) const override;
 
@@ -2353,6 +2376,9 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         template<class T>
         void UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow);
+        // objects at client are kept VISIBILITY_HYSTERESIS beyond the sight range so they don't flicker in and out at its edge
+        bool IsKeptAtClient(WorldObject const* target) const;
+        void UpdateVisibilityWatch(WorldObject const* target);
 
         uint8 m_forced_speed_changes[MAX_MOVE_TYPE];
         uint8 m_movementForceModMagnitudeChanges;
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AuraStore_h__
+#define AuraStore_h__
+
+#include "Define.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class AuraStore
+ *
+ * @brief Keyed aura container of Unit, stored in one vector in insertion order.
+ *
+ * Exposes the subset of the std::multimap interface Unit and scripts use. Iterators are
+ * indexes into the vector so they survive insertion, erase only clears the slot. Like
+ * multimap iterators they stay valid until the element they point to is erased.
+ * Iterators returned by find, lower_bound and equal_range only visit elements of that key.
+ *
+ * Erased slots are dropped from the end of the vector right away and from the middle
+ * by Compact, which the owner calls at a point where nothing iterates the store.
+ */
+template<typename Key, typename T>
+class AuraStore
+{
+    static_assert(std::is_pointer<T>::value, "erased slots are marked by a null value");
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key, T> value_type;
+    typedef std::size_t size_type;
+
+    template<bool Const>
+    class Iterator
+    {
+        friend class AuraStore;
+        template<bool> friend class Iterator;
+
+        typedef typename std::conditional<Const, AuraStore const, AuraStore>::type Store;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename AuraStore::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, value_type const*, value_type*>::type pointer;
+        typedef typename std::conditional<Const, value_type const&, value_type&>::type reference;
+
+        Iterator() : _store(nullptr), _index(npos), _keyed(false), _key() { }
+
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        Iterator(Iterator<OtherConst> const& other) : _store(other._store), _index(other._index), _keyed(other._keyed), _key(other._key) { }
+
+        reference operator*() const { return _store->_slots[_index]; }
+        pointer operator->() const { return &_store->_slots[_index]; }
+
+        Iterator& operator++()
+        {
+            if (_index != npos)
+                _index = _keyed ? _store->FindNext(_index + 1, _key) : _store->FindNextLive(_index + 1);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator itr = *this;
+            ++*this;
+            return itr;
+        }
+
+        template<bool OtherConst>
+        bool operator==(Iterator<OtherConst> const& right) const { return _index == right._index; }
+
+        template<bool OtherConst>
+        bool operator!=(Iterator<OtherConst> const& right) const { return _index != right._index; }
+
+    private:
+        Iterator(Store* store, std::size_t index) : _store(store), _index(index), _keyed(false), _key() { }
+        Iterator(Store* store, std::size_t index, Key const& key) : _store(store), _index(index), _keyed(true), _key(key) { }
+
+        Store* _store;
+        std::size_t _index;
+        bool _keyed;                                        // advances to the next element of _key only
+        Key _key;
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    AuraStore() : _size(0) { }
+
+    iterator begin() { return iterator(this, FindNextLive(0)); }
+    const_iterator begin() const { return const_iterator(this, FindNextLive(0)); }
+    iterator end() { return iterator(this, npos); }
+    const_iterator end() const { return const_iterator(this, npos); }
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    iterator find(Key const& key) { return lower_bound(key); }
+    const_iterator find(Key const& key) const { return lower_bound(key); }
+    iterator lower_bound(Key const& key) { return iterator(this, FindNext(0, key), key); }
+    const_iterator lower_bound(Key const& key) const { return const_iterator(this, FindNext(0, key), key); }
+    iterator upper_bound(Key const& /*key*/) { return end(); }
+    const_iterator upper_bound(Key const& /*key*/) const { return end(); }
+    std::pair<iterator, iterator> equal_range(Key const& key) { return { lower_bound(key), end() }; }
+    std::pair<const_iterator, const_iterator> equal_range(Key const& key) const { return { lower_bound(key), end() }; }
+
+    size_type count(Key const& key) const
+    {
+        return std::count_if(_slots.begin(), _slots.end(), [&key](value_type const& slot) { return slot.second && slot.first == key; });
+    }
+
+    iterator insert(value_type const& value)
+    {
+        _slots.push_back(value);
+        ++_size;
+        return iterator(this, _slots.size() - 1);
+    }
+
+    iterator erase(const_iterator itr)
+    {
+        iterator next(this, itr._index);
+        next._keyed = itr._keyed;
+        next._key = itr._key;
+        ++next;
+
+        _slots[itr._index].second = nullptr;
+        --_size;
+
+        while (!_slots.empty() && !_slots.back().second)
+            _slots.pop_back();
+
+        return next;
+    }
+
+    void clear()
+    {
+        _slots.clear();
+        _size = 0;
+    }
+
+    // drops erased slots, invalidates all iterators
+    void Compact()
+    {
+        if (_slots.size() != _size)
+            _slots.erase(std::remove_if(_slots.begin(), _slots.end(), [](value_type const& slot) { return !slot.second; }), _slots.end());
+    }
+
+private:
+    std::size_t FindNextLive(std::size_t index) const
+    {
+        for (; index < _slots.size(); ++index)
+            if (_slots[index].second)
+                return index;
+
+        return npos;
+    }
+
+    std::size_t FindNext(std::size_t index, Key const& key) const
+    {
+        for (; index < _slots.size(); ++index)
+            if (_slots[index].second && _slots[index].first == key)
+                return index;
+
+        return npos;
+    }
+
+    std::vector<value_type> _slots;
+    size_type _size;
+};
+
+#endif // AuraStore_h__
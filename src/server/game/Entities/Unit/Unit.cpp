@@ -291,7 +291,7 @@ Unit::Unit(bool isWorldObject) :
     IsAIEnabled(false), NeedChangeAI(false), LastCharmerGUID(),
     m_ControlledByPlayer(false), movespline(new Movement::MoveSpline()),
     i_AI(nullptr), i_disabledAI(nullptr), m_AutoRepeatFirstCast(false), m_procDeep(0),
-    m_removedAurasCount(0), i_motionMaster(new MotionMaster(this)), m_regenTimer(0), m_ThreatManager(this),
+    m_procAurasTypeMask(0), m_procAurasGeneration(0), m_removedAurasCount(0), i_motionMaster(new MotionMaster(this)), m_regenTimer(0), m_ThreatManager(this),
     m_vehicle(nullptr), m_vehicleKit(nullptr), m_unitTypeMask(UNIT_MASK_NONE),
     m_HostileRefManager(this), _aiAnimKitId(0), _movementAnimKitId(0), _meleeAnimKitId(0),
     _spellHistory(new SpellHistory(this)), _scheduler(this)
@@ -326,6 +326,7 @@ Unit::Unit(bool isWorldObject) :
         m_ObjectSlot[i].Clear();
 
     m_auraUpdateIterator = m_ownedAuras.end();
+    m_modAurasTotals.fill({ 0, 1.0f, 0, 0 });
 
     m_interruptMask.fill(0);
     m_transform = 0;
@@ -1884,7 +1885,7 @@ void Unit::CalcAbsorbResist(DamageInfo& damageInfo)
     // We're going to call functions which can modify content of the list during iteration over it's elements
     // Let's copy the list so we can prevent iterator invalidation
     AuraEffectList vSchoolAbsorbCopy(damageInfo.GetVictim()->GetAuraEffectsByType(SPELL_AURA_SCHOOL_ABSORB));
-    vSchoolAbsorbCopy.sort(Trinity::AbsorbAuraOrderPred());
+    std::stable_sort(vSchoolAbsorbCopy.begin(), vSchoolAbsorbCopy.end(), Trinity::AbsorbAuraOrderPred());
 
     // absorb without mana cost
     for (AuraEffectList::iterator itr = vSchoolAbsorbCopy.begin(); (itr != vSchoolAbsorbCopy.end()) && (damageInfo.GetDamage() > 0); ++itr)
@@ -2054,8 +2055,10 @@ void Unit::CalcHealAbsorb(HealInfo& healInfo) const
     // Need remove expired auras after
     bool existExpired = false;
 
+    // ChangeAmount re-registers the effect at the end of the list, iterate over a copy
+    AuraEffectList vHealAbsorb(healInfo.GetTarget()->GetAuraEffectsByType(SPELL_AURA_SCHOOL_HEAL_ABSORB));
+
     // absorb without mana cost
-    AuraEffectList const& vHealAbsorb = healInfo.GetTarget()->GetAuraEffectsByType(SPELL_AURA_SCHOOL_HEAL_ABSORB);
     for (AuraEffectList::const_iterator i = vHealAbsorb.begin(); i != vHealAbsorb.end() && healInfo.GetHeal() > 0; ++i)
     {
         if (!((*i)->GetMiscValue() & healInfo.GetSpellInfo()->SchoolMask))
@@ -2087,17 +2090,11 @@ void Unit::CalcHealAbsorb(HealInfo& healInfo) const
     // Remove all expired absorb auras
     if (existExpired)
     {
-        for (AuraEffectList::const_iterator i = vHealAbsorb.begin(); i != vHealAbsorb.end();)
+        for (AuraEffect* auraEff : vHealAbsorb)
         {
-            AuraEffect* auraEff = *i;
-            ++i;
-            if (auraEff->GetAmount() <= 0)
-            {
-                uint32 removedAuras = healInfo.GetTarget()->m_removedAurasCount;
+            // Check if aura was removed by a previous removal
+            if (auraEff->GetAmount() <= 0 && auraEff->GetBase()->GetApplicationOfTarget(healInfo.GetTarget()->GetGUID()))
                 auraEff->GetBase()->Remove(AURA_REMOVE_BY_ENEMY_SPELL);
-                if (removedAuras + 1 < healInfo.GetTarget()->m_removedAurasCount)
-                    i = vHealAbsorb.begin();
-            }
         }
     }
 }
@@ -3003,6 +3000,11 @@ void Unit::_UpdateSpells(uint32 time)
 
     _DeleteRemovedAuras();
 
+    // nothing iterates the aura stores here, drop the slots of removed auras
+    m_ownedAuras.Compact();
+    m_appliedAuras.Compact();
+    m_auraStateAuras.Compact();
+
     if (!m_gameObj.empty())
     {
         GameObjectList::iterator itr;
@@ -3492,6 +3494,7 @@ AuraApplication * Unit::_CreateAuraApplication(Aura* aura, uint32 effMask)
 
     AuraApplication * aurApp = new AuraApplication(this, caster, aura, effMask);
     m_appliedAuras.insert(AuraApplicationMap::value_type(aurId, aurApp));
+    _AddProcAura(aurApp);
 
     if (caster)
         caster->RegisterTargetAura(aurApp);
@@ -3587,6 +3590,7 @@ void Unit::_UnapplyAura(AuraApplicationMap::iterator &i, AuraRemoveMode removeMo
 
     // Remove all pointers from lists here to prevent possible pointer invalidation on spellcast/auraapply/auraremove
     m_appliedAuras.erase(i);
+    _RemoveProcAura(aurApp);
     if (caster)
         caster->UnregisterTargetAura(aurApp);
 
@@ -3720,10 +3724,29 @@ void Unit::_RemoveNoStackAurasDueToAura(Aura* aura)
 
 void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
 {
+    AuraEffectList& auraEffects = m_modAuras[aurEff->GetAuraType()];
     if (apply)
-        m_modAuras[aurEff->GetAuraType()].push_back(aurEff);
+        auraEffects.push_back(aurEff);
     else
-        m_modAuras[aurEff->GetAuraType()].remove(aurEff);
+    {
+        // keep the order of the remaining effects, handlers and scripts take front() as the oldest one
+        auto itr = std::find(auraEffects.begin(), auraEffects.end(), aurEff);
+        if (itr != auraEffects.end())
+            auraEffects.erase(itr);
+    }
+
+    _UpdateAuraModifierTotals(aurEff->GetAuraType());
+}
+
+void Unit::_UpdateAuraModifierTotals(AuraType auraType)
+{
+    auto const allEffects = [](AuraEffect const* /*aurEff*/) { return true; };
+
+    AuraModifierTotals& totals = m_modAurasTotals[auraType];
+    totals.Modifier = GetTotalAuraModifier(auraType, allEffects);
+    totals.Multiplier = GetTotalAuraMultiplier(auraType, allEffects);
+    totals.MaxPositiveModifier = GetMaxPositiveAuraModifier(auraType, allEffects);
+    totals.MaxNegativeModifier = GetMaxNegativeAuraModifier(auraType, allEffects);
 }
 
 // All aura base removes should go threw this function!
@@ -3992,14 +4015,19 @@ void Unit::RemoveAurasByType(AuraType auraType, std::function<bool(AuraApplicati
         AuraApplication * aurApp = aura->GetApplicationOfTarget(GetGUID());
         ASSERT(aurApp);
 
-        ++iter;
         if (check(aurApp))
         {
+            // removal shifts the rest of the list, start over (auras already being removed are left in place)
             uint32 removedAuras = m_removedAurasCount;
             RemoveAura(aurApp);
-            if (m_removedAurasCount > removedAuras + 1)
+            if (m_removedAurasCount != removedAuras)
+            {
                 iter = m_modAuras[auraType].begin();
+                continue;
+            }
         }
+
+        ++iter;
     }
 }
 
@@ -4162,15 +4190,20 @@ void Unit::RemoveAurasByType(AuraType auraType, ObjectGuid casterGUID, Aura* exc
         AuraApplication * aurApp = aura->GetApplicationOfTarget(GetGUID());
         ASSERT(aurApp);
 
-        ++iter;
         if (aura != except && (!casterGUID || aura->GetCasterGUID() == casterGUID)
             && ((negative && !aurApp->IsPositive()) || (positive && aurApp->IsPositive())))
         {
+            // removal shifts the rest of the list, start over (auras already being removed are left in place)
             uint32 removedAuras = m_removedAurasCount;
             RemoveAura(aurApp);
-            if (m_removedAurasCount > removedAuras + 1)
+            if (m_removedAurasCount != removedAuras)
+            {
                 iter = m_modAuras[auraType].begin();
+                continue;
+            }
         }
+
+        ++iter;
     }
 }
 
@@ -5022,22 +5055,22 @@ int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype, std::function<bool(Aur
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    return GetTotalAuraModifier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    return m_modAurasTotals[auratype].Modifier;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    return GetTotalAuraMultiplier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    return m_modAurasTotals[auratype].Multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    return GetMaxPositiveAuraModifier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    return m_modAurasTotals[auratype].MaxPositiveModifier;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    return GetMaxNegativeAuraModifier(auratype, [](AuraEffect const* /*aurEff*/) { return true; });
+    return m_modAurasTotals[auratype].MaxNegativeModifier;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 miscMask) const
@@ -11101,14 +11134,96 @@ void Unit::GetProcAurasTriggeredOnEvent(AuraApplicationProcContainer& aurasTrigg
     // or generate one on our own
     else
     {
-        for (AuraApplicationMap::iterator itr = GetAppliedAuras().begin(); itr != GetAppliedAuras().end(); ++itr)
+        // candidates are collected first, preparing a proc may apply or remove auras
+        std::size_t first = aurasTriggeringProc.size();
+        GetProcAuraCandidates(aurasTriggeringProc, eventInfo);
+
+        std::size_t triggering = first;
+        for (std::size_t i = first; i < aurasTriggeringProc.size(); ++i)
         {
-            if (uint32 procEffectMask = itr->second->GetBase()->GetProcEffectMask(itr->second, eventInfo, now))
+            AuraApplication* aurApp = aurasTriggeringProc[i].second;
+            if (aurApp->GetRemoveMode())
+                continue;
+
+            if (uint32 procEffectMask = aurApp->GetBase()->GetProcEffectMask(aurApp, eventInfo, now))
             {
-                itr->second->GetBase()->PrepareProcToTrigger(itr->second, eventInfo, now);
-                aurasTriggeringProc.emplace_back(procEffectMask, itr->second);
+                aurApp->GetBase()->PrepareProcToTrigger(aurApp, eventInfo, now);
+                aurasTriggeringProc[triggering++] = std::make_pair(procEffectMask, aurApp);
             }
         }
+
+        aurasTriggeringProc.resize(triggering);
+    }
+}
+
+void Unit::GetProcAuraCandidates(AuraApplicationProcContainer& candidates, ProcEventInfo const& eventInfo)
+{
+    if (m_procAurasGeneration != sSpellMgr->GetSpellProcGeneration())
+        _RebuildProcAuras();
+
+    if (!(m_procAurasTypeMask & eventInfo.GetTypeMask()))
+        return;
+
+    for (ProcAuraIndexEntry const& entry : m_procAuras)
+        if (SpellMgr::CanSpellTriggerProcOnEventMasks(*entry.ProcEntry, eventInfo))
+            candidates.emplace_back(0, entry.Application);
+}
+
+void Unit::_AddProcAura(AuraApplication* aurApp)
+{
+    // the application is already in m_appliedAuras
+    if (m_procAurasGeneration != sSpellMgr->GetSpellProcGeneration())
+    {
+        _RebuildProcAuras();
+        return;
+    }
+
+    SpellProcEntry const* procEntry = sSpellMgr->GetSpellProcEntry(aurApp->GetBase()->GetSpellInfo());
+    if (!procEntry)
+        return;
+
+    // same position as in m_appliedAuras, which is in application order
+    m_procAuras.push_back({ aurApp->GetBase()->GetId(), aurApp, procEntry });
+    m_procAurasTypeMask |= procEntry->ProcFlags;
+}
+
+void Unit::_RemoveProcAura(AuraApplication* aurApp)
+{
+    // the application is no longer in m_appliedAuras
+    if (m_procAurasGeneration != sSpellMgr->GetSpellProcGeneration())
+    {
+        _RebuildProcAuras();
+        return;
+    }
+
+    auto itr = std::find_if(m_procAuras.begin(), m_procAuras.end(), [aurApp](ProcAuraIndexEntry const& entry)
+    {
+        return entry.Application == aurApp;
+    });
+
+    if (itr == m_procAuras.end())
+        return;
+
+    m_procAuras.erase(itr);
+
+    m_procAurasTypeMask = 0;
+    for (ProcAuraIndexEntry const& entry : m_procAuras)
+        m_procAurasTypeMask |= entry.ProcEntry->ProcFlags;
+}
+
+void Unit::_RebuildProcAuras()
+{
+    m_procAuras.clear();
+    m_procAurasTypeMask = 0;
+    m_procAurasGeneration = sSpellMgr->GetSpellProcGeneration();
+
+    for (auto const& appliedAura : m_appliedAuras)
+    {
+        if (SpellProcEntry const* procEntry = sSpellMgr->GetSpellProcEntry(appliedAura.second->GetBase()->GetSpellInfo()))
+        {
+            m_procAuras.push_back({ appliedAura.first, appliedAura.second, procEntry });
+            m_procAurasTypeMask |= procEntry->ProcFlags;
+        }
     }
 }
 
@@ -11132,11 +11247,14 @@ void Unit::TriggerAurasProcOnEvent(AuraApplicationList* myProcAuras, AuraApplica
         {
             if (modOwner != this && spell)
             {
+                AuraApplicationProcContainer modOwnerProcAuras;
+                modOwner->GetProcAuraCandidates(modOwnerProcAuras, myProcEventInfo);
+
                 AuraApplicationList modAuras;
-                for (auto itr = modOwner->GetAppliedAuras().begin(); itr != modOwner->GetAppliedAuras().end(); ++itr)
+                for (auto const& modOwnerProcAura : modOwnerProcAuras)
                 {
-                    if (spell->m_appliedMods.count(itr->second->GetBase()) != 0)
-                        modAuras.push_back(itr->second);
+                    if (spell->m_appliedMods.count(modOwnerProcAura.second->GetBase()) != 0)
+                        modAuras.push_back(modOwnerProcAura.second);
                 }
                 modOwner->GetProcAurasTriggeredOnEvent(myAurasTriggeringProc, &modAuras, myProcEventInfo);
             }
@@ -13001,13 +13119,13 @@ void Unit::SendPlaySpellVisualKit(uint32 id, uint32 type, uint32 duration) const
 void Unit::CancelSpellMissiles(uint32 spellId, bool reverseMissile /*= false*/)
 {
     bool hasMissile = false;
-    for (std::pair<uint64 const, BasicEvent*> const& itr : m_Events.GetEvents())
+    for (EventProcessor::QueuedEvent const& itr : m_Events.GetEvents())
     {
-        if (Spell const* spell = Spell::ExtractSpellFromEvent(itr.second))
+        if (Spell const* spell = Spell::ExtractSpellFromEvent(itr.Event))
         {
             if (spell->GetSpellInfo()->Id == spellId)
             {
-                itr.second->ScheduleAbort();
+                itr.Event->ScheduleAbort();
                 hasMissile = true;
             }
         }
@@ -13115,7 +13233,7 @@ void Unit::OnPhaseChange()
 void Unit::UpdateObjectVisibility(bool forced)
 {
     if (!forced)
-        AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+        AddToNotify(NOTIFY_VISIBILITY_CHANGED | NOTIFY_VISIBILITY_STATE);
     else
     {
         WorldObject::UpdateObjectVisibility(true);
@@ -13125,6 +13243,18 @@ void Unit::UpdateObjectVisibility(bool forced)
     }
 }
 
+void Unit::UpdateObjectVisibilityOnRelocation()
+{
+    // creatures around check for aggro on every move
+    AddToNotify(NOTIFY_AI_RELOCATION);
+
+    // small moves add up until they are worth checking everything around again
+    if (GetExactDistSq(_visibilityNotifyPosition) < VISIBILITY_NOTIFY_DISTANCE * VISIBILITY_NOTIFY_DISTANCE)
+        return;
+
+    AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+}
+
 void Unit::SendMoveKnockBack(Player* player, float speedXY, float speedZ, float vcos, float vsin)
 {
     WorldPackets::Movement::MoveKnockBack moveKnockBack;
@@ -14968,6 +15098,20 @@ UF::UpdateFieldFlag Unit::GetUpdateFieldFlagsFor(Player const* target) const
     return flags;
 }
 
+bool Unit::GetValuesUpdateShareKey(Player const* target, uint32& key) const
+{
+    // DisplayID, FactionTemplate, Flags, Flags2, Flags3, AuraState, PvpFlags, NpcFlags
+    if (m_values.HasChanged(TYPEID_UNIT))
+    {
+        UF::UnitData::Mask const& changesMask = m_unitData->GetChangesMask();
+        if (changesMask[5] || changesMask[41] || changesMask[42] || changesMask[43] || changesMask[44] || changesMask[45]
+            || changesMask[78] || changesMask[116] || changesMask[117])
+            return false;
+    }
+
+    return WorldObject::GetValuesUpdateShareKey(target, key);
+}
+
 void Unit::BuildValuesCreate(ByteBuffer* data, Player const* target) const
 {
     UF::UpdateFieldFlag flags = GetUpdateFieldFlagsFor(target);
@@ -15145,10 +15289,10 @@ bool Unit::IsHighestExclusiveAura(Aura const* aura, bool removeOtherAuraApplicat
                     {
                         if (AuraApplication* aurApp = existingAurEff->GetBase()->GetApplicationOfTarget(GetGUID()))
                         {
-                            bool hasMoreThanOneEffect = base->HasMoreThanOneEffectForType(auraType);
+                            // removal shifts the rest of the list, start over
                             uint32 removedAuras = m_removedAurasCount;
                             RemoveAura(aurApp);
-                            if (hasMoreThanOneEffect || m_removedAurasCount > removedAuras + 1)
+                            if (m_removedAurasCount != removedAuras)
                                 itr = auras.begin();
                         }
                     }
@@ -19,6 +19,7 @@
 #define __UNIT_H
 
 #include "Object.h"
+#include "AuraStore.h"
 #include "EventProcessor.h"
 #include "FollowerReference.h"
 #include "FollowerRefManager.h"
@@ -193,6 +194,7 @@ struct FactionTemplateEntry;
 struct LiquidData;
 struct LiquidTypeEntry;
 struct MountCapabilityEntry;
+struct SpellProcEntry;
 struct SpellValue;
 
 class Aura;
@@ -930,18 +932,19 @@ class TC_GAME_API Unit : public WorldObject
         typedef std::set<Unit*> ControlList;
         typedef std::vector<Unit*> UnitVector;
 
-        typedef std::multimap<uint32, Aura*> AuraMap;
+        // keyed by spell id, iterated in the order the auras were added
+        typedef AuraStore<uint32, Aura*> AuraMap;
         typedef std::pair<AuraMap::const_iterator, AuraMap::const_iterator> AuraMapBounds;
         typedef std::pair<AuraMap::iterator, AuraMap::iterator> AuraMapBoundsNonConst;
 
-        typedef std::multimap<uint32,  AuraApplication*> AuraApplicationMap;
+        typedef AuraStore<uint32, AuraApplication*> AuraApplicationMap;
         typedef std::pair<AuraApplicationMap::const_iterator, AuraApplicationMap::const_iterator> AuraApplicationMapBounds;
         typedef std::pair<AuraApplicationMap::iterator, AuraApplicationMap::iterator> AuraApplicationMapBoundsNonConst;
 
-        typedef std::multimap<AuraStateType,  AuraApplication*> AuraStateAurasMap;
+        typedef AuraStore<AuraStateType, AuraApplication*> AuraStateAurasMap;
         typedef std::pair<AuraStateAurasMap::const_iterator, AuraStateAurasMap::const_iterator> AuraStateAurasMapBounds;
 
-        typedef std::list<AuraEffect*> AuraEffectList;
+        typedef std::vector<AuraEffect*> AuraEffectList;   // kept in application order, see _RegisterAuraEffect
         typedef std::list<Aura*> AuraList;
         typedef std::list<AuraApplication *> AuraApplicationList;
         typedef std::array<DiminishingReturn, DIMINISHING_MAX> Diminishing;
@@ -1225,6 +1228,8 @@ class TC_GAME_API Unit : public WorldObject
                                 DamageInfo* damageInfo, HealInfo* healInfo);
 
         void GetProcAurasTriggeredOnEvent(AuraApplicationProcContainer& aurasTriggeringProc, AuraApplicationList* procAuras, ProcEventInfo& eventInfo);
+        // appends the applied auras whose spell_proc entry matches the masks of the event, with an empty effect mask
+        void GetProcAuraCandidates(AuraApplicationProcContainer& candidates, ProcEventInfo const& eventInfo);
         void TriggerAurasProcOnEvent(CalcDamageInfo& damageInfo);
         void TriggerAurasProcOnEvent(AuraApplicationList* myProcAuras, AuraApplicationList* targetProcAuras,
                                      Unit* actionTarget, uint32 typeMaskActor, uint32 typeMaskActionTarget,
@@ -1551,6 +1556,7 @@ class TC_GAME_API Unit : public WorldObject
         void _UnapplyAura(AuraApplication * aurApp, AuraRemoveMode removeMode);
         void _RemoveNoStackAurasDueToAura(Aura* aura);
         void _RegisterAuraEffect(AuraEffect* aurEff, bool apply);
+        void _UpdateAuraModifierTotals(AuraType auraType);
 
         // m_ownedAuras container management
         AuraMap      & GetOwnedAuras()       { return m_ownedAuras; }
@@ -1843,6 +1849,9 @@ class TC_GAME_API Unit : public WorldObject
         // common function for visibility checks for player/creatures with detection code
         void OnPhaseChange();
         void UpdateObjectVisibility(bool forced = true) override;
+        // marks the unit for the AI part of the next relocation notify, and for all of it once it moved VISIBILITY_NOTIFY_DISTANCE since the last one
+        void UpdateObjectVisibilityOnRelocation();
+        void ResetVisibilityNotifyPosition() { _visibilityNotifyPosition.Relocate(this); }
 
         SpellImmuneContainer m_spellImmune[MAX_SPELL_IMMUNITY];
         uint32 m_lastSanctuaryTime;
@@ -2138,6 +2147,7 @@ class TC_GAME_API Unit : public WorldObject
         explicit Unit (bool isWorldObject);
 
         UF::UpdateFieldFlag GetUpdateFieldFlagsFor(Player const* target) const override;
+        bool GetValuesUpdateShareKey(Player const* target, uint32& key) const override;
         void BuildValuesCreate(ByteBuffer* data, Player const* target) const override;
         void BuildValuesUpdate(ByteBuffer* data, Player const* target) const override;
 
@@ -2184,6 +2194,23 @@ class TC_GAME_API Unit : public WorldObject
 
         AuraMap m_ownedAuras;
         AuraApplicationMap m_appliedAuras;
+
+        // Applied auras having a spell_proc entry, in the order of m_appliedAuras, so events skip the auras which can never proc
+        struct ProcAuraIndexEntry
+        {
+            uint32 SpellId;
+            AuraApplication* Application;
+            SpellProcEntry const* ProcEntry;
+        };
+
+        void _AddProcAura(AuraApplication* aurApp);
+        void _RemoveProcAura(AuraApplication* aurApp);
+        void _RebuildProcAuras();
+
+        std::vector<ProcAuraIndexEntry> m_procAuras;
+        uint32 m_procAurasTypeMask;             // ProcFlags of all entries of m_procAuras
+        uint32 m_procAurasGeneration;           // SpellMgr::GetSpellProcGeneration the entries were read from
+
         AuraList m_removedAuras;
         AuraMap::iterator m_auraUpdateIterator;
         uint32 m_removedAurasCount;
@@ -2191,6 +2218,19 @@ class TC_GAME_API Unit : public WorldObject
         TargetAuraContainer m_targetAuras;
 
         AuraEffectList m_modAuras[TOTAL_AURAS];
+
+        // Totals of all effects of an aura type as returned by the GetTotalAuraModifier family without predicate,
+        // recomputed when an effect of the type is registered, unregistered or changes amount
+        struct AuraModifierTotals
+        {
+            int32 Modifier;
+            float Multiplier;
+            int32 MaxPositiveModifier;
+            int32 MaxNegativeModifier;
+        };
+
+        std::array<AuraModifierTotals, TOTAL_AURAS> m_modAurasTotals;
+
         AuraList m_scAuras;                        // cast singlecast auras
         AuraApplicationList m_interruptableAuras;  // auras which have interrupt mask applied on unit
         AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
@@ -2284,6 +2324,8 @@ class TC_GAME_API Unit : public WorldObject
 
         std::unique_ptr<MovementForces> _movementForces;
 
+        Position _visibilityNotifyPosition;             ///< position when the last relocation notify was processed
+
         uint32 m_currentPetBattleId;
 
         std::unordered_map<ObjectGuid, uint32/*entry*/> m_SummonedCreatures;
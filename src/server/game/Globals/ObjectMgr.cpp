@@ -450,14 +450,13 @@ void ObjectMgr::LoadCreatureTemplates()
     stmt->setUInt32(0, 0);
     stmt->setUInt32(1, 1);
 
-    PreparedQueryResult result = WorldDatabase.Query(stmt);
+    StreamQueryResult result = WorldDatabase.StreamQuery(stmt);
     if (!result)
     {
         TC_LOG_INFO("server.loading", ">> Loaded 0 creature template definitions. DB table `creature_template` is empty.");
         return;
     }
 
-    _creatureTemplateStore.rehash(result->GetRowCount());
     do
     {
         Field* fields = result->Fetch();
@@ -2050,7 +2049,7 @@ void ObjectMgr::LoadCreatures()
     uint32 oldMSTime = getMSTime();
 
     //                                               0              1   2    3       4        5             6           7           8           9            10             11              12
-    QueryResult result = WorldDatabase.Query("SELECT creature.guid, id, map, areaId, modelid, equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, corpsetimesecs, spawndist, "
+    StreamQueryResult result = WorldDatabase.StreamQuery("SELECT creature.guid, id, map, areaId, modelid, equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, corpsetimesecs, spawndist, "
     //   12               14         15       16            17                 18          19          20                21                   22                    23
         "currentwaypoint, curhealth, curmana, MovementType, spawnDifficulties, eventEntry, pool_entry, creature.npcflag, creature.unit_flags, creature.unit_flags2, creature.unit_flags3, "
     //   24                     25                      26                27                   28                       29
@@ -2073,8 +2072,6 @@ void ObjectMgr::LoadCreatures()
 
     PhaseShift phaseShift;
 
-    _creatureDataStore.reserve(result->GetRowCount());
-
     WorldDatabaseTransaction updateAreaTransaction = WorldDatabase.BeginTransaction();
 
     do
@@ -2418,7 +2415,7 @@ void ObjectMgr::LoadGameobjects()
     uint32 oldMSTime = getMSTime();
 
     //                                                0                1   2   3       4           5           6           7
-    QueryResult result = WorldDatabase.Query("SELECT gameobject.guid, id, map, areaId, position_x, position_y, position_z, orientation, "
+    StreamQueryResult result = WorldDatabase.StreamQuery("SELECT gameobject.guid, id, map, areaId, position_x, position_y, position_z, orientation, "
     //   8          9          10          11         12             13            14    15                 16          17
         "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnDifficulties, eventEntry, pool_entry, "
     //   18             19       20          21              22        23
@@ -2440,8 +2437,6 @@ void ObjectMgr::LoadGameobjects()
 
     PhaseShift phaseShift;
 
-    _gameObjectDataStore.reserve(result->GetRowCount());
-
     WorldDatabaseTransaction updateAreaTransaction = WorldDatabase.BeginTransaction();
 
     do
@@ -4126,7 +4121,7 @@ void ObjectMgr::LoadQuests()
 
     _exclusiveQuestGroups.clear();
 
-    QueryResult result = WorldDatabase.Query("SELECT "
+    StreamQueryResult result = WorldDatabase.StreamQuery("SELECT "
         //0  1          2           3                    4                5               6         7            8            9                  10               11                  12
         "ID, QuestType, QuestLevel, ScalingFactionGroup, MaxScalingLevel, QuestPackageID, MinLevel, QuestSortID, QuestInfoID, SuggestedGroupNum, RewardNextQuest, RewardXPDifficulty, RewardXPMultiplier, "
         //13          14                     15                     16                17                   18                   19                   20           21           22               23
@@ -4239,7 +4234,7 @@ void ObjectMgr::LoadQuests()
 
     // Load `quest_visual_effect` join table with quest_objectives because visual effects are based on objective ID (core stores objectives by their index in quest)
     //                                   0     1     2          3        4
-    result = WorldDatabase.Query("SELECT v.ID, o.ID, o.QuestID, v.Index, v.VisualEffect FROM quest_visual_effect AS v LEFT JOIN quest_objectives AS o ON v.ID = o.ID ORDER BY v.Index DESC");
+    result = WorldDatabase.StreamQuery("SELECT v.ID, o.ID, o.QuestID, v.Index, v.VisualEffect FROM quest_visual_effect AS v LEFT JOIN quest_objectives AS o ON v.ID = o.ID ORDER BY v.Index DESC");
 
     if (!result)
     {
@@ -7308,7 +7303,7 @@ void ObjectMgr::LoadGameObjectTemplate()
     }
 
     //                                               0      1     2          3     4         5               6     7
-    QueryResult result = WorldDatabase.Query("SELECT entry, type, displayId, name, IconName, castBarCaption, unk1, size, "
+    StreamQueryResult result = WorldDatabase.StreamQuery("SELECT entry, type, displayId, name, IconName, castBarCaption, unk1, size, "
     //                                        8      9      10     11     12     13     14     15     16     17     18      19      20
                                              "Data0, Data1, Data2, Data3, Data4, Data5, Data6, Data7, Data8, Data9, Data10, Data11, Data12, "
     //                                        21      22      23      24      25      26      27      28      29      30      31      32      33      34      35      36
@@ -7323,7 +7318,6 @@ void ObjectMgr::LoadGameObjectTemplate()
         return;
     }
 
-    _gameObjectTemplateStore.rehash(result->GetRowCount());
     uint32 count = 0;
     do
     {
@@ -9711,6 +9705,7 @@ uint32 ObjectMgr::GetScriptIdOrAdd(std::string const& name)
     if (name.empty())
         return 0;
 
+    std::lock_guard<std::mutex> lock(_scriptNamesLock);
     ScriptNameContainer::const_iterator itr = std::find(_scriptNamesStore.begin(), _scriptNamesStore.end(), name);
     if (itr == _scriptNamesStore.end() || *itr != name)
     {
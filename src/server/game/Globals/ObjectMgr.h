@@ -35,6 +35,7 @@
 #include "Trainer.h"
 #include "VehicleDefines.h"
 #include <map>
+#include <mutex>
 #include <unordered_map>
 
 class Item;
@@ -1801,6 +1802,7 @@ class TC_GAME_API ObjectMgr
         GameTeleContainer _gameTeleStore;
 
         ScriptNameContainer _scriptNamesStore;
+        std::mutex _scriptNamesLock;                        // script names are added by loaders running concurrently
 
         SpellClickInfoContainer _spellClickInfoStore;
 
@@ -23,6 +23,7 @@
 #include "Transport.h"
 #include "ObjectAccessor.h"
 #include "CellImpl.h"
+#include <algorithm>
 
 using namespace Trinity;
 
@@ -144,6 +145,192 @@ inline void CreatureUnitRelocationWorker(Creature* c, Unit* u)
     }
 }
 
+namespace
+{
+    bool IsFullVisibilityScanNeeded(Player const& player)
+    {
+        WorldObject const* viewPoint = player.m_seer;
+        Player::VisibilityScan const& scan = player.m_visibilityScan;
+
+        // nothing to compare with
+        if (scan.SightRange == 0.0f || scan.Seer != viewPoint->GetGUID() || scan.MapId != viewPoint->GetMapId() || scan.InstanceId != viewPoint->GetInstanceId())
+            return true;
+
+        // changed more than positions, ghosts see around their corpse
+        if (player.isNeedNotify(NOTIFY_VISIBILITY_STATE) || viewPoint->isNeedNotify(NOTIFY_VISIBILITY_STATE) || player.isDead())
+            return true;
+
+        if (player.GetSightRange() != scan.SightRange)
+            return true;
+
+        // objects that were hidden without a notify are caught by the full scan on entering another grid
+        return Trinity::ComputeGridCoord(viewPoint->GetPositionX(), viewPoint->GetPositionY()) != Trinity::ComputeGridCoord(scan.X, scan.Y);
+    }
+
+    enum class CellSightRange
+    {
+        InRange,        // every object of the cell is close enough to be seen
+        OutOfRange,     // no object of the cell is close enough to be seen or kept at client
+        OnEdge
+    };
+
+    CellSightRange GetCellSightRange(CellCoord const& cell, float x, float y, float inRange, float outRange)
+    {
+        float minX = (int32(cell.x_coord) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+        float minY = (int32(cell.y_coord) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+        float maxX = minX + SIZE_OF_GRID_CELL;
+        float maxY = minY + SIZE_OF_GRID_CELL;
+
+        float nearX = std::max({ minX - x, 0.0f, x - maxX });
+        float nearY = std::max({ minY - y, 0.0f, y - maxY });
+        if (nearX * nearX + nearY * nearY > outRange * outRange)
+            return CellSightRange::OutOfRange;
+
+        float farX = std::max(std::abs(x - minX), std::abs(x - maxX));
+        float farY = std::max(std::abs(y - minY), std::abs(y - maxY));
+        if (farX * farX + farY * farY <= inRange * inRange)
+            return CellSightRange::InRange;
+
+        return CellSightRange::OnEdge;
+    }
+
+    bool IsCellInArea(uint32 x, uint32 y, CellCoord const& low, CellCoord const& high)
+    {
+        return x >= low.x_coord && x <= high.x_coord && y >= low.y_coord && y <= high.y_coord;
+    }
+}
+
+PlayerRelocationNotifier::PlayerRelocationNotifier(Player &player) : PlayerRelocationNotifier(player, IsFullVisibilityScanNeeded(player)) { }
+
+PlayerRelocationNotifier::PlayerRelocationNotifier(Player &player, bool fullScan) : VisibleNotifier(player, fullScan), i_fullScan(fullScan) { }
+
+void PlayerRelocationNotifier::VisitSightRange(float radius)
+{
+    WorldObject const* viewPoint = i_player.m_seer;
+
+    if (i_fullScan)
+        Cell::VisitAllObjects(viewPoint, *this, radius, false);
+    else
+    {
+        VisitChangedCells(radius);
+        VisitWatched();
+    }
+
+    CellArea area = Cell::CalculateCellArea(viewPoint->GetPositionX(), viewPoint->GetPositionY(), std::min(radius + viewPoint->GetCombatReach(), SIZE_OF_GRIDS));
+
+    Player::VisibilityScan& scan = i_player.m_visibilityScan;
+    scan.Seer = viewPoint->GetGUID();
+    scan.MapId = viewPoint->GetMapId();
+    scan.InstanceId = viewPoint->GetInstanceId();
+    scan.X = viewPoint->GetPositionX();
+    scan.Y = viewPoint->GetPositionY();
+    scan.SightRange = i_player.GetSightRange();
+    scan.LowCell = area.low_bound;
+    scan.HighCell = area.high_bound;
+}
+
+void PlayerRelocationNotifier::VisitChangedCells(float radius)
+{
+    WorldObject const* viewPoint = i_player.m_seer;
+    Player::VisibilityScan const& scan = i_player.m_visibilityScan;
+    Map& map = *i_player.GetMap();
+
+    float x = viewPoint->GetPositionX();
+    float y = viewPoint->GetPositionY();
+    CellArea area = Cell::CalculateCellArea(x, y, std::min(radius + viewPoint->GetCombatReach(), SIZE_OF_GRIDS));
+
+    // watched objects aside, nothing with a combat reach above the hysteresis is decided by its cell
+    float inRange = scan.SightRange;
+    float outRange = scan.SightRange + 2 * VISIBILITY_HYSTERESIS + viewPoint->GetCombatReach();
+
+    TypeContainerVisitor<PlayerRelocationNotifier, WorldTypeMapContainer> worldVisitor(*this);
+    TypeContainerVisitor<PlayerRelocationNotifier, GridTypeMapContainer> gridVisitor(*this);
+
+    PlayerRelocationObserverNotifier observer(i_player);
+    TypeContainerVisitor<PlayerRelocationObserverNotifier, WorldTypeMapContainer> observerVisitor(observer);
+
+    uint32 lowX = std::min(area.low_bound.x_coord, scan.LowCell.x_coord);
+    uint32 lowY = std::min(area.low_bound.y_coord, scan.LowCell.y_coord);
+    uint32 highX = std::max(area.high_bound.x_coord, scan.HighCell.x_coord);
+    uint32 highY = std::max(area.high_bound.y_coord, scan.HighCell.y_coord);
+
+    for (uint32 cellX = lowX; cellX <= highX; ++cellX)
+    {
+        for (uint32 cellY = lowY; cellY <= highY; ++cellY)
+        {
+            bool inNewArea = IsCellInArea(cellX, cellY, area.low_bound, area.high_bound);
+            bool inOldArea = IsCellInArea(cellX, cellY, scan.LowCell, scan.HighCell);
+            if (!inNewArea && !inOldArea)
+                continue;
+
+            CellCoord cellCoord(cellX, cellY);
+            CellSightRange now = inNewArea ? GetCellSightRange(cellCoord, x, y, inRange, outRange) : CellSightRange::OutOfRange;
+            CellSightRange before = inOldArea ? GetCellSightRange(cellCoord, scan.X, scan.Y, inRange, outRange) : CellSightRange::OutOfRange;
+
+            Cell cell(cellCoord);
+            if (now == CellSightRange::OutOfRange)
+                cell.SetNoCreate();
+
+            // entered or left the sight range, or still crossed by its edge
+            if (now == CellSightRange::OnEdge || now != before)
+            {
+                map.Visit(cell, worldVisitor);
+                map.Visit(cell, gridVisitor);
+            }
+            else
+                map.Visit(cell, observerVisitor);
+        }
+    }
+}
+
+void PlayerRelocationNotifier::VisitWatched()
+{
+    if (i_player.m_visibilityWatchGUIDs.empty())
+        return;
+
+    // UpdateVisibilityOf adds to and removes from the set
+    GuidUnorderedSet watched = i_player.m_visibilityWatchGUIDs;
+    for (ObjectGuid const& guid : watched)
+    {
+        WorldObject* object = ObjectAccessor::GetWorldObject(i_player, guid);
+        if (!object)
+        {
+            i_player.m_visibilityWatchGUIDs.erase(guid);
+            continue;
+        }
+
+        switch (object->GetTypeId())
+        {
+            case TYPEID_UNIT:
+                i_player.UpdateVisibilityOf(object->ToCreature(), i_data, i_visibleNow);
+                break;
+            case TYPEID_PLAYER:
+                i_player.UpdateVisibilityOf(object->ToPlayer(), i_data, i_visibleNow);
+                break;
+            case TYPEID_GAMEOBJECT:
+                i_player.UpdateVisibilityOf(object->ToGameObject(), i_data, i_visibleNow);
+                break;
+            case TYPEID_DYNAMICOBJECT:
+                i_player.UpdateVisibilityOf(object->ToDynObject(), i_data, i_visibleNow);
+                break;
+            case TYPEID_CORPSE:
+                i_player.UpdateVisibilityOf(object->ToCorpse(), i_data, i_visibleNow);
+                break;
+            case TYPEID_AREATRIGGER:
+                i_player.UpdateVisibilityOf(object->ToAreaTrigger(), i_data, i_visibleNow);
+                break;
+            case TYPEID_SCENEOBJECT:
+                i_player.UpdateVisibilityOf(object->ToSceneObject(), i_data, i_visibleNow);
+                break;
+            case TYPEID_CONVERSATION:
+                i_player.UpdateVisibilityOf(object->ToConversation(), i_data, i_visibleNow);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
 void PlayerRelocationNotifier::Visit(PlayerMapType &m)
 {
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
@@ -157,24 +344,21 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
         if (player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             continue;
 
-        player->UpdateVisibilityOf(&i_player);
+        if (!player->IsVisibilityKeptOnRelocation(&i_player))
+            player->UpdateVisibilityOf(&i_player);
     }
 }
 
-void PlayerRelocationNotifier::Visit(CreatureMapType &m)
+void PlayerRelocationObserverNotifier::Visit(PlayerMapType &m)
 {
-    bool relocated_for_ai = (&i_player == i_player.m_seer);
-
-    for (CreatureMapType::iterator iter=m.begin(); iter != m.end(); ++iter)
+    for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        Creature* c = iter->GetSource();
-
-        vis_guids.erase(c->GetGUID());
-
-        i_player.UpdateVisibilityOf(c, i_data, i_visibleNow);
+        Player* player = iter->GetSource();
+        if (player == &i_player || player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+            continue;
 
-        if (relocated_for_ai && !c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-            CreatureUnitRelocationWorker(c, &i_player);
+        if (!player->IsVisibilityKeptOnRelocation(&i_player))
+            player->UpdateVisibilityOf(&i_player);
     }
 }
 
@@ -184,7 +368,7 @@ void CreatureRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* player = iter->GetSource();
 
-        if (!player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+        if (!player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) && !player->IsVisibilityKeptOnRelocation(&i_creature))
             player->UpdateVisibilityOf(&i_creature);
 
         CreatureUnitRelocationWorker(&i_creature, player);
@@ -201,26 +385,63 @@ void CreatureRelocationNotifier::Visit(CreatureMapType &m)
         Creature* c = iter->GetSource();
         CreatureUnitRelocationWorker(&i_creature, c);
 
-        if (!c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+        if (!c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED | NOTIFY_AI_RELOCATION))
             CreatureUnitRelocationWorker(c, &i_creature);
     }
 }
 
+void UnitAIRelocationNotifier::Visit(CreatureMapType &m)
+{
+    Creature* creature = i_unit.ToCreature();
+    if (creature && !creature->IsAlive())
+        creature = nullptr;
+
+    for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Creature* c = iter->GetSource();
+        if (creature)
+            CreatureUnitRelocationWorker(creature, c);
+
+        if (!c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED | NOTIFY_AI_RELOCATION))
+            CreatureUnitRelocationWorker(c, &i_unit);
+    }
+}
+
+void UnitAIRelocationNotifier::Visit(PlayerMapType &m)
+{
+    Creature* creature = i_unit.ToCreature();
+    if (!creature)
+        return;
+
+    for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+        CreatureUnitRelocationWorker(creature, iter->GetSource());
+}
+
 void DelayedUnitRelocation::Visit(CreatureMapType &m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
         Creature* unit = iter->GetSource();
-        if (!unit->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-            continue;
+        if (unit->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+        {
+            CreatureRelocationNotifier relocate(*unit);
 
-        CreatureRelocationNotifier relocate(*unit);
+            TypeContainerVisitor<CreatureRelocationNotifier, WorldTypeMapContainer > c2world_relocation(relocate);
+            TypeContainerVisitor<CreatureRelocationNotifier, GridTypeMapContainer >  c2grid_relocation(relocate);
 
-        TypeContainerVisitor<CreatureRelocationNotifier, WorldTypeMapContainer > c2world_relocation(relocate);
-        TypeContainerVisitor<CreatureRelocationNotifier, GridTypeMapContainer >  c2grid_relocation(relocate);
+            cell.Visit(p, c2world_relocation, i_map, *unit, i_radius);
+            cell.Visit(p, c2grid_relocation, i_map, *unit, i_radius);
+        }
+        else if (unit->isNeedNotify(NOTIFY_AI_RELOCATION))
+        {
+            UnitAIRelocationNotifier relocate(*unit);
+
+            TypeContainerVisitor<UnitAIRelocationNotifier, WorldTypeMapContainer > c2world_relocation(relocate);
+            TypeContainerVisitor<UnitAIRelocationNotifier, GridTypeMapContainer >  c2grid_relocation(relocate);
 
-        cell.Visit(p, c2world_relocation, i_map, *unit, i_radius);
-        cell.Visit(p, c2grid_relocation, i_map, *unit, i_radius);
+            cell.Visit(p, c2world_relocation, i_map, *unit, i_radius);
+            cell.Visit(p, c2grid_relocation, i_map, *unit, i_radius);
+        }
     }
 }
 
@@ -231,15 +452,20 @@ void DelayedUnitRelocation::Visit(PlayerMapType &m)
         Player* player = iter->GetSource();
         WorldObject const* viewPoint = player->m_seer;
 
-        if (!viewPoint->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-            continue;
-
-        if (player != viewPoint && !viewPoint->IsPositionValid())
-            continue;
+        bool const visibilityChanged = viewPoint->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) && (player == viewPoint || viewPoint->IsPositionValid());
+        if (visibilityChanged)
+        {
+            PlayerRelocationNotifier relocate(*player);
+            relocate.VisitSightRange(i_radius);
+            relocate.SendToSelf();
+        }
 
-        PlayerRelocationNotifier relocate(*player);
-        Cell::VisitAllObjects(viewPoint, relocate, i_radius, false);
-        relocate.SendToSelf();
+        // the creatures around check for aggro whenever the player itself moved
+        if (player->isNeedNotify(NOTIFY_AI_RELOCATION) || (visibilityChanged && player == viewPoint))
+        {
+            UnitAIRelocationNotifier relocate(*player);
+            Cell::VisitAllObjects(player, relocate, i_radius, false);
+        }
     }
 }
 
@@ -42,6 +42,9 @@ namespace Trinity
         GuidUnorderedSet vis_guids;
 
         VisibleNotifier(Player &player) : i_player(player), i_data(player.GetMapId()), vis_guids(player.m_clientGUIDs) { }
+        // without the client guids only the visited objects are checked, nothing else is removed from the client
+        VisibleNotifier(Player &player, bool trackClientGUIDs) : i_player(player), i_data(player.GetMapId()),
+            vis_guids(trackClientGUIDs ? player.m_clientGUIDs : GuidUnorderedSet()) { }
         template<class T> void Visit(GridRefManager<T> &m);
         void SendToSelf(void);
     };
@@ -57,12 +60,33 @@ namespace Trinity
         void Visit(DynamicObjectMapType &);
     };
 
+    // Only a full scan of the sight range when the viewpoint entered another grid or something changed more than positions.
+    // Otherwise only the cells the move took in or out of the sight range and the watched objects are checked,
+    // see Player::VisibilityScan and Player::IsVisibilityWatched
     struct TC_GAME_API PlayerRelocationNotifier : public VisibleNotifier
     {
-        PlayerRelocationNotifier(Player &player) : VisibleNotifier(player) { }
+        bool i_fullScan;
 
-        template<class T> void Visit(GridRefManager<T> &m) { VisibleNotifier::Visit(m); }
-        void Visit(CreatureMapType &);
+        explicit PlayerRelocationNotifier(Player &player);
+
+        template<class T> void Visit(GridRefManager<T> &m);
+        void Visit(PlayerMapType &);
+
+        void VisitSightRange(float radius);
+
+    private:
+        PlayerRelocationNotifier(Player &player, bool fullScan);
+
+        void VisitChangedCells(float radius);
+        void VisitWatched();
+    };
+
+    // Players in the cells where the move could not change what the relocated player sees, they only check whether they still see it
+    struct TC_GAME_API PlayerRelocationObserverNotifier
+    {
+        Player &i_player;
+        explicit PlayerRelocationObserverNotifier(Player &player) : i_player(player) { }
+        template<class T> void Visit(GridRefManager<T> &) { }
         void Visit(PlayerMapType &);
     };
 
@@ -75,6 +99,16 @@ namespace Trinity
         void Visit(PlayerMapType &);
     };
 
+    // Relocation notify of a unit that moved too little to change visibility, only the creatures' aggro checks are done
+    struct TC_GAME_API UnitAIRelocationNotifier
+    {
+        Unit &i_unit;
+        explicit UnitAIRelocationNotifier(Unit &unit) : i_unit(unit) { }
+        template<class T> void Visit(GridRefManager<T> &) { }
+        void Visit(CreatureMapType &);
+        void Visit(PlayerMapType &);
+    };
+
     struct TC_GAME_API DelayedUnitRelocation
     {
         Map &i_map;
@@ -0,0 +1,212 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridPrefetcher.h"
+#include "Log.h"
+#include "Map.h"
+#include "MMapFactory.h"
+#include "StringFormat.h"
+#include "VMapFactory.h"
+#include "World.h"
+
+namespace
+{
+    // data nobody asked for within this time is dropped (player turned around, grid was already loaded by another map)
+    uint32 const PREFETCHED_GRID_EXPIRY = 60 * IN_MILLISECONDS;
+
+    // upper limit of grids queued or held at the same time
+    std::size_t const MAX_PREFETCHED_GRIDS = 64;
+}
+
+void PrefetchedGridData::Release()
+{
+    GridMaps.clear();
+
+    if (!VMapModels.empty())
+    {
+        VMAP::VMapFactory::createOrGetVMapManager()->releaseModels(VMapModels);
+        VMapModels.clear();
+    }
+
+    MMAP::MMapManager::freeMapTiles(MMapTiles);
+}
+
+void GridPrefetcher::Activate(uint32 threadCount)
+{
+    for (uint32 i = 0; i < threadCount; ++i)
+        _workerThreads.push_back(std::thread(&GridPrefetcher::WorkerThread, this));
+}
+
+void GridPrefetcher::Deactivate()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _cancelationToken = true;
+        _condition.notify_all();
+    }
+
+    for (std::thread& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+    _queue.clear();
+
+    for (auto& entry : _entries)
+        if (entry.second.Data)
+            entry.second.Data->Release();
+
+    _entries.clear();
+}
+
+void GridPrefetcher::Request(std::vector<uint32> terrainMapIds, int gx, int gy, bool loadMMap)
+{
+    ASSERT(!terrainMapIds.empty());
+
+    uint64 key = MakeKey(terrainMapIds.front(), gx, gy);
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_entries.size() >= MAX_PREFETCHED_GRIDS)
+        return;
+
+    if (!_entries.emplace(key, Entry()).second)
+        return;
+
+    _queue.push_back({ key, std::move(terrainMapIds), gx, gy, loadMMap });
+    _condition.notify_one();
+}
+
+std::unique_ptr<PrefetchedGridData> GridPrefetcher::Take(uint32 mapId, int gx, int gy)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _entries.find(MakeKey(mapId, gx, gy));
+    if (itr == _entries.end())
+        return nullptr;
+
+    switch (itr->second.Status)
+    {
+        case State::Ready:
+        {
+            std::unique_ptr<PrefetchedGridData> data = std::move(itr->second.Data);
+            _entries.erase(itr);
+            return data;
+        }
+        case State::Queued:
+            // worker skips queued requests without entry
+            _entries.erase(itr);
+            break;
+        case State::Loading:
+            // worker releases the data once it finishes
+            itr->second.Status = State::Cancelled;
+            break;
+        default:
+            break;
+    }
+
+    return nullptr;
+}
+
+void GridPrefetcher::Update(uint32 diff)
+{
+    std::vector<std::unique_ptr<PrefetchedGridData>> expired;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto itr = _entries.begin(); itr != _entries.end();)
+        {
+            if (itr->second.Status == State::Ready)
+            {
+                itr->second.Age += diff;
+                if (itr->second.Age >= PREFETCHED_GRID_EXPIRY)
+                {
+                    expired.push_back(std::move(itr->second.Data));
+                    itr = _entries.erase(itr);
+                    continue;
+                }
+            }
+
+            ++itr;
+        }
+    }
+
+    for (std::unique_ptr<PrefetchedGridData>& data : expired)
+        data->Release();
+}
+
+void GridPrefetcher::WorkerThread()
+{
+    for (;;)
+    {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _condition.wait(lock, [this] { return _cancelationToken || !_queue.empty(); });
+            if (_cancelationToken)
+                return;
+
+            request = std::move(_queue.front());
+            _queue.pop_front();
+
+            auto itr = _entries.find(request.Key);
+            if (itr == _entries.end() || itr->second.Status != State::Queued)
+                continue;
+
+            itr->second.Status = State::Loading;
+        }
+
+        std::unique_ptr<PrefetchedGridData> data = Load(request);
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            auto itr = _entries.find(request.Key);
+            if (itr != _entries.end() && itr->second.Status == State::Loading)
+            {
+                itr->second.Status = State::Ready;
+                itr->second.Data = std::move(data);
+                continue;
+            }
+
+            if (itr != _entries.end())
+                _entries.erase(itr);
+        }
+
+        // grid was loaded synchronously in the meantime
+        data->Release();
+    }
+}
+
+std::unique_ptr<PrefetchedGridData> GridPrefetcher::Load(LoadRequest const& request) const
+{
+    std::unique_ptr<PrefetchedGridData> data = std::make_unique<PrefetchedGridData>();
+
+    for (uint32 mapId : request.MapIds)
+    {
+        std::string fileName = Trinity::StringFormat("%smaps/%04u_%02u_%02u.map", sWorld->GetDataPath().c_str(), mapId, request.GridX, request.GridY);
+        GridMap::LoadResult result;
+        if (std::shared_ptr<GridMap> gridMap = GridMap::GetOrLoad(fileName, &result))
+            data->GridMaps[mapId] = std::move(gridMap);
+    }
+
+    uint32 rootMapId = request.MapIds.front();
+    data->VMapModels = VMAP::VMapFactory::createOrGetVMapManager()->preloadMapTileModels((sWorld->GetDataPath() + "vmaps").c_str(), rootMapId, request.GridX, request.GridY);
+
+    if (request.LoadMMap)
+        data->MMapTiles = MMAP::MMapFactory::createOrGetMMapManager()->readMapTiles(sWorld->GetDataPath(), rootMapId, request.GridX, request.GridY);
+
+    TC_LOG_DEBUG("maps", "GridPrefetcher: loaded grid [%d, %d] of map %u (%u maps, %u models, %u navmesh tiles)", request.GridX, request.GridY, rootMapId,
+        uint32(data->GridMaps.size()), uint32(data->VMapModels.size()), uint32(data->MMapTiles.size()));
+
+    return data;
+}
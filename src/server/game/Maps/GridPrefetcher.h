@@ -0,0 +1,113 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GridPrefetcher_h__
+#define GridPrefetcher_h__
+
+#include "Define.h"
+#include "MMapManager.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class GridMap;
+
+// Terrain data of one grid loaded ahead of time, handed over to the map when the grid is created
+struct PrefetchedGridData
+{
+    std::unordered_map<uint32 /*mapId*/, std::shared_ptr<GridMap>> GridMaps;
+    std::vector<uint32> VMapModels;         // ids of the models referenced by vmap tiles, kept loaded until Release
+    MMAP::MMapTileDataSet MMapTiles;
+
+    // drops everything the map did not take over
+    void Release();
+};
+
+/*
+ * Loads .map files, vmap models and .mmtile data of grids players are expected to enter
+ * on background threads. Loaded data is only published to the map thread when it creates
+ * the grid (Take), requests that did not finish yet are cancelled and the grid is loaded
+ * synchronously as before.
+ */
+class TC_GAME_API GridPrefetcher
+{
+    public:
+        GridPrefetcher() : _cancelationToken(false) { }
+        ~GridPrefetcher() { }
+
+        void Activate(uint32 threadCount);
+        void Deactivate();
+        bool IsActive() const { return !_workerThreads.empty(); }
+
+        // Queues loading grid gx, gy of terrain maps, the first one is the terrain root map, followed by its child terrain maps
+        void Request(std::vector<uint32> terrainMapIds, int gx, int gy, bool loadMMap);
+
+        // Returns loaded data for the grid, nullptr if it was not requested or is still loading
+        std::unique_ptr<PrefetchedGridData> Take(uint32 mapId, int gx, int gy);
+
+        // Releases data that was not picked up by any map in time
+        void Update(uint32 diff);
+
+    private:
+        enum class State
+        {
+            Queued,
+            Loading,
+            Ready,
+            Cancelled
+        };
+
+        struct Entry
+        {
+            State Status = State::Queued;
+            uint32 Age = 0;
+            std::unique_ptr<PrefetchedGridData> Data;
+        };
+
+        struct LoadRequest
+        {
+            uint64 Key;
+            std::vector<uint32> MapIds;     // terrain root map first
+            int GridX;
+            int GridY;
+            bool LoadMMap;
+        };
+
+        static uint64 MakeKey(uint32 mapId, int gx, int gy) { return uint64(mapId) << 32 | uint32(gx) << 16 | uint32(gy); }
+
+        void WorkerThread();
+        std::unique_ptr<PrefetchedGridData> Load(LoadRequest const& request) const;
+
+        std::vector<std::thread> _workerThreads;
+        std::atomic<bool> _cancelationToken;
+
+        std::mutex _lock;
+        std::condition_variable _condition;
+        std::deque<LoadRequest> _queue;
+        std::unordered_map<uint64, Entry> _entries;
+
+        GridPrefetcher(GridPrefetcher const& right) = delete;
+        GridPrefetcher& operator=(GridPrefetcher const& right) = delete;
+};
+
+#endif // GridPrefetcher_h__
@@ -25,6 +25,7 @@
 #include "GameObjectModel.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "GridPrefetcher.h"
 #include "GridStates.h"
 #include "Group.h"
 #include "InstancePackets.h"
@@ -33,17 +34,21 @@
 #include "Log.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "MappedFile.h"
 #include "MiscPackets.h"
 #include "MMapFactory.h"
 #include "MotionMaster.h"
 #include "ObjectAccessor.h"
 #include "ObjectGridLoader.h"
 #include "ObjectMgr.h"
+#include "PathCache.h"
+#include "PathRequestQueue.h"
 #include "Pet.h"
 #include "SceneObject.h"
 #include "PhasingHandler.h"
 #include "ScriptMgr.h"
 #include "Transport.h"
+#include "UpdateData.h"
 #include "Vehicle.h"
 #include "VMapFactory.h"
 #include "Weather.h"
@@ -59,10 +64,18 @@ u_map_magic MapLiquidMagic  = { {'M','L','I','Q'} };
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
+#define GRID_PREFETCH_LOOKAHEAD 10.0f                       // seconds of movement
 #define MAX_CREATURE_ATTACK_RADIUS  (45.0f * sWorld->getRate(RATE_CREATURE_AGGRO))
 
 GridState* si_GridStates[MAX_GRID_STATE];
 
+namespace
+{
+    // process wide terrain store, every map and instance using the same file shares one GridMap
+    std::mutex GridMapCacheLock;
+    std::unordered_map<std::string, std::weak_ptr<GridMap>> GridMapCache;
+}
+
 
 ZoneDynamicInfo::ZoneDynamicInfo() : MusicId(0), DefaultWeather(nullptr), WeatherId(WEATHER_STATE_FINE),
     WeatherGrade(0.0f), OverrideLightId(0), LightFadeInTime(0) { }
@@ -195,12 +208,12 @@ bool Map::ExistVMap(uint32 mapid, int gx, int gy)
     return true;
 }
 
-void Map::LoadMMap(int gx, int gy)
+void Map::LoadMMap(int gx, int gy, PrefetchedGridData* prefetched)
 {
     if (!DisableMgr::IsPathfindingEnabled(GetId()))
         return;
 
-    bool mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMap(sWorld->GetDataPath(), GetId(), gx, gy);
+    bool mmapLoadResult = MMAP::MMapFactory::createOrGetMMapManager()->loadMap(sWorld->GetDataPath(), GetId(), gx, gy, prefetched ? &prefetched->MMapTiles : nullptr);
 
     if (mmapLoadResult)
         TC_LOG_DEBUG("mmaps", "MMAP loaded name:%s, id:%d, x:%d, y:%d (mmap rep.: x:%d, y:%d)", GetMapName(), GetId(), gx, gy, gx, gy);
@@ -228,25 +241,42 @@ void Map::LoadVMap(int gx, int gy)
     }
 }
 
-void Map::LoadMap(int gx, int gy)
+void Map::LoadMap(int gx, int gy, PrefetchedGridData* prefetched)
 {
-    LoadMapImpl(this, gx, gy);
+    LoadMapImpl(this, gx, gy, prefetched);
 
     for (Map* childBaseMap : *m_childTerrainMaps)
-        childBaseMap->LoadMap(gx, gy);
+        childBaseMap->LoadMap(gx, gy, prefetched);
 }
 
-void Map::LoadMapImpl(Map* map, int gx, int gy)
+void Map::LoadMapImpl(Map* map, int gx, int gy, PrefetchedGridData* prefetched)
 {
     if (map->GridMaps[gx][gy])
         return;
 
     // map file name
     std::string fileName = Trinity::StringFormat("%smaps/%04u_%02u_%02u.map", sWorld->GetDataPath().c_str(), map->GetId(), gx, gy);
-    TC_LOG_DEBUG("maps", "Loading map %s", fileName.c_str());
-    // loading data
-    std::shared_ptr<GridMap> gridMap = std::make_shared<GridMap>();
-    GridMap::LoadResult gridMapLoadResult = gridMap->loadData(fileName.c_str());
+    std::shared_ptr<GridMap> gridMap;
+    GridMap::LoadResult gridMapLoadResult = GridMap::LoadResult::Ok;
+    if (prefetched)
+    {
+        auto prefetchedGridMap = prefetched->GridMaps.find(map->GetId());
+        if (prefetchedGridMap != prefetched->GridMaps.end())
+        {
+            gridMap = std::move(prefetchedGridMap->second);
+            prefetched->GridMaps.erase(prefetchedGridMap);
+        }
+    }
+
+    if (gridMap)
+        TC_LOG_DEBUG("maps", "Using prefetched map %s", fileName.c_str());
+    else
+    {
+        TC_LOG_DEBUG("maps", "Loading map %s", fileName.c_str());
+        // loading data
+        gridMap = GridMap::GetOrLoad(fileName, &gridMapLoadResult);
+    }
+
     if (gridMapLoadResult == GridMap::LoadResult::Ok)
         map->GridMaps[gx][gy] = std::move(gridMap);
     else
@@ -284,12 +314,72 @@ void Map::UnloadMapImpl(Map* map, int gx, int gy)
 
 void Map::LoadMapAndVMap(int gx, int gy)
 {
-    LoadMap(gx, gy);
+    std::unique_ptr<PrefetchedGridData> prefetched = sMapMgr->GetGridPrefetcher()->Take(GetId(), gx, gy);
+
+    LoadMap(gx, gy, prefetched.get());
     // Only load the data for the base map
     if (this == m_parentMap)
     {
         LoadVMap(gx, gy);
-        LoadMMap(gx, gy);
+        LoadMMap(gx, gy, prefetched.get());
+    }
+
+    // vmap tiles hold their own model references by now
+    if (prefetched)
+        prefetched->Release();
+}
+
+void Map::GetTerrainMapIds(std::vector<uint32>& mapIds) const
+{
+    mapIds.push_back(GetId());
+    for (Map* childBaseMap : *m_childTerrainMaps)
+        childBaseMap->GetTerrainMapIds(mapIds);
+}
+
+void Map::PrefetchGridsAhead(Player const* player, float dx, float dy)
+{
+    GridPrefetcher* prefetcher = sMapMgr->GetGridPrefetcher();
+    if (!prefetcher->IsActive())
+        return;
+
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length < 0.1f)
+        return;
+
+    dx /= length;
+    dy /= length;
+
+    // grids the player reaches within the next GRID_PREFETCH_LOOKAHEAD seconds at current speed
+    float distance = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN) * GRID_PREFETCH_LOOKAHEAD;
+    Map* rootTerrainMap = m_parentMap->GetRootParentTerrainMap();
+    std::vector<uint32> terrainMapIds;
+    for (float traveled = SIZE_OF_GRIDS / 4; traveled < distance + SIZE_OF_GRIDS / 4; traveled += SIZE_OF_GRIDS / 4)
+    {
+        float x = player->GetPositionX() + dx * std::min(traveled, distance);
+        float y = player->GetPositionY() + dy * std::min(traveled, distance);
+        if (!Trinity::IsValidMapCoord(x, y))
+            break;
+
+        GridCoord p = Trinity::ComputeGridCoord(x, y);
+        int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+        int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+        if (GridMaps[gx][gy])
+            continue;
+
+        {
+            // instances share the terrain of their parent map, it may be loaded there already
+            std::unique_lock<std::mutex> lock(rootTerrainMap->_gridLock, std::defer_lock);
+            if (this != rootTerrainMap)
+                lock.lock();
+
+            if (m_parentMap->GridMaps[gx][gy])
+                continue;
+        }
+
+        if (terrainMapIds.empty())
+            rootTerrainMap->GetTerrainMapIds(terrainMapIds);
+
+        prefetcher->Request(terrainMapIds, gx, gy, DisableMgr::IsPathfindingEnabled(rootTerrainMap->GetId()));
     }
 }
 
@@ -323,7 +413,9 @@ m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry),
-i_scriptLock(false), _defaultLight(DB2Manager::GetDefaultMapLight(id))
+i_scriptLock(false), _updateCost(0), _defaultLight(DB2Manager::GetDefaultMapLight(id)),
+_updateDatas(std::make_unique<UpdateDataMap>()), _updatePacket(std::make_unique<WorldPacket>(SMSG_UPDATE_OBJECT, 0x10000)),
+_pathCache(std::make_unique<PathCache>()), _pathRequests(std::make_unique<PathRequestQueue>())
 {
     if (_parent)
     {
@@ -626,8 +718,6 @@ bool Map::EnsureGridLoaded(const Cell &cell)
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
 
         LoadGridObjects(grid, cell);
-
-        Balance();
         return true;
     }
 
@@ -814,7 +904,6 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
 
 void Map::Update(const uint32 t_diff)
 {
-    _dynamicTree.update(t_diff);
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -898,6 +987,10 @@ void Map::Update(const uint32 t_diff)
         obj->Update(t_diff);
     }
 
+    // paths requested by movement generators during the object updates
+    if (!_pathRequests->IsEmpty())
+        _pathRequests->Process(this);
+
     SendObjectUpdates();
 
     ///- Process necessary scripts
@@ -932,7 +1025,13 @@ struct ResetNotifier
     template<class T>inline void resetNotify(GridRefManager<T> &m)
     {
         for (typename GridRefManager<T>::iterator iter=m.begin(); iter != m.end(); ++iter)
+        {
+            // moves are measured from the last notify that was processed
+            if (iter->GetSource()->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+                iter->GetSource()->ResetVisibilityNotifyPosition();
+
             iter->GetSource()->ResetAllNotifies();
+        }
     }
     template<class T> void Visit(GridRefManager<T> &) { }
     void Visit(CreatureMapType &m) { resetNotify<Creature>(m);}
@@ -978,9 +1077,7 @@ void Map::ProcessRelocationNotifies(const uint32 diff)
         }
     }
 
-    ResetNotifier reset;
-    TypeContainerVisitor<ResetNotifier, GridTypeMapContainer >  grid_notifier(reset);
-    TypeContainerVisitor<ResetNotifier, WorldTypeMapContainer > world_notifier(reset);
+    std::vector<NGridType*> resetGrids;
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
     {
         NGridType *grid = i->GetSource();
@@ -992,25 +1089,100 @@ void Map::ProcessRelocationNotifies(const uint32 diff)
             continue;
 
         grid->getGridInfoRef()->getRelocationTimer().TReset(diff, m_VisibilityNotifyPeriod);
+        resetGrids.push_back(grid);
+    }
 
-        uint32 gx = grid->getX(), gy = grid->getY();
+    // resetting notify flags only touches objects of the visited cell so disjoint grid regions can be processed in parallel
+    auto resetRegion = [this](std::vector<NGridType*> const& region)
+    {
+        ResetNotifier reset;
+        TypeContainerVisitor<ResetNotifier, GridTypeMapContainer >  grid_notifier(reset);
+        TypeContainerVisitor<ResetNotifier, WorldTypeMapContainer > world_notifier(reset);
+        for (NGridType* grid : region)
+        {
+            uint32 gx = grid->getX(), gy = grid->getY();
 
-        CellCoord cell_min(gx*MAX_NUMBER_OF_CELLS, gy*MAX_NUMBER_OF_CELLS);
-        CellCoord cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
+            CellCoord cell_min(gx*MAX_NUMBER_OF_CELLS, gy*MAX_NUMBER_OF_CELLS);
+            CellCoord cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
 
-        for (uint32 x = cell_min.x_coord; x < cell_max.x_coord; ++x)
+            for (uint32 x = cell_min.x_coord; x < cell_max.x_coord; ++x)
+            {
+                for (uint32 y = cell_min.y_coord; y < cell_max.y_coord; ++y)
+                {
+                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                    if (!isCellMarked(cell_id))
+                        continue;
+
+                    // active grids are always loaded, visit directly instead of going through Map::Visit
+                    grid->VisitGrid(x % MAX_NUMBER_OF_CELLS, y % MAX_NUMBER_OF_CELLS, grid_notifier);
+                    grid->VisitGrid(x % MAX_NUMBER_OF_CELLS, y % MAX_NUMBER_OF_CELLS, world_notifier);
+                }
+            }
+        }
+    };
+
+    std::vector<std::vector<NGridType*>> regions;
+    BuildUpdateRegions(resetGrids, regions);
+
+    MapUpdater* updater = sMapMgr->GetMapUpdater();
+    if (regions.size() > 1 && updater->activated())
+    {
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(regions.size());
+        for (std::vector<NGridType*> const& region : regions)
+            tasks.push_back([&resetRegion, &region]() { resetRegion(region); });
+
+        updater->run_parallel(tasks);
+    }
+    else
+    {
+        for (std::vector<NGridType*> const& region : regions)
+            resetRegion(region);
+    }
+}
+
+void Map::BuildUpdateRegions(std::vector<NGridType*> const& grids, std::vector<std::vector<NGridType*>>& regions)
+{
+    std::bitset<MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> pending;
+    NGridType* byCoord[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS] = { };
+    for (NGridType* grid : grids)
+    {
+        pending.set(grid->getX() * MAX_NUMBER_OF_GRIDS + grid->getY());
+        byCoord[grid->getX()][grid->getY()] = grid;
+    }
+
+    // flood fill over 8-connected neighbours
+    std::vector<NGridType*> open;
+    for (NGridType* grid : grids)
+    {
+        if (!pending.test(grid->getX() * MAX_NUMBER_OF_GRIDS + grid->getY()))
+            continue;
+
+        pending.reset(grid->getX() * MAX_NUMBER_OF_GRIDS + grid->getY());
+        regions.emplace_back();
+        std::vector<NGridType*>& region = regions.back();
+        open.push_back(grid);
+
+        while (!open.empty())
         {
-            for (uint32 y = cell_min.y_coord; y < cell_max.y_coord; ++y)
+            NGridType* current = open.back();
+            open.pop_back();
+            region.push_back(current);
+
+            uint32 minX = current->getX() > 0 ? current->getX() - 1 : 0;
+            uint32 maxX = std::min<uint32>(current->getX() + 1, MAX_NUMBER_OF_GRIDS - 1);
+            uint32 minY = current->getY() > 0 ? current->getY() - 1 : 0;
+            uint32 maxY = std::min<uint32>(current->getY() + 1, MAX_NUMBER_OF_GRIDS - 1);
+            for (uint32 x = minX; x <= maxX; ++x)
             {
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                    continue;
+                for (uint32 y = minY; y <= maxY; ++y)
+                {
+                    if (!pending.test(x * MAX_NUMBER_OF_GRIDS + y))
+                        continue;
 
-                CellCoord pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
-                Visit(cell, grid_notifier);
-                Visit(cell, world_notifier);
+                    pending.reset(x * MAX_NUMBER_OF_GRIDS + y);
+                    open.push_back(byCoord[x][y]);
+                }
             }
         }
     }
@@ -1113,6 +1285,8 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
 
     Cell old_cell(player->GetPositionX(), player->GetPositionY());
     Cell new_cell(x, y);
+    float dx = x - player->GetPositionX();
+    float dy = y - player->GetPositionY();
 
     //! If hovering, always increase our server-side Z position
     //! Client automatically projects correct position based on Z coord sent in monster move
@@ -1134,10 +1308,12 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
             EnsureGridLoadedForActiveObject(new_cell, player);
 
         AddToGrid(player, new_cell);
+
+        PrefetchGridsAhead(player, dx, dy);
     }
 
     player->UpdatePositionData();
-    player->UpdateObjectVisibility(false);
+    player->UpdateObjectVisibilityOnRelocation();
 }
 
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang, bool respawnRelocationOnFail)
@@ -1170,7 +1346,7 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
         creature->Relocate(x, y, z, ang);
         if (creature->IsVehicle())
             creature->GetVehicleKit()->RelocatePassengers();
-        creature->UpdateObjectVisibility(false);
+        creature->UpdateObjectVisibilityOnRelocation();
         creature->UpdatePositionData();
         RemoveCreatureFromMoveList(creature);
     }
@@ -1382,7 +1558,7 @@ void Map::MoveAllCreaturesInMoveList()
                 c->GetVehicleKit()->RelocatePassengers();
             //CreatureRelocationNotify(c, new_cell, new_cell.cellCoord());
             c->UpdatePositionData();
-            c->UpdateObjectVisibility(false);
+            c->UpdateObjectVisibilityOnRelocation();
         }
         else
         {
@@ -1998,65 +2174,105 @@ GridMap::~GridMap()
     unloadData();
 }
 
+std::shared_ptr<GridMap> GridMap::GetOrLoad(std::string const& fileName, LoadResult* result)
+{
+    {
+        std::lock_guard<std::mutex> lock(GridMapCacheLock);
+        auto itr = GridMapCache.find(fileName);
+        if (itr != GridMapCache.end())
+        {
+            if (std::shared_ptr<GridMap> gridMap = itr->second.lock())
+            {
+                *result = LoadResult::Ok;
+                return gridMap;
+            }
+        }
+    }
+
+    std::unique_ptr<GridMap> gridMap = std::make_unique<GridMap>();
+    *result = gridMap->loadData(fileName.c_str());
+    if (*result != LoadResult::Ok)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(GridMapCacheLock);
+    std::weak_ptr<GridMap>& cached = GridMapCache[fileName];
+    if (std::shared_ptr<GridMap> existing = cached.lock())
+        return existing;    // loaded by another thread in the meantime
+
+    std::shared_ptr<GridMap> shared(gridMap.release(), [fileName](GridMap* grid)
+    {
+        {
+            std::lock_guard<std::mutex> lock(GridMapCacheLock);
+            auto itr = GridMapCache.find(fileName);
+            if (itr != GridMapCache.end() && itr->second.expired())
+                GridMapCache.erase(itr);
+        }
+
+        delete grid;
+    });
+
+    cached = shared;
+    return shared;
+}
+
 GridMap::LoadResult GridMap::loadData(const char* filename)
 {
     // Unload old data if exist
     unloadData();
 
-    map_fileheader header;
-    // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
-        return LoadResult::FileDoesNotExist;
+    MappedFile::Error error;
+    _fileMapping = MappedFile::Open(filename, MappedFile::Access::ReadOnly, &error);
+    if (!_fileMapping)
+    {
+        // Not return error if file not found
+        if (error == MappedFile::Error::NotFound)
+            return LoadResult::FileDoesNotExist;
+
+        return LoadResult::InvalidFile;
+    }
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    map_fileheader header;
+    if (!readFileData(&header, 0, sizeof(header)))
     {
-        fclose(in);
+        unloadData();
         return LoadResult::InvalidFile;
     }
 
     if (header.mapMagic.asUInt == MapMagic.asUInt && header.versionMagic.asUInt == MapVersionMagic.asUInt)
     {
         // load up area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return LoadResult::InvalidFile;
         }
         // load up height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return LoadResult::InvalidFile;
         }
         // load up liquid data
-        if (header.liquidMapOffset && !loadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return LoadResult::InvalidFile;
         }
-        fclose(in);
         return LoadResult::Ok;
     }
 
     TC_LOG_ERROR("maps", "Map file '%s' is from an incompatible map version (%.*s %.*s), %.*s %.*s is expected. Please pull your source, recompile tools and recreate maps using the updated mapextractor, then replace your old map files with new files. If you still have problems search on forum for error TCE00018.",
         filename, 4, header.mapMagic.asChar, 4, header.versionMagic.asChar, 4, MapMagic.asChar, 4, MapVersionMagic.asChar);
-    fclose(in);
+    unloadData();
     return LoadResult::InvalidFile;
 }
 
 void GridMap::unloadData()
 {
-    delete[] _areaMap;
-    delete[] m_V9;
-    delete[] m_V8;
     delete[] _minHeightPlanes;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
     _areaMap = nullptr;
     m_V9 = nullptr;
     m_V8 = nullptr;
@@ -2065,64 +2281,89 @@ void GridMap::unloadData()
     _liquidFlags = nullptr;
     _liquidMap  = nullptr;
     _gridGetHeight = &GridMap::getHeightFromFlat;
+    _alignedCopies.clear();
+    _fileMapping.reset();
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::readFileData(void* dest, std::size_t offset, std::size_t size) const
 {
-    map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    std::size_t fileSize = _fileMapping->GetSize();
+    if (offset > fileSize || size > fileSize - offset)
+        return false;
+
+    memcpy(dest, _fileMapping->GetData() + offset, size);
+    return true;
+}
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapAreaMagic.asUInt)
+template<typename T>
+T const* GridMap::getFileArray(std::size_t offset, std::size_t count)
+{
+    std::size_t fileSize = _fileMapping->GetSize();
+    if (offset > fileSize || count * sizeof(T) > fileSize - offset)
+        return nullptr;
+
+    char const* data = _fileMapping->GetData() + offset;
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0)
+        return reinterpret_cast<T const*>(data);
+
+    _alignedCopies.emplace_back(new uint8[count * sizeof(T)]);
+    memcpy(_alignedCopies.back().get(), data, count * sizeof(T));
+    return reinterpret_cast<T const*>(_alignedCopies.back().get());
+}
+
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
+{
+    map_areaHeader header;
+    if (!readFileData(&header, offset, sizeof(header)) || header.fourcc != MapAreaMagic.asUInt)
         return false;
 
     _gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        _areaMap = new uint16[16 * 16];
-        if (fread(_areaMap, sizeof(uint16), 16*16, in) != 16*16)
+        _areaMap = getFileArray<uint16>(offset + sizeof(header), 16 * 16);
+        if (!_areaMap)
             return false;
     }
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
     map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapHeightMagic.asUInt)
+    if (!readFileData(&header, offset, sizeof(header)) || header.fourcc != MapHeightMagic.asUInt)
         return false;
 
+    std::size_t position = offset + sizeof(header);
     _gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129*129];
-            m_uint16_V8 = new uint16 [128*128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129*129, in) != 129*129 ||
-                fread(m_uint16_V8, sizeof(uint16), 128*128, in) != 128*128)
+            m_uint16_V9 = getFileArray<uint16>(position, 129 * 129);
+            m_uint16_V8 = getFileArray<uint16>(position + sizeof(uint16) * 129 * 129, 128 * 128);
+            if (!m_uint16_V9 || !m_uint16_V8)
                 return false;
+            position += sizeof(uint16) * (129 * 129 + 128 * 128);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             _gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129*129];
-            m_uint8_V8 = new uint8 [128*128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129*129, in) != 129*129 ||
-                fread(m_uint8_V8, sizeof(uint8), 128*128, in) != 128*128)
+            m_uint8_V9 = getFileArray<uint8>(position, 129 * 129);
+            m_uint8_V8 = getFileArray<uint8>(position + sizeof(uint8) * 129 * 129, 128 * 128);
+            if (!m_uint8_V9 || !m_uint8_V8)
                 return false;
+            position += sizeof(uint8) * (129 * 129 + 128 * 128);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             _gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129*129];
-            m_V8 = new float [128*128];
-            if (fread(m_V9, sizeof(float), 129*129, in) != 129*129 ||
-                fread(m_V8, sizeof(float), 128*128, in) != 128*128)
+            m_V9 = getFileArray<float>(position, 129 * 129);
+            m_V8 = getFileArray<float>(position + sizeof(float) * 129 * 129, 128 * 128);
+            if (!m_V9 || !m_V8)
                 return false;
+            position += sizeof(float) * (129 * 129 + 128 * 128);
             _gridGetHeight = &GridMap::getHeightFromFloat;
         }
     }
@@ -2133,8 +2374,8 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         std::array<int16, 9> maxHeights;
         std::array<int16, 9> minHeights;
-        if (fread(maxHeights.data(), sizeof(int16), maxHeights.size(), in) != maxHeights.size() ||
-            fread(minHeights.data(), sizeof(int16), minHeights.size(), in) != minHeights.size())
+        if (!readFileData(maxHeights.data(), position, sizeof(int16) * maxHeights.size()) ||
+            !readFileData(minHeights.data(), position + sizeof(int16) * maxHeights.size(), sizeof(int16) * minHeights.size()))
             return false;
 
         static uint32 constexpr indices[8][3] =
@@ -2174,12 +2415,10 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadLiquidData(uint32 offset, uint32 /*size*/)
 {
     map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapLiquidMagic.asUInt)
+    if (!readFileData(&header, offset, sizeof(header)) || header.fourcc != MapLiquidMagic.asUInt)
         return false;
 
     _liquidGlobalEntry = header.liquidType;
@@ -2190,20 +2429,19 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
     _liquidHeight = header.height;
     _liquidLevel  = header.liquidLevel;
 
+    std::size_t position = offset + sizeof(header);
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        _liquidEntry = new uint16[16*16];
-        if (fread(_liquidEntry, sizeof(uint16), 16*16, in) != 16*16)
-            return false;
-
-        _liquidFlags = new uint8[16*16];
-        if (fread(_liquidFlags, sizeof(uint8), 16*16, in) != 16*16)
+        _liquidEntry = getFileArray<uint16>(position, 16 * 16);
+        _liquidFlags = getFileArray<uint8>(position + sizeof(uint16) * 16 * 16, 16 * 16);
+        if (!_liquidEntry || !_liquidFlags)
             return false;
+        position += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
     }
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        _liquidMap = new float[uint32(_liquidWidth) * uint32(_liquidHeight)];
-        if (fread(_liquidMap, sizeof(float), _liquidWidth*_liquidHeight, in) != (uint32(_liquidWidth) * uint32(_liquidHeight)))
+        _liquidMap = getFileArray<float>(position, uint32(_liquidWidth) * uint32(_liquidHeight));
+        if (!_liquidMap)
             return false;
     }
     return true;
@@ -2324,7 +2562,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
     y_int&=(MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint8 *V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -2391,7 +2629,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
     y_int&=(MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint16 *V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -2645,27 +2883,8 @@ float Map::GetWaterOrGroundLevel(PhaseShift const& phaseShift, float x, float y,
     return VMAP_INVALID_HEIGHT_VALUE;
 }
 
-float Map::GetStaticHeight(PhaseShift const& phaseShift, float x, float y, float z, bool checkVMap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/)
+static float SelectStaticHeight(float z, float mapHeight, float vmapHeight)
 {
-    // find raw .map surface under Z coordinates
-    float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
-    uint32 terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x, y);
-    if (GridMap* gmap = GetGrid(terrainMapId, x, y))
-    {
-        float gridHeight = gmap->getHeight(x, y);
-        // look from a bit higher pos to find the floor, ignore under surface case
-        if (z + 2.0f > gridHeight)
-            mapHeight = gridHeight;
-    }
-
-    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;
-    if (checkVMap)
-    {
-        VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
-        if (vmgr->isHeightCalcEnabled())
-            vmapHeight = vmgr->getHeight(terrainMapId, x, y, z + 2.0f, maxSearchDist);   // look from a bit higher pos to find the floor
-    }
-
     // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
     // vmapheight set for any under Z value or <= INVALID_HEIGHT
     if (vmapHeight > INVALID_HEIGHT)
@@ -2688,6 +2907,30 @@ float Map::GetStaticHeight(PhaseShift const& phaseShift, float x, float y, float
     return mapHeight;                               // explicitly use map data
 }
 
+float Map::GetStaticHeight(PhaseShift const& phaseShift, float x, float y, float z, bool checkVMap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/)
+{
+    // find raw .map surface under Z coordinates
+    float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
+    uint32 terrainMapId = PhasingHandler::GetTerrainMapId(phaseShift, this, x, y);
+    if (GridMap* gmap = GetGrid(terrainMapId, x, y))
+    {
+        float gridHeight = gmap->getHeight(x, y);
+        // look from a bit higher pos to find the floor, ignore under surface case
+        if (z + 2.0f > gridHeight)
+            mapHeight = gridHeight;
+    }
+
+    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;
+    if (checkVMap)
+    {
+        VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+        if (vmgr->isHeightCalcEnabled())
+            vmapHeight = vmgr->getHeight(terrainMapId, x, y, z + 2.0f, maxSearchDist);   // look from a bit higher pos to find the floor
+    }
+
+    return SelectStaticHeight(z, mapHeight, vmapHeight);
+}
+
 float Map::GetMinHeight(PhaseShift const& phaseShift, float x, float y)
 {
     if (GridMap const* grid = GetGrid(PhasingHandler::GetTerrainMapId(phaseShift, this, x, y), x, y))
@@ -3058,6 +3301,53 @@ bool Map::isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, floa
     return true;
 }
 
+void Map::isInLineOfSight(std::vector<LineOfSightQuery>& queries, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
+    for (LineOfSightQuery& query : queries)
+        query.InLineOfSight = true;
+
+    if (checks & LINEOFSIGHT_CHECK_VMAP)
+    {
+        // queries are grouped by terrain map, usually all of them share the same one
+        std::vector<std::pair<uint32, uint32>> order;
+        order.reserve(queries.size());
+        for (uint32 i = 0; i < queries.size(); ++i)
+            order.emplace_back(PhasingHandler::GetTerrainMapId(*queries[i].Phases, this, queries[i].X1, queries[i].Y1), i);
+
+        std::sort(order.begin(), order.end());
+
+        VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+        std::vector<G3D::Vector3> starts;
+        std::vector<G3D::Vector3> ends;
+        std::unique_ptr<bool[]> results(new bool[queries.size()]);
+        for (auto begin = order.begin(); begin != order.end();)
+        {
+            uint32 terrainMapId = begin->first;
+            auto end = std::find_if(begin, order.end(), [terrainMapId](std::pair<uint32, uint32> const& entry) { return entry.first != terrainMapId; });
+
+            starts.clear();
+            ends.clear();
+            for (auto itr = begin; itr != end; ++itr)
+            {
+                LineOfSightQuery const& query = queries[itr->second];
+                starts.emplace_back(query.X1, query.Y1, query.Z1);
+                ends.emplace_back(query.X2, query.Y2, query.Z2);
+            }
+
+            vmgr->isInLineOfSight(terrainMapId, starts.data(), ends.data(), results.get(), uint32(starts.size()), ignoreFlags);
+            for (auto itr = begin; itr != end; ++itr)
+                queries[itr->second].InLineOfSight = results[itr - begin];
+
+            begin = end;
+        }
+    }
+
+    if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT))
+        for (LineOfSightQuery& query : queries)
+            if (query.InLineOfSight)
+                query.InLineOfSight = _dynamicTree.isInLineOfSight({ query.X1, query.Y1, query.Z1 }, { query.X2, query.Y2, query.Z2 }, *query.Phases);
+}
+
 bool Map::getObjectHitPos(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
 {
     G3D::Vector3 startPos(x1, y1, z1);
@@ -3077,6 +3367,60 @@ float Map::GetHeight(PhaseShift const& phaseShift, float x, float y, float z, bo
     return std::max<float>(GetStaticHeight(phaseShift, x, y, z, vmap, maxSearchDist), GetGameObjectFloor(phaseShift, x, y, z, maxSearchDist));
 }
 
+void Map::GetHeights(PhaseShift const& phaseShift, std::vector<Position> const& positions, std::vector<float>& heights, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/)
+{
+    heights.resize(positions.size());
+
+    // samples are grouped by terrain map, usually all of them share the same one
+    std::vector<std::pair<uint32, uint32>> order;
+    order.reserve(positions.size());
+    for (uint32 i = 0; i < positions.size(); ++i)
+        order.emplace_back(PhasingHandler::GetTerrainMapId(phaseShift, this, positions[i].GetPositionX(), positions[i].GetPositionY()), i);
+
+    std::sort(order.begin(), order.end());
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    bool checkVMap = vmap && vmgr->isHeightCalcEnabled();
+    std::vector<G3D::Vector3> samples;
+    std::vector<float> vmapHeights;
+    for (auto begin = order.begin(); begin != order.end();)
+    {
+        uint32 terrainMapId = begin->first;
+        auto end = std::find_if(begin, order.end(), [terrainMapId](std::pair<uint32, uint32> const& entry) { return entry.first != terrainMapId; });
+
+        vmapHeights.assign(end - begin, VMAP_INVALID_HEIGHT_VALUE);
+        if (checkVMap)
+        {
+            samples.clear();
+            for (auto itr = begin; itr != end; ++itr)
+            {
+                Position const& pos = positions[itr->second];
+                samples.emplace_back(pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ() + 2.0f);   // look from a bit higher pos to find the floor
+            }
+
+            vmgr->getHeights(terrainMapId, samples.data(), vmapHeights.data(), uint32(samples.size()), maxSearchDist);
+        }
+
+        for (auto itr = begin; itr != end; ++itr)
+        {
+            Position const& pos = positions[itr->second];
+            float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
+            if (GridMap* gmap = GetGrid(terrainMapId, pos.GetPositionX(), pos.GetPositionY()))
+            {
+                float gridHeight = gmap->getHeight(pos.GetPositionX(), pos.GetPositionY());
+                // look from a bit higher pos to find the floor, ignore under surface case
+                if (pos.GetPositionZ() + 2.0f > gridHeight)
+                    mapHeight = gridHeight;
+            }
+
+            heights[itr->second] = std::max<float>(SelectStaticHeight(pos.GetPositionZ(), mapHeight, vmapHeights[itr - begin]),
+                GetGameObjectFloor(phaseShift, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), maxSearchDist));
+        }
+
+        begin = end;
+    }
+}
+
 bool Map::IsInWater(PhaseShift const& phaseShift, float x, float y, float pZ, LiquidData* data)
 {
     LiquidData liquid_status;
@@ -3211,25 +3555,49 @@ inline void Map::setNGrid(NGridType *grid, uint32 x, uint32 y)
     i_grids[x][y] = grid;
 }
 
+void Map::AddUpdateObject(Object* obj)
+{
+    obj->m_updateListIndex = uint32(_updateObjects.size());
+    _updateObjects.push_back(obj);
+}
+
+void Map::RemoveUpdateObject(Object* obj)
+{
+    // items are removed through their owner's current map, it may not be the one that has them listed
+    if (obj->m_updateListIndex < _updateObjects.size() && _updateObjects[obj->m_updateListIndex] == obj)
+        _updateObjects[obj->m_updateListIndex] = nullptr;
+}
+
 void Map::SendObjectUpdates()
 {
-    UpdateDataMapType update_players;
+    UpdateDataMap& update_players = *_updateDatas;
 
-    while (!_updateObjects.empty())
+    // objects can be added while building, size is read on every iteration
+    for (std::size_t i = 0; i < _updateObjects.size(); ++i)
     {
-        Object* obj = *_updateObjects.begin();
+        Object* obj = _updateObjects[i];
+        if (!obj)
+            continue;
+
         ASSERT(obj->IsInWorld());
-        _updateObjects.erase(_updateObjects.begin());
         obj->BuildUpdate(update_players);
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    for (Object* obj : _updateObjects)
+        if (obj)
+            obj->ClearUpdateMask(false);
+
+    _updateObjects.clear();
+
+    WorldPacket& packet = *_updatePacket;
+    for (UpdateDataMap::Entry* entry : update_players)
     {
-        iter->second.BuildPacket(&packet);
-        iter->first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
+        entry->Data.BuildPacket(&packet);
+        entry->Viewer->GetSession()->SendPacket(&packet);
+        packet.clear();                                     // clean the string, capacity is kept for the next one
     }
+
+    update_players.Clear();
 }
 
 void Map::DelayedUpdate(const uint32 t_diff)
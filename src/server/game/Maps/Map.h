@@ -36,6 +36,7 @@
 #include <mutex>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 class Battleground;
 class BattlegroundMap;
@@ -48,17 +49,21 @@ class InstanceScript;
 class InstanceScenario;
 class MapInstanced;
 class Object;
+class PathCache;
+class PathRequestQueue;
 class PhaseShift;
 class Player;
 class Spell;
 class TempSummon;
 class Unit;
+class UpdateDataMap;
 class Weather;
 class WorldObject;
 class WorldPacket;
 struct MapDifficultyEntry;
 struct MapEntry;
 struct Position;
+struct PrefetchedGridData;
 struct QuaternionData;
 struct ScriptAction;
 struct ScriptInfo;
@@ -191,18 +196,29 @@ struct PositionFullTerrainStatus
     Optional<LiquidData> liquidInfo;
 };
 
+// Line of sight test resolved together with others by Map::isInLineOfSight
+struct LineOfSightQuery
+{
+    PhaseShift const* Phases;
+    float X1, Y1, Z1;
+    float X2, Y2, Z2;
+    bool InLineOfSight;
+};
+
+class MappedFile;
+
 class TC_GAME_API GridMap
 {
     uint32  _flags;
     union{
-        float* m_V9;
-        uint16* m_uint16_V9;
-        uint8* m_uint8_V9;
+        float const* m_V9;
+        uint16 const* m_uint16_V9;
+        uint8 const* m_uint8_V9;
     };
     union{
-        float* m_V8;
-        uint16* m_uint16_V8;
-        uint8* m_uint8_V8;
+        float const* m_V8;
+        uint16 const* m_uint16_V8;
+        uint8 const* m_uint8_V8;
     };
     G3D::Plane* _minHeightPlanes;
     // Height level data
@@ -210,13 +226,13 @@ class TC_GAME_API GridMap
     float _gridIntHeightMultiplier;
 
     // Area data
-    uint16* _areaMap;
+    uint16 const* _areaMap;
 
     // Liquid data
     float _liquidLevel;
-    uint16* _liquidEntry;
-    uint8* _liquidFlags;
-    float* _liquidMap;
+    uint16 const* _liquidEntry;
+    uint8 const* _liquidFlags;
+    float const* _liquidMap;
     uint16 _gridArea;
     uint16 _liquidGlobalEntry;
     uint8 _liquidGlobalFlags;
@@ -225,9 +241,18 @@ class TC_GAME_API GridMap
     uint8 _liquidWidth;
     uint8 _liquidHeight;
 
-    bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-    bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-    bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
+    // arrays point directly into the read only file mapping, pages are shared with every process using the same file
+    std::unique_ptr<MappedFile> _fileMapping;
+    // copies of arrays not aligned in files created by older extractors
+    std::vector<std::unique_ptr<uint8[]>> _alignedCopies;
+
+    bool readFileData(void* dest, std::size_t offset, std::size_t size) const;
+    template<typename T>
+    T const* getFileArray(std::size_t offset, std::size_t count);
+
+    bool loadAreaData(uint32 offset, uint32 size);
+    bool loadHeightData(uint32 offset, uint32 size);
+    bool loadLiquidData(uint32 offset, uint32 size);
 
     // Get height functions and pointers
     typedef float (GridMap::*GetHeightPtr) (float x, float y) const;
@@ -248,6 +273,9 @@ public:
         InvalidFile
     };
 
+    // Returns the grid already loaded by any map or instance in this process, loads it otherwise
+    static std::shared_ptr<GridMap> GetOrLoad(std::string const& fileName, LoadResult* result);
+
     LoadResult loadData(const char* filename);
     void unloadData();
 
@@ -320,6 +348,10 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32);
 
+        // smoothed duration of previous updates (in microseconds), used by MapUpdater to schedule expensive maps first
+        uint32 GetUpdateCost() const { return _updateCost; }
+        void RecordUpdateCost(uint32 cost) { _updateCost = (_updateCost * 3 + cost) / 4; }
+
         float GetVisibilityRange() const { return m_VisibleDistance; }
         //function for setting up visibility distance for maps on per-type/per-Id basis
         virtual void InitVisibilityDistance();
@@ -538,10 +570,14 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         float GetWaterOrGroundLevel(PhaseShift const& phaseShift, float x, float y, float z, float* ground = nullptr, bool swim = false);
         float GetHeight(PhaseShift const& phaseShift, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH);
         bool isInLineOfSight(PhaseShift const& phaseShift, float x1, float y1, float z1, float x2, float y2, float z2, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
-        void Balance() { _dynamicTree.balance(); }
+        // batched versions of GetHeight and isInLineOfSight, vmap rays of all samples are traced together
+        void GetHeights(PhaseShift const& phaseShift, std::vector<Position> const& positions, std::vector<float>& heights, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH);
+        void isInLineOfSight(std::vector<LineOfSightQuery>& queries, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
         void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
         void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
+        void UpdateGameObjectModel(const GameObjectModel& model) { _dynamicTree.update(model); }
         bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+        DynamicMapTree const& GetDynamicMapTree() const { return _dynamicTree; }
         float GetGameObjectFloor(PhaseShift const& phaseShift, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
             return _dynamicTree.getHeight(x, y, z, maxSearchDist, phaseShift);
@@ -608,15 +644,11 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
             return GetGuidSequenceGenerator<high>().Generate();
         }
 
-        void AddUpdateObject(Object* obj)
-        {
-            _updateObjects.insert(obj);
-        }
+        void AddUpdateObject(Object* obj);
+        void RemoveUpdateObject(Object* obj);
 
-        void RemoveUpdateObject(Object* obj)
-        {
-            _updateObjects.erase(obj);
-        }
+        PathCache& GetPathCache() { return *_pathCache; }
+        PathRequestQueue& GetPathRequestQueue() { return *_pathRequests; }
 
         void SetWorldState(uint32 id, uint64 value) { m_worldStates[id] = value; }
         uint64 GetWorldState(uint32 id) const
@@ -628,11 +660,13 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
     private:
         void LoadMapAndVMap(int gx, int gy);
         void LoadVMap(int gx, int gy);
-        void LoadMap(int gx, int gy);
-        static void LoadMapImpl(Map* map, int gx, int gy);
+        void LoadMap(int gx, int gy, PrefetchedGridData* prefetched);
+        static void LoadMapImpl(Map* map, int gx, int gy, PrefetchedGridData* prefetched);
         void UnloadMap(int gx, int gy);
         static void UnloadMapImpl(Map* map, int gx, int gy);
-        void LoadMMap(int gx, int gy);
+        void LoadMMap(int gx, int gy, PrefetchedGridData* prefetched);
+        void PrefetchGridsAhead(Player const* player, float dx, float dy);
+        void GetTerrainMapIds(std::vector<uint32>& mapIds) const;
         GridMap* GetGrid(uint32 mapId, float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
@@ -745,7 +779,11 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         //visibility calculations. Highly optimized for massive calculations
         void ProcessRelocationNotifies(const uint32 diff);
 
+        // splits grids into groups of adjacent grids, grids of different groups never touch each other
+        static void BuildUpdateRegions(std::vector<NGridType*> const& grids, std::vector<std::vector<NGridType*>>& regions);
+
         bool i_scriptLock;
+        uint32 _updateCost;
         std::set<WorldObject*> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
         std::set<WorldObject*> i_worldObjects;
@@ -806,7 +844,13 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_map<ObjectGuid, Corpse*> _corpsesByPlayer;
         std::unordered_set<Corpse*> _corpseBones;
 
-        std::unordered_set<Object*> _updateObjects;
+        // dirty objects, removal leaves a null hole so the list is never reordered while SendObjectUpdates runs
+        std::vector<Object*> _updateObjects;
+        std::unique_ptr<UpdateDataMap> _updateDatas;
+        std::unique_ptr<WorldPacket> _updatePacket;
+
+        std::unique_ptr<PathCache> _pathCache;
+        std::unique_ptr<PathRequestQueue> _pathRequests;
 };
 
 enum InstanceResetMethod
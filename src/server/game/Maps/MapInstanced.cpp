@@ -29,6 +29,7 @@
 #include "ScenarioMgr.h"
 #include "VMapFactory.h"
 #include "World.h"
+#include <algorithm>
 
 MapInstanced::MapInstanced(uint32 id, time_t expiry) : Map(id, expiry, 0, DIFFICULTY_NORMAL)
 {
@@ -52,6 +53,8 @@ void MapInstanced::Update(const uint32 t)
 
     // update the instanced maps
     InstancedMaps::iterator i = m_InstancedMaps.begin();
+    MapUpdater* updater = sMapMgr->GetMapUpdater();
+    std::vector<Map*> scheduled;
 
     while (i != m_InstancedMaps.end())
     {
@@ -65,13 +68,17 @@ void MapInstanced::Update(const uint32 t)
         else
         {
             // update only here, because it may schedule some bad things before delete
-            if (sMapMgr->GetMapUpdater()->activated())
-                sMapMgr->GetMapUpdater()->schedule_update(*i->second, t);
+            if (updater->activated())
+                scheduled.push_back(i->second);
             else
                 i->second->Update(t);
             ++i;
         }
     }
+
+    std::stable_sort(scheduled.begin(), scheduled.end(), [](Map const* left, Map const* right) { return left->GetUpdateCost() > right->GetUpdateCost(); });
+    for (Map* map : scheduled)
+        updater->schedule_update(*map, t);
 }
 
 void MapInstanced::DelayedUpdate(const uint32 diff)
@@ -34,6 +34,7 @@
 #include "WorldSession.h"
 #include "Opcodes.h"
 #include "MiscPackets.h"
+#include <algorithm>
 
 MapManager::MapManager()
     : _nextInstanceId(0), _scheduledScripts(0)
@@ -52,6 +53,8 @@ void MapManager::Initialize()
     // Start mtmaps if needed.
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    _gridPrefetcher.Activate(sWorld->getIntConfig(CONFIG_GRID_PREFETCH_THREADS));
 }
 
 void MapManager::InitializeParentMapData(std::unordered_map<uint32, std::vector<uint32>> const& mapData)
@@ -235,20 +238,33 @@ Map::EnterState MapManager::PlayerCannotEnter(uint32 mapid, Player* player, bool
 
 void MapManager::Update(uint32 diff)
 {
+    _gridPrefetcher.Update(diff);
+
     i_timer.Update(diff);
     if (!i_timer.Passed())
         return;
 
     MapMapType::iterator iter = i_maps.begin();
-    for (; iter != i_maps.end(); ++iter)
+    if (m_updater.activated())
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
-        else
+        // most expensive maps first so they do not end up alone at the tail of the tick
+        std::vector<Map*> maps;
+        maps.reserve(i_maps.size());
+        for (; iter != i_maps.end(); ++iter)
+            maps.push_back(iter->second);
+
+        std::stable_sort(maps.begin(), maps.end(), [](Map const* left, Map const* right) { return left->GetUpdateCost() > right->GetUpdateCost(); });
+
+        for (Map* map : maps)
+            m_updater.schedule_update(*map, uint32(i_timer.GetCurrent()));
+
+        m_updater.wait();
+    }
+    else
+    {
+        for (; iter != i_maps.end(); ++iter)
             iter->second->Update(uint32(i_timer.GetCurrent()));
     }
-    if (m_updater.activated())
-        m_updater.wait();
 
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
@@ -295,6 +311,8 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    _gridPrefetcher.Deactivate();
+
     Map::DeleteStateMachine();
 }
 
@@ -22,6 +22,7 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "GridStates.h"
+#include "GridPrefetcher.h"
 #include "MapUpdater.h"
 #include <boost/dynamic_bitset.hpp>
 
@@ -118,6 +119,7 @@ class TC_GAME_API MapManager
         void FreeInstanceId(uint32 instanceId);
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        GridPrefetcher* GetGridPrefetcher() { return &_gridPrefetcher; }
 
         template<typename Worker>
         void DoForAllMaps(Worker&& worker);
@@ -156,6 +158,7 @@ class TC_GAME_API MapManager
         InstanceIds _freeInstanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        GridPrefetcher _gridPrefetcher;
 
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
@@ -17,52 +17,156 @@
 
 #include "MapUpdater.h"
 #include "Map.h"
+#include <chrono>
 
-#include <mutex>
+class MapUpdateRequest
+{
+    public:
 
+        MapUpdateRequest(MapUpdater& u, uint32 cost)
+            : m_updater(u), m_cost(cost), m_worker(0)
+        {
+        }
 
-class MapUpdateRequest
+        virtual ~MapUpdateRequest() { }
+
+        virtual void call() = 0;
+
+        uint32 GetEstimatedCost() const { return m_cost; }
+        uint64 GetLoad() const { return uint64(m_cost) + 1; }
+
+        size_t GetWorker() const { return m_worker; }
+        void SetWorker(size_t worker) { m_worker = worker; }
+
+    protected:
+
+        void finished() { m_updater.update_finished(*this); }
+        void released() { m_updater.release_load(*this); }
+
+        MapUpdater& m_updater;
+        uint32 m_cost;
+        size_t m_worker;                    // worker whose load accounts for this request
+};
+
+class MapUpdateMapRequest : public MapUpdateRequest
 {
     private:
 
         Map& m_map;
-        MapUpdater& m_updater;
         uint32 m_diff;
 
     public:
 
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d)
-            : m_map(m), m_updater(u), m_diff(d)
+        MapUpdateMapRequest(Map& m, MapUpdater& u, uint32 d)
+            : MapUpdateRequest(u, m.GetUpdateCost()), m_map(m), m_diff(d)
         {
         }
 
-        void call()
+        void call() override
         {
-            m_map.Update (m_diff);
-            m_updater.update_finished();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            m_map.Update(m_diff);
+
+            m_map.RecordUpdateCost(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+            finished();
+        }
+};
+
+// Shared state of one run_parallel call, tasks are claimed by index so every worker
+// holding a share of the group keeps executing until no unclaimed task is left
+struct MapUpdateTaskGroup
+{
+    MapUpdateTaskGroup(std::vector<std::function<void()>> const& tasks)
+        : Tasks(tasks), Size(tasks.size()), Next(0), Finished(0)
+    {
+    }
+
+    void Execute()
+    {
+        size_t index;
+        while ((index = Next++) < Size)
+        {
+            Tasks[index]();
+
+            if (++Finished == Size)
+            {
+                std::lock_guard<std::mutex> lock(Lock);
+                Condition.notify_all();
+            }
+        }
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+
+        while (Finished < Size)
+            Condition.wait(lock);
+    }
+
+    // only dereferenced while Finished < Size, the owning run_parallel call is still waiting then
+    std::vector<std::function<void()>> const& Tasks;
+    size_t const Size;
+    std::atomic<size_t> Next;
+    std::atomic<size_t> Finished;
+    std::mutex Lock;
+    std::condition_variable Condition;
+};
+
+class MapUpdateTaskRequest : public MapUpdateRequest
+{
+    private:
+
+        std::shared_ptr<MapUpdateTaskGroup> m_group;
+
+    public:
+
+        MapUpdateTaskRequest(std::shared_ptr<MapUpdateTaskGroup> group, MapUpdater& u)
+            : MapUpdateRequest(u, 0), m_group(std::move(group))
+        {
+        }
+
+        void call() override
+        {
+            m_group->Execute();
+            released();
         }
 };
 
 void MapUpdater::activate(size_t num_threads)
 {
+    for (size_t i = 0; i < num_threads; ++i)
+        _queues.push_back(std::make_unique<WorkerQueue>());
+
     for (size_t i = 0; i < num_threads; ++i)
     {
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
     }
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
     wait();
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        _cancelationToken = true;
+        _queueCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
     {
         thread.join();
     }
+
+    // leftover shares of already finished task groups
+    for (std::unique_ptr<WorkerQueue>& queue : _queues)
+        for (MapUpdateRequest* request : queue->Requests)
+            delete request;
+
+    _queues.clear();
+    _workerThreads.clear();
 }
 
 void MapUpdater::wait()
@@ -77,11 +181,36 @@ void MapUpdater::wait()
 
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        ++pending_requests;
+    }
+
+    push_request(new MapUpdateMapRequest(map, *this, diff));
+}
+
+void MapUpdater::run_parallel(std::vector<std::function<void()>> const& tasks)
+{
+    if (tasks.empty())
+        return;
+
+    if (!activated() || tasks.size() == 1)
+    {
+        for (std::function<void()> const& task : tasks)
+            task();
+
+        return;
+    }
+
+    std::shared_ptr<MapUpdateTaskGroup> group = std::make_shared<MapUpdateTaskGroup>(tasks);
 
-    ++pending_requests;
+    // calling thread takes one share itself
+    size_t shares = std::min(tasks.size() - 1, _workerThreads.size());
+    for (size_t i = 0; i < shares; ++i)
+        push_request(new MapUpdateTaskRequest(group, *this));
 
-    _queue.Push(new MapUpdateRequest(map, *this, diff));
+    group->Execute();
+    group->Wait();
 }
 
 bool MapUpdater::activated()
@@ -89,8 +218,109 @@ bool MapUpdater::activated()
     return _workerThreads.size() > 0;
 }
 
-void MapUpdater::update_finished()
+void MapUpdater::push_request(MapUpdateRequest* request)
+{
+    // longest processing time first: requests arrive sorted by descending cost
+    // and each one goes to the worker with the least estimated load
+    size_t target = 0;
+    uint64 targetLoad = 0;
+    for (size_t i = 0; i < _queues.size(); ++i)
+    {
+        std::lock_guard<std::mutex> lock(_queues[i]->Lock);
+        if (!i || _queues[i]->EstimatedLoad < targetLoad)
+        {
+            target = i;
+            targetLoad = _queues[i]->EstimatedLoad;
+        }
+    }
+
+    // counted before it becomes visible so a concurrent pop never underflows the counter
+    ++_queuedRequests;
+
+    {
+        WorkerQueue& queue = *_queues[target];
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        request->SetWorker(target);
+        queue.Requests.push_back(request);
+        queue.EstimatedLoad += request->GetLoad();
+    }
+
+    std::lock_guard<std::mutex> lock(_queueLock);
+    _queueCondition.notify_one();
+}
+
+MapUpdateRequest* MapUpdater::pop_request(size_t workerIndex)
+{
+    WorkerQueue& queue = *_queues[workerIndex];
+
+    std::lock_guard<std::mutex> lock(queue.Lock);
+    if (queue.Requests.empty())
+        return nullptr;
+
+    // the load stays on this worker until the request finished
+    MapUpdateRequest* request = queue.Requests.front();
+    queue.Requests.pop_front();
+    --_queuedRequests;
+    return request;
+}
+
+MapUpdateRequest* MapUpdater::steal_request(size_t workerIndex)
+{
+    MapUpdateRequest* request = nullptr;
+    while (!request)
+    {
+        size_t victimIndex = workerIndex;
+        uint64 victimLoad = 0;
+        for (size_t i = 0; i < _queues.size(); ++i)
+        {
+            if (i == workerIndex)
+                continue;
+
+            std::lock_guard<std::mutex> lock(_queues[i]->Lock);
+            if (!_queues[i]->Requests.empty() && (victimIndex == workerIndex || _queues[i]->EstimatedLoad > victimLoad))
+            {
+                victimIndex = i;
+                victimLoad = _queues[i]->EstimatedLoad;
+            }
+        }
+
+        if (victimIndex == workerIndex)
+            return nullptr;
+
+        WorkerQueue& victim = *_queues[victimIndex];
+        std::lock_guard<std::mutex> lock(victim.Lock);
+
+        // emptied by its owner in the meantime, look again
+        if (victim.Requests.empty())
+            continue;
+
+        // requests are queued by descending cost, the cheapest one is at the back and the owner keeps the expensive ones
+        request = victim.Requests.back();
+        victim.Requests.pop_back();
+        victim.EstimatedLoad -= request->GetLoad();
+        --_queuedRequests;
+    }
+
+    WorkerQueue& queue = *_queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.Lock);
+    request->SetWorker(workerIndex);
+    queue.EstimatedLoad += request->GetLoad();
+    return request;
+}
+
+void MapUpdater::release_load(MapUpdateRequest const& request)
 {
+    WorkerQueue& queue = *_queues[request.GetWorker()];
+
+    std::lock_guard<std::mutex> lock(queue.Lock);
+    queue.EstimatedLoad -= request.GetLoad();
+}
+
+void MapUpdater::update_finished(MapUpdateRequest const& request)
+{
+    // released before the waiting thread is woken up, the next tick is placed by the load of the running maps only
+    release_load(request);
+
     std::lock_guard<std::mutex> lock(_lock);
 
     --pending_requests;
@@ -98,16 +328,26 @@ void MapUpdater::update_finished()
     _condition.notify_all();
 }
 
-void MapUpdater::WorkerThread()
+void MapUpdater::WorkerThread(size_t workerIndex)
 {
     while (1)
     {
-        MapUpdateRequest* request = nullptr;
+        MapUpdateRequest* request = pop_request(workerIndex);
+        if (!request)
+            request = steal_request(workerIndex);
+
+        if (!request)
+        {
+            std::unique_lock<std::mutex> lock(_queueLock);
+
+            while (!_queuedRequests && !_cancelationToken)
+                _queueCondition.wait(lock);
 
-        _queue.WaitAndPop(request);
+            if (_cancelationToken)
+                return;
 
-        if (_cancelationToken)
-            return;
+            continue;
+        }
 
         request->call();
 
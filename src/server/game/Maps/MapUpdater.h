@@ -19,19 +19,37 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
-#include <condition_variable>
-#include "ProducerConsumerQueue.h"
+#include <vector>
 
 class MapUpdateRequest;
 class Map;
 
+/*
+ * Work stealing map update scheduler.
+ *
+ * Every worker owns a request deque, new requests are placed on the deque with
+ * the lowest estimated load (using the cost each map measured during its previous
+ * updates) so the most expensive maps start first and are spread over all workers.
+ * The load of a worker covers its pending requests and the one it is executing.
+ * Idle workers steal the cheapest pending request from the most loaded deque.
+ *
+ * A single map can also split parts of its update into independent tasks
+ * with run_parallel(), the calling thread takes part in executing them.
+ * Only work touching nothing but the objects of one grid region may run that way,
+ * object and player updates share map-wide containers and stay serial.
+ */
 class TC_GAME_API MapUpdater
 {
     public:
 
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), pending_requests(0), _queuedRequests(0) { }
         ~MapUpdater() { };
 
         friend class MapUpdateRequest;
@@ -46,9 +64,21 @@ class TC_GAME_API MapUpdater
 
         bool activated();
 
+        // Executes all tasks and returns once every one of them finished, must not be called from inside a task
+        void run_parallel(std::vector<std::function<void()>> const& tasks);
+
     private:
 
-        ProducerConsumerQueue<MapUpdateRequest*> _queue;
+        struct WorkerQueue
+        {
+            WorkerQueue() : EstimatedLoad(0) { }
+
+            std::mutex Lock;
+            std::deque<MapUpdateRequest*> Requests;
+            uint64 EstimatedLoad;           // pending requests and the one being executed
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
 
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
@@ -57,9 +87,18 @@ class TC_GAME_API MapUpdater
         std::condition_variable _condition;
         size_t pending_requests;
 
-        void update_finished();
+        std::mutex _queueLock;
+        std::condition_variable _queueCondition;
+        std::atomic<size_t> _queuedRequests;
+
+        void push_request(MapUpdateRequest* request);
+        MapUpdateRequest* pop_request(size_t workerIndex);
+        MapUpdateRequest* steal_request(size_t workerIndex);
+
+        void release_load(MapUpdateRequest const& request);
+        void update_finished(MapUpdateRequest const& request);
 
-        void WorkerThread();
+        void WorkerThread(size_t workerIndex);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
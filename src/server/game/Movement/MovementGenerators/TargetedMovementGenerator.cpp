@@ -17,6 +17,7 @@
 
 #include "CreatureAI.h"
 #include "Creature.h"
+#include "MotionMaster.h"
 #include "Player.h"
 #include "VehicleDefines.h"
 #include "MoveSplineInit.h"
@@ -85,6 +86,10 @@ bool TargetedMovementGenerator<T, D>::DoUpdate(T* owner, uint32 diff)
     else if (_speedChanged)
         SetTargetLocation(owner, false);
 
+    // the new path is not launched yet
+    if (_path && _path->IsPathPending())
+        return true;
+
     if (!_targetReached && owner->movespline->Finalized())
     {
         MovementInform(owner);
@@ -165,8 +170,31 @@ void TargetedMovementGenerator<T, D>::SetTargetLocation(T* owner, bool updateDes
     // allow pets to use shortcut if no path found when following their master
     bool forceDest = (owner->GetTypeId() == TYPEID_UNIT && owner->ToCreature()->IsPet() && owner->HasUnitState(UNIT_STATE_FOLLOW));
 
-    bool result = _path->CalculatePath(x, y, z, forceDest);
-    if (!result || (_path->GetPathType() & PATHFIND_NOPATH))
+    // built at the end of the map update together with the paths of the other units
+    _path->CalculatePathAsync(x, y, z, forceDest, [this, owner](bool result)
+    {
+        LaunchMovement(owner, result);
+    });
+}
+
+template<class T, typename D>
+void TargetedMovementGenerator<T, D>::LaunchMovement(T* owner, bool pathResult)
+{
+    // the unit might have been controlled or stopped chasing since it requested the path
+    if (owner->GetMotionMaster()->empty() || owner->GetMotionMaster()->top() != this)
+        return;
+
+    if (!IsTargetValid() || !GetTarget()->IsInWorld() || !owner->IsAlive())
+        return;
+
+    if (owner->HasUnitState(UNIT_STATE_NOT_MOVE) || owner->IsMovementPreventedByCasting() || HasLostTarget(owner))
+    {
+        _interrupt = true;
+        owner->StopMoving();
+        return;
+    }
+
+    if (!pathResult || (_path->GetPathType() & PATHFIND_NOPATH))
     {
         // can't reach target
         _recalculateTravel = true;
@@ -60,6 +60,8 @@ class TargetedMovementGenerator : public MovementGeneratorMedium< T, D >, public
         void SetTargetLocation(T* owner, bool updateDestination);
 
     private:
+        void LaunchMovement(T* owner, bool pathResult);
+
         PathGenerator* _path;
         TimeTrackerSmall _timer;
         float _offset;
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathCache.h"
+#include "DetourNavMeshQuery.h"
+#include "GameTime.h"
+#include "Hash.h"
+#include "Timer.h"
+#include "World.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // positions within the same cell share corridors
+    float const PATH_CACHE_CELL_SIZE = 4.0f;
+
+    // upper limit of corridors kept per map
+    std::size_t const MAX_CACHED_PATHS = 512;
+
+    int16 QuantizeCoord(float coord)
+    {
+        return int16(std::floor(coord / PATH_CACHE_CELL_SIZE));
+    }
+}
+
+bool PathCache::Key::operator==(Key const& right) const
+{
+    return MapId == right.MapId && StartPoly == right.StartPoly && EndPoly == right.EndPoly
+        && std::equal(std::begin(Start), std::end(Start), std::begin(right.Start))
+        && std::equal(std::begin(End), std::end(End), std::begin(right.End))
+        && IncludeFlags == right.IncludeFlags && ExcludeFlags == right.ExcludeFlags;
+}
+
+std::size_t PathCache::KeyHash::operator()(Key const& key) const
+{
+    std::size_t hashVal = 0;
+    Trinity::hash_combine(hashVal, key.MapId);
+    Trinity::hash_combine(hashVal, key.StartPoly);
+    Trinity::hash_combine(hashVal, key.EndPoly);
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        Trinity::hash_combine(hashVal, key.Start[i]);
+        Trinity::hash_combine(hashVal, key.End[i]);
+    }
+
+    Trinity::hash_combine(hashVal, uint32(key.IncludeFlags) << 16 | key.ExcludeFlags);
+    return hashVal;
+}
+
+PathCache::Key PathCache::MakeKey(uint32 mapId, dtPolyRef startPoly, dtPolyRef endPoly, G3D::Vector3 const& start, G3D::Vector3 const& end, dtQueryFilter const& filter)
+{
+    Key key;
+    key.MapId = mapId;
+    key.StartPoly = startPoly;
+    key.EndPoly = endPoly;
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        key.Start[i] = QuantizeCoord(start[i]);
+        key.End[i] = QuantizeCoord(end[i]);
+    }
+
+    key.IncludeFlags = filter.getIncludeFlags();
+    key.ExcludeFlags = filter.getExcludeFlags();
+    return key;
+}
+
+uint32 PathCache::Find(Key const& key, dtNavMesh const* navMesh, dtPolyRef* polys, uint32 maxPolys)
+{
+    uint32 cacheTime = sWorld->getIntConfig(CONFIG_MMAP_PATH_CACHE_TIME);
+    if (!cacheTime)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _index.find(key);
+    if (itr == _index.end())
+        return 0;
+
+    Entry const& entry = *itr->second;
+    bool valid = getMSTimeDiff(entry.CreateTime, GameTime::GetGameTimeMS()) < cacheTime && entry.Polys.size() <= maxPolys;
+
+    // tiles might have been unloaded and replaced in the meantime, refs of removed polygons fail the salt check
+    if (valid)
+        valid = std::all_of(entry.Polys.begin(), entry.Polys.end(), [navMesh](dtPolyRef ref) { return navMesh->isValidPolyRef(ref); });
+
+    if (!valid)
+    {
+        _entries.erase(itr->second);
+        _index.erase(itr);
+        return 0;
+    }
+
+    _entries.splice(_entries.begin(), _entries, itr->second);
+    std::copy(entry.Polys.begin(), entry.Polys.end(), polys);
+    return uint32(entry.Polys.size());
+}
+
+void PathCache::Store(Key const& key, dtPolyRef const* polys, uint32 polyCount)
+{
+    if (!sWorld->getIntConfig(CONFIG_MMAP_PATH_CACHE_TIME) || !polyCount)
+        return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _index.find(key);
+    if (itr != _index.end())
+    {
+        // another thread found a corridor for the same key at the same time, keep the newer one
+        _entries.erase(itr->second);
+        _index.erase(itr);
+    }
+    else if (_entries.size() >= MAX_CACHED_PATHS)
+    {
+        _index.erase(_entries.back().CacheKey);
+        _entries.pop_back();
+    }
+
+    _entries.push_front({ key, std::vector<dtPolyRef>(polys, polys + polyCount), GameTime::GetGameTimeMS() });
+    _index[key] = _entries.begin();
+}
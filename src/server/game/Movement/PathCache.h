@@ -0,0 +1,87 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PathCache_h__
+#define PathCache_h__
+
+#include "Define.h"
+#include "DetourNavMesh.h"
+#include <G3D/Vector3.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class dtQueryFilter;
+
+/*
+ * Short lived cache of the polygon corridors found by PathGenerator, shared by all units of a map.
+ *
+ * Units moving from about the same place to about the same destination (packs of mobs chasing
+ * the same player) reuse the corridor found by the first of them instead of searching the navmesh
+ * again, the point path is still built by every unit from its own start and end point.
+ * Entries expire after mmap.pathCacheTime and the least recently used ones are dropped once
+ * the cache is full. It is thread safe, path requests of a map are built on several threads.
+ */
+class TC_GAME_API PathCache
+{
+    public:
+        struct Key
+        {
+            uint32 MapId;               // terrain map the navmesh belongs to
+            dtPolyRef StartPoly;
+            dtPolyRef EndPoly;
+            int16 Start[3];             // positions quantized to PATH_CACHE_CELL_SIZE
+            int16 End[3];
+            uint16 IncludeFlags;
+            uint16 ExcludeFlags;
+
+            bool operator==(Key const& right) const;
+        };
+
+        PathCache() { }
+
+        static Key MakeKey(uint32 mapId, dtPolyRef startPoly, dtPolyRef endPoly, G3D::Vector3 const& start, G3D::Vector3 const& end, dtQueryFilter const& filter);
+
+        // Copies a cached corridor to polys, returns its length or 0 if there is none or one of its polygons was unloaded since
+        uint32 Find(Key const& key, dtNavMesh const* navMesh, dtPolyRef* polys, uint32 maxPolys);
+        void Store(Key const& key, dtPolyRef const* polys, uint32 polyCount);
+
+    private:
+        struct KeyHash
+        {
+            std::size_t operator()(Key const& key) const;
+        };
+
+        struct Entry
+        {
+            Key CacheKey;
+            std::vector<dtPolyRef> Polys;
+            uint32 CreateTime;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex _lock;
+        EntryList _entries;             // most recently used first
+        std::unordered_map<Key, EntryList::iterator, KeyHash> _index;
+
+        PathCache(PathCache const& right) = delete;
+        PathCache& operator=(PathCache const& right) = delete;
+};
+
+#endif // PathCache_h__
@@ -26,25 +26,30 @@
 #include "MMapManager.h"
 #include "Map.h"
 #include "Metric.h"
+#include "PathCache.h"
+#include "PathRequestQueue.h"
 #include "PhasingHandler.h"
+#include "TileGraph.h"
+#include "World.h"
 
 ////////////////// PathGenerator //////////////////
 PathGenerator::PathGenerator(const Unit* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _straightLine(false),
     _endPosition(G3D::Vector3::zero()), _sourceUnit(owner), _navMesh(nullptr),
-    _navMeshQuery(nullptr)
+    _navMeshQuery(nullptr), _tileGraph(nullptr)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
     TC_LOG_DEBUG("maps", "++ PathGenerator::PathGenerator for %s", _sourceUnit->GetGUID().ToString().c_str());
 
-    uint32 mapId = PhasingHandler::GetTerrainMapId(_sourceUnit->GetPhaseShift(), _sourceUnit->GetMap(), _sourceUnit->GetPositionX(), _sourceUnit->GetPositionY());
+    _terrainMapId = PhasingHandler::GetTerrainMapId(_sourceUnit->GetPhaseShift(), _sourceUnit->GetMap(), _sourceUnit->GetPositionX(), _sourceUnit->GetPositionY());
     if (DisableMgr::IsPathfindingEnabled(_sourceUnit->GetMapId()))
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        _navMesh = mmap->GetNavMesh(mapId);
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _sourceUnit->GetInstanceId());
+        _navMesh = mmap->GetNavMesh(_terrainMapId);
+        _navMeshQuery = mmap->GetNavMeshQuery(_terrainMapId, _sourceUnit->GetInstanceId());
+        _tileGraph = mmap->GetTileGraph(_terrainMapId);
     }
 
     CreateFilter();
@@ -53,6 +58,8 @@ PathGenerator::PathGenerator(const Unit* owner) :
 PathGenerator::~PathGenerator()
 {
     TC_LOG_DEBUG("maps", "++ PathGenerator::~PathGenerator() for %s", _sourceUnit->GetGUID().ToString().c_str());
+
+    CancelPendingPath();
 }
 
 bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool forceDest, bool straightLine)
@@ -78,8 +85,74 @@ bool PathGenerator::CalculatePath(G3D::Vector3 start, G3D::Vector3 dest, bool fo
 {
     TC_METRIC_EVENT("mmap_events", "CalculatePath", "");
 
+    CancelPendingPath();
+
+    switch (InitPath(start, dest, forceDest, straightLine))
+    {
+        case PATH_INIT_INVALID:
+            return false;
+        case PATH_INIT_DONE:
+            return true;
+        default:
+            break;
+    }
+
+    FindPolyPath(start, dest);
+    BuildPolyPath(start, dest);
+    return true;
+}
+
+void PathGenerator::CalculatePathAsync(float destX, float destY, float destZ, bool forceDest, std::function<void(bool)> callback)
+{
+    TC_METRIC_EVENT("mmap_events", "CalculatePathAsync", "");
+
+    CancelPendingPath();
+
+    float x, y, z;
+    _sourceUnit->GetPosition(x, y, z);
+
+    G3D::Vector3 start(x, y, z);
+    G3D::Vector3 dest(destX, destY, destZ);
+
+    switch (InitPath(start, dest, forceDest, false))
+    {
+        case PATH_INIT_INVALID:
+            callback(false);
+            return;
+        case PATH_INIT_DONE:
+            callback(true);
+            return;
+        default:
+            break;
+    }
+
+    if (!sWorld->getBoolConfig(CONFIG_MMAP_ASYNC_PATH_REQUESTS))
+    {
+        FindPolyPath(start, dest);
+        BuildPolyPath(start, dest);
+        callback(true);
+        return;
+    }
+
+    _request = std::make_shared<PathRequest>();
+    _request->Path = this;
+    _request->Callback = std::move(callback);
+    _sourceUnit->GetMap()->GetPathRequestQueue().Add(_request);
+}
+
+void PathGenerator::CancelPendingPath()
+{
+    if (!_request)
+        return;
+
+    _request->Path = nullptr;
+    _request.reset();
+}
+
+PathGenerator::PathInitResult PathGenerator::InitPath(G3D::Vector3 const& start, G3D::Vector3 const& dest, bool forceDest, bool straightLine)
+{
     if (!Trinity::IsValidMapCoord(start.x , start.y, start.z) || !Trinity::IsValidMapCoord(dest.x, dest.y, dest.z))
-        return false;
+        return PATH_INIT_INVALID;
 
     SetEndPosition(dest);
     SetStartPosition(start);
@@ -96,13 +169,11 @@ bool PathGenerator::CalculatePath(G3D::Vector3 start, G3D::Vector3 dest, bool fo
     {
         BuildShortcut();
         _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return PATH_INIT_DONE;
     }
 
     UpdateFilter();
-
-    BuildPolyPath(start, dest);
-    return true;
+    return PATH_INIT_NAVMESH;
 }
 
 dtPolyRef PathGenerator::GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* point, float* distance) const
@@ -172,89 +243,44 @@ dtPolyRef PathGenerator::GetPolyByLocation(float const* point, float* distance)
     return INVALID_POLYREF;
 }
 
-void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos)
+void PathGenerator::FindPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos)
 {
+    PolyPathResult& result = _polyPath;
+    result.FarFromPoly = false;
+    result.EndPointMoved = false;
+    result.Hierarchical = false;
+    result.PointCount = 0;
+    result.PointPathStatus = DT_FAILURE;
+
     // *** getting start/end poly logic ***
 
-    float distToStartPoly, distToEndPoly;
-    float startPoint[VERTEX_SIZE] = {startPos.y, startPos.z, startPos.x};
-    float endPoint[VERTEX_SIZE] = {endPos.y, endPos.z, endPos.x};
+    float* startPoint = result.StartPoint;
+    float* endPoint = result.EndPoint;
+    startPoint[0] = startPos.y; startPoint[1] = startPos.z; startPoint[2] = startPos.x;
+    endPoint[0] = endPos.y; endPoint[1] = endPos.z; endPoint[2] = endPos.x;
 
-    dtPolyRef startPoly = GetPolyByLocation(startPoint, &distToStartPoly);
-    dtPolyRef endPoly = GetPolyByLocation(endPoint, &distToEndPoly);
+    result.StartPoly = GetPolyByLocation(startPoint, &result.DistToStartPoly);
+    result.EndPoly = GetPolyByLocation(endPoint, &result.DistToEndPoly);
 
-    // we have a hole in our mesh
-    // make shortcut path and mark it as NOPATH ( with flying and swimming exception )
-    // its up to caller how he will use this info
-    if (startPoly == INVALID_POLYREF || endPoly == INVALID_POLYREF)
+    // we have a hole in our mesh, BuildPolyPath decides what to do
+    if (result.StartPoly == INVALID_POLYREF || result.EndPoly == INVALID_POLYREF)
     {
-        TC_LOG_DEBUG("maps", "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
-        BuildShortcut();
-        bool path = _sourceUnit->GetTypeId() == TYPEID_UNIT && _sourceUnit->ToCreature()->CanFly();
-
-        bool waterPath = _sourceUnit->GetTypeId() == TYPEID_UNIT && _sourceUnit->ToCreature()->CanSwim();
-        if (waterPath)
-        {
-            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
-            for (uint32 i = 0; i < _pathPoints.size(); ++i)
-            {
-                ZLiquidStatus status = _sourceUnit->GetMap()->GetLiquidStatus(_sourceUnit->GetPhaseShift(), _pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, nullptr);
-                // One of the points is not in the water, cancel movement.
-                if (status == LIQUID_MAP_NO_WATER)
-                {
-                    waterPath = false;
-                    break;
-                }
-            }
-        }
-
-        _type = (path || waterPath) ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+        result.Status = POLY_PATH_NO_POLY;
         return;
     }
 
     // we may need a better number here
-    bool farFromPoly = (distToStartPoly > 7.0f || distToEndPoly > 7.0f);
-    if (farFromPoly)
+    result.FarFromPoly = (result.DistToStartPoly > 7.0f || result.DistToEndPoly > 7.0f);
+    if (result.FarFromPoly)
     {
-        TC_LOG_DEBUG("maps", "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
-
-        bool buildShotrcut = false;
-        if (_sourceUnit->GetTypeId() == TYPEID_UNIT)
-        {
-            Creature* owner = (Creature*)_sourceUnit;
-
-            G3D::Vector3 const& p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (_sourceUnit->GetMap()->IsUnderWater(_sourceUnit->GetPhaseShift(), p.x, p.y, p.z))
-            {
-                TC_LOG_DEBUG("maps", "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
-                    buildShotrcut = true;
-            }
-            else
-            {
-                TC_LOG_DEBUG("maps", "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
-                    buildShotrcut = true;
-            }
-        }
-
-        if (buildShotrcut)
-        {
-            BuildShortcut();
-            _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-            return;
-        }
-        else
+        // swimming and flying creatures take a shortcut instead, that depends on terrain so it is decided by BuildPolyPath
+        // the path to the closest point on the mesh is built anyway
+        float closestPoint[VERTEX_SIZE];
+        // we may want to use closestPointOnPolyBoundary instead
+        if (dtStatusSucceed(_navMeshQuery->closestPointOnPoly(result.EndPoly, endPoint, closestPoint, nullptr)))
         {
-            float closestPoint[VERTEX_SIZE];
-            // we may want to use closestPointOnPolyBoundary instead
-            if (dtStatusSucceed(_navMeshQuery->closestPointOnPoly(endPoly, endPoint, closestPoint, nullptr)))
-            {
-                dtVcopy(endPoint, closestPoint);
-                SetActualEndPosition(G3D::Vector3(endPoint[2], endPoint[0], endPoint[1]));
-            }
-
-            _type = PATHFIND_INCOMPLETE;
+            dtVcopy(endPoint, closestPoint);
+            result.EndPointMoved = true;
         }
     }
 
@@ -262,20 +288,22 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
 
     // start and end are on same polygon
     // just need to move in straight line
-    if (startPoly == endPoly)
+    if (result.StartPoly == result.EndPoly)
     {
-        TC_LOG_DEBUG("maps", "++ BuildPolyPath :: (startPoly == endPoly)\n");
-
-        BuildShortcut();
-
-        _pathPolyRefs[0] = startPoly;
-        _polyLength = 1;
+        result.Status = POLY_PATH_SAME_POLY;
+        return;
+    }
 
-        _type = farFromPoly ? PATHFIND_INCOMPLETE : PATHFIND_NORMAL;
-        TC_LOG_DEBUG("maps", "++ BuildPolyPath :: path type %d\n", _type);
+    // the corridor to far destinations is longer than MAX_PATH_LENGTH, it is routed over the navmesh graph instead
+    if (FindHierarchicalPath(startPos, endPos))
+    {
+        result.Status = POLY_PATH_FOUND;
         return;
     }
 
+    dtPolyRef const startPoly = result.StartPoly;
+    dtPolyRef const endPoly = result.EndPoly;
+
     // look for startPoly/endPoly in current path
     /// @todo we can merge it with getPathPolyByPosition() loop
     bool startPolyFound = false;
@@ -356,8 +384,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             if (dtStatusFailed(_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr)))
             {
                 // suffixStartPoly is still invalid, error state
-                BuildShortcut();
-                _type = PATHFIND_NOPATH;
+                result.Status = POLY_PATH_FAILED;
                 return;
             }
         }
@@ -387,7 +414,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             if (hit != FLT_MAX)
             {
                 // the ray hit something, return no path instead of the incomplete one
-                _type = PATHFIND_NOPATH;
+                result.Status = POLY_PATH_BLOCKED;
                 return;
             }
         }
@@ -450,46 +477,286 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             if (hit != FLT_MAX)
             {
                 // the ray hit something, return no path instead of the incomplete one
-                _type = PATHFIND_NOPATH;
+                result.Status = POLY_PATH_BLOCKED;
                 return;
             }
         }
         else
         {
-            dtResult = _navMeshQuery->findPath(
-                            startPoly,          // start polygon
-                            endPoly,            // end polygon
-                            startPoint,         // start position
-                            endPoint,           // end position
-                            &_filter,           // polygon search filter
-                            _pathPolyRefs,     // [out] path
-                            (int*)&_polyLength,
-                            MAX_PATH_LENGTH);   // max number of polygons in output path
+            // units going from and to about the same place (mobs chasing the same target) share the corridor
+            PathCache& cache = _sourceUnit->GetMap()->GetPathCache();
+            PathCache::Key cacheKey = PathCache::MakeKey(_terrainMapId, startPoly, endPoly, startPos, endPos, _filter);
+            _polyLength = cache.Find(cacheKey, _navMesh, _pathPolyRefs, MAX_PATH_LENGTH);
+            if (_polyLength)
+                dtResult = DT_SUCCESS;
+            else
+            {
+                dtResult = _navMeshQuery->findPath(
+                                startPoly,          // start polygon
+                                endPoly,            // end polygon
+                                startPoint,         // start position
+                                endPoint,           // end position
+                                &_filter,           // polygon search filter
+                                _pathPolyRefs,     // [out] path
+                                (int*)&_polyLength,
+                                MAX_PATH_LENGTH);   // max number of polygons in output path
+
+                if (dtStatusSucceed(dtResult))
+                    cache.Store(cacheKey, _pathPolyRefs, _polyLength);
+            }
         }
 
         if (!_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
             TC_LOG_ERROR("maps", "%s's Path Build failed: 0 length path", _sourceUnit->GetGUID().ToString().c_str());
+            result.Status = POLY_PATH_FAILED;
+            return;
+        }
+    }
+
+    result.Status = POLY_PATH_FOUND;
+
+    // generate the point-path out of our up-to-date poly-path
+    FindPointPath(startPoint, endPoint);
+}
+
+bool PathGenerator::FindHierarchicalPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos)
+{
+    // straight lines and paths with a length limit keep the regular search
+    if (!_tileGraph || _straightLine || _pointPathLimit != MAX_POINT_PATH_LENGTH)
+        return false;
+
+    if ((endPos.xy() - startPos.xy()).squaredLength() < HIERARCHICAL_PATH_MIN_DIST * HIERARCHICAL_PATH_MIN_DIST)
+        return false;
+
+    PolyPathResult& result = _polyPath;
+    uint32 startNode = _tileGraph->GetNode(_navMesh, result.StartPoly);
+    uint32 endNode = _tileGraph->GetNode(_navMesh, result.EndPoly);
+    if (startNode == MMAP_GRAPH_INVALID_NODE || endNode == MMAP_GRAPH_INVALID_NODE)
+        return false;
+
+    std::vector<float> portals;
+    if (!_tileGraph->FindRoute(startNode, endNode, _filter, portals))
+        return false;
+
+    uint32 const portalCount = uint32(portals.size() / VERTEX_SIZE);
+    float const maxLegDistSqr = HIERARCHICAL_PATH_LEG_LENGTH * HIERARCHICAL_PATH_LEG_LENGTH;
+    uint32 nextPortal = 0;
+
+    float legStart[VERTEX_SIZE];
+    dtVcopy(legStart, result.StartPoint);
+    dtPolyRef legStartPoly = result.StartPoly;
+
+    dtPolyRef legPolys[MAX_PATH_LENGTH];
+    dtPolyRef firstLegPolys[MAX_PATH_LENGTH];
+    uint32 firstLegPolyCount = 0;
+    float legPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
+
+    std::vector<float>& pathPoints = result.PathPoints;
+    pathPoints.clear();
+
+    while (true)
+    {
+        float legEnd[VERTEX_SIZE];
+        dtPolyRef legEndPoly = INVALID_POLYREF;
+        bool lastLeg = nextPortal >= portalCount || dtVdist2DSqr(legStart, result.EndPoint) <= maxLegDistSqr;
+        if (lastLeg)
+        {
+            dtVcopy(legEnd, result.EndPoint);
+            legEndPoly = result.EndPoly;
+        }
+        else
+        {
+            // furthest portal of the route still in range, at least the next one
+            uint32 portal = nextPortal;
+            while (portal + 1 < portalCount && dtVdist2DSqr(legStart, &portals[(portal + 1) * VERTEX_SIZE]) <= maxLegDistSqr)
+                ++portal;
+
+            nextPortal = portal + 1;
+
+            float const extents[VERTEX_SIZE] = { 3.0f, 5.0f, 3.0f };
+            if (dtStatusFailed(_navMeshQuery->findNearestPoly(&portals[portal * VERTEX_SIZE], extents, &_filter, &legEndPoly, legEnd)) || legEndPoly == INVALID_POLYREF)
+                return false;
+        }
+
+        uint32 legPolyCount = 1;
+        legPolys[0] = legStartPoly;
+        if (legStartPoly != legEndPoly)
+        {
+            dtStatus dtResult = _navMeshQuery->findPath(legStartPoly, legEndPoly, legStart, legEnd, &_filter, legPolys, (int*)&legPolyCount, MAX_PATH_LENGTH);
+
+            // a leg that cannot be completed means the graph is out of date, the regular search decides what to do
+            if (dtStatusFailed(dtResult) || !legPolyCount || legPolys[legPolyCount - 1] != legEndPoly)
+                return false;
+        }
+
+        uint32 legPointCount = 0;
+        dtStatus dtResult;
+        if (_useStraightPath)
+            dtResult = _navMeshQuery->findStraightPath(legStart, legEnd, legPolys, legPolyCount, legPoints, nullptr, nullptr, (int*)&legPointCount, MAX_POINT_PATH_LENGTH);
+        else
+            dtResult = FindSmoothPath(legStart, legEnd, legPolys, legPolyCount, legPoints, (int*)&legPointCount, MAX_POINT_PATH_LENGTH);
+
+        if (dtStatusFailed(dtResult) || !legPointCount)
+            return false;
+
+        // every leg starts where the previous one ended
+        uint32 firstPoint = pathPoints.empty() ? 0 : 1;
+        if (pathPoints.size() / VERTEX_SIZE + legPointCount - firstPoint > MAX_HIERARCHICAL_POINT_PATH_LENGTH)
+            return false;
+
+        pathPoints.insert(pathPoints.end(), legPoints + firstPoint * VERTEX_SIZE, legPoints + legPointCount * VERTEX_SIZE);
+
+        if (!firstLegPolyCount)
+        {
+            memcpy(firstLegPolys, legPolys, legPolyCount * sizeof(dtPolyRef));
+            firstLegPolyCount = legPolyCount;
+        }
+
+        if (lastLeg)
+            break;
+
+        dtVcopy(legStart, legEnd);
+        legStartPoly = legEndPoly;
+    }
+
+    // only the corridor of the first leg is kept, it helps finding the start polygon of the next calculation
+    memcpy(_pathPolyRefs, firstLegPolys, firstLegPolyCount * sizeof(dtPolyRef));
+    _polyLength = firstLegPolyCount;
+
+    result.PointCount = uint32(pathPoints.size() / VERTEX_SIZE);
+    result.PointPathStatus = DT_SUCCESS;
+    result.Hierarchical = true;
+    return true;
+}
+
+void PathGenerator::FindQueuedPolyPath()
+{
+    // the query of the instance belongs to the map thread, requests are built on any map update thread
+    dtNavMeshQuery const* instanceQuery = _navMeshQuery;
+    _navMeshQuery = MMAP::MMapManager::GetThreadNavMeshQuery(_navMesh);
+    if (_navMeshQuery)
+        FindPolyPath(GetStartPosition(), GetEndPosition());
+    else
+    {
+        _polyPath.Status = POLY_PATH_FAILED;
+        _polyPath.FarFromPoly = false;
+        _polyPath.Hierarchical = false;
+    }
+
+    _navMeshQuery = instanceQuery;
+}
+
+void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos)
+{
+    PolyPathResult const& result = _polyPath;
+
+    // we have a hole in our mesh
+    // make shortcut path and mark it as NOPATH ( with flying and swimming exception )
+    // its up to caller how he will use this info
+    if (result.Status == POLY_PATH_NO_POLY)
+    {
+        TC_LOG_DEBUG("maps", "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
+        BuildShortcut();
+        bool path = _sourceUnit->GetTypeId() == TYPEID_UNIT && _sourceUnit->ToCreature()->CanFly();
+
+        bool waterPath = _sourceUnit->GetTypeId() == TYPEID_UNIT && _sourceUnit->ToCreature()->CanSwim();
+        if (waterPath)
+        {
+            // Check both start and end points, if they're both in water, then we can *safely* let the creature move
+            for (uint32 i = 0; i < _pathPoints.size(); ++i)
+            {
+                ZLiquidStatus status = _sourceUnit->GetMap()->GetLiquidStatus(_sourceUnit->GetPhaseShift(), _pathPoints[i].x, _pathPoints[i].y, _pathPoints[i].z, MAP_ALL_LIQUIDS, nullptr);
+                // One of the points is not in the water, cancel movement.
+                if (status == LIQUID_MAP_NO_WATER)
+                {
+                    waterPath = false;
+                    break;
+                }
+            }
+        }
+
+        _type = (path || waterPath) ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+        return;
+    }
+
+    if (result.FarFromPoly)
+    {
+        TC_LOG_DEBUG("maps", "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", result.DistToStartPoly, result.DistToEndPoly);
+
+        bool buildShotrcut = false;
+        if (_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        {
+            Creature* owner = (Creature*)_sourceUnit;
+
+            G3D::Vector3 const& p = (result.DistToStartPoly > 7.0f) ? startPos : endPos;
+            if (_sourceUnit->GetMap()->IsUnderWater(_sourceUnit->GetPhaseShift(), p.x, p.y, p.z))
+            {
+                TC_LOG_DEBUG("maps", "++ BuildPolyPath :: underWater case\n");
+                if (owner->CanSwim())
+                    buildShotrcut = true;
+            }
+            else
+            {
+                TC_LOG_DEBUG("maps", "++ BuildPolyPath :: flying case\n");
+                if (owner->CanFly())
+                    buildShotrcut = true;
+            }
+        }
+
+        if (buildShotrcut)
+        {
             BuildShortcut();
-            _type = PATHFIND_NOPATH;
+            _type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
             return;
         }
+        else
+        {
+            if (result.EndPointMoved)
+                SetActualEndPosition(G3D::Vector3(result.EndPoint[2], result.EndPoint[0], result.EndPoint[1]));
+
+            _type = PATHFIND_INCOMPLETE;
+        }
+    }
+
+    switch (result.Status)
+    {
+        case POLY_PATH_SAME_POLY:
+            TC_LOG_DEBUG("maps", "++ BuildPolyPath :: (startPoly == endPoly)\n");
+
+            BuildShortcut();
+
+            _pathPolyRefs[0] = result.StartPoly;
+            _polyLength = 1;
+
+            _type = result.FarFromPoly ? PATHFIND_INCOMPLETE : PATHFIND_NORMAL;
+            TC_LOG_DEBUG("maps", "++ BuildPolyPath :: path type %d\n", _type);
+            return;
+        case POLY_PATH_FAILED:
+            BuildShortcut();
+            _type = PATHFIND_NOPATH;
+            return;
+        case POLY_PATH_BLOCKED:
+            _type = PATHFIND_NOPATH;
+            return;
+        default:
+            break;
     }
 
     // by now we know what type of path we can get
-    if (_pathPolyRefs[_polyLength - 1] == endPoly && !(_type & PATHFIND_INCOMPLETE))
+    if ((result.Hierarchical || _pathPolyRefs[_polyLength - 1] == result.EndPoly) && !(_type & PATHFIND_INCOMPLETE))
         _type = PATHFIND_NORMAL;
     else
         _type = PATHFIND_INCOMPLETE;
 
-    // generate the point-path out of our up-to-date poly-path
-    BuildPointPath(startPoint, endPoint);
+    BuildPointPath();
 }
 
-void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoint)
+void PathGenerator::FindPointPath(float const* startPoint, float const* endPoint)
 {
-    float pathPoints[MAX_POINT_PATH_LENGTH*VERTEX_SIZE];
+    _polyPath.PathPoints.resize(MAX_POINT_PATH_LENGTH * VERTEX_SIZE);
+    float* pathPoints = _polyPath.PathPoints.data();
     uint32 pointCount = 0;
     dtStatus dtResult = DT_FAILURE;
     if (_straightLine)
@@ -543,7 +810,15 @@ void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoin
                 _pointPathLimit);    // maximum number of points
     }
 
-    if (pointCount < 2 || dtStatusFailed(dtResult))
+    _polyPath.PointCount = pointCount;
+    _polyPath.PointPathStatus = dtResult;
+}
+
+void PathGenerator::BuildPointPath()
+{
+    float const* pathPoints = _polyPath.PathPoints.data();
+    uint32 pointCount = _polyPath.PointCount;
+    if (pointCount < 2 || dtStatusFailed(_polyPath.PointPathStatus))
     {
         // only happens if pass bad data to findStraightPath or navmesh is broken
         // single point paths can be generated here
@@ -553,7 +828,7 @@ void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoin
         _type = PATHFIND_NOPATH;
         return;
     }
-    else if (pointCount == _pointPathLimit)
+    else if (pointCount == _pointPathLimit && !_polyPath.Hierarchical)
     {
         TC_LOG_DEBUG("maps", "++ PathGenerator::BuildPointPath FAILED! path sized %d returned, lower than limit set to %d\n", pointCount, _pointPathLimit);
         BuildShortcut();
@@ -23,8 +23,17 @@
 #include "DetourNavMeshQuery.h"
 #include "MoveSplineInitArgs.h"
 #include <G3D/Vector3.h>
+#include <functional>
+#include <memory>
+#include <vector>
 
 class Unit;
+struct PathRequest;
+
+namespace MMAP
+{
+    class TileGraph;
+}
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -35,6 +44,12 @@ class Unit;
 #define SMOOTH_PATH_STEP_SIZE   4.0f
 #define SMOOTH_PATH_SLOP        0.3f
 
+// destinations further away are routed over the navmesh graph (mmaps/MMMM.mmgraph) first,
+// then reached by legs short enough for MAX_PATH_LENGTH polygons each
+#define HIERARCHICAL_PATH_MIN_DIST          150.0f
+#define HIERARCHICAL_PATH_LEG_LENGTH        100.0f
+#define MAX_HIERARCHICAL_POINT_PATH_LENGTH  1024
+
 #define VERTEX_SIZE       3
 #define INVALID_POLYREF   0
 
@@ -62,6 +77,12 @@ class TC_GAME_API PathGenerator
         bool CalculatePath(G3D::Vector3 start, G3D::Vector3 dest, bool forceDest = false, bool straightLine = false);
         bool IsInvalidDestinationZ(Unit const* target) const;
 
+        // Same as CalculatePath, but the navmesh queries are batched with the other requests of the map at the end of its update
+        // callback receives the result on the map thread, it is not called if the request is cancelled by a new one or by destroying the generator
+        void CalculatePathAsync(float destX, float destY, float destZ, bool forceDest, std::function<void(bool)> callback);
+        bool IsPathPending() const { return _request != nullptr; }
+        void CancelPendingPath();
+
         // option setters - use optional
         void SetUseStraightPath(bool useStraightPath) { _useStraightPath = useStraightPath; }
         void SetPathLengthLimit(float distance) { _pointPathLimit = std::min<uint32>(uint32(distance/SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); }
@@ -78,6 +99,41 @@ class TC_GAME_API PathGenerator
         void ReducePathLenghtByDist(float dist); // path must be already built
 
     private:
+        friend class PathRequestQueue;
+
+        enum PathInitResult
+        {
+            PATH_INIT_INVALID,      // invalid start or destination, no path
+            PATH_INIT_DONE,         // path was built without navmesh
+            PATH_INIT_NAVMESH       // navmesh queries are needed
+        };
+
+        enum PolyPathStatus
+        {
+            POLY_PATH_NO_POLY,      // start or end is not on the navmesh
+            POLY_PATH_SAME_POLY,    // start and end are on the same polygon
+            POLY_PATH_FAILED,       // no corridor between start and end poly
+            POLY_PATH_BLOCKED,      // straight line path hit a wall
+            POLY_PATH_FOUND         // corridor is in _pathPolyRefs and the point path was built
+        };
+
+        // navmesh query results of BuildPolyPath, filled by FindPolyPath without reading map or unit state
+        struct PolyPathResult
+        {
+            PolyPathStatus Status;
+            dtPolyRef StartPoly;
+            dtPolyRef EndPoly;
+            float DistToStartPoly;
+            float DistToEndPoly;
+            bool FarFromPoly;
+            bool EndPointMoved;                                     // EndPoint was moved to the closest point on EndPoly
+            bool Hierarchical;                                      // path was routed over the navmesh graph, it always reaches EndPoly
+            float StartPoint[VERTEX_SIZE];
+            float EndPoint[VERTEX_SIZE];
+            std::vector<float> PathPoints;                          // point path in detour coordinates
+            uint32 PointCount;
+            dtStatus PointPathStatus;
+        };
 
         dtPolyRef _pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
         uint32 _polyLength;                         // number of polygons in the path
@@ -97,9 +153,14 @@ class TC_GAME_API PathGenerator
         Unit const* const _sourceUnit;          // the unit that is moving
         dtNavMesh const* _navMesh;              // the nav mesh
         dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
+        MMAP::TileGraph const* _tileGraph;      // coarse graph of the nav mesh, optional
 
+        uint32 _terrainMapId;                   // map the nav mesh belongs to
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
+        PolyPathResult _polyPath;
+        std::shared_ptr<PathRequest> _request;  // queued async request
+
         void SetStartPosition(G3D::Vector3 const& point) { _startPosition = point; }
         void SetEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; _endPosition = point; }
         void SetActualEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; }
@@ -119,8 +180,13 @@ class TC_GAME_API PathGenerator
         dtPolyRef GetPolyByLocation(float const* Point, float* Distance) const;
         bool HaveTile(G3D::Vector3 const& p) const;
 
+        PathInitResult InitPath(G3D::Vector3 const& start, G3D::Vector3 const& dest, bool forceDest, bool straightLine);
+        void FindPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
+        bool FindHierarchicalPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
+        void FindPointPath(float const* startPoint, float const* endPoint);
+        void FindQueuedPolyPath();
         void BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
-        void BuildPointPath(float const* startPoint, float const* endPoint);
+        void BuildPointPath();
         void BuildShortcut();
 
         NavTerrainFlag GetNavTerrain(float x, float y, float z);
@@ -0,0 +1,90 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathRequestQueue.h"
+#include "Map.h"
+#include "MapManager.h"
+#include "MapUpdater.h"
+#include "PathGenerator.h"
+#include "Unit.h"
+#include "World.h"
+
+namespace
+{
+    // splitting fewer requests is not worth waking the other threads
+    std::size_t const MIN_PATH_REQUESTS_PER_TASK = 4;
+}
+
+void PathRequestQueue::Process(Map* map)
+{
+    std::vector<std::shared_ptr<PathRequest>> requests;
+    requests.swap(_requests);
+
+    std::vector<PathGenerator*> paths;
+    paths.reserve(requests.size());
+    for (std::shared_ptr<PathRequest> const& request : requests)
+    {
+        PathGenerator* path = request->Path;
+        if (!path)
+            continue;
+
+        // unit left the map after making the request, it won't get a path
+        if (!path->_sourceUnit->IsInWorld() || path->_sourceUnit->GetMap() != map)
+        {
+            path->CancelPendingPath();
+            continue;
+        }
+
+        paths.push_back(path);
+    }
+
+    // navmesh queries only touch the state of their own generator
+    MapUpdater* updater = sMapMgr->GetMapUpdater();
+    std::size_t taskCount = std::min<std::size_t>(paths.size() / MIN_PATH_REQUESTS_PER_TASK, sWorld->getIntConfig(CONFIG_NUMTHREADS));
+    if (taskCount > 1 && updater->activated())
+    {
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(taskCount);
+        for (std::size_t i = 0; i < taskCount; ++i)
+        {
+            tasks.push_back([&paths, i, taskCount]()
+            {
+                for (std::size_t j = i; j < paths.size(); j += taskCount)
+                    paths[j]->FindQueuedPolyPath();
+            });
+        }
+
+        updater->run_parallel(tasks);
+    }
+    else
+    {
+        for (PathGenerator* path : paths)
+            path->FindQueuedPolyPath();
+    }
+
+    for (std::shared_ptr<PathRequest> const& request : requests)
+    {
+        // callbacks of earlier requests can cancel later ones (movement generator replaced)
+        PathGenerator* path = request->Path;
+        if (!path)
+            continue;
+
+        path->_request.reset();
+        path->BuildPolyPath(path->GetStartPosition(), path->GetEndPosition());
+        request->Callback(true);
+    }
+}
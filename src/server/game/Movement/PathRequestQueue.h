@@ -0,0 +1,62 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PathRequestQueue_h__
+#define PathRequestQueue_h__
+
+#include "Define.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+class Map;
+class PathGenerator;
+
+// Path calculation queued by PathGenerator::CalculatePathAsync
+struct PathRequest
+{
+    PathGenerator* Path;                    // nullptr once cancelled
+    std::function<void(bool)> Callback;
+};
+
+/*
+ * Path requests made during a map update, built together at the end of it.
+ *
+ * Building a path is split into the navmesh queries, which only read the navmesh and can run on
+ * any thread using that thread's own dtNavMeshQuery, and the parts reading terrain and unit state
+ * which run on the map thread afterwards. With enough requests the navmesh queries are spread over
+ * the map update threads (MapUpdater::run_parallel), callbacks are always invoked on the map thread.
+ */
+class TC_GAME_API PathRequestQueue
+{
+    public:
+        PathRequestQueue() { }
+
+        void Add(std::shared_ptr<PathRequest> request) { _requests.push_back(std::move(request)); }
+        bool IsEmpty() const { return _requests.empty(); }
+
+        // Builds all queued paths, requests added by callbacks are left for the next call
+        void Process(Map* map);
+
+    private:
+        std::vector<std::shared_ptr<PathRequest>> _requests;
+
+        PathRequestQueue(PathRequestQueue const& right) = delete;
+        PathRequestQueue& operator=(PathRequestQueue const& right) = delete;
+};
+
+#endif // PathRequestQueue_h__
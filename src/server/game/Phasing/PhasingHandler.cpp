@@ -281,6 +281,11 @@ void PhasingHandler::OnAreaChange(WorldObject* object)
             unit->RemoveNotOwnSingleTargetAuras(true);
     }
 
+    // spawn conditions and quest dependent objects follow the same state as the phases
+    if (!changed && object->IsInWorld())
+        if (Player* player = object->ToPlayer())
+            player->RequestVisibilityRescan();
+
     UpdateVisibilityIfNeeded(object, true, changed);
 }
 
@@ -0,0 +1,220 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OpcodeProfiler.h"
+#include "Metric.h"
+#include <algorithm>
+
+OpcodeProfiler::OpcodeStats::OpcodeStats() : Calls(0), TotalTime(0), MaxTime(0), ExportedCalls(0), ExportedTotalTime(0)
+{
+    for (std::atomic<uint32>& bucket : Buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    ExportedBuckets.fill(0);
+}
+
+OpcodeProfiler::OpcodeProfiler()
+{
+    for (std::atomic<OpcodeStats*>& stats : _stats)
+        stats.store(nullptr, std::memory_order_relaxed);
+}
+
+OpcodeProfiler::~OpcodeProfiler()
+{
+    for (std::atomic<OpcodeStats*>& stats : _stats)
+        delete stats.load(std::memory_order_relaxed);
+}
+
+OpcodeProfiler* OpcodeProfiler::instance()
+{
+    static OpcodeProfiler instance;
+    return &instance;
+}
+
+OpcodeProfiler::OpcodeStats* OpcodeProfiler::GetOrCreateStats(OpcodeClient opcode)
+{
+    std::atomic<OpcodeStats*>& slot = _stats[opcode];
+    OpcodeStats* stats = slot.load(std::memory_order_acquire);
+    if (stats)
+        return stats;
+
+    OpcodeStats* newStats = new OpcodeStats();
+    if (slot.compare_exchange_strong(stats, newStats, std::memory_order_acq_rel))
+        return newStats;
+
+    // another thread was faster
+    delete newStats;
+    return stats;
+}
+
+void OpcodeProfiler::Record(OpcodeClient opcode, std::chrono::steady_clock::duration elapsed)
+{
+    if (uint32(opcode) >= NUM_OPCODE_HANDLERS)
+        return;
+
+    uint64 time = uint64(std::max<int64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 0));
+
+    OpcodeStats* stats = GetOrCreateStats(opcode);
+    stats->Calls.fetch_add(1, std::memory_order_relaxed);
+    stats->TotalTime.fetch_add(time, std::memory_order_relaxed);
+    stats->Buckets[GetBucket(time)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64 maxTime = stats->MaxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !stats->MaxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed))
+        ;
+}
+
+uint32 OpcodeProfiler::GetBucket(uint64 time)
+{
+    uint64 units = time >> UnitShift;
+
+    // first two octaves are exact
+    if (units < 2 * SubBucketCount)
+        return uint32(units);
+
+    uint32 magnitude = 0;
+    while (units >> (magnitude + 1))
+        ++magnitude;
+
+    uint32 shift = magnitude - SubBucketBits;
+    uint32 bucket = (shift + 1) * SubBucketCount + uint32(units >> shift) - SubBucketCount;
+    return std::min(bucket, BucketCount - 1);
+}
+
+uint64 OpcodeProfiler::GetBucketUpperBound(uint32 bucket)
+{
+    uint64 units;
+    if (bucket < 2 * SubBucketCount)
+        units = bucket + 1;
+    else
+    {
+        uint32 shift = bucket / SubBucketCount - 1;
+        units = uint64(bucket % SubBucketCount + SubBucketCount + 1) << shift;
+    }
+
+    return (units << UnitShift) - 1;
+}
+
+uint64 OpcodeProfiler::GetPercentile(Histogram const& histogram, uint64 calls, uint32 percent)
+{
+    if (!calls)
+        return 0;
+
+    uint64 threshold = (calls * percent + 99) / 100;
+    uint64 seen = 0;
+    for (uint32 i = 0; i < BucketCount; ++i)
+    {
+        seen += histogram[i];
+        if (seen >= threshold)
+            return GetBucketUpperBound(i);
+    }
+
+    return GetBucketUpperBound(BucketCount - 1);
+}
+
+std::vector<OpcodeProfileSummary> OpcodeProfiler::GetSummaries() const
+{
+    std::vector<OpcodeProfileSummary> summaries;
+    for (uint32 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+    {
+        OpcodeStats const* stats = _stats[opcode].load(std::memory_order_acquire);
+        if (!stats)
+            continue;
+
+        Histogram histogram;
+        uint64 calls = 0;
+        for (uint32 i = 0; i < BucketCount; ++i)
+        {
+            histogram[i] = stats->Buckets[i].load(std::memory_order_relaxed);
+            calls += histogram[i];
+        }
+
+        if (!calls)
+            continue;
+
+        uint64 maxTime = stats->MaxTime.load(std::memory_order_relaxed);
+
+        OpcodeProfileSummary summary;
+        summary.Opcode = OpcodeClient(opcode);
+        summary.Calls = calls;
+        summary.TotalTime = stats->TotalTime.load(std::memory_order_relaxed) / 1000;
+        summary.MaxTime = maxTime / 1000;
+        summary.P50Time = std::min(GetPercentile(histogram, calls, 50), maxTime) / 1000;
+        summary.P99Time = std::min(GetPercentile(histogram, calls, 99), maxTime) / 1000;
+        summaries.push_back(summary);
+    }
+
+    return summaries;
+}
+
+void OpcodeProfiler::Reset()
+{
+    for (std::atomic<OpcodeStats*>& slot : _stats)
+    {
+        OpcodeStats* stats = slot.load(std::memory_order_acquire);
+        if (!stats)
+            continue;
+
+        stats->Calls.store(0, std::memory_order_relaxed);
+        stats->TotalTime.store(0, std::memory_order_relaxed);
+        stats->MaxTime.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint32>& bucket : stats->Buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        stats->ExportedCalls = 0;
+        stats->ExportedTotalTime = 0;
+        stats->ExportedBuckets.fill(0);
+    }
+}
+
+void OpcodeProfiler::LogMetrics()
+{
+    if (!sMetric->IsEnabled())
+        return;
+
+    for (uint32 opcode = 0; opcode < NUM_OPCODE_HANDLERS; ++opcode)
+    {
+        OpcodeStats* stats = _stats[opcode].load(std::memory_order_acquire);
+        if (!stats)
+            continue;
+
+        uint64 calls = stats->Calls.load(std::memory_order_relaxed);
+        if (calls == stats->ExportedCalls)
+            continue;
+
+        uint64 totalTime = stats->TotalTime.load(std::memory_order_relaxed);
+
+        // HDR histograms can be subtracted, this gives latency distribution of the last interval only
+        Histogram interval;
+        uint64 intervalCalls = 0;
+        for (uint32 i = 0; i < BucketCount; ++i)
+        {
+            uint32 bucket = stats->Buckets[i].load(std::memory_order_relaxed);
+            interval[i] = bucket - stats->ExportedBuckets[i];
+            intervalCalls += interval[i];
+            stats->ExportedBuckets[i] = bucket;
+        }
+
+        std::string opcodeName = opcodeTable[OpcodeClient(opcode)]->Name;
+        TC_METRIC_VALUE("opcode_calls", calls - stats->ExportedCalls, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_time", (totalTime - stats->ExportedTotalTime) / 1000, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_time_p99", GetPercentile(interval, intervalCalls, 99) / 1000, TC_METRIC_TAG("opcode", opcodeName));
+
+        stats->ExportedCalls = calls;
+        stats->ExportedTotalTime = totalTime;
+    }
+}
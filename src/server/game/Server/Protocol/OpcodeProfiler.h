@@ -0,0 +1,112 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OpcodeProfiler_h__
+#define OpcodeProfiler_h__
+
+#include "Define.h"
+#include "Opcodes.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+struct OpcodeProfileSummary
+{
+    OpcodeClient Opcode;
+    uint64 Calls;
+    uint64 TotalTime;   // microseconds
+    uint64 MaxTime;     // microseconds
+    uint64 P50Time;     // microseconds
+    uint64 P99Time;     // microseconds
+};
+
+/// Counts calls and handler time of every client opcode.
+/// Durations go to log-linear (HDR style) histograms, each bucket is at most 12.5% wide,
+/// recording is a handful of relaxed atomic increments so it can stay always on.
+class TC_GAME_API OpcodeProfiler
+{
+public:
+    // durations are stored in units of 128ns
+    static uint32 const UnitShift = 7;
+    static uint32 const SubBucketBits = 3;
+    static uint32 const SubBucketCount = 1 << SubBucketBits;
+    // last bucket covers everything above ~68 seconds
+    static uint32 const BucketCount = 27 * SubBucketCount;
+
+    typedef std::array<uint32, BucketCount> Histogram;
+
+    static OpcodeProfiler* instance();
+
+    void Record(OpcodeClient opcode, std::chrono::steady_clock::duration elapsed);
+
+    /// Snapshot of all opcodes that were handled at least once
+    std::vector<OpcodeProfileSummary> GetSummaries() const;
+
+    void Reset();
+
+    /// Sends per opcode values accumulated since previous call to Metric, only opcodes that were handled are sent
+    void LogMetrics();
+
+    class Scope
+    {
+    public:
+        explicit Scope(OpcodeClient opcode) : _opcode(opcode), _start(std::chrono::steady_clock::now()) { }
+        ~Scope() { OpcodeProfiler::instance()->Record(_opcode, std::chrono::steady_clock::now() - _start); }
+
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+    private:
+        OpcodeClient _opcode;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+private:
+    struct OpcodeStats
+    {
+        OpcodeStats();
+
+        std::atomic<uint64> Calls;
+        std::atomic<uint64> TotalTime;
+        std::atomic<uint64> MaxTime;
+        std::array<std::atomic<uint32>, BucketCount> Buckets;
+
+        // state at previous LogMetrics call, only accessed by world thread
+        uint64 ExportedCalls;
+        uint64 ExportedTotalTime;
+        Histogram ExportedBuckets;
+    };
+
+    OpcodeProfiler();
+    ~OpcodeProfiler();
+
+    OpcodeStats* GetOrCreateStats(OpcodeClient opcode);
+
+    static uint32 GetBucket(uint64 time);
+    static uint64 GetBucketUpperBound(uint32 bucket);
+    static uint64 GetPercentile(Histogram const& histogram, uint64 calls, uint32 percent);
+
+    std::array<std::atomic<OpcodeStats*>, NUM_OPCODE_HANDLERS> _stats;
+
+    OpcodeProfiler(OpcodeProfiler const&) = delete;
+    OpcodeProfiler& operator=(OpcodeProfiler const&) = delete;
+};
+
+#define sOpcodeProfiler OpcodeProfiler::instance()
+
+#endif // OpcodeProfiler_h__
@@ -17,6 +17,7 @@
 
 #include "Opcodes.h"
 #include "Log.h"
+#include "OpcodeProfiler.h"
 #include "WorldSession.h"
 #include "Packets/AllPackets.h"
 #include <iomanip>
@@ -30,10 +31,13 @@ public:
 
     void Call(WorldSession* session, WorldPacket& packet) const override
     {
+        OpcodeProfiler::Scope profile(static_cast<OpcodeClient>(packet.GetOpcode()));
         PacketClass nicePacket(std::move(packet));
         nicePacket.Read();
         (session->*HandlerFunction)(nicePacket);
         session->LogUnprocessedTail(nicePacket.GetRawPacket());
+        // hand the storage back, the received packet is recycled by its socket
+        packet = nicePacket.Move();
     }
 };
 
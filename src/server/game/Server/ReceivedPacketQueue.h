@@ -0,0 +1,123 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ReceivedPacketQueue_h__
+#define ReceivedPacketQueue_h__
+
+#include "MPSCQueue.h"
+#include "WorldPacket.h"
+
+// client packet waiting for processing in WorldSession
+// carries its own queue links so queueing it never allocates, instances are recycled by the socket that received them
+class ReceivedWorldPacket : public WorldPacket
+{
+public:
+    ReceivedWorldPacket() : PendingLink(nullptr)
+    {
+        QueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
+    void Assign(WorldPacket&& packet) { WorldPacket::operator=(std::move(packet)); }
+
+    std::atomic<ReceivedWorldPacket*> QueueLink;
+    ReceivedWorldPacket* PendingLink;
+};
+
+// receive queue of a single WorldSession
+// any thread may add packets, only the thread currently updating the session may take them out
+// packets rejected by filter or put back stay in a consumer owned pending list instead of being requeued
+class ReceivedPacketQueue
+{
+public:
+    ReceivedPacketQueue() : _pendingHead(nullptr) { }
+
+    ~ReceivedPacketQueue()
+    {
+        while (ReceivedWorldPacket* packet = Front())
+        {
+            PopFront();
+            delete packet;
+        }
+    }
+
+    void add(ReceivedWorldPacket* packet)
+    {
+        _incoming.Enqueue(packet);
+    }
+
+    bool next(ReceivedWorldPacket*& result)
+    {
+        result = Front();
+        if (!result)
+            return false;
+
+        PopFront();
+        return true;
+    }
+
+    template<class Checker>
+    bool next(ReceivedWorldPacket*& result, Checker& check)
+    {
+        result = Front();
+        if (!result || !check.Process(result))
+            return false;
+
+        PopFront();
+        return true;
+    }
+
+    //! Adds items back to front of the queue
+    template<class Iterator>
+    void readd(Iterator begin, Iterator end)
+    {
+        while (begin != end)
+        {
+            ReceivedWorldPacket* packet = *--end;
+            packet->PendingLink = _pendingHead;
+            _pendingHead = packet;
+        }
+    }
+
+private:
+    ReceivedWorldPacket* Front()
+    {
+        if (!_pendingHead)
+        {
+            ReceivedWorldPacket* packet;
+            if (!_incoming.Dequeue(packet))
+                return nullptr;
+
+            packet->PendingLink = nullptr;
+            _pendingHead = packet;
+        }
+
+        return _pendingHead;
+    }
+
+    void PopFront()
+    {
+        _pendingHead = _pendingHead->PendingLink;
+    }
+
+    MPSCQueue<ReceivedWorldPacket, &ReceivedWorldPacket::QueueLink> _incoming;
+    ReceivedWorldPacket* _pendingHead;
+
+    ReceivedPacketQueue(ReceivedPacketQueue const&) = delete;
+    ReceivedPacketQueue& operator=(ReceivedPacketQueue const&) = delete;
+};
+
+#endif // ReceivedPacketQueue_h__
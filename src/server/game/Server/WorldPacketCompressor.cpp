@@ -0,0 +1,228 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldPacketCompressor.h"
+#include "Errors.h"
+#include "Log.h"
+#include "ProducerConsumerQueue.h"
+#include <zlib.h>
+#include <cstring>
+
+namespace
+{
+    uint32 const CompressionAdlerSeed = 0x9827D8F1;
+
+    bool InitCompressionStream(z_stream* stream, int32 compressionLevel)
+    {
+        stream->zalloc = (alloc_func)nullptr;
+        stream->zfree = (free_func)nullptr;
+        stream->opaque = (voidpf)nullptr;
+        stream->avail_in = 0;
+        stream->next_in = nullptr;
+        int32 z_res = deflateInit2(stream, compressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        if (z_res != Z_OK)
+        {
+            TC_LOG_ERROR("network", "Can't initialize packet compression (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+            return false;
+        }
+
+        return true;
+    }
+}
+
+CompressedWorldPacketData::CompressedWorldPacketData(WorldPacket const& packet, uint32 uncompressedAdler) : _packet(packet), _compressedSize(0), _ready(false)
+{
+    _header.UncompressedSize = packet.size() + 2;
+    _header.UncompressedAdler = uncompressedAdler;
+    _header.CompressedAdler = 0;
+}
+
+bool CompressedWorldPacketData::IsSamePayload(WorldPacket const& packet, uint32 uncompressedAdler) const
+{
+    return _header.UncompressedAdler == uncompressedAdler
+        && _packet.GetOpcode() == packet.GetOpcode()
+        && _packet.size() == packet.size()
+        && !memcmp(_packet.contents(), packet.contents(), packet.size());
+}
+
+WorldPacketCompressor::WorldPacketCompressor() : _compressionLevel(1), _cacheNext(0)
+{
+}
+
+WorldPacketCompressor::~WorldPacketCompressor()
+{
+    Stop();
+}
+
+WorldPacketCompressor* WorldPacketCompressor::instance()
+{
+    static WorldPacketCompressor instance;
+    return &instance;
+}
+
+void WorldPacketCompressor::Start(uint32 threadCount, int32 compressionLevel)
+{
+    std::lock_guard<std::mutex> lock(_workersLock);
+    ASSERT(_workers.empty());
+
+    _compressionLevel = compressionLevel;
+    _queue = std::make_unique<ProducerConsumerQueue<std::shared_ptr<CompressedWorldPacketData>>>();
+
+    for (uint32 i = 0; i < threadCount; ++i)
+    {
+        z_stream* stream = new z_stream();
+        if (!InitCompressionStream(stream, _compressionLevel))
+        {
+            delete stream;
+            break;
+        }
+
+        _workers.push_back(std::thread(&WorldPacketCompressor::WorkerThread, this, stream));
+    }
+
+    if (!_workers.empty())
+        TC_LOG_INFO("network", "Started %u packet compression threads", uint32(_workers.size()));
+}
+
+void WorldPacketCompressor::Stop()
+{
+    std::unique_ptr<ProducerConsumerQueue<std::shared_ptr<CompressedWorldPacketData>>> queue;
+    std::vector<std::thread> workers;
+    {
+        // packets compressed from now on are handled by the calling thread
+        std::lock_guard<std::mutex> lock(_workersLock);
+        if (_workers.empty())
+            return;
+
+        queue = std::move(_queue);
+        workers = std::move(_workers);
+        _workers.clear();
+    }
+
+    // sockets are still waiting for the queued payloads, finish them here next to the workers before cancelling
+    std::shared_ptr<CompressedWorldPacketData> data;
+    while (queue->Pop(data))
+        CompressOnCurrentThread(*data);
+
+    queue->Cancel();
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    std::lock_guard<std::mutex> lock(_cacheLock);
+    for (std::shared_ptr<CompressedWorldPacketData>& cached : _cache)
+        cached.reset();
+}
+
+std::shared_ptr<CompressedWorldPacketData> WorldPacketCompressor::Compress(WorldPacket const& packet)
+{
+    uint16 opcode = packet.GetOpcode();
+    uint32 uncompressedAdler = adler32(adler32(CompressionAdlerSeed, (Bytef*)&opcode, 2), packet.contents(), packet.size());
+
+    std::shared_ptr<CompressedWorldPacketData> data;
+    {
+        std::lock_guard<std::mutex> lock(_cacheLock);
+        for (std::shared_ptr<CompressedWorldPacketData> const& cached : _cache)
+            if (cached && cached->IsSamePayload(packet, uncompressedAdler))
+                return cached;
+
+        data = std::make_shared<CompressedWorldPacketData>(packet, uncompressedAdler);
+        _cache[_cacheNext] = data;
+        _cacheNext = (_cacheNext + 1) % CacheSize;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_workersLock);
+        if (!_workers.empty())
+        {
+            _queue->Push(data);
+            return data;
+        }
+    }
+
+    CompressOnCurrentThread(*data);
+    return data;
+}
+
+bool WorldPacketCompressor::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(_workersLock);
+    return !_workers.empty();
+}
+
+void WorldPacketCompressor::CompressOnCurrentThread(CompressedWorldPacketData& data) const
+{
+    z_stream stream;
+    if (InitCompressionStream(&stream, _compressionLevel))
+    {
+        CompressPacket(&stream, data);
+        deflateEnd(&stream);
+    }
+    else
+        data._ready.store(true, std::memory_order_release);   // sent uncompressed
+}
+
+void WorldPacketCompressor::WorkerThread(z_stream* stream)
+{
+    for (;;)
+    {
+        std::shared_ptr<CompressedWorldPacketData> data;
+        _queue->WaitAndPop(data);
+
+        if (!data)
+            break;
+
+        CompressPacket(stream, *data);
+    }
+
+    deflateEnd(stream);
+    delete stream;
+}
+
+void WorldPacketCompressor::CompressPacket(z_stream* stream, CompressedWorldPacketData& data)
+{
+    // every packet starts from a clean state so that its output does not reference data
+    // the client has not received on a given connection
+    deflateReset(stream);
+
+    uint32 opcode = data._packet.GetOpcode();
+    uint32 bufferSize = deflateBound(stream, data._packet.size() + sizeof(uint16));
+    data._compressed.resize(bufferSize);
+
+    stream->next_out = data._compressed.data();
+    stream->avail_out = bufferSize;
+    stream->next_in = (Bytef*)&opcode;
+    stream->avail_in = sizeof(uint16);
+
+    int32 z_res = deflate(stream, Z_NO_FLUSH);
+    if (z_res != Z_OK)
+        TC_LOG_ERROR("network", "Can't compress packet opcode (zlib: deflate) Error code: %i (%s, msg: %s)", z_res, zError(z_res), stream->msg);
+    else
+    {
+        stream->next_in = (Bytef*)data._packet.contents();
+        stream->avail_in = data._packet.size();
+
+        z_res = deflate(stream, Z_SYNC_FLUSH);
+        if (z_res != Z_OK)
+            TC_LOG_ERROR("network", "Can't compress packet data (zlib: deflate) Error code: %i (%s, msg: %s)", z_res, zError(z_res), stream->msg);
+        else
+            data._compressedSize = bufferSize - stream->avail_out;
+    }
+
+    data._header.CompressedAdler = adler32(CompressionAdlerSeed, data._compressed.data(), data._compressedSize);
+    data._ready.store(true, std::memory_order_release);
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WorldPacketCompressor_h__
+#define WorldPacketCompressor_h__
+
+#include "Define.h"
+#include "WorldPacket.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <typename T>
+class ProducerConsumerQueue;
+typedef struct z_stream_s z_stream;
+
+#pragma pack(push, 1)
+
+struct CompressedWorldPacket
+{
+    uint32 UncompressedSize;
+    uint32 UncompressedAdler;
+    uint32 CompressedAdler;
+};
+
+#pragma pack(pop)
+
+/// Result of compressing a single server packet with its own deflate state.
+/// The compressed data starts a new deflate block and ends with a sync flush so it
+/// is a valid continuation of any client side inflate stream, which allows one
+/// result to be shared by every socket the same payload is sent to.
+class TC_GAME_API CompressedWorldPacketData
+{
+    friend class WorldPacketCompressor;
+
+public:
+    CompressedWorldPacketData(WorldPacket const& packet, uint32 uncompressedAdler);
+
+    uint16 GetOpcode() const { return _packet.GetOpcode(); }
+    bool IsReady() const { return _ready.load(std::memory_order_acquire); }
+
+    // only valid after IsReady() returned true
+    bool IsCompressed() const { return _compressedSize > 0; }
+    WorldPacket const& GetPacket() const { return _packet; }   // uncompressed payload, sent as is when compression failed
+    CompressedWorldPacket const& GetHeader() const { return _header; }
+    uint8 const* GetData() const { return _compressed.data(); }
+    std::size_t GetSize() const { return _compressedSize; }
+
+private:
+    bool IsSamePayload(WorldPacket const& packet, uint32 uncompressedAdler) const;
+
+    WorldPacket _packet;
+    CompressedWorldPacket _header;
+    std::vector<uint8> _compressed;
+    std::size_t _compressedSize;
+    std::atomic<bool> _ready;
+};
+
+/// Compresses large server packets outside of network threads.
+/// Identical payloads queued close to each other (broadcasts) are compressed only once.
+class TC_GAME_API WorldPacketCompressor
+{
+    static std::size_t const CacheSize = 64;
+
+public:
+    static WorldPacketCompressor* instance();
+
+    void Start(uint32 threadCount, int32 compressionLevel);
+    void Stop();
+
+    bool IsRunning() const;
+
+    /// Returns shared compression result for packet, possibly still being compressed by a worker
+    std::shared_ptr<CompressedWorldPacketData> Compress(WorldPacket const& packet);
+
+private:
+    WorldPacketCompressor();
+    ~WorldPacketCompressor();
+
+    void WorkerThread(z_stream* stream);
+
+    void CompressOnCurrentThread(CompressedWorldPacketData& data) const;
+    static void CompressPacket(z_stream* stream, CompressedWorldPacketData& data);
+
+    mutable std::mutex _workersLock;                        // guards _queue and _workers, Stop may run while packets are sent
+    std::unique_ptr<ProducerConsumerQueue<std::shared_ptr<CompressedWorldPacketData>>> _queue;
+    std::vector<std::thread> _workers;
+    int32 _compressionLevel;
+
+    std::mutex _cacheLock;
+    std::array<std::shared_ptr<CompressedWorldPacketData>, CacheSize> _cache;
+    std::size_t _cacheNext;
+
+    WorldPacketCompressor(WorldPacketCompressor const&) = delete;
+    WorldPacketCompressor& operator=(WorldPacketCompressor const&) = delete;
+};
+
+#define sWorldPacketCompressor WorldPacketCompressor::instance()
+
+#endif // WorldPacketCompressor_h__
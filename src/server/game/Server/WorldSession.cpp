@@ -175,7 +175,7 @@ WorldSession::~WorldSession()
     delete _RBACData;
 
     ///- empty incoming packet queue
-    WorldPacket* packet = nullptr;
+    ReceivedWorldPacket* packet = nullptr;
     while (_recvQueue.next(packet))
         delete packet;
 
@@ -301,11 +301,21 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
 }
 
 /// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+void WorldSession::QueuePacket(ReceivedWorldPacket* new_packet)
 {
     _recvQueue.add(new_packet);
 }
 
+/// Return a processed packet to the socket it was received on for reuse
+void WorldSession::RecyclePacket(ReceivedWorldPacket* packet)
+{
+    ConnectionType conIdx = packet->GetConnection();
+    if (conIdx >= CONNECTION_TYPE_REALM && conIdx < MAX_CONNECTION_TYPES && m_Socket[conIdx])
+        m_Socket[conIdx]->RecyclePacket(packet);
+    else
+        delete packet;
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason)
 {
@@ -338,10 +348,10 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    WorldPacket* packet = nullptr;
-    //! Delete packet after processing by default
+    ReceivedWorldPacket* packet = nullptr;
+    //! Recycle packet after processing by default
     bool deletePacket = true;
-    std::vector<WorldPacket*> requeuePackets;
+    std::vector<ReceivedWorldPacket*> requeuePackets;
     uint32 processedPackets = 0;
     time_t currentTime = time(nullptr);
 
@@ -437,7 +447,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
-            delete packet;
+            RecyclePacket(packet);
 
         deletePacket = true;
 
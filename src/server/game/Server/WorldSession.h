@@ -27,9 +27,9 @@
 #include "AuthDefines.h"
 #include "DatabaseEnvFwd.h"
 #include "Duration.h"
-#include "LockedQueue.h"
 #include "ObjectGuid.h"
 #include "Packet.h"
+#include "ReceivedPacketQueue.h"
 #include "SharedDefines.h"
 #include <array>
 #include <map>
@@ -1085,7 +1085,7 @@ class TC_GAME_API WorldSession
         void LogoutPlayer(bool save);
         void KickPlayer();
 
-        void QueuePacket(WorldPacket* new_packet);
+        void QueuePacket(ReceivedWorldPacket* new_packet);
         bool Update(uint32 diff, PacketFilter& updater);
 
         /// Handle the authentication waiting queue (to be completed)
@@ -1998,6 +1998,9 @@ class TC_GAME_API WorldSession
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason);
 
+        // returns processed packet to receive pool of its socket
+        void RecyclePacket(ReceivedWorldPacket* packet);
+
         // EnumData helpers
         bool IsLegitCharacterForAccount(ObjectGuid lowGUID)
         {
@@ -2048,7 +2051,7 @@ class TC_GAME_API WorldSession
         bool _filterAddonMessages;
         uint32 recruiterId;
         bool isRecruiter;
-        LockedQueue<WorldPacket*> _recvQueue;
+        ReceivedPacketQueue _recvQueue;
         rbac::RBACData* _RBACData;
         uint32 expireTime;
         bool forceExit;
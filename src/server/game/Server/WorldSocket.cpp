@@ -33,29 +33,25 @@
 #include "Util.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include "WorldPacketCompressor.h"
 #include "WorldSession.h"
 #include <zlib.h>
 
-#pragma pack(push, 1)
-
-struct CompressedWorldPacket
-{
-    uint32 UncompressedSize;
-    uint32 UncompressedAdler;
-    uint32 CompressedAdler;
-};
-
-#pragma pack(pop)
-
 class EncryptablePacket : public WorldPacket
 {
 public:
     EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt) { }
 
+    // payload is not copied, it is owned by shared compression result
+    explicit EncryptablePacket(std::shared_ptr<CompressedWorldPacketData> compressed) : WorldPacket(compressed->GetOpcode()),
+        _encrypt(true), _compressed(std::move(compressed)) { }
+
     bool NeedsEncryption() const { return _encrypt; }
+    CompressedWorldPacketData const* GetCompressedData() const { return _compressed.get(); }
 
 private:
     bool _encrypt;
+    std::shared_ptr<CompressedWorldPacketData> _compressed;
 };
 
 using boost::asio::ip::tcp;
@@ -63,6 +59,8 @@ using boost::asio::ip::tcp;
 std::string const WorldSocket::ServerConnectionInitialize("WORLD OF WARCRAFT CONNECTION - SERVER TO CLIENT - V2");
 std::string const WorldSocket::ClientConnectionInitialize("WORLD OF WARCRAFT CONNECTION - CLIENT TO SERVER - V2");
 uint32 const WorldSocket::MinSizeForCompression = 0x400;
+uint32 const WorldSocket::MaxPooledReceivedPackets = 128;
+uint32 const WorldSocket::MaxPooledReceivedPacketSize = 0x1000;
 
 uint8 const WorldSocket::AuthCheckSeed[16] = { 0xC5, 0xC6, 0x98, 0x95, 0x76, 0x3F, 0x1D, 0xCD, 0xB6, 0xA1, 0x37, 0x28, 0xB3, 0x12, 0xFF, 0x8A };
 uint8 const WorldSocket::SessionKeySeed[16] = { 0x58, 0xCB, 0xCF, 0x40, 0xFE, 0x2E, 0xCE, 0xA6, 0x5A, 0x90, 0xB8, 0x01, 0x68, 0x6C, 0x28, 0x0B };
@@ -71,7 +69,8 @@ uint8 const WorldSocket::EncryptionKeySeed[16] = { 0xE9, 0x75, 0x3C, 0x50, 0x90,
 
 WorldSocket::WorldSocket(tcp::socket&& socket) : Socket(std::move(socket)),
     _type(CONNECTION_TYPE_REALM), _key(0), _OverSpeedPings(0),
-    _worldSession(nullptr), _authed(false), _sendBufferSize(4096), _compressionStream(nullptr)
+    _worldSession(nullptr), _authed(false), _pendingCompressedPacket(nullptr), _sendBufferSize(4096),
+    _receivedPacketPoolSize(0), _compressionStream(nullptr)
 {
     Trinity::Crypto::GetRandomBytes(_serverChallenge);
     _encryptKey.fill(0);
@@ -80,6 +79,8 @@ WorldSocket::WorldSocket(tcp::socket&& socket) : Socket(std::move(socket)),
 
 WorldSocket::~WorldSocket()
 {
+    delete _pendingCompressedPacket;
+
     if (_compressionStream)
     {
         deflateEnd(_compressionStream);
@@ -200,24 +201,28 @@ void WorldSocket::InitializeHandler(boost::system::error_code error, std::size_t
 bool WorldSocket::Update()
 {
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
-    while (_bufferQueue.Dequeue(queued))
+    MessageBuffer buffer(0);
+    while (GetNextQueuedPacket(queued))
     {
         uint32 packetSize = queued->size();
-        if (packetSize > MinSizeForCompression && queued->NeedsEncryption())
+        if (CompressedWorldPacketData const* compressed = queued->GetCompressedData())
+            packetSize = compressed->IsCompressed() ? compressed->GetSize() + sizeof(CompressedWorldPacket) : compressed->GetPacket().size();
+        else if (packetSize > MinSizeForCompression && queued->NeedsEncryption())
             packetSize = compressBound(packetSize) + sizeof(CompressedWorldPacket);
 
         if (buffer.GetRemainingSpace() < packetSize + sizeof(PacketHeader))
         {
-            QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);
+            if (buffer.GetActiveSize() > 0)
+                QueuePacket(std::move(buffer));
+
+            buffer = AcquireWriteBuffer(_sendBufferSize);
         }
 
         if (buffer.GetRemainingSpace() >= packetSize + sizeof(PacketHeader))
             WritePacketToBuffer(*queued, buffer);
         else    // single packet larger than 4096 bytes
         {
-            MessageBuffer packetBuffer(packetSize + sizeof(PacketHeader));
+            MessageBuffer packetBuffer = AcquireWriteBuffer(packetSize + sizeof(PacketHeader));
             WritePacketToBuffer(*queued, packetBuffer);
             QueuePacket(std::move(packetBuffer));
         }
@@ -236,6 +241,21 @@ bool WorldSocket::Update()
     return true;
 }
 
+bool WorldSocket::GetNextQueuedPacket(EncryptablePacket*& packet)
+{
+    if (!_pendingCompressedPacket && !_bufferQueue.Dequeue(_pendingCompressedPacket))
+        return false;
+
+    // packets must be sent in order, everything queued after a packet still being compressed waits for it
+    if (CompressedWorldPacketData const* compressed = _pendingCompressedPacket->GetCompressedData())
+        if (!compressed->IsReady())
+            return false;
+
+    packet = _pendingCompressedPacket;
+    _pendingCompressedPacket = nullptr;
+    return true;
+}
+
 void WorldSocket::HandleSendAuthSession()
 {
     WorldPackets::Auth::AuthChallenge challenge;
@@ -475,8 +495,11 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
             // Our Idle timer will reset on any non PING opcodes on login screen, allowing us to catch people idling.
             _worldSession->ResetTimeOutTime(false);
 
-            // Copy the packet to the heap before enqueuing
-            _worldSession->QueuePacket(new WorldPacket(std::move(packet)));
+            // Reuse a packet released by the session, its old storage becomes the next read buffer
+            ReceivedWorldPacket* queuedPacket = GetReceivedPacketFromPool();
+            _packetBuffer = MessageBuffer(queuedPacket->Move());
+            queuedPacket->Assign(std::move(packet));
+            _worldSession->QueuePacket(queuedPacket);
             break;
         }
     }
@@ -484,6 +507,37 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
     return ReadDataHandlerResult::Ok;
 }
 
+ReceivedWorldPacket* WorldSocket::GetReceivedPacketFromPool()
+{
+    ReceivedWorldPacket* packet = nullptr;
+    if (_receivedPacketPool.Dequeue(packet))
+    {
+        --_receivedPacketPoolSize;
+        return packet;
+    }
+
+    return new ReceivedWorldPacket();
+}
+
+void WorldSocket::RecyclePacket(ReceivedWorldPacket* packet)
+{
+    // do not keep large buffers around, most client packets are small
+    if (packet->size() > MaxPooledReceivedPacketSize)
+    {
+        delete packet;
+        return;
+    }
+
+    if (++_receivedPacketPoolSize > MaxPooledReceivedPackets)
+    {
+        --_receivedPacketPoolSize;
+        delete packet;
+        return;
+    }
+
+    _receivedPacketPool.Enqueue(packet);
+}
+
 void WorldSocket::LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex> const& guard) const
 {
     if (!guard)
@@ -511,7 +565,10 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     if (sPacketLog->CanLogPacket())
         sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), GetConnectionType());
 
-    _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
+    if (packet.size() > MinSizeForCompression && _authCrypt.IsInitialized() && sWorldPacketCompressor->IsRunning())
+        _bufferQueue.Enqueue(new EncryptablePacket(sWorldPacketCompressor->Compress(packet)));
+    else
+        _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
 void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBuffer& buffer)
@@ -525,7 +582,23 @@ void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBu
     uint8* dataPos = buffer.GetWritePointer();
     buffer.WriteCompleted(sizeof(opcode));
 
-    if (packetSize > MinSizeForCompression && packet.NeedsEncryption())
+    CompressedWorldPacketData const* compressed = packet.GetCompressedData();
+    if (compressed && compressed->IsCompressed())
+    {
+        buffer.Write(&compressed->GetHeader(), sizeof(CompressedWorldPacket));
+        buffer.Write(compressed->GetData(), compressed->GetSize());
+        packetSize = compressed->GetSize() + sizeof(CompressedWorldPacket);
+
+        opcode = SMSG_COMPRESSED_PACKET;
+    }
+    else if (compressed)
+    {
+        // compression failed, send the payload uncompressed
+        packetSize = compressed->GetPacket().size();
+        if (packetSize)
+            buffer.Write(compressed->GetPacket().contents(), packetSize);
+    }
+    else if (packetSize > MinSizeForCompression && packet.NeedsEncryption())
     {
         CompressedWorldPacket cmp;
         cmp.UncompressedSize = packetSize + 2;
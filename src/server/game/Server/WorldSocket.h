@@ -23,6 +23,7 @@
 #include "AuthDefines.h"
 #include "DatabaseEnvFwd.h"
 #include "MessageBuffer.h"
+#include "ReceivedPacketQueue.h"
 #include "Socket.h"
 #include "WorldPacketCrypt.h"
 #include "MPSCQueue.h"
@@ -67,6 +68,8 @@ class TC_GAME_API WorldSocket : public Socket<WorldSocket>
     static std::string const ServerConnectionInitialize;
     static std::string const ClientConnectionInitialize;
     static uint32 const MinSizeForCompression;
+    static uint32 const MaxPooledReceivedPackets;
+    static uint32 const MaxPooledReceivedPacketSize;
 
     static uint8 const AuthCheckSeed[16];
     static uint8 const SessionKeySeed[16];
@@ -93,6 +96,9 @@ public:
     void SetWorldSession(WorldSession* session);
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
 
+    /// stores a processed packet for reuse by next received packet, can be called from any thread
+    void RecyclePacket(ReceivedWorldPacket* packet);
+
 protected:
     void OnClose() override;
     void ReadHandler() override;
@@ -115,8 +121,10 @@ private:
     void LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex> const& guard) const;
     /// sends and logs network.opcode without accessing WorldSession
     void SendPacketAndLogOpcode(WorldPacket const& packet);
+    bool GetNextQueuedPacket(EncryptablePacket*& packet);
     void WritePacketToBuffer(EncryptablePacket const& packet, MessageBuffer& buffer);
     uint32 CompressPacket(uint8* buffer, WorldPacket const& packet);
+    ReceivedWorldPacket* GetReceivedPacketFromPool();
 
     void HandleSendAuthSession();
     void HandleAuthSession(std::shared_ptr<WorldPackets::Auth::AuthSession> authSession);
@@ -146,8 +154,12 @@ private:
     MessageBuffer _headerBuffer;
     MessageBuffer _packetBuffer;
     MPSCQueue<EncryptablePacket> _bufferQueue;
+    EncryptablePacket* _pendingCompressedPacket;
     std::size_t _sendBufferSize;
 
+    MPSCQueue<ReceivedWorldPacket, &ReceivedWorldPacket::QueueLink> _receivedPacketPool;
+    std::atomic<uint32> _receivedPacketPoolSize;
+
     z_stream* _compressionStream;
 
     QueryCallbackProcessor _queryProcessor;
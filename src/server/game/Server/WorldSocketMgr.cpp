@@ -19,6 +19,8 @@
 #include "Config.h"
 #include "NetworkThread.h"
 #include "ScriptMgr.h"
+#include "World.h"
+#include "WorldPacketCompressor.h"
 #include "WorldSocket.h"
 #include <boost/system/error_code.hpp>
 
@@ -75,9 +77,19 @@ bool WorldSocketMgr::StartWorldNetwork(Trinity::Asio::IoContext& ioContext, std:
         return false;
     }
 
+    int32 compressionThreads = sConfigMgr->GetIntDefault("Network.CompressionThreads", 0);
+    if (compressionThreads < 0)
+    {
+        TC_LOG_ERROR("misc", "Network.CompressionThreads is wrong in your config file");
+        return false;
+    }
+
     if (!BaseSocketMgr::StartNetwork(ioContext, bindIp, port, threadCount))
         return false;
 
+    if (compressionThreads > 0)
+        sWorldPacketCompressor->Start(compressionThreads, sWorld->getIntConfig(CONFIG_COMPRESSION));
+
     AsyncAcceptor* instanceAcceptor = nullptr;
     try
     {
@@ -114,6 +126,8 @@ void WorldSocketMgr::StopNetwork()
 
     BaseSocketMgr::StopNetwork();
 
+    sWorldPacketCompressor->Stop();
+
     delete _instanceAcceptor;
     _instanceAcceptor = nullptr;
 
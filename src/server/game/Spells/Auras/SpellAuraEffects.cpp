@@ -783,6 +783,16 @@ void AuraEffect::CalculateSpellMod()
     GetBase()->CallScriptEffectCalcSpellModHandlers(this, m_spellmod);
 }
 
+void AuraEffect::SetAmount(int32 amount)
+{
+    m_amount = amount;
+    m_canBeRecalculated = false;
+
+    // targets keep the totals of their aura types
+    for (auto const& applicationPair : GetBase()->GetApplicationMap())
+        applicationPair.second->GetTarget()->_UpdateAuraModifierTotals(GetAuraType());
+}
+
 void AuraEffect::ChangeAmount(int32 newAmount, bool mark, bool onStackOrReapply)
 {
     // Reapply if amount change
@@ -1384,6 +1384,8 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
         if (uint32 maxTargets = m_spellValue->MaxAffectedTargets)
             Trinity::Containers::RandomResize(targets, maxTargets);
 
+        PrepareAreaTargetsLineOfSight(targets, center);
+
         for (std::list<WorldObject*>::iterator itr = targets.begin(); itr != targets.end(); ++itr)
         {
             if (Unit* unit = (*itr)->ToUnit())
@@ -1391,6 +1393,8 @@ void Spell::SelectImplicitAreaTargets(SpellEffIndex effIndex, SpellImplicitTarge
             else if (GameObject* gObjTarget = (*itr)->ToGameObject())
                 AddGOTarget(gObjTarget, effMask);
         }
+
+        m_areaTargetsInLineOfSight.clear();
     }
 }
 
@@ -7225,12 +7229,7 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const* effect,
             break;
     }
 
-    // check for ignore LOS on the effect itself
-    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, nullptr, SPELL_DISABLE_LOS))
-        return true;
-
-    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
-    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, nullptr, SPELL_DISABLE_LOS)))
+    if (IsLineOfSightIgnored())
         return true;
 
     /// @todo shit below shouldn't be here, but it's temporary
@@ -7265,7 +7264,13 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const* effect,
         default:
         {
             if (losPosition)
+            {
+                auto itr = m_areaTargetsInLineOfSight.find(target->GetGUID());
+                if (itr != m_areaTargetsInLineOfSight.end())
+                    return itr->second;
+
                 return target->IsWithinLOS(losPosition->GetPositionX(), losPosition->GetPositionY(), losPosition->GetPositionZ(), LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2);
+            }
             else
             {
                 // Get GO cast coordinates if original caster -> GO
@@ -7283,6 +7288,47 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const* effect,
     return true;
 }
 
+bool Spell::IsLineOfSightIgnored() const
+{
+    // check for ignore LOS on the effect itself
+    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, nullptr, SPELL_DISABLE_LOS))
+        return true;
+
+    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
+    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, nullptr, SPELL_DISABLE_LOS)))
+        return true;
+
+    return false;
+}
+
+void Spell::PrepareAreaTargetsLineOfSight(std::list<WorldObject*> const& targets, Position const* losPosition)
+{
+    m_areaTargetsInLineOfSight.clear();
+    if (!losPosition || IsLineOfSightIgnored())
+        return;
+
+    std::vector<Unit*> units;
+    std::vector<LineOfSightQuery> queries;
+    for (WorldObject* target : targets)
+    {
+        Unit* unit = target->ToUnit();
+        if (!unit || !unit->IsInWorld())
+            continue;
+
+        units.push_back(unit);
+        queries.emplace_back();
+        unit->BuildLineOfSightQuery(losPosition->GetPositionX(), losPosition->GetPositionY(), losPosition->GetPositionZ(), queries.back());
+    }
+
+    // nothing to gain for a single target, CheckEffectTarget falls back to IsWithinLOS
+    if (queries.size() < 2)
+        return;
+
+    m_caster->GetMap()->isInLineOfSight(queries, LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2);
+    for (std::size_t i = 0; i < queries.size(); ++i)
+        m_areaTargetsInLineOfSight[units[i]->GetGUID()] = queries[i].InLineOfSight;
+}
+
 bool Spell::CheckEffectTarget(GameObject const* target, SpellEffectInfo const* effect) const
 {
     if (!effect->IsEffect())
@@ -24,6 +24,7 @@
 #include "Position.h"
 #include "SharedDefines.h"
 #include <memory>
+#include <unordered_map>
 
 namespace WorldPackets
 {
@@ -603,6 +604,7 @@ class TC_GAME_API Spell
         void DoCreateItem(uint32 i, uint32 itemtype, ItemContext context = ItemContext::NONE, std::vector<int32> const& bonusListIDs = std::vector<int32>());
 
         bool CheckEffectTarget(Unit const* target, SpellEffectInfo const* effect, Position const* losPosition) const;
+        bool IsLineOfSightIgnored() const;
         bool CheckEffectTarget(GameObject const* target, SpellEffectInfo const* effect) const;
         bool CheckEffectTarget(Item const* target, SpellEffectInfo const* effect) const;
         bool CanAutoCast(Unit* target);
@@ -841,6 +843,10 @@ class TC_GAME_API Spell
 
         SpellDestination m_destTargets[MAX_SPELL_EFFECTS];
 
+        // line of sight of area targets to the area center, resolved with one batched query before they are added
+        std::unordered_map<ObjectGuid, bool> m_areaTargetsInLineOfSight;
+        void PrepareAreaTargetsLineOfSight(std::list<WorldObject*> const& targets, Position const* losPosition);
+
         void AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid = true, bool implicit = true, Position const* losPosition = nullptr);
         void AddGOTarget(GameObject* target, uint32 effectMask);
         void AddItemTarget(Item* item, uint32 effectMask);
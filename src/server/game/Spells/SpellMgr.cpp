@@ -37,6 +37,9 @@
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
+#include <limits>
+#include <map>
+#include <type_traits>
 
 namespace
 {
@@ -61,7 +64,26 @@ namespace
         >
     > mSpellInfoMap;
 
+    // Dense index over mSpellInfoMap built once it is loaded, fallback difficulties are resolved in advance.
+    // Spells with the same set of difficulties share a row of DifficultySlots telling which of their SpellInfos answers each difficulty.
+    struct SpellInfoLookupEntry
+    {
+        uint32 FirstSlot;           // first of the spell's SpellInfos in SpellInfoLookup::Slots, ordered by difficulty
+        uint32 DifficultyRow;       // offset of the spell's row in SpellInfoLookup::DifficultySlots
+    };
+
+    uint32 const SPELL_INFO_LOOKUP_ROW_SIZE = std::numeric_limits<std::underlying_type<Difficulty>::type>::max() + 1;
+    uint8 const SPELL_INFO_LOOKUP_NO_SLOT = 0xFF;
+
+    struct SpellInfoLookup
+    {
+        std::vector<SpellInfoLookupEntry> Spells;       // indexed by spell id, unused ids point to row 0 which has no slots
+        std::vector<uint8> DifficultySlots;             // per difficulty, offset from FirstSlot or SPELL_INFO_LOOKUP_NO_SLOT
+        std::vector<SpellInfo const*> Slots;
+    } mSpellInfoLookup;
+
     std::unordered_map<std::pair<uint32, Difficulty>, SpellProcEntry> mSpellProcMap;
+    uint32 mSpellProcGeneration = 0;
 }
 
 PetFamilySpellsStore sPetFamilySpellsStore;
@@ -477,10 +499,15 @@ SpellProcEntry const* SpellMgr::GetSpellProcEntry(SpellInfo const* spellInfo) co
     return nullptr;
 }
 
+uint32 SpellMgr::GetSpellProcGeneration() const
+{
+    return mSpellProcGeneration;
+}
+
 bool SpellMgr::CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo)
 {
-    // proc type doesn't match
-    if (!(eventInfo.GetTypeMask() & procEntry.ProcFlags))
+    // proc type, spell type, spell phase or hit mask doesn't match
+    if (!CanSpellTriggerProcOnEventMasks(procEntry, eventInfo))
         return false;
 
     // check XP or honor target requirement
@@ -533,6 +560,19 @@ bool SpellMgr::CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcE
                 return false;
     }
 
+    return true;
+}
+
+bool SpellMgr::CanSpellTriggerProcOnEventMasks(SpellProcEntry const& procEntry, ProcEventInfo const& eventInfo)
+{
+    // proc type doesn't match
+    if (!(eventInfo.GetTypeMask() & procEntry.ProcFlags))
+        return false;
+
+    // always trigger for these types
+    if (eventInfo.GetTypeMask() & (PROC_FLAG_KILLED | PROC_FLAG_KILL | PROC_FLAG_DEATH))
+        return true;
+
     // check spell type mask (if set)
     if (eventInfo.GetTypeMask() & (SPELL_PROC_FLAG_MASK | PERIODIC_PROC_FLAG_MASK))
     {
@@ -664,6 +704,16 @@ SpellAreaForQuestAreaMapBounds SpellMgr::GetSpellAreaForQuestAreaMapBounds(uint3
 }
 
 SpellInfo const* SpellMgr::GetSpellInfo(uint32 spellId, Difficulty difficulty) const
+{
+    if (spellId >= mSpellInfoLookup.Spells.size())
+        return nullptr;
+
+    SpellInfoLookupEntry const& entry = mSpellInfoLookup.Spells[spellId];
+    uint8 slot = mSpellInfoLookup.DifficultySlots[entry.DifficultyRow + difficulty];
+    return slot != SPELL_INFO_LOOKUP_NO_SLOT ? mSpellInfoLookup.Slots[entry.FirstSlot + slot] : nullptr;
+}
+
+SpellInfo const* SpellMgr::GetSpellInfoFromStore(uint32 spellId, Difficulty difficulty) const
 {
     auto itr = mSpellInfoMap.find(boost::make_tuple(spellId, difficulty));
     if (itr != mSpellInfoMap.end())
@@ -1479,6 +1529,7 @@ void SpellMgr::LoadSpellProcs()
     uint32 oldMSTime = getMSTime();
 
     mSpellProcMap.clear();                             // need for reload case
+    ++mSpellProcGeneration;
 
     //                                                     0           1                2                 3                 4                 5                 6
     QueryResult result = WorldDatabase.Query("SELECT SpellId, SchoolMask, SpellFamilyName, SpellFamilyMask0, SpellFamilyMask1, SpellFamilyMask2, SpellFamilyMask3, "
@@ -2596,11 +2647,84 @@ void SpellMgr::LoadSpellInfoStore()
         mSpellInfoMap.emplace(spellNameEntry, data.first.second, data.second, std::move(visuals));
     }
 
+    // SpellInfos are only modified in place from now on, the index stays valid until UnloadSpellInfoStore
+    BuildSpellInfoLookup();
+
     TC_LOG_INFO("server.loading", ">> Loaded SpellInfo store in %u ms", GetMSTimeDiffToNow(oldMSTime));
 }
 
+void SpellMgr::BuildSpellInfoLookup()
+{
+    std::vector<SpellInfo const*> spellInfos;
+    spellInfos.reserve(mSpellInfoMap.size());
+    uint32 maxSpellId = 0;
+    for (SpellInfo const& spellInfo : mSpellInfoMap)
+    {
+        spellInfos.push_back(&spellInfo);
+        maxSpellId = std::max(maxSpellId, spellInfo.Id);
+    }
+
+    std::sort(spellInfos.begin(), spellInfos.end(), [](SpellInfo const* left, SpellInfo const* right)
+    {
+        return std::make_pair(left->Id, left->Difficulty) < std::make_pair(right->Id, right->Difficulty);
+    });
+
+    mSpellInfoLookup.Spells.assign(spellInfos.empty() ? 0 : maxSpellId + 1, { 0, 0 });
+    mSpellInfoLookup.DifficultySlots.assign(SPELL_INFO_LOOKUP_ROW_SIZE, SPELL_INFO_LOOKUP_NO_SLOT);
+    mSpellInfoLookup.Slots = spellInfos;
+
+    // same walk as GetSpellInfoFromStore, done once per distinct set of difficulties
+    std::map<std::vector<Difficulty>, uint32> rows;
+    for (std::size_t first = 0; first < spellInfos.size();)
+    {
+        std::size_t last = first;
+        std::vector<Difficulty> difficulties;
+        for (; last < spellInfos.size() && spellInfos[last]->Id == spellInfos[first]->Id; ++last)
+            difficulties.push_back(spellInfos[last]->Difficulty);
+
+        ASSERT(difficulties.size() < SPELL_INFO_LOOKUP_NO_SLOT, "Spell %u has too many difficulties", spellInfos[first]->Id);
+
+        auto row = rows.find(difficulties);
+        if (row == rows.end())
+        {
+            uint32 rowOffset = uint32(mSpellInfoLookup.DifficultySlots.size());
+            mSpellInfoLookup.DifficultySlots.resize(rowOffset + SPELL_INFO_LOOKUP_ROW_SIZE, SPELL_INFO_LOOKUP_NO_SLOT);
+
+            auto findSlot = [&difficulties](uint32 difficulty) -> uint8
+            {
+                auto itr = std::find(difficulties.begin(), difficulties.end(), Difficulty(difficulty));
+                return itr != difficulties.end() ? uint8(std::distance(difficulties.begin(), itr)) : SPELL_INFO_LOOKUP_NO_SLOT;
+            };
+
+            for (uint32 difficulty = 0; difficulty < SPELL_INFO_LOOKUP_ROW_SIZE; ++difficulty)
+            {
+                uint8 slot = findSlot(difficulty);
+                DifficultyEntry const* difficultyEntry = sDifficultyStore.LookupEntry(difficulty);
+                // bounded in case of a fallback cycle in the db2 data
+                for (uint32 steps = 0; slot == SPELL_INFO_LOOKUP_NO_SLOT && difficultyEntry && steps < SPELL_INFO_LOOKUP_ROW_SIZE; ++steps)
+                {
+                    slot = findSlot(difficultyEntry->FallbackDifficultyID);
+                    difficultyEntry = sDifficultyStore.LookupEntry(difficultyEntry->FallbackDifficultyID);
+                }
+
+                mSpellInfoLookup.DifficultySlots[rowOffset + difficulty] = slot;
+            }
+
+            row = rows.emplace(std::move(difficulties), rowOffset).first;
+        }
+
+        mSpellInfoLookup.Spells[spellInfos[first]->Id] = { uint32(first), row->second };
+        first = last;
+    }
+
+    TC_LOG_INFO("server.loading", ">> Built SpellInfo lookup for %u spells with %u distinct difficulty sets", uint32(mSpellInfoLookup.Spells.size()), uint32(rows.size()));
+}
+
 void SpellMgr::UnloadSpellInfoStore()
 {
+    mSpellInfoLookup.Spells.clear();
+    mSpellInfoLookup.DifficultySlots.clear();
+    mSpellInfoLookup.Slots.clear();
     mSpellInfoMap.clear();
 }
 
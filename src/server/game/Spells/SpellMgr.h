@@ -682,6 +682,10 @@ class TC_GAME_API SpellMgr
         // Spell proc table
         SpellProcEntry const* GetSpellProcEntry(SpellInfo const* spellInfo) const;
         static bool CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo);
+        // checks only the event masks, needed but not enough for CanSpellTriggerProcOnEvent
+        static bool CanSpellTriggerProcOnEventMasks(SpellProcEntry const& procEntry, ProcEventInfo const& eventInfo);
+        // changes each time the table is (re)loaded, SpellProcEntry pointers of the previous load are no longer valid
+        uint32 GetSpellProcGeneration() const;
 
         // Spell threat table
         SpellThreatEntry const* GetSpellThreatEntry(uint32 spellID) const;
@@ -708,6 +712,8 @@ class TC_GAME_API SpellMgr
 
         // SpellInfo object management
         SpellInfo const* GetSpellInfo(uint32 spellId, Difficulty difficulty = DIFFICULTY_NONE) const;
+        // same result as GetSpellInfo through the hashed store and the fallback difficulty chain, for comparison only
+        SpellInfo const* GetSpellInfoFromStore(uint32 spellId, Difficulty difficulty = DIFFICULTY_NONE) const;
 
         // Use this only with 100% valid spellIds
         SpellInfo const* AssertSpellInfo(uint32 spellId, Difficulty difficulty) const
@@ -749,6 +755,7 @@ class TC_GAME_API SpellMgr
         void LoadPetDefaultSpells();
         void LoadSpellAreas();
         void LoadSpellInfoStore();
+        void BuildSpellInfoLookup();
         void UnloadSpellInfoStore();
         void UnloadSpellInfoImplicitTargetConditionLists();
         void LoadSpellInfoCustomAttributes();
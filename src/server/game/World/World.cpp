@@ -87,6 +87,7 @@
 #include "SpellMgr.h"
 #include "SmartScriptMgr.h"
 #include "SupportMgr.h"
+#include "TaskGraph.h"
 #include "TaxiPathGraph.h"
 #include "TransportMgr.h"
 #include "Unit.h"
@@ -102,6 +103,7 @@
 #include "WorldSocket.h"
 
 #include <boost/algorithm/string.hpp>
+#include <limits>
 
 TC_GAME_API std::atomic<bool> World::m_stopEvent(false);
 TC_GAME_API uint8 World::m_ExitCode = SHUTDOWN_EXIT_CODE;
@@ -1333,6 +1335,8 @@ void World::LoadConfigSettings(bool reload)
     }
 
     m_bool_configs[CONFIG_ENABLE_MMAPS] = sConfigMgr->GetBoolDefault("mmap.enablePathFinding", false);
+    m_bool_configs[CONFIG_MMAP_ASYNC_PATH_REQUESTS] = sConfigMgr->GetBoolDefault("mmap.asyncPathRequests", true);
+    m_int_configs[CONFIG_MMAP_PATH_CACHE_TIME] = sConfigMgr->GetIntDefault("mmap.pathCacheTime", 1000);
     TC_LOG_INFO("server.loading", "WORLD: MMap data directory is: %smmaps", m_dataPath.c_str());
 
     m_bool_configs[CONFIG_VMAP_INDOOR_CHECK] = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", false);
@@ -1370,6 +1374,8 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_LOADING_THREADS] = std::max(sConfigMgr->GetIntDefault("Loading.Threads", 4), 1);
+    m_int_configs[CONFIG_GRID_PREFETCH_THREADS] = sConfigMgr->GetIntDefault("GridPrefetch.Threads", 1);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1534,6 +1540,26 @@ void World::SetInitialWorldSettings()
     ///- Initialize Allowed Security Level
     LoadDBAllowedSecurityLevel();
 
+    ///- Independent loaders run concurrently, every running loader needs its own synchronous world database connection
+    TaskGraph loaders;
+    if (getIntConfig(CONFIG_LOADING_THREADS) > WorldDatabase.GetSynchConnectionCount())
+    {
+        uint8 const extraConnections = uint8(std::min<std::size_t>(getIntConfig(CONFIG_LOADING_THREADS) - WorldDatabase.GetSynchConnectionCount(), std::numeric_limits<uint8>::max()));
+        if (WorldDatabase.OpenExtraSynchConnections(extraConnections))
+            TC_LOG_ERROR("server.loading", "Could not open all %u extra world database connections for loading, loaders run with " SZFMTD " threads.",
+                uint32(extraConnections), WorldDatabase.GetSynchConnectionCount());
+    }
+
+    uint32 const loaderThreads = std::min<uint32>(getIntConfig(CONFIG_LOADING_THREADS), uint32(WorldDatabase.GetSynchConnectionCount()));
+    auto addLoader = [&loaders](char const* name, std::function<void()> loader, std::initializer_list<TaskGraph::TaskId> dependencies = { })
+    {
+        return loaders.AddTask(name, [name, loader]()
+        {
+            TC_LOG_INFO("server.loading", "Loading %s...", name);
+            loader();
+        }, dependencies);
+    };
+
     ///- Init highest guids before any table loading to prevent using not initialized guids in some code.
     sObjectMgr->SetHighestGuids();
 
@@ -1572,7 +1598,7 @@ void World::SetInitialWorldSettings()
 
     TC_LOG_INFO("server.loading", "Initialize data stores...");
     ///- Load DB2s
-    m_availableDbcLocaleMask = sDB2Manager.LoadStores(m_dataPath, m_defaultDbcLocale);
+    m_availableDbcLocaleMask = sDB2Manager.LoadStores(m_dataPath, sConfigMgr->GetStringDefault("DB2CacheDir", ""), m_defaultDbcLocale);
     if (!(m_availableDbcLocaleMask & (1 << m_defaultDbcLocale)))
     {
         TC_LOG_FATAL("server.loading", "Unable to load db2 files for %s locale specified in DBC.Locale config!", localeNames[m_defaultDbcLocale]);
@@ -1625,456 +1651,223 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Initializing PlayerDump tables...");
     PlayerDump::InitializeTables();
 
-    TC_LOG_INFO("server.loading", "Loading SpellInfo store...");
-    sSpellMgr->LoadSpellInfoStore();
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo corrections...");
-    sSpellMgr->LoadSpellInfoCorrections();
-
-    TC_LOG_INFO("server.loading", "Loading SkillLineAbilityMultiMap Data...");
-    sSpellMgr->LoadSkillLineAbilityMap();
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo custom attributes...");
-    sSpellMgr->LoadSpellInfoCustomAttributes();
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo diminishing infos...");
-    sSpellMgr->LoadSpellInfoDiminishing();
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo immunity infos...");
-    sSpellMgr->LoadSpellInfoImmunities();
-
-    TC_LOG_INFO("server.loading", "Loading PetFamilySpellsStore Data...");
-    sSpellMgr->LoadPetFamilySpellsStore();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Totem models...");
-    sSpellMgr->LoadSpellTotemModel();
-
-    TC_LOG_INFO("server.loading", "Loading GameObject models...");
-    LoadGameObjectModelList(m_dataPath);
-
-    TC_LOG_INFO("server.loading", "Loading Script Names...");
-    sObjectMgr->LoadScriptNames();
-
-    TC_LOG_INFO("server.loading", "Loading Instance Template...");
-    sObjectMgr->LoadInstanceTemplate();
-
-    // Must be called before `creature_respawn`/`gameobject_respawn` tables
-    TC_LOG_INFO("server.loading", "Loading instances...");
-    sInstanceSaveMgr->LoadInstances();
-
     TC_LOG_INFO("server.loading", "Loading Localization strings...");
     uint32 oldMSTime = getMSTime();
-    sObjectMgr->LoadCreatureLocales();
-    sObjectMgr->LoadGameObjectLocales();
-    sObjectMgr->LoadQuestTemplateLocale();
-    sObjectMgr->LoadQuestGreetingLocales();
-    sObjectMgr->LoadQuestOfferRewardLocale();
-    sObjectMgr->LoadQuestRequestItemsLocale();
-    sObjectMgr->LoadQuestObjectivesLocale();
-    sObjectMgr->LoadPageTextLocales();
-    sObjectMgr->LoadGossipMenuItemsLocales();
-    sObjectMgr->LoadPointOfInterestLocales();
+    addLoader("Creature locales", [] { sObjectMgr->LoadCreatureLocales(); });
+    addLoader("GameObject locales", [] { sObjectMgr->LoadGameObjectLocales(); });
+    addLoader("Quest template locales", [] { sObjectMgr->LoadQuestTemplateLocale(); });
+    addLoader("Quest greeting locales", [] { sObjectMgr->LoadQuestGreetingLocales(); });
+    addLoader("Quest offer reward locales", [] { sObjectMgr->LoadQuestOfferRewardLocale(); });
+    addLoader("Quest request items locales", [] { sObjectMgr->LoadQuestRequestItemsLocale(); });
+    addLoader("Quest objectives locales", [] { sObjectMgr->LoadQuestObjectivesLocale(); });
+    addLoader("Page text locales", [] { sObjectMgr->LoadPageTextLocales(); });
+    addLoader("Gossip menu items locales", [] { sObjectMgr->LoadGossipMenuItemsLocales(); });
+    addLoader("Point of interest locales", [] { sObjectMgr->LoadPointOfInterestLocales(); });
+    loaders.Run(loaderThreads);
 
     sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
     TC_LOG_INFO("server.loading", ">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
 
-    TC_LOG_INFO("server.loading", "Loading Account Roles and Permissions...");
-    sAccountMgr->LoadRBAC();
-
-    TC_LOG_INFO("server.loading", "Loading Page Texts...");
-    sObjectMgr->LoadPageTexts();
-
-    TC_LOG_INFO("server.loading", "Loading Game Object Templates...");         // must be after LoadPageTexts
-    sObjectMgr->LoadGameObjectTemplate();
-
-    TC_LOG_INFO("server.loading", "Loading Game Object template addons...");
-    sObjectMgr->LoadGameObjectTemplateAddons();
-
-    TC_LOG_INFO("server.loading", "Loading Transport templates...");
-    sTransportMgr->LoadTransportTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Transport animations and rotations...");
-    sTransportMgr->LoadTransportAnimationAndRotation();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Rank Data...");
-    sSpellMgr->LoadSpellRanks();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Required Data...");
-    sSpellMgr->LoadSpellRequired();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Group types...");
-    sSpellMgr->LoadSpellGroups();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Skills...");
-    sSpellMgr->LoadSpellLearnSkills();                           // must be after LoadSpellRanks
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo SpellSpecific and AuraState...");
-    sSpellMgr->LoadSpellInfoSpellSpecificAndAuraState();         // must be after LoadSpellRanks
-
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Spells...");
-    sSpellMgr->LoadSpellLearnSpells();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
-    sSpellMgr->LoadSpellProcs();
-
-    TC_LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
-    sSpellMgr->LoadSpellThreats();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
-    sSpellMgr->LoadSpellGroupStackRules();
-
-    TC_LOG_INFO("server.loading", "Loading NPC Texts...");
-    sObjectMgr->LoadNPCText();
-
-    TC_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
-    sSpellMgr->LoadSpellEnchantProcData();
-
-    TC_LOG_INFO("server.loading", "Loading Random item bonus list definitions...");
-    LoadItemRandomBonusListTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Disables");                         // must be before loading quests and items
-    DisableMgr::LoadDisables();
-
-    TC_LOG_INFO("server.loading", "Loading Items...");                         // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr->LoadItemTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Item set names...");                // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemTemplateAddon();
-
-    TC_LOG_INFO("server.loading", "Loading Item scrapping loots...");
-    sObjectMgr->LoadItemScrappingLoot();
-
-    TC_LOG_INFO("misc", "Loading Item Scripts...");                            // must be after LoadItemPrototypes
-    sObjectMgr->LoadItemScriptNames();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Model Based Info Data...");
-    sObjectMgr->LoadCreatureModelInfo();
-
-    TC_LOG_INFO("server.loading", "Loading Creature templates...");
-    sObjectMgr->LoadCreatureTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Creature template journals...");
-    sObjectMgr->LoadCreatureTemplateJournals();                                // must be after LoadCreatureTemplates
-
-    TC_LOG_INFO("server.loading", "Loading Equipment templates...");           // must be after LoadCreatureTemplates
-    sObjectMgr->LoadEquipmentTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Creature template addons...");
-    sObjectMgr->LoadCreatureTemplateAddons();
-
-    TC_LOG_INFO("server.loading", "Loading Creature template scaling...");
-    sObjectMgr->LoadCreatureScalingData();
-
-    TC_LOG_INFO("server.loading", "Loading Reputation Reward Rates...");
-    sObjectMgr->LoadReputationRewardRate();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data...");
-    sObjectMgr->LoadReputationOnKill();
-
-    TC_LOG_INFO("server.loading", "Loading Reputation Spillover Data...");
-    sObjectMgr->LoadReputationSpilloverTemplate();
-
-    TC_LOG_INFO("server.loading", "Loading Points Of Interest Data...");
-    sObjectMgr->LoadPointsOfInterest();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Base Stats...");
-    sObjectMgr->LoadCreatureClassLevelStats();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Data...");
-    sObjectMgr->LoadCreatures();
-
-    TC_LOG_INFO("server.loading", "Loading Temporary Summon Data...");
-    sObjectMgr->LoadTempSummons();                               // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
-
-    TC_LOG_INFO("server.loading", "Loading Script Params...");
-    sObjectMgr->LoadScriptParams();                              // must be after LoadCreatures()
-
-    TC_LOG_INFO("server.loading", "Loading pet levelup spells...");
-    sSpellMgr->LoadPetLevelupSpellMap();
-
-    TC_LOG_INFO("server.loading", "Loading pet default spells additional to levelup spells...");
-    sSpellMgr->LoadPetDefaultSpells();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Addon Data...");
-    sObjectMgr->LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
-
-    TC_LOG_INFO("server.loading", "Loading Gameobject Data...");
-    sObjectMgr->LoadGameobjects();
-
-    TC_LOG_INFO("server.loading", "Loading GameObject Addon Data...");
-    sObjectMgr->LoadGameObjectAddons();                          // must be after LoadGameObjectTemplate() and LoadGameobjects()
-
-    TC_LOG_INFO("server.loading", "Loading GameObject Quest Items...");
-    sObjectMgr->LoadGameObjectQuestItems();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Quest Items...");
-    sObjectMgr->LoadCreatureQuestItems();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Linked Respawn...");
-    sObjectMgr->LoadLinkedRespawn();                             // must be after LoadCreatures(), LoadGameObjects()
-
-    TC_LOG_INFO("server.loading", "Loading Weather Data...");
-    WeatherMgr::LoadWeatherData();
-
-    TC_LOG_INFO("server.loading", "Loading Quests...");
-    sObjectMgr->LoadQuests();                                    // must be loaded after DBCs, creature_template, items, gameobject tables
-
-    TC_LOG_INFO("server.loading", "Checking Quest Disables");
-    DisableMgr::CheckQuestDisables();                           // must be after loading quests
-
-    TC_LOG_INFO("server.loading", "Loading Quest POI");
-    sObjectMgr->LoadQuestPOI();
-
-    TC_LOG_INFO("server.loading", "Loading Quests Starters and Enders...");
-    sObjectMgr->LoadQuestStartersAndEnders();                    // must be after quest load
-
-    TC_LOG_INFO("server.loading", "Loading Quest Greetings...");
-    sObjectMgr->LoadQuestGreetings();
-
-    TC_LOG_INFO("server.loading", "Loading Objects Pooling Data...");
-    sPoolMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Filling pools data from Areas...");
-    sAreaMgr->FillGatheringNodePools();
-
-    TC_LOG_INFO("server.loading", "Loading Game Event Data...");               // must be after loading pools fully
-    sGameEventMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading UNIT_NPC_FLAG_SPELLCLICK Data..."); // must be after LoadQuests
-    sObjectMgr->LoadNPCSpellClickSpells();
-
-    TC_LOG_INFO("server.loading", "Loading Vehicle Template Accessories...");
-    sObjectMgr->LoadVehicleTemplateAccessories();                // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
-
-    TC_LOG_INFO("server.loading", "Loading Vehicle Accessories...");
-    sObjectMgr->LoadVehicleAccessories();                       // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
-
-    TC_LOG_INFO("server.loading", "Loading SpellArea Data...");                // must be after quest load
-    sSpellMgr->LoadSpellAreas();
-
-    TC_LOG_INFO("server.loading", "Loading World locations...");
-    sObjectMgr->LoadWorldSafeLocs();                            // must be before LoadAreaTriggerTeleports and LoadGraveyardZones
-
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger definitions...");
-    sObjectMgr->LoadAreaTriggerTeleports();
-
-    TC_LOG_INFO("server.loading", "Loading Access Requirements...");
-    sObjectMgr->LoadAccessRequirements();                        // must be after item template load
-
-    TC_LOG_INFO("server.loading", "Loading Quest Area Triggers...");
-    sObjectMgr->LoadQuestAreaTriggers();                         // must be after LoadQuests
-
-    TC_LOG_INFO("server.loading", "Loading Tavern Area Triggers...");
-    sObjectMgr->LoadTavernAreaTriggers();
-
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger script names...");
-    sObjectMgr->LoadAreaTriggerScripts();
-
-    TC_LOG_INFO("server.loading", "Loading LFG entrance positions..."); // Must be after areatriggers
-    sLFGMgr->LoadLFGDungeons();
-
-    TC_LOG_INFO("server.loading", "Loading Dungeon boss data...");
-    sObjectMgr->LoadInstanceEncounters();
-
-    TC_LOG_INFO("server.loading", "Loading LFG rewards...");
-    sLFGMgr->LoadRewards();
-
-    TC_LOG_INFO("server.loading", "Loading Graveyard-zone links...");
-    sObjectMgr->LoadGraveyardZones();
-
-    TC_LOG_INFO("server.loading", "Loading spell pet auras...");
-    sSpellMgr->LoadSpellPetAuras();
-
-    TC_LOG_INFO("server.loading", "Loading Spell target coordinates...");
-    sSpellMgr->LoadSpellTargetPositions();
-
-    TC_LOG_INFO("server.loading", "Loading enchant custom attributes...");
-    sSpellMgr->LoadEnchantCustomAttr();
-
-    TC_LOG_INFO("server.loading", "Loading linked spells...");
-    sSpellMgr->LoadSpellLinked();
-
-    TC_LOG_INFO("server.loading", "Loading Player Create Data...");
-    sObjectMgr->LoadPlayerInfo();
-
-    TC_LOG_INFO("server.loading", "Loading Exploration BaseXP Data...");
-    sObjectMgr->LoadExplorationBaseXP();
-
-    TC_LOG_INFO("server.loading", "Loading Pet Name Parts...");
-    sObjectMgr->LoadPetNames();
-
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger Templates...");
-    sAreaTriggerDataStore->LoadAreaTriggerTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading AreaTriggers...");
-    sAreaTriggerDataStore->LoadAreaTriggers();
-
-    TC_LOG_INFO("server.loading", "Loading Conversation Templates...");
-    sConversationDataStore->LoadConversationTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Scenes Templates...");
-    sObjectMgr->LoadSceneTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Player Choices...");
-    sObjectMgr->LoadPlayerChoices();
-
-    TC_LOG_INFO("server.loading", "Loading Player Choices Locales...");
-    sObjectMgr->LoadPlayerChoicesLocale();
-
-    TC_LOG_INFO("server.loading", "Loading Instance difficulty multipliers...");
-    sObjectMgr->LoadInstanceDifficultyMultiplier();
-
-    CharacterDatabaseCleaner::CleanDatabase();
-
-    TC_LOG_INFO("server.loading", "Loading the max pet number...");
-    sObjectMgr->LoadPetNumber();
-
-    TC_LOG_INFO("server.loading", "Loading pet level stats...");
-    sObjectMgr->LoadPetLevelInfo();
-
-    TC_LOG_INFO("server.loading", "Loading Player level dependent mail rewards...");
-    sObjectMgr->LoadMailLevelRewards();
-
-    // Loot tables
-    LoadLootTables();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Perfection Data Table...");
-    LoadSkillPerfectItemTable();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Fishing base level requirements...");
-    sObjectMgr->LoadFishingBaseSkillLevel();
+    ///- Loaders touching the same manager stay chained in their original order, lanes of different managers overlap
+    // SpellInfo is modified up to the end of this chain, everything reading spells depends on it
+    TaskGraph::TaskId spells = addLoader("SpellInfo store", [] { sSpellMgr->LoadSpellInfoStore(); });
+    spells = addLoader("SpellInfo corrections", [] { sSpellMgr->LoadSpellInfoCorrections(); }, { spells });
+    spells = addLoader("SkillLineAbilityMultiMap Data", [] { sSpellMgr->LoadSkillLineAbilityMap(); }, { spells });
+    spells = addLoader("SpellInfo custom attributes", [] { sSpellMgr->LoadSpellInfoCustomAttributes(); }, { spells });
+    spells = addLoader("SpellInfo diminishing infos", [] { sSpellMgr->LoadSpellInfoDiminishing(); }, { spells });
+    spells = addLoader("SpellInfo immunity infos", [] { sSpellMgr->LoadSpellInfoImmunities(); }, { spells });
+    spells = addLoader("PetFamilySpellsStore Data", [] { sSpellMgr->LoadPetFamilySpellsStore(); }, { spells });
+    spells = addLoader("Spell Totem models", [] { sSpellMgr->LoadSpellTotemModel(); }, { spells });
+    spells = addLoader("Spell Rank Data", [] { sSpellMgr->LoadSpellRanks(); }, { spells });
+    spells = addLoader("Spell Required Data", [] { sSpellMgr->LoadSpellRequired(); }, { spells });
+    spells = addLoader("Spell Group types", [] { sSpellMgr->LoadSpellGroups(); }, { spells });
+    spells = addLoader("Spell Learn Skills", [] { sSpellMgr->LoadSpellLearnSkills(); }, { spells });                                         // must be after LoadSpellRanks
+    spells = addLoader("SpellInfo SpellSpecific and AuraState", [] { sSpellMgr->LoadSpellInfoSpellSpecificAndAuraState(); }, { spells });   // must be after LoadSpellRanks
+    spells = addLoader("Spell Learn Spells", [] { sSpellMgr->LoadSpellLearnSpells(); }, { spells });
+    spells = addLoader("Spell Proc conditions and data", [] { sSpellMgr->LoadSpellProcs(); }, { spells });
+    spells = addLoader("Aggro Spells Definitions", [] { sSpellMgr->LoadSpellThreats(); }, { spells });
+    spells = addLoader("Spell Group Stack Rules", [] { sSpellMgr->LoadSpellGroupStackRules(); }, { spells });
+    spells = addLoader("Enchant Spells Proc datas", [] { sSpellMgr->LoadSpellEnchantProcData(); }, { spells });
+
+    TaskGraph::TaskId spellTables = addLoader("spell pet auras", [] { sSpellMgr->LoadSpellPetAuras(); }, { spells });
+    spellTables = addLoader("Spell target coordinates", [] { sSpellMgr->LoadSpellTargetPositions(); }, { spellTables });
+    spellTables = addLoader("enchant custom attributes", [] { sSpellMgr->LoadEnchantCustomAttr(); }, { spellTables });
+    spellTables = addLoader("linked spells", [] { sSpellMgr->LoadSpellLinked(); }, { spellTables });
+
+    addLoader("GameObject models", [this] { LoadGameObjectModelList(m_dataPath); });
+    addLoader("Account Roles and Permissions", [] { sAccountMgr->LoadRBAC(); });
+
+    // Script names are added by most loaders below, the store has to be filled first
+    TaskGraph::TaskId scriptNames = addLoader("Script Names", [] { sObjectMgr->LoadScriptNames(); });
+    TaskGraph::TaskId instances = addLoader("Instance Template", [] { sObjectMgr->LoadInstanceTemplate(); }, { scriptNames });
+    instances = addLoader("instances", [] { sInstanceSaveMgr->LoadInstances(); }, { instances });          // Must be called before `creature_respawn`/`gameobject_respawn` tables
+
+    TaskGraph::TaskId cleaner = loaders.AddTask("Character database cleaner", &CharacterDatabaseCleaner::CleanDatabase, { spells });
+
+    TaskGraph::TaskId world = addLoader("Page Texts", [] { sObjectMgr->LoadPageTexts(); }, { scriptNames });
+    world = addLoader("Game Object Templates", [] { sObjectMgr->LoadGameObjectTemplate(); }, { world, spells });                 // must be after LoadPageTexts
+    world = addLoader("Game Object template addons", [] { sObjectMgr->LoadGameObjectTemplateAddons(); }, { world });
+    world = addLoader("Transport templates", [] { sTransportMgr->LoadTransportTemplates(); }, { world });
+    world = addLoader("Transport animations and rotations", [] { sTransportMgr->LoadTransportAnimationAndRotation(); }, { world });
+    world = addLoader("NPC Texts", [] { sObjectMgr->LoadNPCText(); }, { world });
+    world = addLoader("Random item bonus list definitions", &LoadItemRandomBonusListTemplates, { world });
+    world = addLoader("Disables", &DisableMgr::LoadDisables, { world });                                                        // must be before loading quests and items
+    world = addLoader("Items", [] { sObjectMgr->LoadItemTemplates(); }, { world });                                              // must be after LoadRandomEnchantmentsTable and LoadPageTexts
+    world = addLoader("Item set names", [] { sObjectMgr->LoadItemTemplateAddon(); }, { world });                                 // must be after LoadItemPrototypes
+    world = addLoader("Item scrapping loots", [] { sObjectMgr->LoadItemScrappingLoot(); }, { world });
+    world = addLoader("Item Scripts", [] { sObjectMgr->LoadItemScriptNames(); }, { world });                                     // must be after LoadItemPrototypes
+    world = addLoader("Creature Model Based Info Data", [] { sObjectMgr->LoadCreatureModelInfo(); }, { world });
+    world = addLoader("Creature templates", [] { sObjectMgr->LoadCreatureTemplates(); }, { world });
+    world = addLoader("Creature template journals", [] { sObjectMgr->LoadCreatureTemplateJournals(); }, { world });              // must be after LoadCreatureTemplates
+    world = addLoader("Equipment templates", [] { sObjectMgr->LoadEquipmentTemplates(); }, { world });                           // must be after LoadCreatureTemplates
+    world = addLoader("Creature template addons", [] { sObjectMgr->LoadCreatureTemplateAddons(); }, { world });
+    world = addLoader("Creature template scaling", [] { sObjectMgr->LoadCreatureScalingData(); }, { world });
+    world = addLoader("Reputation Reward Rates", [] { sObjectMgr->LoadReputationRewardRate(); }, { world });
+    world = addLoader("Creature Reputation OnKill Data", [] { sObjectMgr->LoadReputationOnKill(); }, { world });
+    world = addLoader("Reputation Spillover Data", [] { sObjectMgr->LoadReputationSpilloverTemplate(); }, { world });
+    world = addLoader("Points Of Interest Data", [] { sObjectMgr->LoadPointsOfInterest(); }, { world });
+    world = addLoader("Creature Base Stats", [] { sObjectMgr->LoadCreatureClassLevelStats(); }, { world });
+    world = addLoader("Creature Data", [] { sObjectMgr->LoadCreatures(); }, { world, instances });
+    world = addLoader("Temporary Summon Data", [] { sObjectMgr->LoadTempSummons(); }, { world });                               // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
+    world = addLoader("Script Params", [] { sObjectMgr->LoadScriptParams(); }, { world });                                       // must be after LoadCreatures()
+    world = addLoader("pet levelup spells", [] { sSpellMgr->LoadPetLevelupSpellMap(); }, { world });
+    world = addLoader("pet default spells additional to levelup spells", [] { sSpellMgr->LoadPetDefaultSpells(); }, { world });
+    world = addLoader("Creature Addon Data", [] { sObjectMgr->LoadCreatureAddons(); }, { world });                               // must be after LoadCreatureTemplates() and LoadCreatures()
+    world = addLoader("Gameobject Data", [] { sObjectMgr->LoadGameobjects(); }, { world });
+    world = addLoader("GameObject Addon Data", [] { sObjectMgr->LoadGameObjectAddons(); }, { world });                           // must be after LoadGameObjectTemplate() and LoadGameobjects()
+    world = addLoader("GameObject Quest Items", [] { sObjectMgr->LoadGameObjectQuestItems(); }, { world });
+    world = addLoader("Creature Quest Items", [] { sObjectMgr->LoadCreatureQuestItems(); }, { world });
+    world = addLoader("Creature Linked Respawn", [] { sObjectMgr->LoadLinkedRespawn(); }, { world });                            // must be after LoadCreatures(), LoadGameObjects()
+    world = addLoader("Weather Data", &WeatherMgr::LoadWeatherData, { world });
+    // Item, creature and gameobject templates are complete once quests are loaded, later loaders of this lane do not add any
+    world = addLoader("Quests", [] { sObjectMgr->LoadQuests(); }, { world });                                                    // must be loaded after DBCs, creature_template, items, gameobject tables
+    TaskGraph::TaskId const quests = world;
+    world = loaders.AddTask("Quest disables", []
+    {
+        TC_LOG_INFO("server.loading", "Checking Quest Disables");
+        DisableMgr::CheckQuestDisables();                                                                                            // must be after loading quests
+    }, { world });
+    world = addLoader("Quest POI", [] { sObjectMgr->LoadQuestPOI(); }, { world });
+    world = addLoader("Quests Starters and Enders", [] { sObjectMgr->LoadQuestStartersAndEnders(); }, { world });                // must be after quest load
+    world = addLoader("Quest Greetings", [] { sObjectMgr->LoadQuestGreetings(); }, { world });
+    world = addLoader("Objects Pooling Data", [] { sPoolMgr->LoadFromDB(); }, { world });
+    world = loaders.AddTask("Gathering node pools", []
+    {
+        TC_LOG_INFO("server.loading", "Filling pools data from Areas...");
+        sAreaMgr->FillGatheringNodePools();
+    }, { world });
+    world = addLoader("Game Event Data", [] { sGameEventMgr->LoadFromDB(); }, { world });                                       // must be after loading pools fully
+    world = addLoader("UNIT_NPC_FLAG_SPELLCLICK Data", [] { sObjectMgr->LoadNPCSpellClickSpells(); }, { world });                // must be after LoadQuests
+    world = addLoader("Vehicle Template Accessories", [] { sObjectMgr->LoadVehicleTemplateAccessories(); }, { world });          // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+    world = addLoader("Vehicle Accessories", [] { sObjectMgr->LoadVehicleAccessories(); }, { world });                           // must be after LoadCreatureTemplates() and LoadNPCSpellClickSpells()
+    world = addLoader("SpellArea Data", [] { sSpellMgr->LoadSpellAreas(); }, { world });                                         // must be after quest load
+    world = addLoader("World locations", [] { sObjectMgr->LoadWorldSafeLocs(); }, { world });                                    // must be before LoadAreaTriggerTeleports and LoadGraveyardZones
+    world = addLoader("AreaTrigger definitions", [] { sObjectMgr->LoadAreaTriggerTeleports(); }, { world });
+    world = addLoader("Access Requirements", [] { sObjectMgr->LoadAccessRequirements(); }, { world });                           // must be after item template load
+    world = addLoader("Quest Area Triggers", [] { sObjectMgr->LoadQuestAreaTriggers(); }, { world });                            // must be after LoadQuests
+    world = addLoader("Tavern Area Triggers", [] { sObjectMgr->LoadTavernAreaTriggers(); }, { world });
+    world = addLoader("AreaTrigger script names", [] { sObjectMgr->LoadAreaTriggerScripts(); }, { world });
+    world = addLoader("LFG entrance positions", [] { sLFGMgr->LoadLFGDungeons(); }, { world });                                  // Must be after areatriggers
+    world = addLoader("Dungeon boss data", [] { sObjectMgr->LoadInstanceEncounters(); }, { world });
+    world = addLoader("LFG rewards", [] { sLFGMgr->LoadRewards(); }, { world });
+    world = addLoader("Graveyard-zone links", [] { sObjectMgr->LoadGraveyardZones(); }, { world });
+    world = addLoader("Player Create Data", [] { sObjectMgr->LoadPlayerInfo(); }, { world });
+    world = addLoader("Exploration BaseXP Data", [] { sObjectMgr->LoadExplorationBaseXP(); }, { world });
+    world = addLoader("Pet Name Parts", [] { sObjectMgr->LoadPetNames(); }, { world });
+    world = addLoader("AreaTrigger Templates", [] { sAreaTriggerDataStore->LoadAreaTriggerTemplates(); }, { world });
+    world = addLoader("AreaTriggers", [] { sAreaTriggerDataStore->LoadAreaTriggers(); }, { world });
+    world = addLoader("Conversation Templates", [] { sConversationDataStore->LoadConversationTemplates(); }, { world });
+    world = addLoader("Scenes Templates", [] { sObjectMgr->LoadSceneTemplates(); }, { world });
+    world = addLoader("Player Choices", [] { sObjectMgr->LoadPlayerChoices(); }, { world });
+    world = addLoader("Player Choices Locales", [] { sObjectMgr->LoadPlayerChoicesLocale(); }, { world });
+    world = addLoader("Instance difficulty multipliers", [] { sObjectMgr->LoadInstanceDifficultyMultiplier(); }, { world });
+    world = addLoader("the max pet number", [] { sObjectMgr->LoadPetNumber(); }, { world });
+    world = addLoader("pet level stats", [] { sObjectMgr->LoadPetLevelInfo(); }, { world });
+    world = addLoader("Player level dependent mail rewards", [] { sObjectMgr->LoadMailLevelRewards(); }, { world });
+    world = addLoader("ReservedNames", [] { sObjectMgr->LoadReservedPlayersNames(); }, { world });
+    world = addLoader("BattleMasters", [] { sBattlegroundMgr->LoadBattleMastersEntry(); }, { world });                          // must be after load CreatureTemplate
+    world = addLoader("GameTeleports", [] { sObjectMgr->LoadGameTele(); }, { world });
+    world = addLoader("Trainers", [] { sObjectMgr->LoadTrainers(); }, { world });                                               // must be after load CreatureTemplate
+    world = addLoader("Creature summoner specific entry", [] { sObjectMgr->LoadCreatureSummonerEntry(); }, { world });
+    world = addLoader("Gossip menu", [] { sObjectMgr->LoadGossipMenu(); }, { world });
+    world = addLoader("Gossip menu options", [] { sObjectMgr->LoadGossipMenuItems(); }, { world });
+    world = addLoader("Creature trainers", [] { sObjectMgr->LoadCreatureTrainers(); }, { world });                               // must be after LoadGossipMenuItems
+    world = addLoader("Vendors", [] { sObjectMgr->LoadVendors(); }, { world });                                                  // must be after load CreatureTemplate and ItemTemplate
+    world = addLoader("Trainer spells", [] { sObjectMgr->LoadTrainerSpell(); }, { world });                                      // must be after load CreatureTemplate
+    world = addLoader("Waypoints", [] { sWaypointMgr->Load(); }, { world });
+    world = addLoader("SmartAI Waypoints", [] { sSmartWaypointMgr->LoadFromDB(); }, { world });
+    world = addLoader("Creature Formations", [] { sFormationMgr->LoadCreatureFormations(); }, { world });
+    world = addLoader("World States", [this] { LoadWorldStates(); }, { world });                                                 // must be loaded before battleground, outdoor PvP and conditions
+    world = loaders.AddTask("Phases", [] { sObjectMgr->LoadPhases(); }, { world });
+
+    // Loot tables, references are checked against all other loot stores
+    uint32 lootStartTime = 0;
+    TaskGraph::TaskId lootTables = addLoader("Loot Tables", [&lootStartTime] { lootStartTime = getMSTime(); }, { quests });
+    lootTables = loaders.AddTask("Reference loot templates", [&lootStartTime]
+    {
+        LoadLootTemplates_Reference();
+        TC_LOG_INFO("server.loading", ">> Loaded Loot Tables in %u ms", GetMSTimeDiffToNow(lootStartTime));
+    },
+    {
+        loaders.AddTask("Creature loot templates", &LoadLootTemplates_Creature, { lootTables }),
+        loaders.AddTask("Fishing loot templates", &LoadLootTemplates_Fishing, { lootTables }),
+        loaders.AddTask("Gameobject loot templates", &LoadLootTemplates_Gameobject, { lootTables }),
+        loaders.AddTask("Item loot templates", &LoadLootTemplates_Item, { lootTables }),
+        loaders.AddTask("Mail loot templates", &LoadLootTemplates_Mail, { lootTables }),
+        loaders.AddTask("Milling loot templates", &LoadLootTemplates_Milling, { lootTables }),
+        loaders.AddTask("Pickpocketing loot templates", &LoadLootTemplates_Pickpocketing, { lootTables }),
+        loaders.AddTask("Scrapping loot templates", &LoadLootTemplates_Scrapping, { lootTables }),
+        loaders.AddTask("Skinning loot templates", &LoadLootTemplates_Skinning, { lootTables }),
+        loaders.AddTask("Disenchant loot templates", &LoadLootTemplates_Disenchant, { lootTables }),
+        loaders.AddTask("Prospecting loot templates", &LoadLootTemplates_Prospecting, { lootTables }),
+        loaders.AddTask("Spell loot templates", &LoadLootTemplates_Spell, { lootTables })
+    });
 
-    TC_LOG_INFO("server.loading", "Loading skill tier info...");
-    sObjectMgr->LoadSkillTiers();
+    // Chest loot is checked for quest items
+    TaskGraph::TaskId questObjects = addLoader("GameObjects for quests", [] { sObjectMgr->LoadGameObjectForQuests(); }, { world, lootTables });
 
-    TC_LOG_INFO("server.loading", "Loading Criteria Modifier trees...");
-    sCriteriaMgr->LoadCriteriaModifiersTree();
-    TC_LOG_INFO("server.loading", "Loading Criteria Lists...");
-    sCriteriaMgr->LoadCriteriaList();
-    TC_LOG_INFO("server.loading", "Loading Criteria Data...");
-    sCriteriaMgr->LoadCriteriaData();
-    TC_LOG_INFO("server.loading", "Loading Achievements...");
-    sAchievementMgr->LoadAchievementReferenceList();
-    TC_LOG_INFO("server.loading", "Loading Achievement Rewards...");
-    sAchievementMgr->LoadRewards();
-    TC_LOG_INFO("server.loading", "Loading Achievement Reward Locales...");
-    sAchievementMgr->LoadRewardLocales();
-    TC_LOG_INFO("server.loading", "Loading Completed Achievements...");
-    sAchievementMgr->LoadCompletedAchievements();
+    TaskGraph::TaskId skillTables = addLoader("Skill Discovery Table", &LoadSkillDiscoveryTable, { spells });
+    skillTables = addLoader("Skill Extra Item Table", &LoadSkillExtraItemTable, { skillTables });
+    skillTables = addLoader("Skill Perfection Data Table", &LoadSkillPerfectItemTable, { skillTables });
+    skillTables = addLoader("Skill Fishing base level requirements", [] { sObjectMgr->LoadFishingBaseSkillLevel(); }, { skillTables });
+    skillTables = addLoader("skill tier info", [] { sObjectMgr->LoadSkillTiers(); }, { skillTables });
 
-    // Load before guilds and arena teams
-    TC_LOG_INFO("server.loading", "Loading character cache store...");
-    sCharacterCache->LoadCharacterCacheStorage();
+    TaskGraph::TaskId achievements = addLoader("Criteria Modifier trees", [] { sCriteriaMgr->LoadCriteriaModifiersTree(); }, { quests });
+    achievements = addLoader("Criteria Lists", [] { sCriteriaMgr->LoadCriteriaList(); }, { achievements });
+    achievements = addLoader("Criteria Data", [] { sCriteriaMgr->LoadCriteriaData(); }, { achievements });
+    achievements = addLoader("Achievements", [] { sAchievementMgr->LoadAchievementReferenceList(); }, { achievements });
+    achievements = addLoader("Achievement Rewards", [] { sAchievementMgr->LoadRewards(); }, { achievements });
+    achievements = addLoader("Achievement Reward Locales", [] { sAchievementMgr->LoadRewardLocales(); }, { achievements });
+    achievements = addLoader("Completed Achievements", [] { sAchievementMgr->LoadCompletedAchievements(); }, { achievements, cleaner });
 
     ///- Load dynamic data tables from the database
-    TC_LOG_INFO("server.loading", "Loading Auctions...");
-    sAuctionMgr->LoadAuctions();
-
+    TaskGraph::TaskId characters = addLoader("character cache store", [] { sCharacterCache->LoadCharacterCacheStorage(); });   // Load before guilds and arena teams
+    characters = addLoader("Auctions", [] { sAuctionMgr->LoadAuctions(); }, { characters, quests });
     if (m_bool_configs[CONFIG_BLACKMARKET_ENABLED])
     {
-        TC_LOG_INFO("server.loading", "Loading Black Market Templates...");
-        sBlackMarketMgr->LoadTemplates();
-
-        TC_LOG_INFO("server.loading", "Loading Black Market Auctions...");
-        sBlackMarketMgr->LoadAuctions();
+        characters = addLoader("Black Market Templates", [] { sBlackMarketMgr->LoadTemplates(); }, { characters });
+        characters = addLoader("Black Market Auctions", [] { sBlackMarketMgr->LoadAuctions(); }, { characters });
     }
 
-    TC_LOG_INFO("server.loading", "Loading Guild rewards...");
-    sGuildMgr->LoadGuildRewards();
-
-    TC_LOG_INFO("server.loading", "Loading Guilds...");
-    sGuildMgr->LoadGuilds();
-
-    sGuildFinderMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Groups...");
-    sGroupMgr->LoadGroups();
-
-    TC_LOG_INFO("server.loading", "Loading ReservedNames...");
-    sObjectMgr->LoadReservedPlayersNames();
-
-    TC_LOG_INFO("server.loading", "Loading GameObjects for quests...");
-    sObjectMgr->LoadGameObjectForQuests();
-
-    TC_LOG_INFO("server.loading", "Loading BattleMasters...");
-    sBattlegroundMgr->LoadBattleMastersEntry();                 // must be after load CreatureTemplate
-
-    TC_LOG_INFO("server.loading", "Loading GameTeleports...");
-    sObjectMgr->LoadGameTele();
-
-    TC_LOG_INFO("server.loading", "Loading Trainers...");
-    sObjectMgr->LoadTrainers();                                 // must be after load CreatureTemplate
-
-    TC_LOG_INFO("server.loading", "Loading Creature summoner specific entry...");
-    sObjectMgr->LoadCreatureSummonerEntry();
-
-    TC_LOG_INFO("server.loading", "Loading Gossip menu...");
-    sObjectMgr->LoadGossipMenu();
-
-    TC_LOG_INFO("server.loading", "Loading Gossip menu options...");
-    sObjectMgr->LoadGossipMenuItems();
-
-    TC_LOG_INFO("server.loading", "Loading Creature trainers...");
-    sObjectMgr->LoadCreatureTrainers();                         // must be after LoadGossipMenuItems
-
-    TC_LOG_INFO("server.loading", "Loading Vendors...");
-    sObjectMgr->LoadVendors();                                  // must be after load CreatureTemplate and ItemTemplate
-
-    TC_LOG_INFO("server.loading", "Loading Trainers...");
-    sObjectMgr->LoadTrainerSpell();                              // must be after load CreatureTemplate
-
-    TC_LOG_INFO("server.loading", "Loading Waypoints...");
-    sWaypointMgr->Load();
-
-    TC_LOG_INFO("server.loading", "Loading SmartAI Waypoints...");
-    sSmartWaypointMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Formations...");
-    sFormationMgr->LoadCreatureFormations();
+    characters = addLoader("Guild rewards", [] { sGuildMgr->LoadGuildRewards(); }, { characters });
+    characters = addLoader("Guilds", [] { sGuildMgr->LoadGuilds(); }, { characters, achievements });
+    characters = loaders.AddTask("Guild finder", [] { sGuildFinderMgr->LoadFromDB(); }, { characters });
+    characters = addLoader("Groups", [] { sGroupMgr->LoadGroups(); }, { characters, instances });
 
-    TC_LOG_INFO("server.loading", "Loading World States...");              // must be loaded before battleground, outdoor PvP and conditions
-    LoadWorldStates();
+    // Conditions are attached to spells, loot, gossip and most world content, load them once everything else is done
+    addLoader("Conditions", [] { sConditionMgr->LoadConditions(); }, { world, spellTables, lootTables, questObjects });
 
-    sObjectMgr->LoadPhases();
-
-    TC_LOG_INFO("server.loading", "Loading Conditions...");
-    sConditionMgr->LoadConditions();
-
-    TC_LOG_INFO("server.loading", "Loading faction change achievement pairs...");
-    sObjectMgr->LoadFactionChangeAchievements();
-
-    TC_LOG_INFO("server.loading", "Loading faction change spell pairs...");
-    sObjectMgr->LoadFactionChangeSpells();
-
-    TC_LOG_INFO("server.loading", "Loading faction change quest pairs...");
-    sObjectMgr->LoadFactionChangeQuests();
-
-    TC_LOG_INFO("server.loading", "Loading faction change item pairs...");
-    sObjectMgr->LoadFactionChangeItems();
-
-    TC_LOG_INFO("server.loading", "Loading faction change reputation pairs...");
-    sObjectMgr->LoadFactionChangeReputations();
-
-    TC_LOG_INFO("server.loading", "Loading faction change title pairs...");
-    sObjectMgr->LoadFactionChangeTitles();
-
-    TC_LOG_INFO("server.loading", "Loading mount definitions...");
-    CollectionMgr::LoadMountDefinitions();
-
-    TC_LOG_INFO("server.loading", "Loading GM bugs...");
-    sSupportMgr->LoadBugTickets();
-
-    TC_LOG_INFO("server.loading", "Loading GM complaints...");
-    sSupportMgr->LoadComplaintTickets();
-
-    TC_LOG_INFO("server.loading", "Loading GM suggestions...");
-    sSupportMgr->LoadSuggestionTickets();
+    addLoader("faction change achievement pairs", [] { sObjectMgr->LoadFactionChangeAchievements(); });
+    addLoader("faction change spell pairs", [] { sObjectMgr->LoadFactionChangeSpells(); }, { spells });
+    addLoader("faction change quest pairs", [] { sObjectMgr->LoadFactionChangeQuests(); }, { quests });
+    addLoader("faction change item pairs", [] { sObjectMgr->LoadFactionChangeItems(); }, { quests });
+    addLoader("faction change reputation pairs", [] { sObjectMgr->LoadFactionChangeReputations(); });
+    addLoader("faction change title pairs", [] { sObjectMgr->LoadFactionChangeTitles(); });
+    addLoader("mount definitions", &CollectionMgr::LoadMountDefinitions, { spells });
+    addLoader("GM bugs", [] { sSupportMgr->LoadBugTickets(); });
+    addLoader("GM complaints", [] { sSupportMgr->LoadComplaintTickets(); });
+    addLoader("GM suggestions", [] { sSupportMgr->LoadSuggestionTickets(); });
+    loaders.Run(loaderThreads);
 
     /*TC_LOG_INFO("server.loading", "Loading GM surveys...");
     sSupportMgr->LoadSurveys();*/
@@ -2116,35 +1909,20 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Validating spell scripts...");
     sObjectMgr->ValidateSpellScripts();
 
-    TC_LOG_INFO("server.loading", "Loading SmartAI scripts...");
-    sSmartScriptMgr->LoadSmartAIFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Calendar data...");
-    sCalendarMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Quest task...");
-    sObjectMgr->LoadQuestTasks();
-
-    TC_LOG_INFO("server.loading", "Loading Adventure Map UI...");
-    sObjectMgr->LoadAdventureMapUI();
+    addLoader("SmartAI scripts", [] { sSmartScriptMgr->LoadSmartAIFromDB(); });
+    addLoader("Calendar data", [] { sCalendarMgr->LoadFromDB(); });
 
-    TC_LOG_INFO("server.loading", "Loading Adventure Map UI...");
-    sObjectMgr->LoadAdventureMapUI();
+    TaskGraph::TaskId scriptData = addLoader("Quest task", [] { sObjectMgr->LoadQuestTasks(); });
+    scriptData = addLoader("Adventure Map UI", [] { sObjectMgr->LoadAdventureMapUI(); }, { scriptData });
+    scriptData = addLoader("Zones script names", [] { sObjectMgr->LoadZoneScriptNames(); }, { scriptData });
+    addLoader("Garrison script names", [] { sObjectMgr->LoadGarrisonScriptNames(); }, { scriptData });
 
-    TC_LOG_INFO("server.loading", "Loading Zones script names...");
-    sObjectMgr->LoadZoneScriptNames();
+    addLoader("Signatures", [] { sPetitionMgr->LoadSignatures(); }, { addLoader("Petitions", [] { sPetitionMgr->LoadPetitions(); }) });
+    addLoader("Item loot", [] { sLootItemStorage->LoadStorageFromDB(); });
+    loaders.Run(loaderThreads);
 
-    TC_LOG_INFO("server.loading", "Loading Garrison script names...");
-    sObjectMgr->LoadGarrisonScriptNames();
-
-    TC_LOG_INFO("server.loading", "Loading Petitions...");
-    sPetitionMgr->LoadPetitions();
-
-    TC_LOG_INFO("server.loading", "Loading Signatures...");
-    sPetitionMgr->LoadSignatures();
-
-    TC_LOG_INFO("server.loading", "Loading Item loot...");
-    sLootItemStorage->LoadStorageFromDB();
+    ///- All concurrent loaders are done, drop the extra world database connections opened for them
+    WorldDatabase.CloseExtraSynchConnections();
 
     TC_LOG_INFO("server.loading", "Initialize query data...");
     sObjectMgr->InitializeQueriesData(QUERY_DATA_ALL);
@@ -2305,6 +2083,8 @@ void World::SetInitialWorldSettings()
 
     TC_LOG_INFO("server.worldserver", "World initialized in %u minutes %u seconds", (startupDuration / 60000), ((startupDuration % 60000) / 1000));
 
+    loaders.LogTimings("server.loading");
+
     TC_METRIC_EVENT("events", "World initialized", "World initialized in " + std::to_string(startupDuration / 60000) + " minutes " + std::to_string((startupDuration % 60000) / 1000) + " seconds");
 
     sLog->SetRealmId(realm.Id.Realm, realm.Name);
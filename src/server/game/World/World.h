@@ -167,6 +167,7 @@ enum WorldBoolConfigs
     CONFIG_WARDEN_ENABLED,
     CONFIG_CHARACTER_TEMPLATE,
     CONFIG_ENABLE_MMAPS,
+    CONFIG_MMAP_ASYNC_PATH_REQUESTS,
     CONFIG_WINTERGRASP_ENABLE,
     CONFIG_TOLBARAD_ENABLE,
     CONFIG_UI_QUESTLEVELS_IN_DIALOGS,     // Should we add quest levels to the title in the NPC dialogs?
@@ -345,6 +346,9 @@ enum WorldIntConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_LOADING_THREADS,
+    CONFIG_GRID_PREFETCH_THREADS,
+    CONFIG_MMAP_PATH_CACHE_TIME,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
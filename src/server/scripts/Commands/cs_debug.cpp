@@ -31,6 +31,9 @@ EndScriptData */
 #include "Chat.h"
 #include "ChatPackets.h"
 #include "Conversation.h"
+#include "DB2Stores.h"
+#include "EventProcessor.h"
+#include "GameObjectModel.h"
 #include "GossipDef.h"
 #include "GridNotifiersImpl.h"
 #include "Language.h"
@@ -40,16 +43,46 @@ EndScriptData */
 #include "MovementPackets.h"
 #include "MotionMaster.h"
 #include "ObjectMgr.h"
+#include "OpcodeProfiler.h"
 #include "PhasingHandler.h"
+#include "Random.h"
 #include "RBAC.h"
+#include "SpellAuras.h"
+#include "SpellMgr.h"
 #include "SpellPackets.h"
+#include "StringFormat.h"
 #include "Transport.h"
 #include "World.h"
 #include "WorldSession.h"
+#include <G3D/Vector3.h>
+#include <chrono>
 #include <fstream>
 #include <limits>
+#include <map>
 #include <sstream>
 
+// Periodic event re-adding itself like spell and movement events do, used by .debug eventbench
+class DebugBenchmarkEvent : public BasicEvent
+{
+    public:
+        DebugBenchmarkEvent(EventProcessor& events, uint64 time, uint32 period, uint64& executed) : _events(events), _time(time), _period(period), _executed(executed) { }
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            ++_executed;
+            // reschedule from the planned time like the multimap run does, so both runs execute the same events
+            _time += _period;
+            _events.AddEvent(this, _time);
+            return false;
+        }
+
+    private:
+        EventProcessor& _events;
+        uint64 _time;
+        uint32 _period;
+        uint64& _executed;
+};
+
 class debug_commandscript : public CommandScript
 {
 public:
@@ -119,6 +152,11 @@ public:
             { "worldstate" ,   rbac::RBAC_PERM_COMMAND_DEBUG,               false, &HandleDebugWorldStateCommand,       "" },
             { "wsexpression" , rbac::RBAC_PERM_COMMAND_DEBUG,               false, &HandleDebugWSExpressionCommand,     "" },
             { "completecriteriatree",      rbac::RBAC_PERM_COMMAND_DEBUG,               false, &HandleDebugCompleteCriteriaTreeCommand,         "" },
+            { "opcodeprofile", rbac::RBAC_PERM_COMMAND_DEBUG,               true,  &HandleDebugOpcodeProfileCommand,    "" },
+            { "dynamiclos",    rbac::RBAC_PERM_COMMAND_DEBUG,               false, &HandleDebugDynamicLosCommand,       "" },
+            { "spelllookup",   rbac::RBAC_PERM_COMMAND_DEBUG,               true,  &HandleDebugSpellLookupCommand,      "" },
+            { "procreplay",    rbac::RBAC_PERM_COMMAND_DEBUG,               false, &HandleDebugProcReplayCommand,       "" },
+            { "eventbench",    rbac::RBAC_PERM_COMMAND_DEBUG,               false, &HandleDebugEventBenchCommand,       "" },
         };
         static std::vector<ChatCommand> commandTable =
         {
@@ -1604,6 +1642,372 @@ public:
 
         return true;
     }
+
+    // Runs one pass of a benchmark command and returns its wall time in microseconds
+    template<typename Pass>
+    static uint64 MeasureBenchmarkPass(Pass&& pass)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        pass();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static std::string FormatBenchmarkTime(uint64 elapsed, uint64 count)
+    {
+        return Trinity::StringFormat("total " UI64FMTD " us, avg %.4f us", elapsed, count ? double(elapsed) / count : 0.0);
+    }
+
+    static void PrintOpcodeProfile(ChatHandler* handler, std::vector<OpcodeProfileSummary> const& summaries, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            OpcodeProfileSummary const& summary = summaries[i];
+            handler->PSendSysMessage("%s: calls " UI64FMTD ", %s, p50 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                GetOpcodeNameForLogging(summary.Opcode).c_str(), summary.Calls, FormatBenchmarkTime(summary.TotalTime, summary.Calls).c_str(),
+                summary.P50Time, summary.P99Time, summary.MaxTime);
+        }
+    }
+
+    // USAGE: .debug opcodeprofile [#count|reset]
+    static bool HandleDebugOpcodeProfileCommand(ChatHandler* handler, char const* args)
+    {
+        if (args && !strcmp(args, "reset"))
+        {
+            sOpcodeProfiler->Reset();
+            handler->SendSysMessage("Opcode handler profile reset.");
+            return true;
+        }
+
+        uint32 count = 10;
+        if (args && *args)
+            count = std::max<uint32>(uint32(atoul(args)), 1);
+
+        std::vector<OpcodeProfileSummary> summaries = sOpcodeProfiler->GetSummaries();
+        if (summaries.empty())
+        {
+            handler->SendSysMessage("No opcode handlers were called since last reset.");
+            return true;
+        }
+
+        count = std::min<uint32>(count, summaries.size());
+
+        std::partial_sort(summaries.begin(), summaries.begin() + count, summaries.end(), [](OpcodeProfileSummary const& left, OpcodeProfileSummary const& right)
+        {
+            return left.TotalTime > right.TotalTime;
+        });
+        handler->PSendSysMessage("Top %u opcode handlers by total time:", count);
+        PrintOpcodeProfile(handler, summaries, count);
+
+        std::partial_sort(summaries.begin(), summaries.begin() + count, summaries.end(), [](OpcodeProfileSummary const& left, OpcodeProfileSummary const& right)
+        {
+            return left.P99Time > right.P99Time;
+        });
+        handler->PSendSysMessage("Top %u opcode handlers by p99 time:", count);
+        PrintOpcodeProfile(handler, summaries, count);
+        return true;
+    }
+
+    // USAGE: .debug dynamiclos [#queries]
+    // Times gameobject line of sight queries around the player, then the same queries while models are removed and inserted again in between.
+    // Queries run on a copy of the map's dynamic tree, the churn never touches the tree the map uses.
+    // The run blocks the world thread, so the query count is capped to keep it at a few hundred milliseconds.
+    static bool HandleDebugDynamicLosCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 const maxQueryCount = 100000;
+
+        uint32 queryCount = 10000;
+        if (args && *args)
+            queryCount = std::min(std::max<uint32>(uint32(atoul(args)), 1), maxQueryCount);
+
+        Player* player = handler->GetSession()->GetPlayer();
+        Map* map = player->GetMap();
+        DynamicMapTree tree(map->GetDynamicMapTree());
+
+        std::list<GameObject*> gameObjects;
+        player->GetGameObjectListWithEntryInGrid(gameObjects, 0, SIZE_OF_GRIDS);
+
+        std::vector<GameObjectModel const*> models;
+        for (GameObject* go : gameObjects)
+            if (go->m_model && tree.contains(*go->m_model))
+                models.push_back(go->m_model);
+
+        // both runs trace the same rays, between random points above the ground near the player
+        float const radius = 60.0f;
+        std::vector<Position> points;
+        points.reserve(queryCount * 2);
+        for (uint32 i = 0; i < queryCount * 2; ++i)
+            points.emplace_back(player->GetPositionX() + frand(-radius, radius), player->GetPositionY() + frand(-radius, radius), player->GetPositionZ() + frand(0.0f, 10.0f));
+
+        auto runQueries = [&](bool churn)
+        {
+            uint32 visible = 0;
+            uint64 elapsed = MeasureBenchmarkPass([&]()
+            {
+                for (uint32 i = 0; i < queryCount; ++i)
+                {
+                    if (churn && !models.empty())
+                    {
+                        GameObjectModel const& model = *models[i % models.size()];
+                        tree.remove(model);
+                        tree.insert(model);
+                    }
+
+                    Position const& from = points[i * 2];
+                    Position const& to = points[i * 2 + 1];
+                    if (tree.isInLineOfSight({ from.GetPositionX(), from.GetPositionY(), from.GetPositionZ() },
+                        { to.GetPositionX(), to.GetPositionY(), to.GetPositionZ() }, player->GetPhaseShift()))
+                        ++visible;
+                }
+            });
+
+            handler->PSendSysMessage("%s: %u queries, %u in line of sight, %s",
+                churn ? "With churn" : "Static", queryCount, visible, FormatBenchmarkTime(elapsed, queryCount).c_str());
+        };
+
+        handler->PSendSysMessage("Dynamic tree of map %u holds %u models, %u of them within %.0f yards.",
+            map->GetId(), tree.size(), uint32(models.size()), SIZE_OF_GRIDS);
+        runQueries(false);
+        runQueries(true);
+        return true;
+    }
+
+    // USAGE: .debug spelllookup [#lookups]
+    // Times SpellInfo lookups of random spells and difficulties through the dense index and through the hashed store, and checks they agree
+    static bool HandleDebugSpellLookupCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 lookupCount = 1000000;
+        if (args && *args)
+            lookupCount = std::max<uint32>(uint32(atoul(args)), 1);
+
+        std::vector<Difficulty> difficulties = { DIFFICULTY_NONE };
+        for (DifficultyEntry const* difficulty : sDifficultyStore)
+            difficulties.push_back(Difficulty(difficulty->ID));
+
+        // both runs look up the same keys, mostly existing spells like the callers in Unit and Aura code do
+        std::vector<std::pair<uint32, Difficulty>> keys;
+        keys.reserve(lookupCount);
+        for (uint32 i = 0; i < lookupCount; ++i)
+            keys.emplace_back(urand(1, sSpellNameStore.GetNumRows() - 1), difficulties[urand(0, difficulties.size() - 1)]);
+
+        std::vector<SpellInfo const*> results(lookupCount);
+        auto runLookups = [&](char const* name, SpellInfo const* (SpellMgr::*lookup)(uint32, Difficulty) const, bool compare)
+        {
+            uint32 found = 0;
+            uint32 mismatches = 0;
+            uint64 elapsed = MeasureBenchmarkPass([&]()
+            {
+                for (uint32 i = 0; i < lookupCount; ++i)
+                {
+                    SpellInfo const* spellInfo = (sSpellMgr->*lookup)(keys[i].first, keys[i].second);
+                    if (spellInfo)
+                        ++found;
+
+                    if (compare && spellInfo != results[i])
+                        ++mismatches;
+
+                    results[i] = spellInfo;
+                }
+            });
+
+            handler->PSendSysMessage("%s: %u lookups, %u found, %s", name, lookupCount, found, FormatBenchmarkTime(elapsed, lookupCount).c_str());
+            if (compare)
+                handler->PSendSysMessage("%u lookups returned a different SpellInfo than the hashed store", mismatches);
+        };
+
+        // untimed pass through both lookups first, so neither timed run pays for bringing the keys and SpellInfos into cache
+        for (std::pair<uint32, Difficulty> const& key : keys)
+        {
+            sSpellMgr->GetSpellInfoFromStore(key.first, key.second);
+            sSpellMgr->GetSpellInfo(key.first, key.second);
+        }
+
+        runLookups("Hashed store", &SpellMgr::GetSpellInfoFromStore, false);
+        runLookups("Dense index", &SpellMgr::GetSpellInfo, true);
+        return true;
+    }
+
+    // USAGE: .debug procreplay [#events]
+    // Replays a synthetic combat log against the auras of the selected unit and times the proc candidate lookup
+    // by scanning all applied auras and through the proc index, and checks they agree
+    static bool HandleDebugProcReplayCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 eventCount = 1000000;
+        if (args && *args)
+            eventCount = std::max<uint32>(uint32(atoul(args)), 1);
+
+        Unit* unit = handler->getSelectedUnit();
+        if (!unit)
+            unit = handler->GetSession()->GetPlayer();
+
+        struct ProcEventMasks
+        {
+            uint32 TypeMask;
+            uint32 SpellTypeMask;
+            uint32 SpellPhaseMask;
+            uint32 HitMask;
+        };
+
+        // roughly the mix of events a unit sees in raid combat, most of them hits and periodic ticks
+        std::vector<ProcEventMasks> const eventTemplates =
+        {
+            { PROC_FLAG_DONE_MELEE_AUTO_ATTACK | PROC_FLAG_DONE_MAINHAND_ATTACK, PROC_SPELL_TYPE_NONE,        PROC_SPELL_PHASE_NONE,   PROC_HIT_NORMAL   },
+            { PROC_FLAG_DONE_MELEE_AUTO_ATTACK | PROC_FLAG_DONE_MAINHAND_ATTACK, PROC_SPELL_TYPE_NONE,        PROC_SPELL_PHASE_NONE,   PROC_HIT_CRITICAL },
+            { PROC_FLAG_TAKEN_MELEE_AUTO_ATTACK | PROC_FLAG_TAKEN_DAMAGE,        PROC_SPELL_TYPE_NONE,        PROC_SPELL_PHASE_NONE,   PROC_HIT_NORMAL   },
+            { PROC_FLAG_TAKEN_MELEE_AUTO_ATTACK,                                 PROC_SPELL_TYPE_NONE,        PROC_SPELL_PHASE_NONE,   PROC_HIT_DODGE    },
+            { PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG,                          PROC_SPELL_TYPE_MASK_ALL,    PROC_SPELL_PHASE_CAST,   PROC_HIT_NONE     },
+            { PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG,                          PROC_SPELL_TYPE_DAMAGE,      PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG,                          PROC_SPELL_TYPE_DAMAGE,      PROC_SPELL_PHASE_HIT,    PROC_HIT_CRITICAL },
+            { PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG,                          PROC_SPELL_TYPE_MASK_ALL,    PROC_SPELL_PHASE_FINISH, PROC_HIT_NONE     },
+            { PROC_FLAG_TAKEN_SPELL_MAGIC_DMG_CLASS_NEG | PROC_FLAG_TAKEN_DAMAGE, PROC_SPELL_TYPE_DAMAGE,     PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_POS,                          PROC_SPELL_TYPE_HEAL,        PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_TAKEN_SPELL_MAGIC_DMG_CLASS_POS,                         PROC_SPELL_TYPE_HEAL,        PROC_SPELL_PHASE_HIT,    PROC_HIT_CRITICAL },
+            { PROC_FLAG_DONE_PERIODIC,                                           PROC_SPELL_TYPE_DAMAGE,      PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_DONE_PERIODIC,                                           PROC_SPELL_TYPE_DAMAGE,      PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_DONE_PERIODIC,                                           PROC_SPELL_TYPE_HEAL,        PROC_SPELL_PHASE_HIT,    PROC_HIT_CRITICAL },
+            { PROC_FLAG_TAKEN_PERIODIC | PROC_FLAG_TAKEN_DAMAGE,                 PROC_SPELL_TYPE_DAMAGE,      PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_TAKEN_PERIODIC,                                          PROC_SPELL_TYPE_HEAL,        PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_DONE_SPELL_NONE_DMG_CLASS_POS,                           PROC_SPELL_TYPE_NO_DMG_HEAL, PROC_SPELL_PHASE_HIT,    PROC_HIT_NORMAL   },
+            { PROC_FLAG_KILL,                                                    PROC_SPELL_TYPE_NONE,        PROC_SPELL_PHASE_NONE,   PROC_HIT_NONE     },
+        };
+
+        // both runs replay the same events
+        std::vector<ProcEventInfo> events;
+        events.reserve(eventCount);
+        for (uint32 i = 0; i < eventCount; ++i)
+        {
+            ProcEventMasks const& masks = eventTemplates[urand(0, eventTemplates.size() - 1)];
+            events.emplace_back(unit, unit->GetVictim(), unit, masks.TypeMask, masks.SpellTypeMask, masks.SpellPhaseMask, masks.HitMask, nullptr, nullptr, nullptr);
+        }
+
+        std::vector<uint32> candidateCounts(eventCount);
+        Unit::AuraApplicationProcContainer candidates;
+        auto runReplay = [&](char const* name, bool useIndex)
+        {
+            uint64 total = 0;
+            uint32 mismatches = 0;
+            uint64 elapsed = MeasureBenchmarkPass([&]()
+            {
+                for (uint32 i = 0; i < eventCount; ++i)
+                {
+                    candidates.clear();
+                    if (useIndex)
+                        unit->GetProcAuraCandidates(candidates, events[i]);
+                    else
+                    {
+                        for (auto const& appliedAura : unit->GetAppliedAuras())
+                            if (SpellProcEntry const* procEntry = sSpellMgr->GetSpellProcEntry(appliedAura.second->GetBase()->GetSpellInfo()))
+                                if (SpellMgr::CanSpellTriggerProcOnEventMasks(*procEntry, events[i]))
+                                    candidates.emplace_back(0, appliedAura.second);
+                    }
+
+                    if (useIndex && candidates.size() != candidateCounts[i])
+                        ++mismatches;
+
+                    candidateCounts[i] = uint32(candidates.size());
+                    total += candidates.size();
+                }
+            });
+
+            handler->PSendSysMessage("%s: %u events, " UI64FMTD " candidates, %s", name, eventCount, total, FormatBenchmarkTime(elapsed, eventCount).c_str());
+            if (useIndex)
+                handler->PSendSysMessage("%u events got a different number of candidates than the full scan", mismatches);
+        };
+
+        handler->PSendSysMessage("%s has %u applied auras.", unit->GetName().c_str(), uint32(unit->GetAppliedAuras().size()));
+        runReplay("Full scan", false);
+        runReplay("Proc index", true);
+        return true;
+    }
+
+    // USAGE: .debug eventbench [#processors] [#events]
+    // Simulates a minute of event processors of units with periodic events, through EventProcessor and through a std::multimap queue
+    // driven the same way as the one EventProcessor used before.
+    // Both runs block the world thread, so the sizes are capped to keep them at a few hundred milliseconds.
+    static bool HandleDebugEventBenchCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 const maxProcessorCount = 10000;
+        uint32 const maxEventCount = 20;
+
+        uint32 processorCount = 5000;
+        uint32 eventCount = 10;
+        if (args && *args)
+        {
+            if (char* processorsStr = strtok((char*)args, " "))
+                processorCount = std::min(std::max<uint32>(uint32(atoul(processorsStr)), 1), maxProcessorCount);
+            if (char* eventsStr = strtok(nullptr, " "))
+                eventCount = std::min(std::max<uint32>(uint32(atoul(eventsStr)), 1), maxEventCount);
+        }
+
+        uint32 const tickTime = 100;
+        uint32 const tickCount = 600;
+
+        // both runs use the same periods
+        std::vector<uint32> periods(processorCount * eventCount);
+        for (uint32& period : periods)
+            period = urand(500, 30000);
+
+        auto report = [&](char const* name, uint64 executed, uint64 elapsed)
+        {
+            handler->PSendSysMessage("%s: %u processors, %u events each, " UI64FMTD " executed, %s per processor update",
+                name, processorCount, eventCount, executed, FormatBenchmarkTime(elapsed, uint64(processorCount) * tickCount).c_str());
+        };
+
+        {
+            uint64 executed = 0;
+            uint64 elapsed = MeasureBenchmarkPass([&]()
+            {
+                std::vector<EventProcessor> processors(processorCount);
+                for (uint32 i = 0; i < processorCount; ++i)
+                    for (uint32 j = 0; j < eventCount; ++j)
+                    {
+                        uint32 period = periods[i * eventCount + j];
+                        uint64 time = processors[i].CalculateTime(period);
+                        processors[i].AddEvent(new DebugBenchmarkEvent(processors[i], time, period, executed), time);
+                    }
+
+                for (uint32 tick = 0; tick < tickCount; ++tick)
+                    for (EventProcessor& processor : processors)
+                        processor.Update(tickTime);
+            });
+
+            report("EventProcessor", executed, elapsed);
+        }
+
+        {
+            uint64 executed = 0;
+            uint64 elapsed = MeasureBenchmarkPass([&]()
+            {
+                std::vector<std::pair<uint64, std::multimap<uint64, uint32>>> processors(processorCount);
+                for (uint32 i = 0; i < processorCount; ++i)
+                    for (uint32 j = 0; j < eventCount; ++j)
+                    {
+                        uint32 period = periods[i * eventCount + j];
+                        processors[i].second.emplace(period, period);
+                    }
+
+                for (uint32 tick = 0; tick < tickCount; ++tick)
+                {
+                    for (std::pair<uint64, std::multimap<uint64, uint32>>& processor : processors)
+                    {
+                        processor.first += tickTime;
+                        std::multimap<uint64, uint32>::iterator itr;
+                        while ((itr = processor.second.begin()) != processor.second.end() && itr->first <= processor.first)
+                        {
+                            uint64 time = itr->first;
+                            uint32 period = itr->second;
+                            processor.second.erase(itr);
+                            ++executed;
+                            processor.second.emplace(time + period, period);
+                        }
+                    }
+                }
+            });
+
+            report("std::multimap", executed, elapsed);
+        }
+
+        return true;
+    }
 };
 
 void AddSC_debug_commandscript()
@@ -2735,7 +2735,7 @@ public:
             if (!GetCaster() || !GetHitUnit())
                 return;
 
-            std::list<AuraEffect*> const& auraEffects = GetHitUnit()->GetAuraEffectsByType(SPELL_AURA_PERIODIC_HEAL);
+            Unit::AuraEffectList const& auraEffects = GetHitUnit()->GetAuraEffectsByType(SPELL_AURA_PERIODIC_HEAL);
 
             for (AuraEffect* auraEffect : auraEffects)
                 if (auraEffect->GetCasterGUID() == GetCaster()->GetGUID())
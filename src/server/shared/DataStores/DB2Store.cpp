@@ -20,7 +20,56 @@
 #include "DB2DatabaseLoader.h"
 #include "DB2FileSystemSource.h"
 #include "DB2Meta.h"
+#include "CryptoHash.h"
+#include "MappedFile.h"
 #include "StringFormat.h"
+#include <boost/filesystem/operations.hpp>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+    uint32 const DB2CacheSignature = 0x42444354; // TCDB
+    uint32 const DB2CacheVersion = 1;
+
+    // Cache file layout: header, ids of all records, records (8 byte aligned) and string block
+    // string pointers in records are stored as offset + 1 into the string block, 0 is nullptr
+#pragma pack(push, 1)
+    struct DB2CacheHeader
+    {
+        uint32 Signature;
+        uint32 Version;
+        uint64 Key;
+        uint32 TableHash;
+        uint32 LayoutHash;
+        uint32 FieldCount;
+        uint32 IndexTableSize;
+        uint32 RecordCount;
+        uint32 RecordSize;
+        uint64 RecordsOffset;
+        uint64 StringsOffset;
+        uint64 StringsSize;
+    };
+#pragma pack(pop)
+
+    uint64 HashBytes(uint64 hash, void const* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<uint8 const*>(data)[i];
+            hash *= UI64LIT(0x100000001B3);
+        }
+        return hash;
+    }
+
+    template<typename T>
+    uint64 HashValue(uint64 hash, T value)
+    {
+        return HashBytes(hash, &value, sizeof(value));
+    }
+}
 
 DB2StorageBase::DB2StorageBase(char const* fileName, DB2LoadInfo const* loadInfo)
     : _tableHash(0), _layoutHash(0), _fileName(fileName), _fieldCount(0), _loadInfo(loadInfo), _dataTable(nullptr), _dataTableEx(), _indexTableSize(0)
@@ -150,3 +199,232 @@ void DB2StorageBase::LoadStringsFromDB(LocaleConstant locale, char** indexTable)
     loader.LoadStrings(true, locale, _indexTableSize, indexTable, _stringPool);
     _stringPool.shrink_to_fit();
 }
+
+template<typename F>
+void DB2StorageBase::VisitStringFields(char* entry, F visitor) const
+{
+    for (std::size_t i = 0; i < _loadInfo->FieldCount; ++i)
+    {
+        switch (_loadInfo->Fields[i].Type)
+        {
+            case FT_INT:
+            case FT_FLOAT:
+                entry += 4;
+                break;
+            case FT_BYTE:
+                entry += 1;
+                break;
+            case FT_SHORT:
+                entry += 2;
+                break;
+            case FT_LONG:
+                entry += 8;
+                break;
+            case FT_STRING:
+                for (std::size_t locale = 0; locale < TOTAL_LOCALES; ++locale)
+                    visitor(entry + locale * sizeof(char const*));
+                entry += sizeof(LocalizedString);
+                break;
+            case FT_STRING_NOT_LOCALIZED:
+                visitor(entry);
+                entry += sizeof(char const*);
+                break;
+        }
+    }
+}
+
+uint64 DB2StorageBase::GetCacheKey(std::vector<std::string> const& sourceFiles) const
+{
+    uint64 key = UI64LIT(0xCBF29CE484222325);
+    key = HashValue(key, DB2CacheVersion);
+    key = HashValue(key, uint32(sizeof(char const*)));
+    key = HashValue(key, _loadInfo->Meta->GetRecordSize());
+    key = HashValue(key, _loadInfo->Meta->LayoutHash);
+    key = HashBytes(key, _loadInfo->TypesString.data(), _loadInfo->TypesString.length());
+    for (std::string const& sourceFile : sourceFiles)
+    {
+        // contents, not file times - copying or touching the client data must not invalidate the cache, replacing it must
+        Trinity::Crypto::SHA1 contentHash;
+        std::ifstream in(sourceFile, std::ios::binary);
+        bool exists = bool(in);
+        std::array<char, 65536> buffer;
+        while (in)
+        {
+            in.read(buffer.data(), buffer.size());
+            contentHash.UpdateData(reinterpret_cast<uint8 const*>(buffer.data()), std::size_t(in.gcount()));
+        }
+        contentHash.Finalize();
+
+        key = HashValue(key, exists);
+        key = HashBytes(key, contentHash.GetDigest().data(), contentHash.GetDigest().size());
+    }
+
+    return key;
+}
+
+bool DB2StorageBase::LoadFromCache(std::string const& cacheFile, uint64 cacheKey, char**& indexTable)
+{
+    indexTable = nullptr;
+
+    // copy on write - string block and record pages nothing writes to stay shared between all processes using the same cache
+    std::unique_ptr<MappedFile> mapping = MappedFile::Open(cacheFile, MappedFile::Access::CopyOnWrite);
+    if (!mapping)
+        return false;
+
+    char* data = mapping->GetData();
+    std::size_t size = mapping->GetSize();
+    if (size < sizeof(DB2CacheHeader))
+        return false;
+
+    DB2CacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.Signature != DB2CacheSignature || header.Version != DB2CacheVersion || header.Key != cacheKey
+        || header.RecordSize != _loadInfo->Meta->GetRecordSize() || header.StringsOffset + header.StringsSize > size
+        || header.RecordsOffset + uint64(header.RecordCount) * header.RecordSize > header.StringsOffset
+        || sizeof(DB2CacheHeader) + uint64(header.RecordCount) * sizeof(uint32) > header.RecordsOffset)
+        return false;
+
+    uint32 const* ids = reinterpret_cast<uint32 const*>(data + sizeof(DB2CacheHeader));
+    char* records = data + header.RecordsOffset;
+    char const* strings = data + header.StringsOffset;
+
+    // records without strings are used in place and stay shared until a hotfix overwrites one of them,
+    // string pointers only exist in this process so those records are copied and point into the shared string block
+    bool const hasStrings = _loadInfo->GetStringFieldCount(false) != 0;
+    if (hasStrings)
+    {
+        _dataTable = new char[std::size_t(header.RecordCount) * header.RecordSize];
+        memcpy(_dataTable, records, std::size_t(header.RecordCount) * header.RecordSize);
+        records = _dataTable;
+    }
+
+    indexTable = new char*[header.IndexTableSize];
+    memset(indexTable, 0, header.IndexTableSize * sizeof(char*));
+
+    bool valid = true;
+    for (uint32 i = 0; i < header.RecordCount && valid; ++i)
+    {
+        if (ids[i] >= header.IndexTableSize)
+        {
+            valid = false;
+            break;
+        }
+
+        char* record = records + std::size_t(i) * header.RecordSize;
+        if (hasStrings)
+        {
+            VisitStringFields(record, [&](char* field)
+            {
+                std::uintptr_t offset;
+                memcpy(&offset, field, sizeof(offset));
+                char const* value = nullptr;
+                if (offset)
+                {
+                    if (offset > header.StringsSize)
+                    {
+                        valid = false;
+                        return;
+                    }
+
+                    value = strings + offset - 1;
+                }
+
+                memcpy(field, &value, sizeof(value));
+            });
+        }
+
+        indexTable[ids[i]] = record;
+    }
+
+    if (!valid)
+    {
+        delete[] indexTable;
+        indexTable = nullptr;
+        delete[] _dataTable;
+        _dataTable = nullptr;
+        return false;
+    }
+
+    _fieldCount = header.FieldCount;
+    _tableHash = header.TableHash;
+    _layoutHash = header.LayoutHash;
+    _indexTableSize = header.IndexTableSize;
+    _cacheMapping = std::move(mapping);
+    return true;
+}
+
+bool DB2StorageBase::SaveToCache(std::string const& cacheFile, uint64 cacheKey, char const* const* indexTable) const
+{
+    if (!indexTable)
+        return false;
+
+    uint32 const recordSize = _loadInfo->Meta->GetRecordSize();
+
+    std::vector<uint32> ids;
+    for (uint32 i = 0; i < _indexTableSize; ++i)
+        if (indexTable[i])
+            ids.push_back(i);
+
+    std::vector<char> records(ids.size() * recordSize);
+    std::vector<char> strings;
+    std::unordered_map<std::string, std::uintptr_t> stringOffsets;
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+        char* record = &records[i * recordSize];
+        memcpy(record, indexTable[ids[i]], recordSize);
+        VisitStringFields(record, [&](char* field)
+        {
+            char const* value;
+            memcpy(&value, field, sizeof(value));
+            std::uintptr_t offset = 0;
+            if (value)
+            {
+                auto itr = stringOffsets.find(value);
+                if (itr == stringOffsets.end())
+                {
+                    itr = stringOffsets.emplace(value, strings.size() + 1).first;
+                    strings.insert(strings.end(), value, value + strlen(value) + 1);
+                }
+
+                offset = itr->second;
+            }
+
+            memcpy(field, &offset, sizeof(offset));
+        });
+    }
+
+    DB2CacheHeader header;
+    header.Signature = DB2CacheSignature;
+    header.Version = DB2CacheVersion;
+    header.Key = cacheKey;
+    header.TableHash = _tableHash;
+    header.LayoutHash = _layoutHash;
+    header.FieldCount = _fieldCount;
+    header.IndexTableSize = _indexTableSize;
+    header.RecordCount = uint32(ids.size());
+    header.RecordSize = recordSize;
+    header.RecordsOffset = (sizeof(DB2CacheHeader) + ids.size() * sizeof(uint32) + 7) & ~UI64LIT(7);
+    header.StringsOffset = header.RecordsOffset + records.size();
+    header.StringsSize = strings.size();
+
+    // write to a temporary file first so that other processes never map a partially written cache
+    std::string tempFile = cacheFile + ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        char const padding[8] = { };
+        out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        out.write(reinterpret_cast<char const*>(ids.data()), ids.size() * sizeof(uint32));
+        out.write(padding, header.RecordsOffset - sizeof(DB2CacheHeader) - ids.size() * sizeof(uint32));
+        out.write(records.data(), records.size());
+        out.write(strings.data(), strings.size());
+        if (!out)
+            return false;
+    }
+
+    boost::system::error_code error;
+    boost::filesystem::rename(tempFile, cacheFile, error);
+    return !error;
+}
@@ -21,9 +21,11 @@
 #include "Common.h"
 #include "Errors.h"
 #include "DBStorageIterator.h"
+#include <memory>
 #include <vector>
 
 class ByteBuffer;
+class MappedFile;
 struct DB2LoadInfo;
 
 /// Interface class for common access
@@ -49,12 +51,22 @@ public:
     virtual void LoadFromDB() = 0;
     virtual void LoadStringsFromDB(LocaleConstant locale) = 0;
 
+    // Precompiled cache of client data (all locales, without hotfixes) that can be mapped instead of parsing db2 files
+    uint64 GetCacheKey(std::vector<std::string> const& sourceFiles) const;
+    virtual bool LoadFromCache(std::string const& cacheFile, uint64 cacheKey) = 0;
+    virtual bool SaveToCache(std::string const& cacheFile, uint64 cacheKey) const = 0;
+
 protected:
     void WriteRecordData(char const* entry, LocaleConstant locale, ByteBuffer& buffer) const;
     void Load(std::string const& path, LocaleConstant locale, char**& indexTable);
     void LoadStringsFrom(std::string const& path, LocaleConstant locale, char** indexTable);
     void LoadFromDB(char**& indexTable);
     void LoadStringsFromDB(LocaleConstant locale, char** indexTable);
+    bool LoadFromCache(std::string const& cacheFile, uint64 cacheKey, char**& indexTable);
+    bool SaveToCache(std::string const& cacheFile, uint64 cacheKey, char const* const* indexTable) const;
+
+    template<typename F>
+    void VisitStringFields(char* entry, F visitor) const;
 
     uint32 _tableHash;
     uint32 _layoutHash;
@@ -64,6 +76,7 @@ protected:
     char* _dataTable;
     char* _dataTableEx[2];
     std::vector<char*> _stringPool;
+    std::unique_ptr<MappedFile> _cacheMapping;
     uint32 _indexTableSize;
 };
 
@@ -118,6 +131,16 @@ public:
         DB2StorageBase::LoadStringsFromDB(locale, _indexTable.AsChar);
     }
 
+    bool LoadFromCache(std::string const& cacheFile, uint64 cacheKey) override
+    {
+        return DB2StorageBase::LoadFromCache(cacheFile, cacheKey, _indexTable.AsChar);
+    }
+
+    bool SaveToCache(std::string const& cacheFile, uint64 cacheKey) const override
+    {
+        return DB2StorageBase::SaveToCache(cacheFile, cacheKey, _indexTable.AsChar);
+    }
+
     iterator begin() { return iterator(_indexTable.AsT, _indexTableSize); }
     iterator end() { return iterator(_indexTable.AsT, _indexTableSize, _indexTableSize); }
 
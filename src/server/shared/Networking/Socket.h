@@ -20,9 +20,12 @@
 
 #include "MessageBuffer.h"
 #include "Log.h"
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <queue>
+#include <deque>
 #include <memory>
+#include <vector>
 #include <functional>
 #include <type_traits>
 #include <boost/asio/ip/tcp.hpp>
@@ -30,6 +33,8 @@
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+#define WRITE_GATHER_BUFFER_COUNT 16
+#define WRITE_BUFFER_POOL_SIZE 2
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
@@ -130,7 +135,7 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.push_back(std::move(buffer));
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -163,6 +168,20 @@ protected:
 
     virtual void ReadHandler() = 0;
 
+    /// Returns an empty write buffer of at least given size, reusing memory of already sent buffers when possible
+    MessageBuffer AcquireWriteBuffer(std::size_t size)
+    {
+        if (_freeWriteBuffers.empty())
+            return MessageBuffer(size);
+
+        MessageBuffer buffer(std::move(_freeWriteBuffers.back()));
+        _freeWriteBuffers.pop_back();
+        if (buffer.GetBufferSize() < size)
+            buffer.Resize(size);
+
+        return buffer;
+    }
+
     bool AsyncProcessQueue()
     {
         if (_isWritingAsync)
@@ -171,8 +190,9 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T, Stream>::WriteHandler,
+        WriteBufferSequence buffers;
+        GetWriteBuffers(buffers);
+        _socket.async_write_some(buffers, std::bind(&Socket<T, Stream>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T, Stream>::WriteHandlerWrapper,
@@ -197,6 +217,51 @@ protected:
     }
 
 private:
+    typedef std::array<boost::asio::const_buffer, WRITE_GATHER_BUFFER_COUNT> WriteBufferSequence;
+
+    /// Gathers queued buffers into a single scatter/gather write, unused slots are left empty
+    std::size_t GetWriteBuffers(WriteBufferSequence& buffers)
+    {
+        std::size_t bytesToSend = 0;
+        std::size_t count = 0;
+        for (auto itr = _writeQueue.begin(); itr != _writeQueue.end() && count < buffers.size(); ++itr)
+        {
+            buffers[count++] = boost::asio::const_buffer(itr->GetReadPointer(), itr->GetActiveSize());
+            bytesToSend += itr->GetActiveSize();
+        }
+
+        for (; count < buffers.size(); ++count)
+            buffers[count] = boost::asio::const_buffer();
+
+        return bytesToSend;
+    }
+
+    void PopWriteQueue()
+    {
+        MessageBuffer& buffer = _writeQueue.front();
+        if (_freeWriteBuffers.size() < WRITE_BUFFER_POOL_SIZE)
+        {
+            buffer.Reset();
+            _freeWriteBuffers.push_back(std::move(buffer));
+        }
+
+        _writeQueue.pop_front();
+    }
+
+    /// Advances write queue past bytes that were sent, releasing fully sent buffers
+    void WriteCompleted(std::size_t bytes)
+    {
+        while (bytes > 0 && !_writeQueue.empty())
+        {
+            MessageBuffer& buffer = _writeQueue.front();
+            std::size_t written = std::min<std::size_t>(bytes, buffer.GetActiveSize());
+            buffer.ReadCompleted(written);
+            bytes -= written;
+            if (!buffer.GetActiveSize())
+                PopWriteQueue();
+        }
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -216,9 +281,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            WriteCompleted(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -242,37 +305,36 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        WriteBufferSequence buffers;
+        std::size_t bytesToSend = GetWriteBuffers(buffers);
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(buffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            PopWriteQueue();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            PopWriteQueue();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent < bytesToSend) // now n > 0
         {
-            queuedMessage.ReadCompleted(bytesSent);
+            WriteCompleted(bytesSent);
             return AsyncProcessQueue();
         }
 
-        _writeQueue.pop();
+        WriteCompleted(bytesSent);
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -286,7 +348,8 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<MessageBuffer> _writeQueue;
+    std::vector<MessageBuffer> _freeWriteBuffers;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
@@ -37,6 +37,7 @@
 #include "Metric.h"
 #include "MySQLThreading.h"
 #include "ObjectAccessor.h"
+#include "OpcodeProfiler.h"
 #include "OpenSSLCrypto.h"
 #include "OutdoorPvP/OutdoorPvPMgr.h"
 #include "ProcessPriority.h"
@@ -261,6 +262,11 @@ extern int main(int argc, char** argv)
     sMetric->Initialize(realm.Name, *ioContext, []()
     {
         TC_METRIC_VALUE("online_players", sWorld->GetPlayerCount());
+        sOpcodeProfiler->LogMetrics();
+        TC_METRIC_VALUE("db_queue_size", uint64(LoginDatabase.GetQueueSize()), TC_METRIC_TAG("db", "login"));
+        TC_METRIC_VALUE("db_queue_size", uint64(WorldDatabase.GetQueueSize()), TC_METRIC_TAG("db", "world"));
+        TC_METRIC_VALUE("db_queue_size", uint64(CharacterDatabase.GetQueueSize()), TC_METRIC_TAG("db", "character"));
+        TC_METRIC_VALUE("db_queue_size", uint64(HotfixDatabase.GetQueueSize()), TC_METRIC_TAG("db", "hotfix"));
     });
 
     TC_METRIC_EVENT("events", "Worldserver started", "");
@@ -167,6 +167,17 @@ uint32 CASC::File::GetId() const
     return info.FileDataId;
 }
 
+bool CASC::File::GetContentKey(ContentKey& contentKey) const
+{
+    CASC_FILE_FULL_INFO info;
+    if (!::CascGetFileInfo(_handle, CascFileFullInfo, &info, sizeof(info), nullptr))
+        return false;
+
+    static_assert(sizeof(info.CKey) == std::tuple_size<ContentKey>::value, "ContentKey size does not match CascLib");
+    memcpy(contentKey.data(), info.CKey, contentKey.size());
+    return true;
+}
+
 int64 CASC::File::GetSize() const
 {
     ULONGLONG size;
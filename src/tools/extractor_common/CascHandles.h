@@ -20,6 +20,7 @@
 
 #include "Define.h"
 #include <CascPort.h>
+#include <array>
 #include <memory>
 
 namespace boost
@@ -34,6 +35,9 @@ namespace CASC
 {
     char const* HumanReadableCASCError(uint32 error);
 
+    // md5 of the decoded file contents, changes only when a patch changes the file
+    typedef std::array<uint8, 16> ContentKey;
+
     class File;
 
     class Storage
@@ -65,6 +69,7 @@ namespace CASC
         ~File();
 
         uint32 GetId() const;
+        bool GetContentKey(ContentKey& contentKey) const;
         int64 GetSize() const;
         int64 GetPointer() const;
         bool SetPointer(int64 position);
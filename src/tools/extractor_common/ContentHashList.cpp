@@ -0,0 +1,91 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ContentHashList.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+void ContentHashList::Load()
+{
+    FILE* file = fopen(_fileName.c_str(), "r");
+    if (!file)
+        return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    unsigned long long hash;
+    char name[1024];
+    while (fscanf(file, "%llx %1023s", &hash, name) == 2)
+        _hashes[name] = uint64(hash);
+
+    fclose(file);
+}
+
+bool ContentHashList::Save() const
+{
+    std::string tempFileName = _fileName + ".tmp";
+    FILE* file = fopen(tempFileName.c_str(), "w");
+    if (!file)
+    {
+        printf("Can't create the content hash list '%s'\n", tempFileName.c_str());
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        std::vector<std::pair<std::string, uint64>> hashes(_hashes.begin(), _hashes.end());
+        std::sort(hashes.begin(), hashes.end());
+        for (std::pair<std::string, uint64> const& hash : hashes)
+            fprintf(file, "%016llx %s\n", (unsigned long long)hash.second, hash.first.c_str());
+    }
+
+    fclose(file);
+
+    // an interrupted run keeps the list of the previous one
+    remove(_fileName.c_str());
+    return rename(tempFileName.c_str(), _fileName.c_str()) == 0;
+}
+
+uint64 ContentHashList::GetHash(CASC::ContentKey const& contentKey) const
+{
+    return HashBytes(contentKey.data(), contentKey.size(), HashBytes(&_settingsHash, sizeof(_settingsHash)));
+}
+
+bool ContentHashList::IsUnchanged(std::string const& outputName, uint64 hash) const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _hashes.find(outputName);
+    return itr != _hashes.end() && itr->second == hash;
+}
+
+void ContentHashList::Set(std::string const& outputName, uint64 hash)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _hashes[outputName] = hash;
+}
+
+uint64 ContentHashList::HashBytes(void const* data, std::size_t size, uint64 hash)
+{
+    uint8 const* bytes = static_cast<uint8 const*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= UI64LIT(0x100000001B3);
+    }
+
+    return hash;
+}
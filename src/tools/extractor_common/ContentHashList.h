@@ -0,0 +1,57 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ContentHashList_h__
+#define ContentHashList_h__
+
+#include "CascHandles.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+ * Hashes of the sources of the files written by an extractor, kept next to its output.
+ * Output files whose source and settings did not change since the previous run are not extracted again.
+ * Can be used by several threads at once.
+ */
+class ContentHashList
+{
+public:
+    // settingsHash must change whenever an extractor setting or table changes the output of the same source
+    ContentHashList(std::string fileName, uint64 settingsHash) : _fileName(std::move(fileName)), _settingsHash(settingsHash) { }
+
+    void Load();
+    bool Save() const;
+
+    uint64 GetHash(CASC::ContentKey const& contentKey) const;
+
+    // caller still has to check that the output file exists
+    bool IsUnchanged(std::string const& outputName, uint64 hash) const;
+    void Set(std::string const& outputName, uint64 hash);
+
+    // FNV-1a
+    static uint64 HashBytes(void const* data, std::size_t size, uint64 hash = UI64LIT(0xCBF29CE484222325));
+
+private:
+    std::string _fileName;
+    uint64 _settingsHash;
+
+    mutable std::mutex _lock;
+    std::unordered_map<std::string, uint64> _hashes;
+};
+
+#endif // ContentHashList_h__
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ExtractionPipeline_h__
+#define ExtractionPipeline_h__
+
+#include "Define.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Spreads the conversion of files read from CASC over worker threads.
+ *
+ * Files are read by the thread calling Push, CascLib handles are never used by the workers.
+ * Push waits while readAhead files are queued, so reading stays only that far ahead of the conversion.
+ * Workers write their output files themselves, anything shared between items must be locked by process.
+ */
+template<typename T>
+class ExtractionPipeline
+{
+public:
+    // threads = 0 processes every item on the calling thread
+    ExtractionPipeline(uint32 threads, uint32 readAhead, std::function<void(T&)> process)
+        : _process(std::move(process)), _readAhead(std::max<uint32>(readAhead, 1)), _closed(false)
+    {
+        for (uint32 i = 0; i < threads; ++i)
+            _workers.emplace_back(&ExtractionPipeline::WorkerThread, this);
+    }
+
+    ~ExtractionPipeline()
+    {
+        Finish();
+    }
+
+    void Push(T&& item)
+    {
+        if (_workers.empty())
+        {
+            _process(item);
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(_lock);
+        while (_queue.size() >= _readAhead)
+            _notFull.wait(lock);
+
+        _queue.push_back(std::move(item));
+        _notEmpty.notify_one();
+    }
+
+    // returns once every pushed item was processed
+    void Finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _closed = true;
+        }
+
+        _notEmpty.notify_all();
+        for (std::thread& worker : _workers)
+            worker.join();
+
+        _workers.clear();
+    }
+
+private:
+    void WorkerThread()
+    {
+        while (true)
+        {
+            T item;
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+                while (_queue.empty() && !_closed)
+                    _notEmpty.wait(lock);
+
+                if (_queue.empty())
+                    return;
+
+                item = std::move(_queue.front());
+                _queue.pop_front();
+            }
+
+            _notFull.notify_one();
+            _process(item);
+        }
+    }
+
+    std::function<void(T&)> _process;
+    uint32 _readAhead;
+
+    std::mutex _lock;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::deque<T> _queue;
+    bool _closed;
+
+    std::vector<std::thread> _workers;
+
+    ExtractionPipeline(ExtractionPipeline const&) = delete;
+    ExtractionPipeline& operator=(ExtractionPipeline const&) = delete;
+};
+
+#endif // ExtractionPipeline_h__
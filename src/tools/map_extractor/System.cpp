@@ -18,9 +18,11 @@
 #include "Banner.h"
 #include "CascHandles.h"
 #include "Common.h"
+#include "ContentHashList.h"
 #include "DB2CascFileSource.h"
 #include "DB2Meta.h"
 #include "DBFilesClientList.h"
+#include "ExtractionPipeline.h"
 #include "ExtractorDB2LoadInfo.h"
 #include "StringFormat.h"
 #include "adt.h"
@@ -32,7 +34,9 @@
 #include <cstdio>
 #include <deque>
 #include <fstream>
+#include <map>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <cstdlib>
 #include <cstring>
@@ -100,6 +104,9 @@ float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - l
 
 uint32 CONF_Locale = 0;
 
+// Threads converting map tiles, CASC is still read by a single one
+uint32 CONF_threads = std::thread::hardware_concurrency();
+
 char const* CONF_Product = "wow";
 
 #define CASC_LOCALES_COUNT 17
@@ -154,6 +161,7 @@ void Usage(char const* prg)
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
         "-l dbc locale\n"\
         "-p which installed product to open (wow/wowt/wow_beta)\n"\
+        "-t number of threads converting map tiles (0 converts them while reading)\n"\
         "Example: %s -f 0 -i \"c:\\games\\game\"\n", prg, prg);
     exit(1);
 }
@@ -218,6 +226,12 @@ void HandleArgs(int argc, char* arg[])
                 else
                     Usage(arg[0]);
                 break;
+            case 't':
+                if (c + 1 < argc)                            // all ok
+                    CONF_threads = uint32(atoi(arg[c++ + 1]));
+                else
+                    Usage(arg[0]);
+                break;
             case 'h':
                 Usage(arg[0]);
                 break;
@@ -406,6 +420,14 @@ struct map_fileheader
     uint32 holesSize;
 };
 
+// sections start at aligned file offsets so the server can use arrays directly from the memory mapped file
+#define MAP_SECTION_ALIGNMENT 16
+
+static uint32 AlignMapSection(uint32 offset)
+{
+    return (offset + MAP_SECTION_ALIGNMENT - 1) & ~uint32(MAP_SECTION_ALIGNMENT - 1);
+}
+
 #define MAP_AREA_NO_AREA      0x0001
 
 struct map_areaHeader
@@ -461,24 +483,24 @@ float selectUInt16StepStore(float maxDiff)
 {
     return 65535 / maxDiff;
 }
-// Temporary grid data store
-uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+// Temporary grid data store, every thread converting tiles has its own
+thread_local uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID][8];
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint8 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID][8];
 
-int16 flight_box_max[3][3];
-int16 flight_box_min[3][3];
+thread_local int16 flight_box_max[3][3];
+thread_local int16 flight_box_min[3][3];
 
 LiquidVertexFormatType adt_MH2O::GetLiquidVertexFormat(adt_liquid_instance const* liquidInstance) const
 {
@@ -763,7 +785,7 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
         }
     }
 
-    map.areaMapOffset = sizeof(map);
+    map.areaMapOffset = AlignMapSection(sizeof(map));
     map.areaMapSize   = sizeof(map_areaHeader);
 
     map_areaHeader areaHeader;
@@ -821,7 +843,7 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
             maxHeight = CONF_use_minHeight;
     }
 
-    map.heightMapOffset = map.areaMapOffset + map.areaMapSize;
+    map.heightMapOffset = AlignMapSection(map.areaMapOffset + map.areaMapSize);
     map.heightMapSize = sizeof(map_heightHeader);
 
     map_heightHeader heightHeader;
@@ -940,7 +962,7 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
                     liquid_height[y][x] = CONF_use_minHeight;
             }
         }
-        map.liquidMapOffset = map.heightMapOffset + map.heightMapSize;
+        map.liquidMapOffset = AlignMapSection(map.heightMapOffset + map.heightMapSize);
         map.liquidMapSize = sizeof(map_liquidHeader);
         liquidHeader.fourcc = *reinterpret_cast<uint32 const*>(MAP_LIQUID_MAGIC);
         liquidHeader.flags = 0;
@@ -976,9 +998,9 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
     if (hasHoles)
     {
         if (map.liquidMapOffset)
-            map.holesOffset = map.liquidMapOffset + map.liquidMapSize;
+            map.holesOffset = AlignMapSection(map.liquidMapOffset + map.liquidMapSize);
         else
-            map.holesOffset = map.heightMapOffset + map.heightMapSize;
+            map.holesOffset = AlignMapSection(map.heightMapOffset + map.heightMapSize);
 
         map.holesSize = sizeof(holes);
     }
@@ -996,13 +1018,21 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
         return false;
     }
 
+    auto padToOffset = [&outFile](uint32 offset)
+    {
+        static char const padding[MAP_SECTION_ALIGNMENT] = { };
+        outFile.write(padding, offset - uint32(outFile.tellp()));
+    };
+
     outFile.write(reinterpret_cast<const char*>(&map), sizeof(map));
     // Store area data
+    padToOffset(map.areaMapOffset);
     outFile.write(reinterpret_cast<const char*>(&areaHeader), sizeof(areaHeader));
     if (!(areaHeader.flags & MAP_AREA_NO_AREA))
         outFile.write(reinterpret_cast<const char*>(area_ids), sizeof(area_ids));
 
     // Store height data
+    padToOffset(map.heightMapOffset);
     outFile.write(reinterpret_cast<const char*>(&heightHeader), sizeof(heightHeader));
     if (!(heightHeader.flags & MAP_HEIGHT_NO_HEIGHT))
     {
@@ -1032,6 +1062,7 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
     // Store liquid data if need
     if (map.liquidMapOffset)
     {
+        padToOffset(map.liquidMapOffset);
         outFile.write(reinterpret_cast<const char*>(&liquidHeader), sizeof(liquidHeader));
         if (!(liquidHeader.flags & MAP_LIQUID_NO_TYPE))
         {
@@ -1048,33 +1079,16 @@ bool ConvertADT(ChunkedFile& adt, std::string const& mapName, std::string const&
 
     // store hole data
     if (hasHoles)
+    {
+        padToOffset(map.holesOffset);
         outFile.write(reinterpret_cast<const char*>(holes), map.holesSize);
+    }
 
     outFile.close();
 
     return true;
 }
 
-bool ConvertADT(std::string const& fileName, std::string const& mapName, std::string const& outputPath, int gx, int gy, uint32 build, bool ignoreDeepWater)
-{
-    ChunkedFile adt;
-
-    if (!adt.loadFile(CascStorage, fileName))
-        return false;
-
-    return ConvertADT(adt, mapName, outputPath, gx, gy, build, ignoreDeepWater);
-}
-
-bool ConvertADT(uint32 fileDataId, std::string const& mapName, std::string const& outputPath, int gx, int gy, uint32 build, bool ignoreDeepWater)
-{
-    ChunkedFile adt;
-
-    if (!adt.loadFile(CascStorage, fileDataId, Trinity::StringFormat("Map %s grid [%u,%u]", mapName.c_str(), gx, gy)))
-        return false;
-
-    return ConvertADT(adt, mapName, outputPath, gx, gy, build, ignoreDeepWater);
-}
-
 bool IsDeepWaterIgnored(uint32 mapId, uint32 x, uint32 y)
 {
     if (mapId == 0)
@@ -1102,6 +1116,54 @@ bool IsDeepWaterIgnored(uint32 mapId, uint32 x, uint32 y)
     return false;
 }
 
+// Tile read from CASC, converted by ExtractMaps workers
+struct MapTileJob
+{
+    std::unique_ptr<ChunkedFile> Adt;
+    std::string MapName;
+    std::string OutputFileName;
+    int X = 0;
+    int Y = 0;
+    bool IgnoreDeepWater = false;
+    uint64 Hash = 0;
+    uint8* Converted = nullptr;
+};
+
+uint64 GetMapSettingsHash()
+{
+    // output of an unchanged adt still changes with these
+    uint64 hash = ContentHashList::HashBytes(MAP_VERSION_MAGIC, strlen(MAP_VERSION_MAGIC));
+    hash = ContentHashList::HashBytes(&CONF_allow_height_limit, sizeof(CONF_allow_height_limit), hash);
+    hash = ContentHashList::HashBytes(&CONF_use_minHeight, sizeof(CONF_use_minHeight), hash);
+    hash = ContentHashList::HashBytes(&CONF_allow_float_to_int, sizeof(CONF_allow_float_to_int), hash);
+    hash = ContentHashList::HashBytes(&CONF_float_to_int8_limit, sizeof(CONF_float_to_int8_limit), hash);
+    hash = ContentHashList::HashBytes(&CONF_float_to_int16_limit, sizeof(CONF_float_to_int16_limit), hash);
+    hash = ContentHashList::HashBytes(&CONF_flat_height_delta_limit, sizeof(CONF_flat_height_delta_limit), hash);
+    hash = ContentHashList::HashBytes(&CONF_flat_liquid_delta_limit, sizeof(CONF_flat_liquid_delta_limit), hash);
+
+    // liquid tables come from the same patch as the adts, sorted to not depend on hash table order
+    for (auto const& liquidMaterial : std::map<uint32, LiquidMaterialEntry>(LiquidMaterials.begin(), LiquidMaterials.end()))
+    {
+        hash = ContentHashList::HashBytes(&liquidMaterial.first, sizeof(liquidMaterial.first), hash);
+        hash = ContentHashList::HashBytes(&liquidMaterial.second.LVF, sizeof(liquidMaterial.second.LVF), hash);
+    }
+
+    for (auto const& liquidObject : std::map<uint32, LiquidObjectEntry>(LiquidObjects.begin(), LiquidObjects.end()))
+    {
+        hash = ContentHashList::HashBytes(&liquidObject.first, sizeof(liquidObject.first), hash);
+        hash = ContentHashList::HashBytes(&liquidObject.second.LiquidTypeID, sizeof(liquidObject.second.LiquidTypeID), hash);
+    }
+
+    for (auto const& liquidType : std::map<uint32, LiquidTypeEntry>(LiquidTypes.begin(), LiquidTypes.end()))
+    {
+        hash = ContentHashList::HashBytes(&liquidType.first, sizeof(liquidType.first), hash);
+        hash = ContentHashList::HashBytes(&liquidType.second.SoundBank, sizeof(liquidType.second.SoundBank), hash);
+        hash = ContentHashList::HashBytes(&liquidType.second.MaterialID, sizeof(liquidType.second.MaterialID), hash);
+    }
+
+    return hash;
+}
+
 void ExtractMaps(uint32 build)
 {
     std::string outputFileName;
@@ -1116,13 +1178,27 @@ void ExtractMaps(uint32 build)
 
     CreateDir(output_path / "maps");
 
-    printf("Convert map files\n");
+    // files skipped keep the build number of the run that converted them in their header, nothing reads it
+    ContentHashList contentHashes((output_path / "maps" / "contenthashes.txt").string(), GetMapSettingsHash());
+    contentHashes.Load();
+
+    // converted tiles of every map, one byte each so workers never write to the same memory
+    std::vector<std::vector<uint8>> existingTiles(map_ids.size(), std::vector<uint8>(WDT_MAP_SIZE * WDT_MAP_SIZE));
+    uint32 skippedTiles = 0;
+
+    ExtractionPipeline<MapTileJob> pipeline(CONF_threads, CONF_threads * 2, [&contentHashes, build](MapTileJob& job)
+    {
+        *job.Converted = ConvertADT(*job.Adt, job.MapName, job.OutputFileName, job.X, job.Y, build, job.IgnoreDeepWater);
+        if (*job.Converted)
+            contentHashes.Set(boost::filesystem::path(job.OutputFileName).filename().string(), job.Hash);
+    });
+
+    printf("Convert map files using %u threads\n", CONF_threads);
     for (std::size_t z = 0; z < map_ids.size(); ++z)
     {
         printf("Extract %s (" SZFMTD "/" SZFMTD ")                  \n", map_ids[z].Name.c_str(), z + 1, map_ids.size());
         // Loadup map grid data
         ChunkedFile wdt;
-        std::bitset<(WDT_MAP_SIZE) * (WDT_MAP_SIZE)> existingTiles;
         if (wdt.loadFile(CascStorage, map_ids[z].WdtFileDataId, Trinity::StringFormat("WDT for map %u", map_ids[z].Id), false))
         {
             FileChunk* mphd = wdt.GetChunk("MPHD");
@@ -1136,34 +1212,76 @@ void ExtractMaps(uint32 build)
                         continue;
 
                     outputFileName = Trinity::StringFormat("%s/maps/%04u_%02u_%02u.map", output_path.string().c_str(), map_ids[z].Id, y, x);
-                    bool ignoreDeepWater = IsDeepWaterIgnored(map_ids[z].Id, y, x);
+                    std::string description = Trinity::StringFormat("Map %s grid [%u,%u]", map_ids[z].Name.c_str(), y, x);
+                    std::unique_ptr<CASC::File> file;
                     if (mphd && mphd->As<wdt_MPHD>()->flags & 0x200)
+                        file.reset(CascStorage->OpenFile(maid->As<wdt_MAID>()->adt_files[y][x].rootADT, CASC_LOCALE_ALL_WOW, true));
+                    else
                     {
-                        existingTiles[y * WDT_MAP_SIZE + x] = ConvertADT(maid->As<wdt_MAID>()->adt_files[y][x].rootADT, map_ids[z].Name, outputFileName, y, x, build, ignoreDeepWater);
+                        description = Trinity::StringFormat(R"(World\Maps\%s\%s_%u_%u.adt)", map_ids[z].Directory.c_str(), map_ids[z].Directory.c_str(), x, y);
+                        file.reset(CascStorage->OpenFile(description.c_str(), CASC_LOCALE_ALL_WOW, true));
                     }
-                    else
+
+                    if (!file)
+                        continue;
+
+                    MapTileJob job;
+                    job.OutputFileName = outputFileName;
+                    job.X = y;
+                    job.Y = x;
+                    job.IgnoreDeepWater = IsDeepWaterIgnored(map_ids[z].Id, y, x);
+                    job.Converted = &existingTiles[z][y * WDT_MAP_SIZE + x];
+
+                    CASC::ContentKey contentKey;
+                    if (file->GetContentKey(contentKey))
                     {
-                        std::string storagePath = Trinity::StringFormat(R"(World\Maps\%s\%s_%u_%u.adt)", map_ids[z].Directory.c_str(), map_ids[z].Directory.c_str(), x, y);
-                        existingTiles[y * WDT_MAP_SIZE + x] = ConvertADT(storagePath, map_ids[z].Name, outputFileName, y, x, build, ignoreDeepWater);
+                        job.Hash = contentHashes.GetHash(contentKey);
+                        job.Hash = ContentHashList::HashBytes(&job.IgnoreDeepWater, sizeof(job.IgnoreDeepWater), job.Hash);
+                        if (contentHashes.IsUnchanged(boost::filesystem::path(outputFileName).filename().string(), job.Hash) && boost::filesystem::exists(outputFileName))
+                        {
+                            *job.Converted = 1;
+                            ++skippedTiles;
+                            continue;
+                        }
                     }
+
+                    job.Adt = std::make_unique<ChunkedFile>();
+                    if (!job.Adt->loadFile(*file, description))
+                        continue;
+
+                    job.MapName = map_ids[z].Name;
+                    pipeline.Push(std::move(job));
                 }
 
                 // draw progress bar
                 printf("Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
             }
         }
+    }
+
+    pipeline.Finish();
+
+    if (!contentHashes.Save())
+        printf("All tiles will be converted again by the next run\n");
+
+    // tile lists are written once the workers converted every tile
+    for (std::size_t z = 0; z < map_ids.size(); ++z)
+    {
+        std::bitset<(WDT_MAP_SIZE) * (WDT_MAP_SIZE)> mapTiles;
+        for (std::size_t i = 0; i < existingTiles[z].size(); ++i)
+            mapTiles[i] = existingTiles[z][i] != 0;
 
         if (FILE* tileList = fopen(Trinity::StringFormat("%s/maps/%04u.tilelist", output_path.string().c_str(), map_ids[z].Id).c_str(), "wb"))
         {
             fwrite(MAP_MAGIC, 1, strlen(MAP_MAGIC), tileList);
             fwrite(MAP_VERSION_MAGIC, 1, strlen(MAP_VERSION_MAGIC), tileList);
             fwrite(&build, sizeof(build), 1, tileList);
-            fwrite(existingTiles.to_string().c_str(), 1, existingTiles.size(), tileList);
+            fwrite(mapTiles.to_string().c_str(), 1, mapTiles.size(), tileList);
             fclose(tileList);
         }
     }
 
-    printf("\n");
+    printf("\n%u unchanged tiles were not converted again\n", skippedTiles);
 }
 
 bool ExtractFile(CASC::File* fileInArchive, std::string const& filename)
@@ -40,24 +40,7 @@ bool ChunkedFile::loadFile(std::shared_ptr<CASC::Storage const> mpq, std::string
     if (!file)
         return false;
 
-    int64 fileSize = file->GetSize();
-    if (fileSize == -1)
-        return false;
-
-    data_size = uint32(fileSize);
-    data = new uint8[data_size];
-    uint32 bytesRead = 0;
-    if (!file->ReadFile(data, data_size, &bytesRead) || bytesRead != data_size)
-        return false;
-
-    parseChunks();
-    if (prepareLoadedData())
-        return true;
-
-    printf("Error loading %s\n", fileName.c_str());
-    free();
-
-    return false;
+    return loadFile(*file, fileName);
 }
 
 bool ChunkedFile::loadFile(std::shared_ptr<CASC::Storage const> mpq, uint32 fileDataId, std::string const& description, bool log)
@@ -67,14 +50,20 @@ bool ChunkedFile::loadFile(std::shared_ptr<CASC::Storage const> mpq, uint32 file
     if (!file)
         return false;
 
-    int64 fileSize = file->GetSize();
+    return loadFile(*file, description);
+}
+
+bool ChunkedFile::loadFile(CASC::File& file, std::string const& description)
+{
+    free();
+    int64 fileSize = file.GetSize();
     if (fileSize == -1)
         return false;
 
-    data_size = fileSize;
+    data_size = uint32(fileSize);
     data = new uint8[data_size];
     uint32 bytesRead = 0;
-    if (!file->ReadFile(data, data_size, &bytesRead) || bytesRead != data_size)
+    if (!file.ReadFile(data, data_size, &bytesRead) || bytesRead != data_size)
         return false;
 
     parseChunks();
@@ -83,6 +83,7 @@ public:
     bool prepareLoadedData();
     bool loadFile(std::shared_ptr<CASC::Storage const> mpq, std::string const& fileName, bool log = true);
     bool loadFile(std::shared_ptr<CASC::Storage const> mpq, uint32 fileDataId, std::string const& description, bool log = true);
+    bool loadFile(CASC::File& file, std::string const& description);
     void free();
 
     void parseChunks();
@@ -27,6 +27,7 @@
 #include <DetourNavMesh.h>
 #include <DetourNavMeshBuilder.h>
 #include <climits>
+#include <cstdio>
 
 namespace MMAP
 {
@@ -44,8 +45,7 @@ namespace MMAP
         m_mapid              (mapid),
         m_totalTiles         (0u),
         m_totalTilesProcessed(0u),
-        m_rcContext          (nullptr),
-        _cancelationToken    (false)
+        m_rcContext          (nullptr)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
@@ -171,18 +171,34 @@ namespace MMAP
     {
         while (true)
         {
-            uint32 mapId = 0;
+            TileInfo tileInfo;
 
-            _queue.WaitAndPop(mapId);
+            _queue.WaitAndPop(tileInfo);
 
-            if (_cancelationToken)
+            // queue was canceled
+            if (!tileInfo.m_map)
                 return;
 
-            buildMap(mapId);
+            buildMapTile(*tileInfo.m_map, tileInfo.m_tileX, tileInfo.m_tileY);
         }
     }
 
     void MapBuilder::buildAllMaps(unsigned int threads)
+    {
+        m_tiles.sort([](MapTiles const& a, MapTiles const& b)
+        {
+            return a.m_tiles->size() > b.m_tiles->size();
+        });
+
+        std::vector<uint32> mapIDs;
+        for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+            if (!shouldSkipMap(it->m_mapId))
+                mapIDs.push_back(it->m_mapId);
+
+        buildMaps(mapIDs, threads);
+    }
+
+    void MapBuilder::buildMaps(std::vector<uint32> const& mapIDs, unsigned int threads)
     {
         printf("Using %u threads to extract mmaps\n", threads);
 
@@ -191,20 +207,39 @@ namespace MMAP
             _workerThreads.push_back(std::thread(&MapBuilder::WorkerThread, this));
         }
 
-        m_tiles.sort([](MapTiles const& a, MapTiles const& b)
+        for (uint32 mapID : mapIDs)
         {
-            return a.m_tiles->size() > b.m_tiles->size();
-        });
+            _maps.emplace_back(new MapBuildState(mapID));
+            MapBuildState& map = *_maps.back();
 
-        for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
-        {
-            uint32 mapId = it->m_mapId;
-            if (!shouldSkipMap(mapId))
+            std::set<uint32>* tiles = getTileList(mapID);
+            if (!startMap(map))
+            {
+                m_totalTilesProcessed += tiles->size();
+                continue;
+            }
+
+            if (tiles->empty())
+            {
+                finishMap(map);
+                continue;
+            }
+
+            printf("[Map %04u] We have %u tiles.                          \n", mapID, uint32(tiles->size()));
+
+            // set before the first tile is queued, a worker may finish it right away
+            map.m_pendingTiles = uint32(tiles->size());
+            for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
             {
+                uint32 tileX, tileY;
+
+                // unpack tile coords
+                StaticMapTree::unpackTileID((*it), tileX, tileY);
+
                 if (threads > 0)
-                    _queue.Push(mapId);
+                    _queue.Push(TileInfo(&map, tileX, tileY));
                 else
-                    buildMap(mapId);
+                    buildMapTile(map, tileX, tileY);
             }
         }
 
@@ -213,14 +248,193 @@ namespace MMAP
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         }
 
-        _cancelationToken = true;
-
+        // workers still finish the tile they are building
         _queue.Cancel();
 
         for (auto& thread : _workerThreads)
         {
             thread.join();
         }
+
+        _workerThreads.clear();
+        _maps.clear();
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::startMap(MapBuildState& map)
+    {
+        if (!buildNavMeshParams(map.m_mapId, map.m_navMeshParams))
+        {
+            printf("[Map %04u] Failed creating navmesh!\n", map.m_mapId);
+            return false;
+        }
+
+        loadTileHashes(map);
+
+        std::string fileName = Trinity::StringFormat("mmaps/%04u.mmhash", map.m_mapId);
+        map.m_hashFile = fopen(fileName.c_str(), "a");
+        if (!map.m_hashFile)
+        {
+            char message[1024];
+            sprintf(message, "[Map %04u] Failed to open %s for writing!\n", map.m_mapId, fileName.c_str());
+            perror(message);
+            return false;
+        }
+
+        return true;
+    }
+
+    void MapBuilder::buildMapTile(MapBuildState& map, uint32 tileX, uint32 tileY)
+    {
+        // every tile is built on a navmesh of its own, tiles of the same map are built at the same time
+        dtNavMesh* navMesh = dtAllocNavMesh();
+        if (!navMesh || !navMesh->init(&map.m_navMeshParams))
+            printf("[Map %04u] [%02u,%02u]: Failed creating navmesh!\n", map.m_mapId, tileX, tileY);
+        else
+        {
+            MeshData meshData;
+            bool hasGeometry = loadTileMeshData(map.m_mapId, tileX, tileY, meshData);
+
+            TileHash tileHash;
+            tileHash.hash = hashTileInput(meshData);
+            tileHash.written = false;
+
+            bool upToDate = false;
+            {
+                std::lock_guard<std::mutex> lock(map.m_hashLock);
+                auto itr = map.m_tileHashes.find(StaticMapTree::packTileID(tileX, tileY));
+                if (itr != map.m_tileHashes.end() && itr->second.hash == tileHash.hash)
+                {
+                    upToDate = true;
+                    tileHash.written = itr->second.written;
+                }
+            }
+
+            // the graph is written from scratch, tiles kept from a previous run must be in it as well
+            if (upToDate && tileHash.written)
+                upToDate = addTileFileToGraph(map.m_mapId, tileX, tileY, navMesh, map.m_graph);
+
+            if (upToDate)
+                printf("%u%% [Map %04u] Tile [%02u,%02u] is up to date\n", percentageDone(m_totalTiles, m_totalTilesProcessed), map.m_mapId, tileX, tileY);
+            else
+            {
+                // a tile that no longer has polygons must not leave its old file behind
+                remove(Trinity::StringFormat("mmaps/%04u%02u%02u.mmtile", map.m_mapId, tileY, tileX).c_str());
+
+                tileHash.written = hasGeometry && buildTile(map.m_mapId, tileX, tileY, meshData, navMesh, &map.m_graph);
+                saveTileHash(map, tileX, tileY, tileHash);
+            }
+        }
+
+        dtFreeNavMesh(navMesh);
+
+        ++m_totalTilesProcessed;
+        if (--map.m_pendingTiles == 0)
+            finishMap(map);
+    }
+
+    void MapBuilder::finishMap(MapBuildState& map)
+    {
+        // tiles without geometry are not in the graph, long paths through them use the regular search
+        map.m_graph.writeGraph(map.m_mapId);
+        writeTileHashes(map);
+
+        printf("[Map %04u] Complete!\n", map.m_mapId);
+    }
+
+    /**************************************************************************/
+    void MapBuilder::loadTileHashes(MapBuildState& map)
+    {
+        FILE* file = fopen(Trinity::StringFormat("mmaps/%04u.mmhash", map.m_mapId).c_str(), "r");
+        if (!file)
+            return;
+
+        // later lines were appended by later builds of the same tile, a line cut by an interruption fails to parse or to match
+        uint32 tileX, tileY, written;
+        unsigned long long hash;
+        while (fscanf(file, "%u %u %llx %u", &tileX, &tileY, &hash, &written) == 4)
+            map.m_tileHashes[StaticMapTree::packTileID(tileX, tileY)] = { uint64(hash), written != 0 };
+
+        fclose(file);
+    }
+
+    void MapBuilder::saveTileHash(MapBuildState& map, uint32 tileX, uint32 tileY, TileHash const& tileHash)
+    {
+        std::lock_guard<std::mutex> lock(map.m_hashLock);
+        map.m_tileHashes[StaticMapTree::packTileID(tileX, tileY)] = tileHash;
+
+        // the tile file is complete at this point, a run interrupted afterwards will not build it again
+        fprintf(map.m_hashFile, "%u %u %016llx %u\n", tileX, tileY, (unsigned long long)tileHash.hash, uint32(tileHash.written));
+        fflush(map.m_hashFile);
+    }
+
+    void MapBuilder::writeTileHashes(MapBuildState& map)
+    {
+        std::lock_guard<std::mutex> lock(map.m_hashLock);
+        fclose(map.m_hashFile);
+        map.m_hashFile = nullptr;
+
+        // drop the lines of tiles built more than once
+        std::string fileName = Trinity::StringFormat("mmaps/%04u.mmhash", map.m_mapId);
+        std::string tempFileName = fileName + ".tmp";
+        FILE* file = fopen(tempFileName.c_str(), "w");
+        if (!file)
+            return;
+
+        for (auto const& tileHash : map.m_tileHashes)
+        {
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID(tileHash.first, tileX, tileY);
+            fprintf(file, "%u %u %016llx %u\n", tileX, tileY, (unsigned long long)tileHash.second.hash, uint32(tileHash.second.written));
+        }
+
+        fclose(file);
+        remove(fileName.c_str());
+        rename(tempFileName.c_str(), fileName.c_str());
+    }
+
+    namespace
+    {
+        // FNV-1a, only used to notice changed input of a tile between two runs
+        void HashBytes(uint64& hash, void const* data, size_t size)
+        {
+            uint8 const* bytes = static_cast<uint8 const*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= UI64LIT(0x100000001B3);
+            }
+        }
+
+        template<class T>
+        void HashArray(uint64& hash, G3D::Array<T> const& data)
+        {
+            uint32 size = uint32(data.size());
+            HashBytes(hash, &size, sizeof(size));
+            HashBytes(hash, data.getCArray(), data.size() * sizeof(T));
+        }
+    }
+
+    uint64 MapBuilder::hashTileInput(MeshData const& meshData)
+    {
+        uint64 hash = UI64LIT(0xCBF29CE484222325);
+
+        // settings changing the tile built from the same geometry
+        uint32 const settings[] = { MMAP_VERSION, uint32(DT_NAVMESH_VERSION), uint32(m_bigBaseUnit), uint32(m_terrainBuilder->usesLiquids()) };
+        HashBytes(hash, settings, sizeof(settings));
+        HashBytes(hash, &m_maxWalkableAngle, sizeof(m_maxWalkableAngle));
+
+        HashArray(hash, meshData.solidVerts);
+        HashArray(hash, meshData.solidTris);
+        HashArray(hash, meshData.liquidVerts);
+        HashArray(hash, meshData.liquidTris);
+        HashArray(hash, meshData.liquidType);
+        HashArray(hash, meshData.offMeshConnections);
+        HashArray(hash, meshData.offMeshConnectionRads);
+        HashArray(hash, meshData.offMeshConnectionDirs);
+        HashArray(hash, meshData.offMeshConnectionsAreas);
+        HashArray(hash, meshData.offMeshConnectionsFlags);
+        return hash;
     }
 
     /**************************************************************************/
@@ -362,63 +576,37 @@ namespace MMAP
             return;
         }
 
-        buildTile(mapID, tileX, tileY, navMesh);
+        MeshData meshData;
+        if (loadTileMeshData(mapID, tileX, tileY, meshData))
+            buildTile(mapID, tileX, tileY, meshData, navMesh);
+
         dtFreeNavMesh(navMesh);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMap(uint32 mapID)
+    void MapBuilder::buildMap(uint32 mapID, unsigned int threads)
     {
-        std::set<uint32>* tiles = getTileList(mapID);
-
-        if (!tiles->empty())
-        {
-            // build navMesh
-            dtNavMesh* navMesh = nullptr;
-            buildNavMesh(mapID, navMesh);
-            if (!navMesh)
-            {
-                printf("[Map %04i] Failed creating navmesh!\n", mapID);
-                m_totalTilesProcessed += tiles->size();
-                return;
-            }
-
-            // now start building mmtiles for each tile
-            printf("[Map %04i] We have %u tiles.                          \n", mapID, (unsigned int)tiles->size());
-            for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
-            {
-                uint32 tileX, tileY;
-
-                // unpack tile coords
-                StaticMapTree::unpackTileID((*it), tileX, tileY);
-
-                if (!shouldSkipTile(mapID, tileX, tileY))
-                    buildTile(mapID, tileX, tileY, navMesh);
-                ++m_totalTilesProcessed;
-            }
-
-            dtFreeNavMesh(navMesh);
-        }
-
-        printf("[Map %04u] Complete!\n", mapID);
+        buildMaps(std::vector<uint32>(1, mapID), threads);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
+    bool MapBuilder::loadTileMeshData(uint32 mapID, uint32 tileX, uint32 tileY, MeshData& meshData)
     {
-        printf("%u%% [Map %04i] Building tile [%02u,%02u]\n", percentageDone(m_totalTiles, m_totalTilesProcessed), mapID, tileX, tileY);
-
-        MeshData meshData;
-
         // get heightmap data
         m_terrainBuilder->loadMap(mapID, tileX, tileY, meshData);
 
         // get model data
         m_terrainBuilder->loadVMap(mapID, tileY, tileX, meshData);
 
-        // if there is no data, give up now
-        if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
-            return;
+        m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
+
+        return meshData.solidVerts.size() || meshData.liquidVerts.size();
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, MeshData& meshData, dtNavMesh* navMesh, TileGraphBuilder* graph)
+    {
+        printf("%u%% [Map %04i] Building tile [%02u,%02u]\n", percentageDone(m_totalTiles, m_totalTilesProcessed), mapID, tileX, tileY);
 
         // remove unused vertices
         TerrainBuilder::cleanVertices(meshData.solidVerts, meshData.solidTris);
@@ -430,20 +618,55 @@ namespace MMAP
         allVerts.append(meshData.solidVerts);
 
         if (!allVerts.size())
-            return;
+            return false;
 
         // get bounds of current tile
         float bmin[3], bmax[3];
         getTileBounds(tileX, tileY, allVerts.getCArray(), allVerts.size() / 3, bmin, bmax);
 
-        m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
-
         // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        return buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh, graph);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildNavMesh(uint32 mapID, dtNavMesh* &navMesh)
+    bool MapBuilder::addTileFileToGraph(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, TileGraphBuilder& graph)
+    {
+        FILE* file = fopen(Trinity::StringFormat("mmaps/%04u%02u%02u.mmtile", mapID, tileY, tileX).c_str(), "rb");
+        if (!file)
+            return false;
+
+        MmapTileHeader header;
+        if (fread(&header, sizeof(MmapTileHeader), 1, file) != 1 || header.mmapMagic != MMAP_MAGIC ||
+            header.dtVersion != uint32(DT_NAVMESH_VERSION) || header.mmapVersion != MMAP_VERSION)
+        {
+            fclose(file);
+            return false;
+        }
+
+        unsigned char* data = (unsigned char*)dtAlloc(header.size, DT_ALLOC_PERM);
+        if (!data || fread(data, header.size, 1, file) != 1)
+        {
+            dtFree(data);
+            fclose(file);
+            return false;
+        }
+
+        fclose(file);
+
+        dtTileRef tileRef = 0;
+        if (dtStatusFailed(navMesh->addTile(data, header.size, DT_TILE_FREE_DATA, 0, &tileRef)))
+        {
+            dtFree(data);
+            return false;
+        }
+
+        graph.addTile(navMesh, navMesh->getTileByRef(tileRef));
+        navMesh->removeTile(tileRef, nullptr, nullptr);
+        return true;
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::buildNavMeshParams(uint32 mapID, dtNavMeshParams& navMeshParams)
     {
         // if map has a parent we use that to generate dtNavMeshParams - worldserver will load all missing tiles from that map
         int32 navMeshParamsMapId = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager())->getParentMapId(mapID);
@@ -488,7 +711,6 @@ namespace MMAP
         /***       now create the navmesh       ***/
 
         // navmesh creation params
-        dtNavMeshParams navMeshParams;
         memset(&navMeshParams, 0, sizeof(dtNavMeshParams));
         navMeshParams.tileWidth = GRID_SIZE;
         navMeshParams.tileHeight = GRID_SIZE;
@@ -496,13 +718,12 @@ namespace MMAP
         navMeshParams.maxTiles = maxTiles;
         navMeshParams.maxPolys = maxPolysPerTile;
 
-        navMesh = dtAllocNavMesh();
-        printf("[Map %04u] Creating navMesh...\n", mapID);
-        if (!navMesh->init(&navMeshParams))
-        {
-            printf("[Map %04u] Failed creating navmesh!                \n", mapID);
-            return;
-        }
+        // check the params before writing them
+        dtNavMesh* navMesh = dtAllocNavMesh();
+        bool valid = navMesh && navMesh->init(&navMeshParams);
+        dtFreeNavMesh(navMesh);
+        if (!valid)
+            return false;
 
         char fileName[25];
         sprintf(fileName, "mmaps/%04u.mmap", mapID);
@@ -510,23 +731,42 @@ namespace MMAP
         FILE* file = fopen(fileName, "wb");
         if (!file)
         {
-            dtFreeNavMesh(navMesh);
-            navMesh = nullptr;
             char message[1024];
             sprintf(message, "[Map %04u] Failed to open %s for writing!\n", mapID, fileName);
             perror(message);
-            return;
+            return false;
         }
 
         // now that we know navMesh params are valid, we can write them to file
         fwrite(&navMeshParams, sizeof(dtNavMeshParams), 1, file);
         fclose(file);
+        return true;
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
+    void MapBuilder::buildNavMesh(uint32 mapID, dtNavMesh* &navMesh)
+    {
+        dtNavMeshParams navMeshParams;
+        if (!buildNavMeshParams(mapID, navMeshParams))
+        {
+            printf("[Map %04u] Failed creating navmesh!                \n", mapID);
+            return;
+        }
+
+        navMesh = dtAllocNavMesh();
+        printf("[Map %04u] Creating navMesh...\n", mapID);
+        if (!navMesh->init(&navMeshParams))
+        {
+            printf("[Map %04u] Failed creating navmesh!                \n", mapID);
+            dtFreeNavMesh(navMesh);
+            navMesh = nullptr;
+        }
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
         MeshData &meshData, float bmin[3], float bmax[3],
-        dtNavMesh* navMesh)
+        dtNavMesh* navMesh, TileGraphBuilder* graph)
     {
         // console output
         std::string tileString = Trinity::StringFormat("[Map %04u] [%02i,%02i]: ", mapID, tileX, tileY);
@@ -700,7 +940,7 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return false;
         }
         rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
 
@@ -711,7 +951,7 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return false;
         }
         rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
 
@@ -771,6 +1011,7 @@ namespace MMAP
         // will hold final navmesh
         unsigned char* navData = nullptr;
         int navDataSize = 0;
+        bool written = false;
 
         do
         {
@@ -828,14 +1069,15 @@ namespace MMAP
                 break;
             }
 
-            // file output
+            // file output, written under another name first so an interrupted run never leaves a partial tile behind
             char fileName[255];
             sprintf(fileName, "mmaps/%04u%02i%02i.mmtile", mapID, tileY, tileX);
-            FILE* file = fopen(fileName, "wb");
+            std::string tempFileName = std::string(fileName) + ".tmp";
+            FILE* file = fopen(tempFileName.c_str(), "wb");
             if (!file)
             {
                 char message[1024];
-                sprintf(message, "[Map %04u] Failed to open %s for writing!\n", mapID, fileName);
+                sprintf(message, "[Map %04u] Failed to open %s for writing!\n", mapID, tempFileName.c_str());
                 perror(message);
                 navMesh->removeTile(tileRef, nullptr, nullptr);
                 break;
@@ -853,6 +1095,13 @@ namespace MMAP
             fwrite(navData, sizeof(unsigned char), navDataSize, file);
             fclose(file);
 
+            remove(fileName);
+            written = rename(tempFileName.c_str(), fileName) == 0;
+
+            // neighbour tiles were already removed, the links of the tile are all internal
+            if (graph)
+                graph->addTile(navMesh, navMesh->getTileByRef(tileRef));
+
             // now that tile is written to disk, we can unload it
             navMesh->removeTile(tileRef, nullptr, nullptr);
         }
@@ -871,6 +1120,8 @@ namespace MMAP
             iv.generateObjFile(mapID, tileX, tileY, meshData);
             iv.writeIV(mapID, tileX, tileY);
         }
+
+        return written;
     }
 
     /**************************************************************************/
@@ -1077,30 +1328,6 @@ namespace MMAP
         }
     }
 
-    /**************************************************************************/
-    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY)
-    {
-        char fileName[255];
-        sprintf(fileName, "mmaps/%04u%02i%02i.mmtile", mapID, tileY, tileX);
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
-            return false;
-
-        MmapTileHeader header;
-        int count = fread(&header, sizeof(MmapTileHeader), 1, file);
-        fclose(file);
-        if (count != 1)
-            return false;
-
-        if (header.mmapMagic != MMAP_MAGIC || header.dtVersion != uint32(DT_NAVMESH_VERSION))
-            return false;
-
-        if (header.mmapVersion != MMAP_VERSION)
-            return false;
-
-        return true;
-    }
-
     /**************************************************************************/
     uint32 MapBuilder::percentageDone(uint32 totalTiles, uint32 totalTilesBuilt)
     {
@@ -23,10 +23,13 @@
 #include <map>
 #include <list>
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
+#include "TileGraphBuilder.h"
 
 #include "Recast.h"
 #include "DetourNavMesh.h"
@@ -72,6 +75,39 @@ namespace MMAP
         rcPolyMeshDetail* dmesh;
     };
 
+    // input of a tile as of its last build, stored in mmaps/MMMM.mmhash
+    struct TileHash
+    {
+        uint64 hash;
+        bool written;                           // tiles without polygons have no file
+    };
+
+    // a map whose tiles are being built by the workers
+    struct MapBuildState
+    {
+        explicit MapBuildState(uint32 mapId) : m_mapId(mapId), m_navMeshParams(), m_pendingTiles(0), m_hashFile(nullptr) { }
+
+        uint32 m_mapId;
+        dtNavMeshParams m_navMeshParams;
+        std::atomic<uint32> m_pendingTiles;     // the worker finishing the last tile finishes the map
+
+        TileGraphBuilder m_graph;
+
+        std::mutex m_hashLock;
+        std::map<uint32, TileHash> m_tileHashes;
+        FILE* m_hashFile;                       // every built tile is appended right away so an interrupted run can resume
+    };
+
+    struct TileInfo
+    {
+        TileInfo() : m_map(nullptr), m_tileX(0), m_tileY(0) { }
+        TileInfo(MapBuildState* map, uint32 tileX, uint32 tileY) : m_map(map), m_tileX(tileX), m_tileY(tileY) { }
+
+        MapBuildState* m_map;
+        uint32 m_tileX;
+        uint32 m_tileY;
+    };
+
     class MapBuilder
     {
         public:
@@ -88,34 +124,56 @@ namespace MMAP
             ~MapBuilder();
 
             // builds all mmap tiles for the specified map id (ignores skip settings)
-            void buildMap(uint32 mapID);
+            void buildMap(uint32 mapID, unsigned int threads);
             void buildMeshFromFile(char* name);
 
             // builds an mmap tile for the specified map and its mesh
             void buildSingleTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
             // builds list of maps, then builds all of mmap tiles (based on the skip settings)
+            // tiles whose input did not change since they were last built are not built again
             void buildAllMaps(unsigned int threads);
 
-            void WorkerThread();
-
         private:
             // detect maps and tiles
             void discoverTiles();
             std::set<uint32>* getTileList(uint32 mapID);
 
+            // tiles of all maps are spread over the workers, largest maps first
+            void buildMaps(std::vector<uint32> const& mapIDs, unsigned int threads);
+            void WorkerThread();
+
+            bool startMap(MapBuildState& map);
+            void buildMapTile(MapBuildState& map, uint32 tileX, uint32 tileY);
+            void finishMap(MapBuildState& map);
+
+            // tile input hashes
+            void loadTileHashes(MapBuildState& map);
+            void saveTileHash(MapBuildState& map, uint32 tileX, uint32 tileY, TileHash const& tileHash);
+            void writeTileHashes(MapBuildState& map);
+            uint64 hashTileInput(MeshData const& meshData);
+
+            bool buildNavMeshParams(uint32 mapID, dtNavMeshParams& navMeshParams);
             void buildNavMesh(uint32 mapID, dtNavMesh* &navMesh);
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
+            // loads terrain, models and offmesh connections of a tile, false if it has no geometry
+            bool loadTileMeshData(uint32 mapID, uint32 tileX, uint32 tileY, MeshData& meshData);
+
+            // graph collects the clusters of the tile when the whole map is built, false if no tile file was written
+            bool buildTile(uint32 mapID, uint32 tileX, uint32 tileY, MeshData& meshData, dtNavMesh* navMesh, TileGraphBuilder* graph = nullptr);
+
+            // adds a tile built by a previous run to the graph, false if the file is missing or not usable
+            bool addTileFileToGraph(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, TileGraphBuilder& graph);
 
             // move map building
-            void buildMoveMapTile(uint32 mapID,
+            bool buildMoveMapTile(uint32 mapID,
                 uint32 tileX,
                 uint32 tileY,
                 MeshData &meshData,
                 float bmin[3],
                 float bmax[3],
-                dtNavMesh* navMesh);
+                dtNavMesh* navMesh,
+                TileGraphBuilder* graph = nullptr);
 
             void getTileBounds(uint32 tileX, uint32 tileY,
                 float* verts, int vertCount,
@@ -124,7 +182,6 @@ namespace MMAP
 
             bool shouldSkipMap(uint32 mapID);
             bool isTransportMap(uint32 mapID);
-            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
             uint32 percentageDone(uint32 totalTiles, uint32 totalTilesDone);
 
@@ -150,8 +207,8 @@ namespace MMAP
             rcContext* m_rcContext;
 
             std::vector<std::thread> _workerThreads;
-            ProducerConsumerQueue<uint32> _queue;
-            std::atomic<bool> _cancelationToken;
+            ProducerConsumerQueue<TileInfo> _queue;
+            std::vector<std::unique_ptr<MapBuildState>> _maps;
     };
 }
 
@@ -22,6 +22,7 @@
 #include "ModelInstance.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
+#include <memory>
 
 // ******************************************
 // Map file format defines
@@ -635,9 +636,23 @@ namespace MMAP
     }
 
     /**************************************************************************/
+    VMapManager2* TerrainBuilder::getVMapManager()
+    {
+        // the model instances of a map tree are those of all its loaded tiles, workers building tiles of
+        // the same map at the same time need trees of their own
+        static thread_local std::unique_ptr<VMapManager2> vmapManager;
+        if (!vmapManager)
+        {
+            vmapManager = std::make_unique<VMapManager2>();
+            vmapManager->GetLiquidFlagsPtr = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager())->GetLiquidFlagsPtr;
+        }
+
+        return vmapManager.get();
+    }
+
     bool TerrainBuilder::loadVMap(uint32 mapID, uint32 tileX, uint32 tileY, MeshData &meshData)
     {
-        VMapManager2* vmapManager = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager());
+        VMapManager2* vmapManager = getVMapManager();
         LoadResult result = vmapManager->loadSingleMap(mapID, "vmaps", tileX, tileY);
         bool retval = false;
 
@@ -25,6 +25,11 @@
 #include <G3D/Vector3.h>
 #include <G3D/Matrix3.h>
 
+namespace VMAP
+{
+    class VMapManager2;
+}
+
 namespace MMAP
 {
     enum Spot
@@ -94,6 +99,8 @@ namespace MMAP
             static void copyIndices(G3D::Array<int> &src, G3D::Array<int> &dest, int offset);
             static void cleanVertices(G3D::Array<float> &verts, G3D::Array<int> &tris);
         private:
+            static VMAP::VMapManager2* getVMapManager();
+
             /// Loads a portion of a map's terrain
             bool loadMap(uint32 mapID, uint32 tileX, uint32 tileY, MeshData &meshData, Spot portion);
 
@@ -0,0 +1,305 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TileGraphBuilder.h"
+#include <DetourCommon.h>
+#include <DetourNavMesh.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    // clusters are limited to 1/8 of a tile (~67 yards) in both directions
+    int32 const GRAPH_SECTORS_PER_TILE = 8;
+
+    // borders of neighbour tiles must overlap that much and be at about the same height to connect
+    float const MIN_PORTAL_WIDTH = 0.5f;
+    float const MAX_PORTAL_CLIMB = 2.0f;
+
+    float heightAt(float const* a, float const* b, int32 axis, float coord)
+    {
+        float length = b[axis] - a[axis];
+        if (std::fabs(length) < 0.001f)
+            return (a[1] + b[1]) * 0.5f;
+
+        return a[1] + (b[1] - a[1]) * dtClamp((coord - a[axis]) / length, 0.0f, 1.0f);
+    }
+}
+
+namespace MMAP
+{
+    void TileGraphBuilder::addTile(dtNavMesh const* navMesh, dtMeshTile const* tile)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        dtMeshHeader const* header = tile->header;
+        uint32 polyCount = uint32(header->polyCount);
+        unsigned int tileIndex = navMesh->decodePolyIdTile(navMesh->getPolyRefBase(tile));
+
+        MmapGraphTile graphTile;
+        graphTile.x = header->x;
+        graphTile.y = header->y;
+        graphTile.polyCount = polyCount;
+        graphTile.firstPoly = uint32(m_polyNodes.size());
+        m_tiles.push_back(graphTile);
+
+        // polygons are assigned to the sector containing their centroid
+        float sectorWidth = (header->bmax[0] - header->bmin[0]) / GRAPH_SECTORS_PER_TILE;
+        float sectorHeight = (header->bmax[2] - header->bmin[2]) / GRAPH_SECTORS_PER_TILE;
+        std::vector<float> centers(polyCount * 3);
+        std::vector<int32> sectors(polyCount);
+        for (uint32 i = 0; i < polyCount; ++i)
+        {
+            dtPoly const* poly = &tile->polys[i];
+            float* center = &centers[i * 3];
+            dtVset(center, 0.0f, 0.0f, 0.0f);
+            for (uint32 j = 0; j < poly->vertCount; ++j)
+                dtVadd(center, center, &tile->verts[poly->verts[j] * 3]);
+
+            if (poly->vertCount)
+                dtVscale(center, center, 1.0f / poly->vertCount);
+
+            int32 sectorX = dtClamp(int32((center[0] - header->bmin[0]) / sectorWidth), 0, GRAPH_SECTORS_PER_TILE - 1);
+            int32 sectorY = dtClamp(int32((center[2] - header->bmin[2]) / sectorHeight), 0, GRAPH_SECTORS_PER_TILE - 1);
+            sectors[i] = sectorY * GRAPH_SECTORS_PER_TILE + sectorX;
+        }
+
+        auto forEachLink = [&](uint32 polyIndex, auto callback)
+        {
+            for (unsigned int k = tile->polys[polyIndex].firstLink; k != DT_NULL_LINK; k = tile->links[k].next)
+            {
+                dtLink const& link = tile->links[k];
+                if (navMesh->decodePolyIdTile(link.ref) != tileIndex)
+                    continue;
+
+                uint32 target = navMesh->decodePolyIdPoly(link.ref);
+                if (target < polyCount)
+                    callback(link, target);
+            }
+        };
+
+        // clusters - polygons connected within the same sector and with the same flags
+        std::vector<uint32> nodes(polyCount, MMAP_GRAPH_INVALID_NODE);
+        std::vector<uint32> stack;
+        std::vector<uint32> members;
+        for (uint32 i = 0; i < polyCount; ++i)
+        {
+            if (nodes[i] != MMAP_GRAPH_INVALID_NODE)
+                continue;
+
+            uint32 node = uint32(m_nodes.size());
+            uint16 flags = tile->polys[i].flags;
+            nodes[i] = node;
+            stack.assign(1, i);
+            members.clear();
+            while (!stack.empty())
+            {
+                uint32 polyIndex = stack.back();
+                stack.pop_back();
+                members.push_back(polyIndex);
+
+                forEachLink(polyIndex, [&](dtLink const& /*link*/, uint32 target)
+                {
+                    if (nodes[target] != MMAP_GRAPH_INVALID_NODE || sectors[target] != sectors[i] || tile->polys[target].flags != flags)
+                        return;
+
+                    nodes[target] = node;
+                    stack.push_back(target);
+                });
+            }
+
+            // center is the centroid of the member closest to their average, it must lie on the mesh
+            float average[3] = { 0.0f, 0.0f, 0.0f };
+            for (uint32 member : members)
+                dtVadd(average, average, &centers[member * 3]);
+            dtVscale(average, average, 1.0f / members.size());
+
+            uint32 closest = *std::min_element(members.begin(), members.end(), [&](uint32 left, uint32 right)
+            {
+                return dtVdistSqr(average, &centers[left * 3]) < dtVdistSqr(average, &centers[right * 3]);
+            });
+
+            MmapGraphNode graphNode;
+            dtVcopy(graphNode.center, &centers[closest * 3]);
+            graphNode.flags = flags;
+            graphNode.padding = 0;
+            graphNode.firstEdge = 0;
+            graphNode.edgeCount = 0;
+            m_nodes.push_back(graphNode);
+            m_nodeEdges.emplace_back();
+        }
+
+        m_polyNodes.insert(m_polyNodes.end(), nodes.begin(), nodes.end());
+
+        // connections between clusters of this tile, links are one way for one way off-mesh connections
+        std::vector<BorderSegment>& borders = m_borders[std::make_pair(header->x, header->y)];
+        for (uint32 i = 0; i < polyCount; ++i)
+        {
+            dtPoly const* poly = &tile->polys[i];
+            forEachLink(i, [&](dtLink const& link, uint32 target)
+            {
+                if (nodes[target] == nodes[i])
+                    return;
+
+                float portal[3];
+                if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+                    dtVcopy(portal, &tile->verts[poly->verts[link.edge ? 1 : 0] * 3]);
+                else if (link.edge < poly->vertCount)
+                    dtVlerp(portal, &tile->verts[poly->verts[link.edge] * 3], &tile->verts[poly->verts[(link.edge + 1) % poly->vertCount] * 3], 0.5f);
+                else
+                {
+                    // link to an off-mesh connection, it starts at its end closest to this polygon
+                    dtPoly const* connection = &tile->polys[target];
+                    float const* start = &tile->verts[connection->verts[0] * 3];
+                    float const* end = &tile->verts[connection->verts[1] * 3];
+                    dtVcopy(portal, dtVdistSqr(start, &centers[i * 3]) <= dtVdistSqr(end, &centers[i * 3]) ? start : end);
+                }
+
+                addEdge(nodes[i], nodes[target], portal);
+            });
+
+            if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+                continue;
+
+            // tile borders, connected once the neighbour tiles are known
+            for (uint32 j = 0; j < poly->vertCount; ++j)
+            {
+                if (!(poly->neis[j] & DT_EXT_LINK))
+                    continue;
+
+                BorderSegment segment;
+                segment.node = nodes[i];
+                segment.side = uint8(poly->neis[j] & 0xFF);
+                dtVcopy(segment.a, &tile->verts[poly->verts[j] * 3]);
+                dtVcopy(segment.b, &tile->verts[poly->verts[(j + 1) % poly->vertCount] * 3]);
+                borders.push_back(segment);
+            }
+        }
+    }
+
+    void TileGraphBuilder::addEdge(uint32 from, uint32 to, float const* portal)
+    {
+        float cost = dtVdist(m_nodes[from].center, portal) + dtVdist(portal, m_nodes[to].center);
+        auto itr = m_nodeEdges[from].find(to);
+        if (itr != m_nodeEdges[from].end() && itr->second.cost <= cost)
+            return;
+
+        MmapGraphEdge& edge = m_nodeEdges[from][to];
+        edge.target = to;
+        edge.cost = cost;
+        dtVcopy(edge.portal, portal);
+    }
+
+    void TileGraphBuilder::connectBorders(std::vector<BorderSegment> const& segments, std::vector<BorderSegment> const& neighbourSegments, uint8 side)
+    {
+        uint8 oppositeSide = (side + 4) & 0x7;
+        // x+ and x- borders run along z, z+ and z- borders along x
+        int32 axis = (side == 0 || side == 4) ? 2 : 0;
+        int32 otherAxis = 2 - axis;
+
+        for (BorderSegment const& segment : segments)
+        {
+            if (segment.side != side)
+                continue;
+
+            float segmentMin = std::min(segment.a[axis], segment.b[axis]);
+            float segmentMax = std::max(segment.a[axis], segment.b[axis]);
+            for (BorderSegment const& neighbour : neighbourSegments)
+            {
+                if (neighbour.side != oppositeSide)
+                    continue;
+
+                float low = std::max(segmentMin, std::min(neighbour.a[axis], neighbour.b[axis]));
+                float high = std::min(segmentMax, std::max(neighbour.a[axis], neighbour.b[axis]));
+                if (high - low < MIN_PORTAL_WIDTH)
+                    continue;
+
+                float middle = (low + high) * 0.5f;
+                float height = heightAt(segment.a, segment.b, axis, middle);
+                float neighbourHeight = heightAt(neighbour.a, neighbour.b, axis, middle);
+                if (std::fabs(height - neighbourHeight) > MAX_PORTAL_CLIMB)
+                    continue;
+
+                float portal[3];
+                portal[axis] = middle;
+                portal[otherAxis] = (segment.a[otherAxis] + segment.b[otherAxis]) * 0.5f;
+                portal[1] = (height + neighbourHeight) * 0.5f;
+                addEdge(segment.node, neighbour.node, portal);
+            }
+        }
+    }
+
+    bool TileGraphBuilder::writeGraph(uint32 mapID)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        // neighbour tile in the direction of each border side, same as dtNavMesh::getNeighbourTilesAt
+        static int32 const neighbourOffsets[4][3] =
+        {
+            { 0,  1,  0 },
+            { 2,  0,  1 },
+            { 4, -1,  0 },
+            { 6,  0, -1 }
+        };
+
+        for (auto const& tileBorders : m_borders)
+        {
+            for (int32 const* offset : neighbourOffsets)
+            {
+                auto neighbour = m_borders.find(std::make_pair(tileBorders.first.first + offset[1], tileBorders.first.second + offset[2]));
+                if (neighbour != m_borders.end())
+                    connectBorders(tileBorders.second, neighbour->second, uint8(offset[0]));
+            }
+        }
+
+        std::vector<MmapGraphEdge> edges;
+        for (uint32 i = 0; i < m_nodes.size(); ++i)
+        {
+            m_nodes[i].firstEdge = uint32(edges.size());
+            m_nodes[i].edgeCount = uint32(m_nodeEdges[i].size());
+            for (std::pair<uint32 const, MmapGraphEdge> const& edge : m_nodeEdges[i])
+                edges.push_back(edge.second);
+        }
+
+        char fileName[255];
+        sprintf(fileName, "mmaps/%04u.mmgraph", mapID);
+        FILE* file = fopen(fileName, "wb");
+        if (!file)
+        {
+            char message[1024];
+            sprintf(message, "[Map %04u] Failed to open %s for writing!\n", mapID, fileName);
+            perror(message);
+            return false;
+        }
+
+        MmapGraphHeader header;
+        header.tileCount = uint32(m_tiles.size());
+        header.polyCount = uint32(m_polyNodes.size());
+        header.nodeCount = uint32(m_nodes.size());
+        header.edgeCount = uint32(edges.size());
+        fwrite(&header, sizeof(MmapGraphHeader), 1, file);
+        fwrite(m_tiles.data(), sizeof(MmapGraphTile), m_tiles.size(), file);
+        fwrite(m_polyNodes.data(), sizeof(uint32), m_polyNodes.size(), file);
+        fwrite(m_nodes.data(), sizeof(MmapGraphNode), m_nodes.size(), file);
+        fwrite(edges.data(), sizeof(MmapGraphEdge), edges.size(), file);
+        fclose(file);
+
+        printf("[Map %04u] Wrote navmesh graph with %u clusters and %u connections\n", mapID, header.nodeCount, header.edgeCount);
+        return true;
+    }
+}
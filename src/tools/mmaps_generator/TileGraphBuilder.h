@@ -0,0 +1,63 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MMAP_TILE_GRAPH_BUILDER_H
+#define _MMAP_TILE_GRAPH_BUILDER_H
+
+#include "MapDefines.h"
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace MMAP
+{
+    // Collects the clusters of the tiles of a map while they are built and writes mmaps/MMMM.mmgraph, see MMAP::TileGraph
+    class TileGraphBuilder
+    {
+        public:
+            TileGraphBuilder() { }
+
+            // tile must be added to navMesh without its neighbours, all of its links are then internal
+            // can be called by several threads building tiles of the same map
+            void addTile(dtNavMesh const* navMesh, dtMeshTile const* tile);
+
+            // connects clusters along the borders of neighbour tiles and writes the graph
+            bool writeGraph(uint32 mapID);
+
+        private:
+            struct BorderSegment
+            {
+                uint32 node;
+                uint8 side;             // same as dtPoly::neis, 0 = x+, 2 = z+, 4 = x-, 6 = z-
+                float a[3];
+                float b[3];
+            };
+
+            void addEdge(uint32 from, uint32 to, float const* portal);
+            void connectBorders(std::vector<BorderSegment> const& segments, std::vector<BorderSegment> const& neighbourSegments, uint8 side);
+
+            std::mutex m_lock;
+            std::vector<MmapGraphTile> m_tiles;
+            std::vector<uint32> m_polyNodes;
+            std::vector<MmapGraphNode> m_nodes;
+            std::vector<std::map<uint32, MmapGraphEdge>> m_nodeEdges;       // cheapest edge to each target
+            std::map<std::pair<int32, int32>, std::vector<BorderSegment>> m_borders;
+    };
+}
+
+#endif
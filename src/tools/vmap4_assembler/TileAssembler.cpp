@@ -82,7 +82,7 @@ namespace VMAP
                         continue;
 
                 mapSpawns.push_back(&entry->second);
-                spawnedModelFiles.insert(entry->second.name);
+                addModelFile(entry->second.name);
 
                 std::map<uint32, std::set<TileSpawn>>& tileEntries = (entry->second.flags & MOD_PARENT_SPAWN) ? data.ParentTileEntries : data.TileEntries;
 
@@ -155,12 +155,19 @@ namespace VMAP
                     if (success && fwrite(VMAP_MAGIC, 1, 8, tileFile) != 8) success = false;
                     // write number of tile spawns
                     if (success && fwrite(&nSpawns, sizeof(uint32), 1, tileFile) != 1) success = false;
-                    // write tile spawns
+                    // write tile spawns, each followed by the id of its model in WorldModels.vmlist
+                    auto writeTileSpawn = [&](TileSpawn const& tileSpawn)
+                    {
+                        ModelSpawn const& spawn = data.UniqueEntries[tileSpawn.Id];
+                        uint32 modelId = spawnedModelIds[spawn.name];
+                        return ModelSpawn::writeToFile(tileFile, spawn) && fwrite(&modelId, sizeof(uint32), 1, tileFile) == 1;
+                    };
+
                     for (auto spawnItr = tileItr->second.begin(); spawnItr != tileItr->second.end() && success; ++spawnItr)
-                        success = ModelSpawn::writeToFile(tileFile, data.UniqueEntries[spawnItr->Id]);
+                        success = writeTileSpawn(*spawnItr);
 
                     for (auto spawnItr = parentTileEntries.begin(); spawnItr != parentTileEntries.end() && success; ++spawnItr)
-                        success = ModelSpawn::writeToFile(tileFile, data.UniqueEntries[spawnItr->Id]);
+                        success = writeTileSpawn(*spawnItr);
 
                     fclose(tileFile);
                 }
@@ -171,7 +178,7 @@ namespace VMAP
         exportGameobjectModels();
         // export objects
         std::cout << "\nConverting Model Files" << std::endl;
-        for (std::set<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
+        for (std::vector<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
         {
             std::cout << "Converting " << *mfile << std::endl;
             if (!convertRawFile(*mfile))
@@ -182,6 +189,44 @@ namespace VMAP
             }
         }
 
+        if (success)
+            success = writeModelList();
+
+        return success;
+    }
+
+    uint32 TileAssembler::addModelFile(std::string const& modelFilename)
+    {
+        auto itr = spawnedModelIds.find(modelFilename);
+        if (itr != spawnedModelIds.end())
+            return itr->second;
+
+        uint32 modelId = spawnedModelFiles.size();
+        spawnedModelFiles.push_back(modelFilename);
+        spawnedModelIds[modelFilename] = modelId;
+        return modelId;
+    }
+
+    bool TileAssembler::writeModelList()
+    {
+        std::string fileName = iDestDir + "/" + WORLD_MODELS;
+        FILE* file = fopen(fileName.c_str(), "wb");
+        if (!file)
+        {
+            printf("Cannot open %s\n", fileName.c_str());
+            return false;
+        }
+
+        uint32 count = spawnedModelFiles.size();
+        bool success = fwrite(VMAP_MAGIC, 1, 8, file) == 8 && fwrite(&count, sizeof(uint32), 1, file) == 1;
+        for (std::string const& modelFilename : spawnedModelFiles)
+        {
+            uint32 nameLength = modelFilename.length();
+            if (success && fwrite(&nameLength, sizeof(uint32), 1, file) != 1) success = false;
+            if (success && fwrite(modelFilename.c_str(), sizeof(char), nameLength, file) != nameLength) success = false;
+        }
+
+        fclose(file);
         return success;
     }
 
@@ -350,7 +395,7 @@ namespace VMAP
             if (!raw_model.Read((iSrcDir + "/" + model_name).c_str()) )
                 continue;
 
-            spawnedModelFiles.insert(model_name);
+            addModelFile(model_name);
             AABox bounds;
             for (GroupModel_Raw const& groupModel : raw_model.groupsArray)
                 for (G3D::Vector3 const& vertice : groupModel.vertexArray)
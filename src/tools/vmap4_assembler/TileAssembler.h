@@ -23,6 +23,7 @@
 #include <deque>
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #include "ModelInstance.h"
 #include "WorldModel.h"
@@ -108,7 +109,8 @@ namespace VMAP
             std::string iDestDir;
             std::string iSrcDir;
             MapData mapData;
-            std::set<std::string> spawnedModelFiles;
+            std::vector<std::string> spawnedModelFiles;                 // index is the model id written to tile files
+            std::unordered_map<std::string, uint32> spawnedModelIds;
 
         public:
             TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
@@ -118,6 +120,8 @@ namespace VMAP
             bool readMapSpawns();
             bool calculateTransformedBound(ModelSpawn &spawn);
             void exportGameobjectModels();
+            uint32 addModelFile(std::string const& modelFilename);
+            bool writeModelList();
 
             bool convertRawFile(const std::string& pModelFilename);
     };
@@ -16,6 +16,7 @@
  */
 
 #include "adtfile.h"
+#include "ContentHashList.h"
 #include "DB2CascFileSource.h"
 #include "Errors.h"
 #include "ExtractorDB2LoadInfo.h"
@@ -26,8 +27,14 @@
 #include <CascLib.h>
 #include <algorithm>
 #include <cstdio>
+#include <unordered_set>
 
-bool ExtractSingleModel(std::string& fname)
+extern std::shared_ptr<CASC::Storage> CascStorage;
+
+// models extracted by this run, they are referenced again by most tiles and wmos
+static std::unordered_set<std::string> ExtractedModels;
+
+bool PrepareSingleModel(std::string& fname, ModelExtraction& extraction)
 {
     if (fname.length() < 4)
         return false;
@@ -44,21 +51,55 @@ bool ExtractSingleModel(std::string& fname)
     char* name = GetPlainName((char*)fname.c_str());
     NormalizeFileName(name, strlen(name));
 
+    extraction.OutputName = name;
+    if (ExtractedModels.count(extraction.OutputName))
+        return true;
+
     std::string output(szWorkDirWmo);
     output += "/";
     output += name;
 
-    if (FileExists(output.c_str()))
-        return true;
+    // unchanged since the previous run
+    std::unique_ptr<CASC::File> file(CascStorage->OpenFile(originalName.c_str(), CASC_LOCALE_ALL_WOW));
+    CASC::ContentKey contentKey;
+    if (file && file->GetContentKey(contentKey))
+    {
+        extraction.ContentHash = ModelContentHashes->GetHash(contentKey);
+        if (ModelContentHashes->IsUnchanged(extraction.OutputName, extraction.ContentHash) && FileExists(output.c_str()))
+        {
+            ExtractedModels.insert(extraction.OutputName);
+            return true;
+        }
+    }
 
-    Model mdl(originalName);
-    if (!mdl.open())
+    extraction.Source = std::make_unique<Model>(originalName);
+    if (!extraction.Source->open())
+    {
+        extraction.Source.reset();
+        // spawns must not use the output of a previous run
+        SetExtractedVertexCount(extraction.OutputName, 0);
         return false;
+    }
 
-    return mdl.ConvertToVMAPModel(output.c_str());
+    SetExtractedVertexCount(extraction.OutputName, extraction.Source->header.nBoundingVertices);
+    ExtractedModels.insert(extraction.OutputName);
+    return true;
 }
 
-extern std::shared_ptr<CASC::Storage> CascStorage;
+bool ConvertSingleModel(ModelExtraction& extraction)
+{
+    std::string output(szWorkDirWmo);
+    output += "/";
+    output += extraction.OutputName;
+
+    if (!extraction.Source->ConvertToVMAPModel(output.c_str()))
+        return false;
+
+    if (extraction.ContentHash)
+        ModelContentHashes->Set(extraction.OutputName, extraction.ContentHash);
+
+    return true;
+}
 
 bool GetHeaderMagic(std::string const& fileName, uint32* magic)
 {
@@ -103,6 +144,18 @@ void ExtractGameobjectModels()
 
     fwrite(VMAP::RAW_VMAP_MAGIC, 1, 8, model_list);
 
+    struct GameObjectModel
+    {
+        uint32 DisplayId;
+        uint8 IsWmo;
+        std::string FileName;
+        uint8 Extracted;
+    };
+
+    // models are written by the ModelConversions workers, the list only needs their sources to be valid
+    std::vector<GameObjectModel> models;
+    models.reserve(db2.GetRecordCount());
+
     for (uint32 rec = 0; rec < db2.GetRecordCount(); ++rec)
     {
         DB2Record record = db2.GetRecord(rec);
@@ -114,31 +167,33 @@ void ExtractGameobjectModels()
             continue;
 
         std::string fileName = Trinity::StringFormat("FILE%08X.xxx", fileId);
-        bool result = false;
         uint32 header;
         if (!GetHeaderMagic(fileName, &header))
             continue;
 
-        uint8 isWmo = 0;
+        models.push_back({ record.GetId(), 0, fileName, 0 });
+        GameObjectModel& model = models.back();
         if (!memcmp(&header, "REVM", 4))
         {
-            isWmo = 1;
-            result = ExtractSingleWmo(fileName);
+            model.IsWmo = 1;
+            model.Extracted = ExtractSingleWmo(model.FileName);
         }
         else if (!memcmp(&header, "MD20", 4) || !memcmp(&header, "MD21", 4))
-            result = ExtractSingleModel(fileName);
+            model.Extracted = ExtractSingleModel(model.FileName);
         else
             ASSERT(false, "%s header: %d - %c%c%c%c", fileName.c_str(), header, (header >> 24) & 0xFF, (header >> 16) & 0xFF, (header >> 8) & 0xFF, header & 0xFF);
+    }
 
-        if (result)
-        {
-            uint32 displayId = record.GetId();
-            uint32 path_length = fileName.length();
-            fwrite(&displayId, sizeof(uint32), 1, model_list);
-            fwrite(&isWmo, sizeof(uint8), 1, model_list);
-            fwrite(&path_length, sizeof(uint32), 1, model_list);
-            fwrite(fileName.c_str(), sizeof(char), path_length, model_list);
-        }
+    for (GameObjectModel const& model : models)
+    {
+        if (!model.Extracted)
+            continue;
+
+        uint32 path_length = model.FileName.length();
+        fwrite(&model.DisplayId, sizeof(uint32), 1, model_list);
+        fwrite(&model.IsWmo, sizeof(uint8), 1, model_list);
+        fwrite(&path_length, sizeof(uint32), 1, model_list);
+        fwrite(model.FileName.c_str(), sizeof(char), path_length, model_list);
     }
 
     fclose(model_list);
@@ -153,19 +153,8 @@ Vec3D fixCoordSystem(Vec3D const& v)
 
 void Doodad::Extract(ADT::MDDF const& doodadDef, char const* ModelInstName, uint32 mapID, uint32 originalMapId, FILE* pDirfile, std::vector<ADTOutputCache>* dirfileCache)
 {
-    char tempname[1036];
-    sprintf(tempname, "%s/%s", szWorkDirWmo, ModelInstName);
-    FILE* input = fopen(tempname, "r+b");
-
-    if (!input)
-        return;
-
-    fseek(input, 8, SEEK_SET); // get the correct no of vertices
     int nVertices;
-    int count = fread(&nVertices, sizeof (int), 1, input);
-    fclose(input);
-
-    if (count != 1 || nVertices == 0)
+    if (!GetExtractedVertexCount(ModelInstName, nVertices) || nVertices == 0)
         return;
 
     // scale factor - divide by 1024. blizzard devs must be on crack, why not just use a float?
@@ -260,18 +249,8 @@ void Doodad::ExtractSet(WMODoodadData const& doodadData, ADT::MODF const& wmo, b
             }
         }
 
-        char tempname[1036];
-        sprintf(tempname, "%s/%s", szWorkDirWmo, ModelInstName);
-        FILE* input = fopen(tempname, "r+b");
-        if (!input)
-            continue;
-
-        fseek(input, 8, SEEK_SET); // get the correct no of vertices
         int nVertices;
-        int count = fread(&nVertices, sizeof(int), 1, input);
-        fclose(input);
-
-        if (count != 1 || nVertices == 0)
+        if (!GetExtractedVertexCount(ModelInstName, nVertices) || nVertices == 0)
             continue;
 
         ASSERT(doodadId < std::numeric_limits<uint16>::max());
@@ -19,10 +19,13 @@
 #include "Banner.h"
 #include "Common.h"
 #include "cascfile.h"
+#include "ContentHashList.h"
 #include "DB2CascFileSource.h"
+#include "ExtractionPipeline.h"
 #include "ExtractorDB2LoadInfo.h"
 #include "StringFormat.h"
 #include "vmapexport.h"
+#include "VMapDefinitions.h"
 #include "wdtfile.h"
 #include "wmo.h"
 #include <CascLib.h>
@@ -31,6 +34,7 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -62,6 +66,9 @@ boost::filesystem::path input_path;
 bool preciseVectorData = false;
 char const* CascProduct = "wow";
 std::unordered_map<std::string, WMODoodadData> WmoDoodads;
+uint32 ExtractThreads = std::thread::hardware_concurrency();
+std::unique_ptr<ContentHashList> ModelContentHashes;
+ExtractionPipeline<ModelExtraction>* ModelConversions = nullptr;
 
 // Constants
 
@@ -155,17 +162,62 @@ bool FileExists(char const* file)
     return false;
 }
 
-bool ExtractSingleWmo(std::string& fname)
+ModelExtraction::ModelExtraction() = default;
+ModelExtraction::ModelExtraction(ModelExtraction&&) = default;
+ModelExtraction& ModelExtraction::operator=(ModelExtraction&&) = default;
+ModelExtraction::~ModelExtraction() = default;
+
+// only used by the reading thread
+static std::unordered_map<std::string, int> ExtractedVertexCounts;
+
+bool GetExtractedVertexCount(char const* outputName, int& vertexCount)
+{
+    auto itr = ExtractedVertexCounts.find(outputName);
+    if (itr != ExtractedVertexCounts.end())
+    {
+        vertexCount = itr->second;
+        return true;
+    }
+
+    // kept from a previous run
+    std::string fileName = Trinity::StringFormat("%s/%s", szWorkDirWmo, outputName);
+    FILE* input = fopen(fileName.c_str(), "rb");
+    if (!input)
+        return false;
+
+    fseek(input, 8, SEEK_SET); // get the correct no of vertices
+    int count = fread(&vertexCount, sizeof(int), 1, input);
+    fclose(input);
+
+    if (count != 1)
+        return false;
+
+    ExtractedVertexCounts[outputName] = vertexCount;
+    return true;
+}
+
+void SetExtractedVertexCount(std::string const& outputName, int vertexCount)
+{
+    ExtractedVertexCounts[outputName] = vertexCount;
+}
+
+static bool GetContentKey(std::string const& fileName, CASC::ContentKey& contentKey)
+{
+    std::unique_ptr<CASC::File> file(CascStorage->OpenFile(fileName.c_str(), CASC_LOCALE_ALL_WOW));
+    return file && file->GetContentKey(contentKey);
+}
+
+bool PrepareSingleWmo(std::string& fname, ModelExtraction& extraction)
 {
     // Copy files from archive
     std::string originalName = fname;
 
-    char szLocalFile[1024];
     char* plain_name = GetPlainName(&fname[0]);
     NormalizeFileName(plain_name, strlen(plain_name));
-    sprintf(szLocalFile, "%s/%s", szWorkDirWmo, plain_name);
+    extraction.OutputName = plain_name;
 
-    if (FileExists(szLocalFile))
+    // already read by this run
+    if (WmoDoodads.count(plain_name))
         return true;
 
     int p = 0;
@@ -179,65 +231,155 @@ bool ExtractSingleWmo(std::string& fname)
     if (p == 3)
         return true;
 
-    bool file_ok = true;
-    WMORoot froot(originalName);
-    if (!froot.open())
+    std::unique_ptr<WMORoot> froot = std::make_unique<WMORoot>(originalName);
+    if (!froot->open())
     {
         printf("Couldn't open RootWmo!!!\n");
         return true;
     }
-    FILE *output = fopen(szLocalFile,"wb");
-    if(!output)
-    {
-        printf("couldn't open %s for writing!\n", szLocalFile);
-        return false;
-    }
-    froot.ConvertToVMAPRootWmo(output);
+
+    std::string output = Trinity::StringFormat("%s/%s", szWorkDirWmo, plain_name);
+
+    // the output depends on the root and all of its groups
+    CASC::ContentKey contentKey;
+    bool hashed = GetContentKey(originalName, contentKey);
+    uint64 contentHash = hashed ? ModelContentHashes->GetHash(contentKey) : 0;
+
+    // the groups are read even if the output is unchanged, their doodad references are needed by the spawns
+    bool file_ok = true;
     WMODoodadData& doodads = WmoDoodads[plain_name];
-    std::swap(doodads, froot.DoodadData);
+    std::swap(doodads, froot->DoodadData);
     int Wmo_nVertices = 0;
-    uint32 groupCount = 0;
     //printf("root has %d groups\n", froot->nGroups);
-    for (std::size_t i = 0; i < froot.groupFileDataIDs.size(); ++i)
+    for (std::size_t i = 0; i < froot->groupFileDataIDs.size(); ++i)
     {
-        std::string s = Trinity::StringFormat("FILE%08X.xxx", froot.groupFileDataIDs[i]);
-        WMOGroup fgroup(s);
-        if (!fgroup.open(&froot))
+        std::string s = Trinity::StringFormat("FILE%08X.xxx", froot->groupFileDataIDs[i]);
+        std::unique_ptr<WMOGroup> fgroup = std::make_unique<WMOGroup>(s);
+        if (!fgroup->open(froot.get()))
         {
             printf("Could not open all Group file for: %s\n", plain_name);
             file_ok = false;
             break;
         }
 
-        if (fgroup.ShouldSkip(&froot))
+        if (hashed && GetContentKey(s, contentKey))
+            contentHash = ContentHashList::HashBytes(contentKey.data(), contentKey.size(), contentHash);
+        else
+            hashed = false;
+
+        if (fgroup->ShouldSkip(froot.get()))
             continue;
 
-        Wmo_nVertices += fgroup.ConvertToVMAPGroupWmo(output, preciseVectorData);
-        ++groupCount;
-        for (uint16 groupReference : fgroup.DoodadReferences)
+        Wmo_nVertices += fgroup->GetCollisionTriangleCount(preciseVectorData);
+        for (uint16 groupReference : fgroup->DoodadReferences)
         {
             if (groupReference >= doodads.Spawns.size())
                 continue;
 
             uint32 doodadNameIndex = doodads.Spawns[groupReference].NameIndex;
-            if (froot.ValidDoodadNames.find(doodadNameIndex) == froot.ValidDoodadNames.end())
+            if (froot->ValidDoodadNames.find(doodadNameIndex) == froot->ValidDoodadNames.end())
                 continue;
 
             doodads.References.insert(groupReference);
         }
-    }
 
-    fseek(output, 8, SEEK_SET); // store the correct no of vertices
-    fwrite(&Wmo_nVertices, sizeof(int), 1, output);
-    fwrite(&groupCount, sizeof(uint32), 1, output);
-    fclose(output);
+        extraction.WmoGroups.push_back(std::move(fgroup));
+    }
 
-    // Delete the extracted file in the case of an error
+    // Delete the file extracted by a previous run in the case of an error
     if (!file_ok)
-        remove(szLocalFile);
+    {
+        remove(output.c_str());
+        WmoDoodads.erase(plain_name);
+        extraction.WmoGroups.clear();
+        return true;
+    }
+
+    // unchanged since the previous run
+    if (hashed && ModelContentHashes->IsUnchanged(extraction.OutputName, contentHash) && FileExists(output.c_str()))
+    {
+        extraction.WmoGroups.clear();
+        return true;
+    }
+
+    SetExtractedVertexCount(extraction.OutputName, Wmo_nVertices);
+    extraction.WmoRoot = std::move(froot);
+    extraction.ContentHash = hashed ? contentHash : 0;
+    return true;
+}
+
+bool ConvertSingleWmo(ModelExtraction& extraction)
+{
+    std::string output = Trinity::StringFormat("%s/%s", szWorkDirWmo, extraction.OutputName.c_str());
+    FILE* file = fopen(output.c_str(), "wb");
+    if (!file)
+    {
+        printf("couldn't open %s for writing!\n", output.c_str());
+        return false;
+    }
+
+    extraction.WmoRoot->ConvertToVMAPRootWmo(file);
+    int Wmo_nVertices = 0;
+    uint32 groupCount = 0;
+    for (std::unique_ptr<WMOGroup> const& group : extraction.WmoGroups)
+    {
+        Wmo_nVertices += group->ConvertToVMAPGroupWmo(file, preciseVectorData);
+        ++groupCount;
+    }
+
+    fseek(file, 8, SEEK_SET); // store the correct no of vertices
+    fwrite(&Wmo_nVertices, sizeof(int), 1, file);
+    fwrite(&groupCount, sizeof(uint32), 1, file);
+    fclose(file);
+
+    if (extraction.ContentHash)
+        ModelContentHashes->Set(extraction.OutputName, extraction.ContentHash);
+
+    return true;
+}
+
+bool ConvertExtraction(ModelExtraction& extraction)
+{
+    if (extraction.Source)
+        return ConvertSingleModel(extraction);
+
+    if (extraction.WmoRoot)
+        return ConvertSingleWmo(extraction);
+
     return true;
 }
 
+// the outcome of a conversion on a worker thread is not waited for, preparing already checked the source
+static bool QueueConversion(ModelExtraction& extraction)
+{
+    if (!extraction.Source && !extraction.WmoRoot)
+        return true;
+
+    if (!ModelConversions)
+        return ConvertExtraction(extraction);
+
+    ModelConversions->Push(std::move(extraction));
+    return true;
+}
+
+bool ExtractSingleWmo(std::string& fname)
+{
+    ModelExtraction extraction;
+    if (!PrepareSingleWmo(fname, extraction))
+        return false;
+
+    return QueueConversion(extraction);
+}
+
+bool ExtractSingleModel(std::string& fname)
+{
+    ModelExtraction extraction;
+    if (!PrepareSingleModel(fname, extraction))
+        return false;
+
+    return QueueConversion(extraction);
+}
+
 void ParsMapFiles()
 {
     std::unordered_map<uint32, WDTFile> wdts;
@@ -338,6 +480,13 @@ bool processArgv(int argc, char ** argv, const char *versionString)
             else
                 result = false;
         }
+        else if (strcmp("-t", argv[i]) == 0)
+        {
+            if (i + 1 < argc && atoi(argv[i + 1]) >= 0)
+                ExtractThreads = uint32(atoi(argv[++i]));
+            else
+                result = false;
+        }
         else
         {
             result = false;
@@ -348,11 +497,12 @@ bool processArgv(int argc, char ** argv, const char *versionString)
     if (!result)
     {
         printf("Extract %s.\n",versionString);
-        printf("%s [-?][-s][-l][-d <path>][-p <product>]\n", argv[0]);
+        printf("%s [-?][-s][-l][-d <path>][-p <product>][-t <threads>]\n", argv[0]);
         printf("   -s : (default) small size (data size optimization), ~500MB less vmap data.\n");
         printf("   -l : large size, ~500MB more vmap data. (might contain more details)\n");
         printf("   -d <path>: Path to the vector data source folder.\n");
         printf("   -p <product>: which installed product to open (wow/wowt/wow_beta)\n");
+        printf("   -t <threads>: number of threads converting models and wmos, 0 converts them on the reading thread. (default: hardware concurrency)\n");
         printf("   -? : This message.\n");
     }
 
@@ -417,13 +567,17 @@ int main(int argc, char ** argv)
         std::string sdir = std::string(szWorkDirWmo) + "/dir";
         std::string sdir_bin = std::string(szWorkDirWmo) + "/dir_bin";
         struct stat status;
-        if (!stat(sdir.c_str(), &status) || !stat(sdir_bin.c_str(), &status))
+        if (!stat(sdir.c_str(), &status))
         {
             printf("Your output directory seems to be polluted, please use an empty directory!\n");
             printf("<press return to exit>");
             char garbage[2];
             return scanf("%c", garbage);
         }
+
+        // spawns are appended to dir_bin, it is written again by every run while unchanged models are kept
+        boost::system::error_code ec;
+        boost::filesystem::remove(sdir_bin, ec);
     }
 
     printf("Extract %s. Beginning work ....\n", versionString);
@@ -467,6 +621,17 @@ int main(int argc, char ** argv)
         return 1;
     }
 
+    ModelContentHashes = std::make_unique<ContentHashList>(std::string(szWorkDirWmo) + "/contenthashes.txt",
+        ContentHashList::HashBytes(VMAP::RAW_VMAP_MAGIC, strlen(VMAP::RAW_VMAP_MAGIC)));
+    ModelContentHashes->Load();
+
+    // models and wmos are read from CASC here and converted by the workers, spawns are written here in the same order as before
+    ExtractionPipeline<ModelExtraction> conversions(ExtractThreads, ExtractThreads * 2, [](ModelExtraction& extraction)
+    {
+        ConvertExtraction(extraction);
+    });
+    ModelConversions = &conversions;
+
     // Extract models, listed in GameObjectDisplayInfo.dbc
     ExtractGameobjectModels();
 
@@ -538,6 +703,12 @@ int main(int argc, char ** argv)
         ParsMapFiles();
     }
 
+    conversions.Finish();
+    ModelConversions = nullptr;
+
+    if (!ModelContentHashes->Save())
+        printf("Could not write %s/contenthashes.txt, all models will be extracted again by the next run\n", szWorkDirWmo);
+
     CascStorage.reset();
 
     printf("\n");
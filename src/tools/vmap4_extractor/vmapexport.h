@@ -19,8 +19,10 @@
 #define VMAPEXPORT_H
 
 #include "Define.h"
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 enum ModelFlags
 {
@@ -30,9 +32,33 @@ enum ModelFlags
 };
 
 struct WMODoodadData;
+class ContentHashList;
+class Model;
+class WMOGroup;
+class WMORoot;
+template<typename T> class ExtractionPipeline;
+
+// m2 or wmo read from CASC by PrepareSingleModel or PrepareSingleWmo, written by ConvertExtraction on any thread
+struct ModelExtraction
+{
+    std::unique_ptr<Model> Source;                      // null when the output is up to date
+    std::unique_ptr<WMORoot> WmoRoot;                   // null when the output is up to date
+    std::vector<std::unique_ptr<WMOGroup>> WmoGroups;
+    std::string OutputName;
+    uint64 ContentHash = 0;
+
+    ModelExtraction();
+    ModelExtraction(ModelExtraction&&);
+    ModelExtraction& operator=(ModelExtraction&&);
+    ~ModelExtraction();
+};
 
 extern const char * szWorkDirWmo;
 extern std::unordered_map<std::string, WMODoodadData> WmoDoodads;
+extern uint32 ExtractThreads;
+extern std::unique_ptr<ContentHashList> ModelContentHashes;
+// set while models are converted on worker threads, they are converted on the reading thread otherwise
+extern ExtractionPipeline<ModelExtraction>* ModelConversions;
 
 uint32 GenerateUniqueObjectId(uint32 clientId, uint16 clientDoodadId);
 
@@ -41,6 +67,17 @@ bool FileExists(const char * file);
 bool ExtractSingleWmo(std::string& fname);
 bool ExtractSingleModel(std::string& fname);
 
+// ExtractSingleModel and ExtractSingleWmo split for ExtractionPipeline, CASC is only read by the Prepare functions
+bool PrepareSingleModel(std::string& fname, ModelExtraction& extraction);
+bool PrepareSingleWmo(std::string& fname, ModelExtraction& extraction);
+bool ConvertSingleModel(ModelExtraction& extraction);
+bool ConvertSingleWmo(ModelExtraction& extraction);
+bool ConvertExtraction(ModelExtraction& extraction);
+
+// vertex count stored in the header of an extracted model, known once it is prepared even if a worker did not write the file yet
+bool GetExtractedVertexCount(char const* outputName, int& vertexCount);
+void SetExtractedVertexCount(std::string const& outputName, int vertexCount);
+
 void ExtractGameobjectModels();
 
 #endif
@@ -439,10 +439,7 @@ int WMOGroup::ConvertToVMAPGroupWmo(FILE* output, bool preciseVectorData)
         for (int i=0; i<nTriangles; ++i)
         {
             // Skip no collision triangles
-            bool isRenderFace = (MOPY[2 * i] & WMO_MATERIAL_RENDER) && !(MOPY[2 * i] & WMO_MATERIAL_DETAIL);
-            bool isCollision = MOPY[2 * i] & WMO_MATERIAL_COLLISION || isRenderFace;
-
-            if (!isCollision)
+            if (!IsCollisionTriangle(i))
                 continue;
 
             // Use this triangle
@@ -524,6 +521,25 @@ int WMOGroup::ConvertToVMAPGroupWmo(FILE* output, bool preciseVectorData)
     return nColTriangles;
 }
 
+int WMOGroup::GetCollisionTriangleCount(bool preciseVectorData) const
+{
+    if (preciseVectorData)
+        return nTriangles;
+
+    int nColTriangles = 0;
+    for (int i = 0; i < nTriangles; ++i)
+        if (IsCollisionTriangle(i))
+            ++nColTriangles;
+
+    return nColTriangles;
+}
+
+bool WMOGroup::IsCollisionTriangle(int triangle) const
+{
+    bool isRenderFace = (MOPY[2 * triangle] & WMO_MATERIAL_RENDER) && !(MOPY[2 * triangle] & WMO_MATERIAL_DETAIL);
+    return (MOPY[2 * triangle] & WMO_MATERIAL_COLLISION) || isRenderFace;
+}
+
 uint32 WMOGroup::GetLiquidTypeId(uint32 liquidTypeId)
 {
     if (liquidTypeId < 21 && liquidTypeId)
@@ -572,22 +588,14 @@ void MapObject::Extract(ADT::MODF const& mapObjDef, char const* WmoInstName, boo
 
     //-----------add_in _dir_file----------------
 
-    char tempname[512];
-    sprintf(tempname, "%s/%s", szWorkDirWmo, WmoInstName);
-    FILE* input = fopen(tempname, "r+b");
-
-    if (!input)
+    int nVertices;
+    if (!GetExtractedVertexCount(WmoInstName, nVertices))
     {
-        printf("WMOInstance::WMOInstance: couldn't open %s\n", tempname);
+        printf("WMOInstance::WMOInstance: couldn't open %s/%s\n", szWorkDirWmo, WmoInstName);
         return;
     }
 
-    fseek(input, 8, SEEK_SET); // get the correct no of vertices
-    int nVertices;
-    int count = fread(&nVertices, sizeof (int), 1, input);
-    fclose(input);
-
-    if (count != 1 || nVertices == 0)
+    if (nVertices == 0)
         return;
 
     Vec3D position = fixCoords(mapObjDef.Position);
@@ -156,8 +156,13 @@ public:
 
     bool open(WMORoot* rootWMO);
     int ConvertToVMAPGroupWmo(FILE* output, bool preciseVectorData);
+    // same count as returned by ConvertToVMAPGroupWmo
+    int GetCollisionTriangleCount(bool preciseVectorData) const;
     uint32 GetLiquidTypeId(uint32 liquidTypeId);
     bool ShouldSkip(WMORoot const* root) const;
+
+private:
+    bool IsCollisionTriangle(int triangle) const;
 };
 
 namespace MapObject